@@ -8,9 +8,11 @@ namespace qrz
 	 */
 	enum Action
 	{
+		ADIF_ENRICH_ACTION,
 		BIO_ACTION,
 		CALLSIGN_ACTION,
 		DXCC_ACTION,
+		DXCC_MIRROR_ACTION,
 		RESET_LOGIN_ACTION
 	};
 }
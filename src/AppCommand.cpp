@@ -90,3 +90,541 @@ void AppCommand::setSearchTerms(const std::set<std::string> &searchTerms)
 {
 	m_searchTerms = searchTerms;
 }
+
+/**
+ * @brief Get whether run statistics should be printed.
+ *
+ * When enabled, the AppController prints request throttling and timing statistics to stderr after the command completes.
+ *
+ * @return Whether run statistics should be printed.
+ */
+bool AppCommand::getShowStats() const
+{
+	return m_showStats;
+}
+
+/**
+ * @brief Set whether run statistics should be printed.
+ *
+ * When enabled, the AppController prints request throttling and timing statistics to stderr after the command completes.
+ *
+ * @param showStats Whether run statistics should be printed.
+ */
+void AppCommand::setShowStats(bool showStats)
+{
+	m_showStats = showStats;
+}
+
+/**
+ * @brief Get the maximum QRZ API request rate, in requests per second.
+ *
+ * A value of zero leaves the client's default rate limit in place.
+ *
+ * @return The maximum QRZ API request rate, in requests per second.
+ */
+double AppCommand::getRequestRate() const
+{
+	return m_requestRate;
+}
+
+/**
+ * @brief Set the maximum QRZ API request rate, in requests per second.
+ *
+ * A value of zero leaves the client's default rate limit in place.
+ *
+ * @param requestRate The maximum QRZ API request rate, in requests per second.
+ */
+void AppCommand::setRequestRate(double requestRate)
+{
+	m_requestRate = requestRate;
+}
+
+/**
+ * @brief Get the maximum number of concurrent QRZ API requests.
+ *
+ * The client adapts the number of requests in flight up to this bound. A value of zero leaves the client default in place.
+ *
+ * @return The maximum number of concurrent QRZ API requests.
+ */
+int AppCommand::getMaxConcurrency() const
+{
+	return m_maxConcurrency;
+}
+
+/**
+ * @brief Set the maximum number of concurrent QRZ API requests.
+ *
+ * The client adapts the number of requests in flight up to this bound. A value of zero leaves the client default in place.
+ *
+ * @param maxConcurrency The maximum number of concurrent QRZ API requests.
+ */
+void AppCommand::setMaxConcurrency(int maxConcurrency)
+{
+	m_maxConcurrency = maxConcurrency;
+}
+
+/**
+ * @brief Get the request hedging percentile.
+ *
+ * A request not answered within this percentile of recent latency is duplicated, and the first response wins.
+ * 0 disables hedging.
+ *
+ * @return The request hedging percentile.
+ */
+double AppCommand::getHedgePercentile() const
+{
+	return m_hedgePercentile;
+}
+
+/**
+ * @brief Set the request hedging percentile.
+ *
+ * A request not answered within this percentile of recent latency is duplicated, and the first response wins.
+ * 0 disables hedging.
+ *
+ * @param hedgePercentile The request hedging percentile.
+ */
+void AppCommand::setHedgePercentile(double hedgePercentile)
+{
+	m_hedgePercentile = hedgePercentile;
+}
+
+/**
+ * @brief Get the connect timeout in seconds.
+ *
+ * Time allowed to establish a connection to the QRZ API. 0 uses the client default.
+ *
+ * @return The connect timeout in seconds.
+ */
+double AppCommand::getConnectTimeout() const
+{
+	return m_connectTimeout;
+}
+
+/**
+ * @brief Set the connect timeout in seconds.
+ *
+ * Time allowed to establish a connection to the QRZ API. 0 uses the client default.
+ *
+ * @param connectTimeout The connect timeout in seconds.
+ */
+void AppCommand::setConnectTimeout(double connectTimeout)
+{
+	m_connectTimeout = connectTimeout;
+}
+
+/**
+ * @brief Get the send timeout in seconds.
+ *
+ * Time allowed for each send on the socket. 0 uses the client default.
+ *
+ * @return The send timeout in seconds.
+ */
+double AppCommand::getSendTimeout() const
+{
+	return m_sendTimeout;
+}
+
+/**
+ * @brief Set the send timeout in seconds.
+ *
+ * Time allowed for each send on the socket. 0 uses the client default.
+ *
+ * @param sendTimeout The send timeout in seconds.
+ */
+void AppCommand::setSendTimeout(double sendTimeout)
+{
+	m_sendTimeout = sendTimeout;
+}
+
+/**
+ * @brief Get the receive timeout in seconds.
+ *
+ * Time allowed for each receive on the socket. 0 uses the client default.
+ *
+ * @return The receive timeout in seconds.
+ */
+double AppCommand::getReceiveTimeout() const
+{
+	return m_receiveTimeout;
+}
+
+/**
+ * @brief Set the receive timeout in seconds.
+ *
+ * Time allowed for each receive on the socket. 0 uses the client default.
+ *
+ * @param receiveTimeout The receive timeout in seconds.
+ */
+void AppCommand::setReceiveTimeout(double receiveTimeout)
+{
+	m_receiveTimeout = receiveTimeout;
+}
+
+/**
+ * @brief Get the lookup timeout in seconds.
+ *
+ * Time allowed for a single lookup, including retries. 0 uses the client default.
+ *
+ * @return The lookup timeout in seconds.
+ */
+double AppCommand::getLookupTimeout() const
+{
+	return m_lookupTimeout;
+}
+
+/**
+ * @brief Set the lookup timeout in seconds.
+ *
+ * Time allowed for a single lookup, including retries. 0 uses the client default.
+ *
+ * @param lookupTimeout The lookup timeout in seconds.
+ */
+void AppCommand::setLookupTimeout(double lookupTimeout)
+{
+	m_lookupTimeout = lookupTimeout;
+}
+
+/**
+ * @brief Get the batch timeout in seconds.
+ *
+ * Time allowed for the whole batch of lookups. 0 means no limit.
+ *
+ * @return The batch timeout in seconds.
+ */
+double AppCommand::getBatchTimeout() const
+{
+	return m_batchTimeout;
+}
+
+/**
+ * @brief Set the batch timeout in seconds.
+ *
+ * Time allowed for the whole batch of lookups. 0 means no limit.
+ *
+ * @param batchTimeout The batch timeout in seconds.
+ */
+void AppCommand::setBatchTimeout(double batchTimeout)
+{
+	m_batchTimeout = batchTimeout;
+}
+
+/**
+ * @brief Get the prefix table path.
+ *
+ * Path of the cty.dat or cty.csv file used to resolve DXCC entities locally. Empty uses the file in the
+ * configuration directory.
+ *
+ * @return The prefix table path.
+ */
+const std::string &AppCommand::getPrefixTablePath() const
+{
+	return m_prefixTablePath;
+}
+
+/**
+ * @brief Set the prefix table path.
+ *
+ * Path of the cty.dat or cty.csv file used to resolve DXCC entities locally. Empty uses the file in the
+ * configuration directory.
+ *
+ * @param prefixTablePath The prefix table path.
+ */
+void AppCommand::setPrefixTablePath(const std::string &prefixTablePath)
+{
+	m_prefixTablePath = prefixTablePath;
+}
+
+/**
+ * @brief Get whether the command must run offline.
+ *
+ * When set, DXCC lookups are only answered from the local prefix and DXCC tables, and the QRZ API is never
+ * called.
+ *
+ * @return Whether the command must run offline.
+ */
+bool AppCommand::getOffline() const
+{
+	return m_offline;
+}
+
+/**
+ * @brief Set whether the command must run offline.
+ *
+ * When set, DXCC lookups are only answered from the local prefix and DXCC tables, and the QRZ API is never
+ * called.
+ *
+ * @param offline Whether the command must run offline.
+ */
+void AppCommand::setOffline(bool offline)
+{
+	m_offline = offline;
+}
+
+/**
+ * @brief Get whether callsign results are joined to their DXCC entities.
+ *
+ * When set, each callsign is rendered with the name, continent and zones of its DXCC entity.
+ *
+ * @return Whether callsign results are joined to their DXCC entities.
+ */
+bool AppCommand::getWithDxcc() const
+{
+	return m_withDxcc;
+}
+
+/**
+ * @brief Set whether callsign results are joined to their DXCC entities.
+ *
+ * When set, each callsign is rendered with the name, continent and zones of its DXCC entity.
+ *
+ * @param withDxcc Whether callsign results are joined to their DXCC entities.
+ */
+void AppCommand::setWithDxcc(bool withDxcc)
+{
+	m_withDxcc = withDxcc;
+}
+
+/**
+ * @brief Get the input file path.
+ *
+ * Path of the ADIF log read by the ADIF enrichment action.
+ *
+ * @return The input file path.
+ */
+const std::string &AppCommand::getInputPath() const
+{
+	return m_inputPath;
+}
+
+/**
+ * @brief Set the input file path.
+ *
+ * Path of the ADIF log read by the ADIF enrichment action.
+ *
+ * @param inputPath The input file path.
+ */
+void AppCommand::setInputPath(const std::string &inputPath)
+{
+	m_inputPath = inputPath;
+}
+
+/**
+ * @brief Get the output file path.
+ *
+ * Path of the file written by the ADIF enrichment action. Empty writes to standard output.
+ *
+ * @return The output file path.
+ */
+const std::string &AppCommand::getOutputPath() const
+{
+	return m_outputPath;
+}
+
+/**
+ * @brief Set the output file path.
+ *
+ * Path of the file written by the ADIF enrichment action. Empty writes to standard output.
+ *
+ * @param outputPath The output file path.
+ */
+void AppCommand::setOutputPath(const std::string &outputPath)
+{
+	m_outputPath = outputPath;
+}
+
+/**
+ * @brief Get whether lookups use the lookup cache.
+ *
+ * When set, callsign lookups are answered from the lookup cache while their entries are fresh, and fetched
+ * results are added to it.
+ *
+ * @return Whether lookups use the lookup cache.
+ */
+bool AppCommand::getUseCache() const
+{
+	return m_useCache;
+}
+
+/**
+ * @brief Set whether lookups use the lookup cache.
+ *
+ * When set, callsign lookups are answered from the lookup cache while their entries are fresh, and fetched
+ * results are added to it.
+ *
+ * @param useCache Whether lookups use the lookup cache.
+ */
+void AppCommand::setUseCache(bool useCache)
+{
+	m_useCache = useCache;
+}
+
+/**
+ * @brief Get the file to write a trace of the run to.
+ *
+ * When set, the phases of every lookup are written to it as Chrome trace-event JSON. Empty means no trace.
+ *
+ * @return The file to write a trace of the run to.
+ */
+const std::string &AppCommand::getTracePath() const
+{
+	return m_tracePath;
+}
+
+/**
+ * @brief Set the file to write a trace of the run to.
+ *
+ * When set, the phases of every lookup are written to it as Chrome trace-event JSON. Empty means no trace.
+ *
+ * @param tracePath The file to write a trace of the run to.
+ */
+void AppCommand::setTracePath(const std::string &tracePath)
+{
+	m_tracePath = tracePath;
+}
+
+/**
+ * @brief Get the file to write metrics to.
+ *
+ * When set, request metrics are written to it in the Prometheus text format while the command runs. Empty
+ * means no metrics.
+ *
+ * @return The file to write metrics to.
+ */
+const std::string &AppCommand::getMetricsPath() const
+{
+	return m_metricsPath;
+}
+
+/**
+ * @brief Set the file to write metrics to.
+ *
+ * When set, request metrics are written to it in the Prometheus text format while the command runs. Empty
+ * means no metrics.
+ *
+ * @param metricsPath The file to write metrics to.
+ */
+void AppCommand::setMetricsPath(const std::string &metricsPath)
+{
+	m_metricsPath = metricsPath;
+}
+
+/**
+ * @brief Get the number of seconds between metrics file writes.
+ *
+ * 0 means the default interval.
+ *
+ * @return The number of seconds between metrics file writes.
+ */
+double AppCommand::getMetricsInterval() const
+{
+	return m_metricsInterval;
+}
+
+/**
+ * @brief Set the number of seconds between metrics file writes.
+ *
+ * 0 means the default interval.
+ *
+ * @param metricsInterval The number of seconds between metrics file writes.
+ */
+void AppCommand::setMetricsInterval(double metricsInterval)
+{
+	m_metricsInterval = metricsInterval;
+}
+
+/**
+ * @brief Get the directory bios are written to.
+ *
+ * Each bio is written to CALL.html in this directory. Empty to write bios to standard output.
+ *
+ * @return The directory bios are written to.
+ */
+const std::string &AppCommand::getOutputDir() const
+{
+	return m_outputDir;
+}
+
+/**
+ * @brief Set the directory bios are written to.
+ *
+ * Each bio is written to CALL.html in this directory. Empty to write bios to standard output.
+ *
+ * @param outputDir The directory bios are written to.
+ */
+void AppCommand::setOutputDir(const std::string &outputDir)
+{
+	m_outputDir = outputDir;
+}
+
+/**
+ * @brief Get the template callsigns are rendered with.
+ *
+ * Used when the format is OutputFormat::TEMPLATE, e.g. "{call}\\t{grid}".
+ *
+ * @return The template callsigns are rendered with.
+ */
+const std::string &AppCommand::getOutputTemplate() const
+{
+	return m_outputTemplate;
+}
+
+/**
+ * @brief Set the template callsigns are rendered with.
+ *
+ * Used when the format is OutputFormat::TEMPLATE, e.g. "{call}\\t{grid}".
+ *
+ * @param outputTemplate The template callsigns are rendered with.
+ */
+void AppCommand::setOutputTemplate(const std::string &outputTemplate)
+{
+	m_outputTemplate = outputTemplate;
+}
+
+/**
+ * @brief Get whether results are rendered in completion order.
+ *
+ * By default results are rendered in search term order, as soon as every earlier term has completed.
+ *
+ * @return Whether results are rendered in completion order.
+ */
+bool AppCommand::getUnordered() const
+{
+	return m_unordered;
+}
+
+/**
+ * @brief Set whether results are rendered in completion order.
+ *
+ * By default results are rendered in search term order, as soon as every earlier term has completed.
+ *
+ * @param unordered Whether results are rendered in completion order.
+ */
+void AppCommand::setUnordered(bool unordered)
+{
+	m_unordered = unordered;
+}
+
+/**
+ * @brief Get the lookup cache policy of each record type.
+ *
+ * The policies decide how long cached entries are served fresh, stale while they are refreshed, or as "not found".
+ *
+ * @return The lookup cache policy of each record type.
+ */
+const cache::CachePolicies &AppCommand::getCachePolicies() const
+{
+	return m_cachePolicies;
+}
+
+/**
+ * @brief Set the lookup cache policy of each record type.
+ *
+ * The policies decide how long cached entries are served fresh, stale while they are refreshed, or as "not found".
+ *
+ * @param cachePolicies The lookup cache policy of each record type.
+ */
+void AppCommand::setCachePolicies(const cache::CachePolicies &cachePolicies)
+{
+	m_cachePolicies = cachePolicies;
+}
\ No newline at end of file
@@ -7,6 +7,7 @@
 
 #include "Action.h"
 #include "OutputFormat.h"
+#include "cache/CachePolicy.h"
 
 namespace qrz
 {
@@ -86,6 +87,412 @@ namespace qrz
 		 */
 		void setSearchTerms(const std::set<std::string> &searchTerms);
 
+		/**
+		 * @brief Get whether run statistics should be printed.
+		 *
+		 * When enabled, the AppController prints request throttling and timing statistics to stderr after the command completes.
+		 *
+		 * @return Whether run statistics should be printed.
+		 */
+		bool getShowStats() const;
+
+		/**
+		 * @brief Set whether run statistics should be printed.
+		 *
+		 * When enabled, the AppController prints request throttling and timing statistics to stderr after the command completes.
+		 *
+		 * @param showStats Whether run statistics should be printed.
+		 */
+		void setShowStats(bool showStats);
+
+		/**
+		 * @brief Get the maximum QRZ API request rate, in requests per second.
+		 *
+		 * A value of zero leaves the client's default rate limit in place.
+		 *
+		 * @return The maximum QRZ API request rate, in requests per second.
+		 */
+		double getRequestRate() const;
+
+		/**
+		 * @brief Set the maximum QRZ API request rate, in requests per second.
+		 *
+		 * A value of zero leaves the client's default rate limit in place.
+		 *
+		 * @param requestRate The maximum QRZ API request rate, in requests per second.
+		 */
+		void setRequestRate(double requestRate);
+
+		/**
+		 * @brief Get the maximum number of concurrent QRZ API requests.
+		 *
+		 * The client adapts the number of requests in flight up to this bound. A value of zero leaves the client default in place.
+		 *
+		 * @return The maximum number of concurrent QRZ API requests.
+		 */
+		int getMaxConcurrency() const;
+
+		/**
+		 * @brief Set the maximum number of concurrent QRZ API requests.
+		 *
+		 * The client adapts the number of requests in flight up to this bound. A value of zero leaves the client default in place.
+		 *
+		 * @param maxConcurrency The maximum number of concurrent QRZ API requests.
+		 */
+		void setMaxConcurrency(int maxConcurrency);
+
+		/**
+		 * @brief Get the request hedging percentile.
+		 *
+		 * A request not answered within this percentile of recent latency is duplicated, and the first response wins.
+		 * 0 disables hedging.
+		 *
+		 * @return The request hedging percentile.
+		 */
+		double getHedgePercentile() const;
+
+		/**
+		 * @brief Set the request hedging percentile.
+		 *
+		 * A request not answered within this percentile of recent latency is duplicated, and the first response wins.
+		 * 0 disables hedging.
+		 *
+		 * @param hedgePercentile The request hedging percentile.
+		 */
+		void setHedgePercentile(double hedgePercentile);
+
+		/**
+		 * @brief Get the connect timeout in seconds.
+		 *
+		 * Time allowed to establish a connection to the QRZ API. 0 uses the client default.
+		 *
+		 * @return The connect timeout in seconds.
+		 */
+		double getConnectTimeout() const;
+
+		/**
+		 * @brief Set the connect timeout in seconds.
+		 *
+		 * Time allowed to establish a connection to the QRZ API. 0 uses the client default.
+		 *
+		 * @param connectTimeout The connect timeout in seconds.
+		 */
+		void setConnectTimeout(double connectTimeout);
+
+		/**
+		 * @brief Get the send timeout in seconds.
+		 *
+		 * Time allowed for each send on the socket. 0 uses the client default.
+		 *
+		 * @return The send timeout in seconds.
+		 */
+		double getSendTimeout() const;
+
+		/**
+		 * @brief Set the send timeout in seconds.
+		 *
+		 * Time allowed for each send on the socket. 0 uses the client default.
+		 *
+		 * @param sendTimeout The send timeout in seconds.
+		 */
+		void setSendTimeout(double sendTimeout);
+
+		/**
+		 * @brief Get the receive timeout in seconds.
+		 *
+		 * Time allowed for each receive on the socket. 0 uses the client default.
+		 *
+		 * @return The receive timeout in seconds.
+		 */
+		double getReceiveTimeout() const;
+
+		/**
+		 * @brief Set the receive timeout in seconds.
+		 *
+		 * Time allowed for each receive on the socket. 0 uses the client default.
+		 *
+		 * @param receiveTimeout The receive timeout in seconds.
+		 */
+		void setReceiveTimeout(double receiveTimeout);
+
+		/**
+		 * @brief Get the lookup timeout in seconds.
+		 *
+		 * Time allowed for a single lookup, including retries. 0 uses the client default.
+		 *
+		 * @return The lookup timeout in seconds.
+		 */
+		double getLookupTimeout() const;
+
+		/**
+		 * @brief Set the lookup timeout in seconds.
+		 *
+		 * Time allowed for a single lookup, including retries. 0 uses the client default.
+		 *
+		 * @param lookupTimeout The lookup timeout in seconds.
+		 */
+		void setLookupTimeout(double lookupTimeout);
+
+		/**
+		 * @brief Get the batch timeout in seconds.
+		 *
+		 * Time allowed for the whole batch of lookups. 0 means no limit.
+		 *
+		 * @return The batch timeout in seconds.
+		 */
+		double getBatchTimeout() const;
+
+		/**
+		 * @brief Set the batch timeout in seconds.
+		 *
+		 * Time allowed for the whole batch of lookups. 0 means no limit.
+		 *
+		 * @param batchTimeout The batch timeout in seconds.
+		 */
+		void setBatchTimeout(double batchTimeout);
+
+		/**
+		 * @brief Get the prefix table path.
+		 *
+		 * Path of the cty.dat or cty.csv file used to resolve DXCC entities locally. Empty uses the file in the
+		 * configuration directory.
+		 *
+		 * @return The prefix table path.
+		 */
+		const std::string &getPrefixTablePath() const;
+
+		/**
+		 * @brief Set the prefix table path.
+		 *
+		 * Path of the cty.dat or cty.csv file used to resolve DXCC entities locally. Empty uses the file in the
+		 * configuration directory.
+		 *
+		 * @param prefixTablePath The prefix table path.
+		 */
+		void setPrefixTablePath(const std::string &prefixTablePath);
+
+		/**
+		 * @brief Get whether the command must run offline.
+		 *
+		 * When set, DXCC lookups are only answered from the local prefix and DXCC tables, and the QRZ API is never
+		 * called.
+		 *
+		 * @return Whether the command must run offline.
+		 */
+		bool getOffline() const;
+
+		/**
+		 * @brief Set whether the command must run offline.
+		 *
+		 * When set, DXCC lookups are only answered from the local prefix and DXCC tables, and the QRZ API is never
+		 * called.
+		 *
+		 * @param offline Whether the command must run offline.
+		 */
+		void setOffline(bool offline);
+
+		/**
+		 * @brief Get whether callsign results are joined to their DXCC entities.
+		 *
+		 * When set, each callsign is rendered with the name, continent and zones of its DXCC entity.
+		 *
+		 * @return Whether callsign results are joined to their DXCC entities.
+		 */
+		bool getWithDxcc() const;
+
+		/**
+		 * @brief Set whether callsign results are joined to their DXCC entities.
+		 *
+		 * When set, each callsign is rendered with the name, continent and zones of its DXCC entity.
+		 *
+		 * @param withDxcc Whether callsign results are joined to their DXCC entities.
+		 */
+		void setWithDxcc(bool withDxcc);
+
+		/**
+		 * @brief Get the input file path.
+		 *
+		 * Path of the ADIF log read by the ADIF enrichment action.
+		 *
+		 * @return The input file path.
+		 */
+		const std::string &getInputPath() const;
+
+		/**
+		 * @brief Set the input file path.
+		 *
+		 * Path of the ADIF log read by the ADIF enrichment action.
+		 *
+		 * @param inputPath The input file path.
+		 */
+		void setInputPath(const std::string &inputPath);
+
+		/**
+		 * @brief Get the output file path.
+		 *
+		 * Path of the file written by the ADIF enrichment action. Empty writes to standard output.
+		 *
+		 * @return The output file path.
+		 */
+		const std::string &getOutputPath() const;
+
+		/**
+		 * @brief Set the output file path.
+		 *
+		 * Path of the file written by the ADIF enrichment action. Empty writes to standard output.
+		 *
+		 * @param outputPath The output file path.
+		 */
+		void setOutputPath(const std::string &outputPath);
+
+		/**
+		 * @brief Get whether lookups use the lookup cache.
+		 *
+		 * When set, callsign lookups are answered from the lookup cache while their entries are fresh, and fetched
+		 * results are added to it.
+		 *
+		 * @return Whether lookups use the lookup cache.
+		 */
+		bool getUseCache() const;
+
+		/**
+		 * @brief Set whether lookups use the lookup cache.
+		 *
+		 * When set, callsign lookups are answered from the lookup cache while their entries are fresh, and fetched
+		 * results are added to it.
+		 *
+		 * @param useCache Whether lookups use the lookup cache.
+		 */
+		void setUseCache(bool useCache);
+
+		/**
+		 * @brief Get the file to write a trace of the run to.
+		 *
+		 * When set, the phases of every lookup are written to it as Chrome trace-event JSON. Empty means no trace.
+		 *
+		 * @return The file to write a trace of the run to.
+		 */
+		const std::string &getTracePath() const;
+
+		/**
+		 * @brief Set the file to write a trace of the run to.
+		 *
+		 * When set, the phases of every lookup are written to it as Chrome trace-event JSON. Empty means no trace.
+		 *
+		 * @param tracePath The file to write a trace of the run to.
+		 */
+		void setTracePath(const std::string &tracePath);
+
+		/**
+		 * @brief Get the file to write metrics to.
+		 *
+		 * When set, request metrics are written to it in the Prometheus text format while the command runs. Empty
+		 * means no metrics.
+		 *
+		 * @return The file to write metrics to.
+		 */
+		const std::string &getMetricsPath() const;
+
+		/**
+		 * @brief Set the file to write metrics to.
+		 *
+		 * When set, request metrics are written to it in the Prometheus text format while the command runs. Empty
+		 * means no metrics.
+		 *
+		 * @param metricsPath The file to write metrics to.
+		 */
+		void setMetricsPath(const std::string &metricsPath);
+
+		/**
+		 * @brief Get the number of seconds between metrics file writes.
+		 *
+		 * 0 means the default interval.
+		 *
+		 * @return The number of seconds between metrics file writes.
+		 */
+		double getMetricsInterval() const;
+
+		/**
+		 * @brief Set the number of seconds between metrics file writes.
+		 *
+		 * 0 means the default interval.
+		 *
+		 * @param metricsInterval The number of seconds between metrics file writes.
+		 */
+		void setMetricsInterval(double metricsInterval);
+
+		/**
+		 * @brief Get the directory bios are written to.
+		 *
+		 * Each bio is written to CALL.html in this directory. Empty to write bios to standard output.
+		 *
+		 * @return The directory bios are written to.
+		 */
+		const std::string &getOutputDir() const;
+
+		/**
+		 * @brief Set the directory bios are written to.
+		 *
+		 * Each bio is written to CALL.html in this directory. Empty to write bios to standard output.
+		 *
+		 * @param outputDir The directory bios are written to.
+		 */
+		void setOutputDir(const std::string &outputDir);
+
+		/**
+		 * @brief Get the template callsigns are rendered with.
+		 *
+		 * Used when the format is OutputFormat::TEMPLATE, e.g. "{call}\\t{grid}".
+		 *
+		 * @return The template callsigns are rendered with.
+		 */
+		const std::string &getOutputTemplate() const;
+
+		/**
+		 * @brief Set the template callsigns are rendered with.
+		 *
+		 * Used when the format is OutputFormat::TEMPLATE, e.g. "{call}\\t{grid}".
+		 *
+		 * @param outputTemplate The template callsigns are rendered with.
+		 */
+		void setOutputTemplate(const std::string &outputTemplate);
+
+		/**
+		 * @brief Get whether results are rendered in completion order.
+		 *
+		 * By default results are rendered in search term order, as soon as every earlier term has completed.
+		 *
+		 * @return Whether results are rendered in completion order.
+		 */
+		bool getUnordered() const;
+
+		/**
+		 * @brief Set whether results are rendered in completion order.
+		 *
+		 * By default results are rendered in search term order, as soon as every earlier term has completed.
+		 *
+		 * @param unordered Whether results are rendered in completion order.
+		 */
+		void setUnordered(bool unordered);
+
+		/**
+		 * @brief Get the lookup cache policy of each record type.
+		 *
+		 * The policies decide how long cached entries are served fresh, stale while they are refreshed, or as "not found".
+		 *
+		 * @return The lookup cache policy of each record type.
+		 */
+		const cache::CachePolicies &getCachePolicies() const;
+
+		/**
+		 * @brief Set the lookup cache policy of each record type.
+		 *
+		 * The policies decide how long cached entries are served fresh, stale while they are refreshed, or as "not found".
+		 *
+		 * @param cachePolicies The lookup cache policy of each record type.
+		 */
+		void setCachePolicies(const cache::CachePolicies &cachePolicies);
+
 	private:
 		// The action to be performed by the AppController
 		Action m_action = Action::CALLSIGN_ACTION;
@@ -95,6 +502,72 @@ namespace qrz
 
 		// List of terms to be used in the QRZ API calls to fetch the relevant records
 		std::set<std::string> m_searchTerms;
+
+		// Print run statistics to stderr when the command completes
+		bool m_showStats = false;
+
+		// Maximum request rate in requests per second, 0 for the client default
+		double m_requestRate = 0;
+
+		// Upper bound for concurrent requests, 0 for the client default
+		int m_maxConcurrency = 0;
+
+		// Latency percentile after which a slow request is hedged, or 0 to disable hedging
+		double m_hedgePercentile = 0;
+
+		// Connect timeout in seconds, 0 for the client default
+		double m_connectTimeout = 0;
+
+		// Send timeout in seconds, 0 for the client default
+		double m_sendTimeout = 0;
+
+		// Receive timeout in seconds, 0 for the client default
+		double m_receiveTimeout = 0;
+
+		// Per-lookup deadline in seconds, 0 for the client default
+		double m_lookupTimeout = 0;
+
+		// Per-batch deadline in seconds, 0 for no limit
+		double m_batchTimeout = 0;
+
+		// Path of the country file prefix table, empty for the default
+		std::string m_prefixTablePath;
+
+		// Answer from local data only, without calling the QRZ API
+		bool m_offline = false;
+
+		// Join callsign results to their DXCC entities
+		bool m_withDxcc = false;
+
+		// Path of the input file, for actions that read one
+		std::string m_inputPath;
+
+		// Path of the output file, empty for standard output
+		std::string m_outputPath;
+
+		// Answer lookups from the lookup cache, and add fetched results to it
+		bool m_useCache = true;
+
+		// File to write Chrome trace-event JSON to, or empty for none
+		std::string m_tracePath;
+
+		// File to write Prometheus metrics to, or empty for none
+		std::string m_metricsPath;
+
+		// Seconds between metrics file writes. 0 means the default
+		double m_metricsInterval = 0;
+
+		// Directory bios are written to, empty for standard output
+		std::string m_outputDir;
+
+		// Template callsigns are rendered with, for OutputFormat::TEMPLATE
+		std::string m_outputTemplate;
+
+		// Whether results are rendered in completion order rather than search term order
+		bool m_unordered = false;
+
+		// How long the lookup cache serves entries of each record type
+		cache::CachePolicies m_cachePolicies;
 	};
 }
 
@@ -1,12 +1,30 @@
 #include "AppController.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <format>
+#include <fstream>
 #include <iostream>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <thread>
 
 #include <indicators/block_progress_bar.hpp>
 #include <indicators/cursor_control.hpp>
 
 #include "Action.h"
+#include "BioArchive.h"
+#include "CallsignNormalizer.h"
 #include "OutputFormat.h"
+#include "ReorderBuffer.h"
+#include "adif/AdifReader.h"
+#include "adif/AdifWriter.h"
+#include "model/CallsignMarshaler.h"
 #include "render/RendererFactory.h"
 
 #ifdef WIN32
@@ -17,53 +35,151 @@
 
 using namespace qrz;
 
+namespace
+{
+	// Deadline of the batch being fetched, cancelled by the SIGINT handler
+	std::atomic<const net::Deadline *> interruptibleBatch = nullptr;
+
+	/**
+	 * @brief SIGINT handler that cancels the batch being fetched.
+	 *
+	 * Cancelling only stores to an atomic flag, so it is safe in a signal handler. The default handler is restored
+	 * once the batch ends, so a second Ctrl+C during rendering exits as usual.
+	 */
+	extern "C" void cancelBatchOnInterrupt(int)
+	{
+		if (const net::Deadline *deadline = interruptibleBatch.load())
+		{
+			deadline->cancel();
+		}
+	}
+
+	/**
+	 * @class InterruptibleBatch
+	 * @brief Bounds the client's lookups by a batch deadline and lets Ctrl+C cancel it, for as long as it lives.
+	 *
+	 * The previous SIGINT handler and an unbounded batch deadline are restored on destruction, so a batch that ends
+	 * with an exception does not leave the handler pointing at its destroyed deadline.
+	 */
+	class InterruptibleBatch
+	{
+	public:
+		InterruptibleBatch(QRZClient &client, const net::Deadline &deadline) : m_client(client)
+		{
+			m_client.setBatchDeadline(deadline);
+
+			interruptibleBatch = &deadline;
+			m_previousHandler = std::signal(SIGINT, cancelBatchOnInterrupt);
+		}
+
+		~InterruptibleBatch()
+		{
+			std::signal(SIGINT, m_previousHandler);
+			interruptibleBatch = nullptr;
+			m_client.setBatchDeadline(net::Deadline());
+		}
+
+		InterruptibleBatch(const InterruptibleBatch &) = delete;
+		InterruptibleBatch &operator=(const InterruptibleBatch &) = delete;
+
+	private:
+		QRZClient &m_client;
+
+		void (*m_previousHandler)(int) = SIG_DFL;
+	};
+
+	/**
+	 * @brief Converts a number of seconds from the command line to milliseconds.
+	 *
+	 * @param seconds The number of seconds.
+	 * @return The equivalent duration.
+	 */
+	std::chrono::milliseconds secondsToDuration(double seconds)
+	{
+		return std::chrono::milliseconds(static_cast<int64_t>(seconds * 1000.0));
+	}
+
+	// ADIF fields that describe the operator rather than where they operate from
+	constexpr std::array<std::string_view, 2> operatorFields = {"NAME", "EMAIL"};
+
+	/**
+	 * @brief Parses the callsign of a logged QSO.
+	 *
+	 * @param record The ADIF record.
+	 * @return The record's CALL field split into its parts, or std::nullopt if it has none or it is not a callsign.
+	 * The base callsign is the one to look up.
+	 */
+	std::optional<ParsedCallsign> parseCall(const adif::Record &record)
+	{
+		const adif::Field *call = record.find("CALL");
+
+		if (!call)
+		{
+			return std::nullopt;
+		}
+
+		return CallsignNormalizer::parse(call->value);
+	}
+
+	/**
+	 * @brief Returns the ADIF location fields of a station operating away from home, from the prefix table.
+	 *
+	 * @param resolver The prefix table, or nullptr if none is loaded.
+	 * @param call The callsign as logged, e.g. KH6/W1AW.
+	 * @return The DXCC, COUNTRY, CQZ and ITUZ fields the table has for the callsign, or none.
+	 */
+	std::vector<adif::Field> awayFields(const dxcc::PrefixResolver *resolver, const std::string &call)
+	{
+		std::optional<DXCC> entity = resolver ? resolver->resolve(call) : std::nullopt;
+
+		if (!entity)
+		{
+			return {};
+		}
+
+		std::vector<adif::Field> fields;
+
+		auto add = [&fields](std::string name, const std::string &value)
+		{
+			if (!value.empty() && value != "0")
+			{
+				fields.push_back(adif::Field{std::move(name), value, ""});
+			}
+		};
+
+		add("DXCC", entity->getDxcc());
+		add("COUNTRY", entity->getName());
+		add("CQZ", entity->getCqzone());
+		add("ITUZ", entity->getItuzone());
+
+		return fields;
+	}
+}
+
 AppController::AppController()
 {
 	initialize();
 }
 
 /**
- * @brief Initializes the application by setting up the necessary configurations and checking for authentication.
+ * @brief Initializes the application by loading the saved login and session.
  *
- * This function is responsible for initializing the application. It checks if a callsign is set in the configuration,
- * and if not, prompts the user to enter their callsign. It also sets the callsign in the QRZ API client. Then, it checks
- * if a session key and session expiration are set in the configuration. If not, it refreshes the token by fetching a new
- * session key and expiration from the QRZ API. If the token is already expired, it refreshes it as well. Finally, it sets
- * the session key and expiration in the QRZ API client.
+ * This function sets the callsign, session key and session expiration saved in the configuration on the QRZ API
+ * client. It does not log in: fetchConcurrently() refreshes the token before the first request if the session is
+ * missing or expired, so lookups answered from local data never touch the network.
  */
 void AppController::initialize()
 {
-	std::string userCall;
-
-	if (!config.hasCallsign())
+	if (config.hasCallsign())
 	{
-		userCall = getUserCallsignFromUser();
-
-		config.setCallsign(userCall);
-		config.saveConfig();
+		client.setUsername(config.getCallsign());
 	}
 
-	userCall = config.getCallsign();
-
-	client.setUsername(userCall);
-
-	if (!config.hasSessionKey() || !config.hasSessionExpiration())
-	{
-		refreshToken();
-	}
-	else
+	if (config.hasSessionKey() && config.hasSessionExpiration())
 	{
 		client.setSessionKey(config.getSessionKey());
 		client.setSessionExpiration(config.getSessionExpiration());
-
-		if (!client.tokenIsValid())
-		{
-			refreshToken();
-		}
 	}
-
-	client.setSessionKey(config.getSessionKey());
-	client.setSessionExpiration(config.getSessionExpiration());
 }
 
 /**
@@ -76,21 +192,120 @@ void AppController::initialize()
  */
 void AppController::handleCommand(const AppCommand &command)
 {
+	if (command.getRequestRate() > 0)
+	{
+		client.setRequestRate(command.getRequestRate());
+	}
+
+	if (command.getMaxConcurrency() > 0)
+	{
+		client.setMaxConcurrency(command.getMaxConcurrency());
+	}
+
+	client.setHedgePercentile(command.getHedgePercentile());
+
+	if (command.getConnectTimeout() > 0)
+	{
+		client.setConnectTimeout(secondsToDuration(command.getConnectTimeout()));
+	}
+
+	if (command.getSendTimeout() > 0)
+	{
+		client.setSendTimeout(secondsToDuration(command.getSendTimeout()));
+	}
+
+	if (command.getReceiveTimeout() > 0)
+	{
+		client.setReceiveTimeout(secondsToDuration(command.getReceiveTimeout()));
+	}
+
+	if (command.getLookupTimeout() > 0)
+	{
+		client.setLookupTimeout(secondsToDuration(command.getLookupTimeout()));
+	}
+
+	m_batchTimeout = secondsToDuration(command.getBatchTimeout());
+
+	m_prefixTablePath = command.getPrefixTablePath().empty() ? config.getPrefixTablePath() : command.getPrefixTablePath();
+	m_dxccTablePath = config.getDXCCTablePath();
+	m_offline = command.getOffline();
+	m_withDxcc = command.getWithDxcc();
+	m_outputTemplate = command.getOutputTemplate();
+	m_unordered = command.getUnordered();
+	m_cachePath = command.getUseCache() ? config.getCachePath() : "";
+	m_cachePolicies = command.getCachePolicies();
+
+	m_tracePath = command.getTracePath();
+
+	if (command.getShowStats() || !m_tracePath.empty())
+	{
+		m_phaseStats = std::make_shared<net::PhaseStats>();
+		client.setPhaseStats(m_phaseStats);
+	}
+
+	if (!m_tracePath.empty())
+	{
+		m_traceRecorder = std::make_shared<net::TraceRecorder>();
+		m_phaseStats->setTraceRecorder(m_traceRecorder);
+	}
+
+	if (!command.getMetricsPath().empty())
+	{
+		m_metrics = std::make_shared<metrics::Registry>();
+		client.setMetrics(m_metrics);
+
+		std::chrono::milliseconds interval = command.getMetricsInterval() > 0
+				? secondsToDuration(command.getMetricsInterval())
+				: std::chrono::milliseconds(m_defaultMetricsInterval);
+
+		m_metricsExporter = std::make_unique<metrics::TextFileExporter>(m_metrics, command.getMetricsPath(), interval);
+	}
+
 	switch (command.getAction())
 	{
 		case Action::CALLSIGN_ACTION:
 			fetchAndRenderCallsigns(command.getSearchTerms(), command.getFormat());
 			break;
 		case Action::BIO_ACTION:
-			fetchAndRenderBios(command.getSearchTerms());
+			if (command.getOutputDir().empty())
+			{
+				fetchAndRenderBios(command.getSearchTerms());
+			}
+			else
+			{
+				exportBios(std::vector<std::string>(command.getSearchTerms().begin(), command.getSearchTerms().end()),
+						   command.getOutputDir());
+				updateConfigFromClientState();
+			}
 			break;
 		case Action::DXCC_ACTION:
 			fetchAndRenderDXCC(command.getSearchTerms(), command.getFormat());
 			break;
+		case Action::DXCC_MIRROR_ACTION:
+			mirrorDXCC();
+			break;
+		case Action::ADIF_ENRICH_ACTION:
+			enrichAdif(command.getInputPath(), command.getOutputPath());
+			break;
 		case Action::RESET_LOGIN_ACTION:
 			resetLogin();
 			break;
 	}
+
+	// Let any request that lost a hedge race finish before the client goes away
+	client.waitForHedges();
+
+	finishCacheCompaction();
+
+	if (command.getShowStats())
+	{
+		printStats();
+	}
+
+	writeTrace();
+
+	// Write the final values
+	m_metricsExporter.reset();
 }
 
 /**
@@ -136,8 +351,14 @@ void AppController::resetLogin()
 /**
  * @brief Fetches and renders callsigns based on the given search terms and output format.
  *
- * This function takes a set of search terms and an output format and fetches the callsign records using the fetchCallsignRecords function.
- * It then creates a renderer object based on the output format using the RendererFactory and renders the callsigns using the Render function.
+ * This function takes a set of search terms and an output format and looks the callsigns up through lookupCallsigns().
+ * It creates a renderer object based on the output format using the RendererFactory, and hands it each record as it
+ * arrives. A ReorderBuffer puts the records back into search term order as soon as the head of the line is ready, or
+ * with --unordered passes them on as they complete. Formats that can be written a record at a time, such as CSV,
+ * ADIF and --template, therefore start writing while the lookups are still running; the others are rendered at the
+ * end.
+ * With --with-dxcc, the DXCC entity of each callsign is joined to it by joinDXCC(), which needs every record first,
+ * so the records are fetched with fetchCallsignRecords() and rendered at the end.
  * After rendering, it updates the application configuration from the client state.
  *
  * @param searchTerms The set of search terms used to fetch the callsign records.
@@ -145,11 +366,56 @@ void AppController::resetLogin()
  */
 void AppController::fetchAndRenderCallsigns(const std::set<std::string> &searchTerms, const OutputFormat &format)
 {
-	const std::vector<Callsign> callsigns = fetchCallsignRecords(searchTerms);
+	if (m_withDxcc)
+	{
+		const std::vector<Callsign> callsigns = fetchCallsignRecords(searchTerms);
+		const render::DXCCJoin dxccJoin = joinDXCC(callsigns);
+
+		std::unique_ptr<render::Renderer<Callsign>> renderer =
+				render::RendererFactory::createCallsignRenderer(format, &dxccJoin);
+
+		{
+			net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::RENDER);
+
+			renderer->Render(callsigns);
+		}
+
+		updateConfigFromClientState();
+		return;
+	}
+
+	std::unique_ptr<render::Renderer<Callsign>> renderer =
+			format == OutputFormat::TEMPLATE
+			? render::RendererFactory::createCallsignRenderer(render::CallsignTemplate::compile(m_outputTemplate))
+			: render::RendererFactory::createCallsignRenderer(format, nullptr);
+
+	m_streaming = render::RendererFactory::streamsCallsigns(format);
+	renderer->Begin();
+
+	ReorderBuffer<Callsign> reorder(m_reorderWindow, [this, &renderer](Callsign &&callsign)
+	{
+		net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::RENDER);
 
-	std::unique_ptr<render::Renderer<Callsign>> renderer = render::RendererFactory::createCallsignRenderer(format);
+		renderer->RenderOne(callsign);
+	}, !m_unordered);
 
-	renderer->Render(callsigns);
+	lookupCallsigns(std::vector<std::string>(searchTerms.begin(), searchTerms.end()),
+					[&reorder](size_t index, Callsign &&callsign)
+	{
+		reorder.push(index, std::move(callsign));
+	}, [&reorder](size_t index)
+	{
+		reorder.skip(index);
+	});
+
+	reorder.finish();
+	m_streaming = false;
+
+	{
+		net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::RENDER);
+
+		renderer->End();
+	}
 
 	updateConfigFromClientState();
 }
@@ -170,7 +436,11 @@ void AppController::fetchAndRenderDXCC(const std::set<std::string> &searchTerms,
 
 	std::unique_ptr<render::Renderer<DXCC>> renderer = render::RendererFactory::createDXCCRenderer(format);
 
-	renderer->Render(dxccRecords);
+	{
+		net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::RENDER);
+
+		renderer->Render(dxccRecords);
+	}
 
 	updateConfigFromClientState();
 }
@@ -178,268 +448,1480 @@ void AppController::fetchAndRenderDXCC(const std::set<std::string> &searchTerms,
 /**
  * @brief Fetches and renders bios based on the given search terms.
  *
- * This function fetches the specified callsign records and renders them.
+ * This function fetches the specified bios and renders them.
  *
- * Unlike callsigns and DXCC records, bio HTML content is rendered directly as it is received from the QRZ API.
+ * Unlike DXCC records, bio HTML content is rendered directly as it is received from the QRZ API, so each bio is
+ * written out as soon as it and every bio before it have arrived, rather than once the batch is complete. With
+ * --unordered, each bio is written as soon as it arrives.
  *
  * @param searchTerms The set of search terms used to fetch the bio content.
  */
 void AppController::fetchAndRenderBios(const std::set<std::string> &searchTerms)
 {
-	std::unique_ptr<render::Renderer<std::string>> renderer = render::RendererFactory::createBioRenderer();
+	std::unique_ptr<render::BioRenderer> renderer = render::RendererFactory::createBioRenderer();
+
+	m_streaming = true;
+
+	// Bios arrive on the fetch workers, and the buffer writes them one at a time
+	ReorderBuffer<std::string> reorder(m_reorderWindow, [this, &renderer](std::string &&bio)
+	{
+		net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::RENDER);
+
+		renderer->Render(bio);
+	}, !m_unordered);
+
+	fetchBios(std::vector<std::string>(searchTerms.begin(), searchTerms.end()),
+			  [&reorder](size_t index, const std::string &bio)
+	{
+		reorder.push(index, std::string(bio));
+	}, [&reorder](size_t index)
+	{
+		reorder.skip(index);
+	});
+
+	reorder.finish();
+	m_streaming = false;
+
+	updateConfigFromClientState();
+}
+
+/**
+ * @brief Fetches the callsign records based on the given search terms.
+ *
+ * This function fetches the callsign records based on the provided search terms through lookupCallsigns(), so fresh
+ * results are served from the lookup cache and the rest are fetched from the QRZ API concurrently.
+ *
+ * @param searchTerms The set of search terms used to fetch the callsign records.
+ * @return A vector of Callsign objects representing the fetched callsign records, in search term order.
+ *
+ * @note This function assumes that the necessary APIs and client objects are properly initialized before calling this function.
+ * @note This function prints any errors encountered during the API calls to the standard error stream.
+ */
+std::vector<Callsign> AppController::fetchCallsignRecords(const std::set<std::string> &searchTerms)
+{
+	const std::vector<std::string> terms(searchTerms.begin(), searchTerms.end());
+
+	// One slot per term, so workers never write to the same element
+	std::vector<std::optional<Callsign>> results(terms.size());
+
+	lookupCallsigns(terms, [&results](size_t index, Callsign &&callsign)
+	{
+		results[index] = std::move(callsign);
+	});
+
+	std::vector<Callsign> callsigns;
+	for (std::optional<Callsign> &result : results)
+	{
+		if (result)
+		{
+			callsigns.push_back(std::move(*result));
+		}
+	}
+
+	return callsigns;
+}
+
+/**
+ * @brief Looks up callsigns, from the lookup cache where possible and otherwise from the QRZ API.
+ *
+ * Fresh cached records are used as they are. Stale ones are used too, and are fetched again in the same batch to
+ * refresh the cache, after the callsigns that were not cached. Calls cached as "not found" are reported as missing
+ * without a request. The other callsigns are fetched concurrently by fetchConcurrently(), which handles
+ * authentication errors by refreshing the token and retrying, and displays a progress bar. Fetched records, and
+ * "not found" answers, are added to the cache, which is written to disk once the batch ends. Any errors are printed
+ * once all calls have been made.
+ *
+ * @param terms The callsigns to look up.
+ * @param onResult Called with the index of the term and its record, for every callsign found. It is called
+ * concurrently from several threads, so it must only touch state owned by that index.
+ * @param onMissing Called with the index of every term that has no record, as soon as its lookup has failed.
+ */
+void AppController::lookupCallsigns(const std::vector<std::string> &terms,
+									const std::function<void(size_t, Callsign &&)> &onResult,
+									const std::function<void(size_t)> &onMissing)
+{
+	cache::LookupCache *cache = getCache();
+
+	// Terms the cache could not answer, then the stale terms to refresh, and their indices in terms
+	std::vector<std::string> remoteTerms;
+	std::vector<size_t> remoteIndices;
+	std::vector<std::string> staleTerms;
+	std::vector<size_t> staleIndices;
+
+	// Calls the cache knows QRZ has no record of
+	std::vector<std::string> cachedNotFound;
+
+	for (size_t i = 0; i < terms.size(); ++i)
+	{
+		if (!cache)
+		{
+			remoteTerms.push_back(terms[i]);
+			remoteIndices.push_back(i);
+			continue;
+		}
+
+		net::TraceRecorder::setThreadTag(terms[i]);
+		net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::CACHE);
+
+		std::optional<cache::LookupCache::Hit> hit = cache->lookup(cache::RecordType::CALLSIGN, terms[i]);
+		std::optional<Callsign> cached = hit ? getCachedCallsign(hit->entry) : std::nullopt;
+
+		timer.stop();
+
+		if (hit && hit->entry.isNotFound())
+		{
+			countCacheEvent(cache::RecordType::CALLSIGN, cache::LookupCache::Event::NOT_FOUND_HIT);
+			cachedNotFound.push_back(terms[i]);
+
+			if (onMissing)
+			{
+				onMissing(i);
+			}
+		}
+		else if (cached && hit->freshness == cache::Freshness::STALE)
+		{
+			countCacheEvent(cache::RecordType::CALLSIGN, cache::LookupCache::Event::STALE_HIT);
+			staleTerms.push_back(terms[i]);
+			staleIndices.push_back(i);
+
+			onResult(i, std::move(*cached));
+		}
+		else if (cached)
+		{
+			countCacheEvent(cache::RecordType::CALLSIGN, cache::LookupCache::Event::HIT);
+
+			onResult(i, std::move(*cached));
+		}
+		else
+		{
+			countCacheEvent(cache::RecordType::CALLSIGN, cache::LookupCache::Event::MISS);
+			remoteTerms.push_back(terms[i]);
+			remoteIndices.push_back(i);
+		}
+	}
+
+	net::TraceRecorder::setThreadTag("");
+
+	// Terms from here on are refreshes of records that have already been served
+	const size_t missCount = remoteTerms.size();
+
+	remoteTerms.insert(remoteTerms.end(), staleTerms.begin(), staleTerms.end());
+	remoteIndices.insert(remoteIndices.end(), staleIndices.begin(), staleIndices.end());
+
+	auto fetchOne = [this, cache, missCount, &remoteIndices, &onResult](size_t index, const std::string &call)
+	{
+		if (index >= missCount)
+		{
+			revalidate(cache::RecordType::CALLSIGN, call, [this, &call]()
+			{
+				return CallsignMarshaler::ToXML({client.fetchCallsign(call)});
+			});
+
+			return;
+		}
+
+		Callsign callsign;
+
+		try
+		{
+			callsign = client.fetchCallsign(call);
+		}
+		catch (NotFoundException &)
+		{
+			if (cache)
+			{
+				cache->putNotFound(cache::RecordType::CALLSIGN, call);
+			}
+
+			throw;
+		}
+
+		if (cache)
+		{
+			net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::CACHE);
+
+			cache->put(cache::RecordType::CALLSIGN, call, CallsignMarshaler::ToXML({callsign}));
+		}
+
+		onResult(remoteIndices[index], std::move(callsign));
+	};
+
+	std::function<void(size_t)> onFailed;
+
+	if (onMissing)
+	{
+		onFailed = [missCount, &remoteIndices, &onMissing](size_t index)
+		{
+			if (index < missCount)
+			{
+				onMissing(remoteIndices[index]);
+			}
+		};
+	}
+
+	std::vector<std::string> errors = fetchConcurrently(remoteTerms, fetchOne, true, onFailed);
+
+	// Print the errors, if any
+	for (const std::string &call : cachedNotFound)
+	{
+		std::cerr << "Not found: " << call << " (cached)" << std::endl;
+	}
+
+	for(const std::string& error : errors)
+	{
+		std::cerr << error << std::endl;
+	}
+
+	if (cache)
+	{
+		net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::CACHE);
+
+		try
+		{
+			cache->flush();
+		}
+		catch (std::exception &e)
+		{
+			std::cerr << e.what() << std::endl;
+		}
+	}
+}
+
+/**
+ * @brief Reads a callsign record from a lookup cache entry.
+ *
+ * @param entry The cache entry.
+ * @return The record, or std::nullopt if the entry records a "not found" answer or cannot be read.
+ */
+std::optional<Callsign> AppController::getCachedCallsign(const cache::LookupCache::Entry &entry)
+{
+	if (entry.isNotFound())
+	{
+		return std::nullopt;
+	}
 
-	std::vector<std::string> bios = fetchBios(searchTerms);
+	try
+	{
+		return CallsignMarshaler::FromXml(entry.value);
+	}
+	catch (std::exception &)
+	{
+		// An unreadable entry is fetched again, and replaced
+		return std::nullopt;
+	}
+}
+
+/**
+ * @brief Enriches an ADIF log with the QRZ details of each contacted station.
+ *
+ * The log is streamed twice, so only one QSO is in memory at a time. The first pass collects the distinct
+ * callsigns, which are then looked up once each through lookupCallsigns(), keeping just the ADIF fields for each.
+ * The second pass writes every record with the fields it already has unchanged, adding the looked up fields it is
+ * missing, such as NAME, QTH, GRIDSQUARE, CQZ and ITUZ. Memory use therefore grows with the number of distinct
+ * callsigns, not with the number of QSOs.
+ *
+ * A QSO with a station operating away from home, such as KH6/W1AW or W1AW/KH6, only gets the operator fields of the
+ * home record, NAME and EMAIL, since its location is not the home station's. Its DXCC, COUNTRY, CQZ and ITUZ come
+ * from the prefix table when one is loaded, and are left out otherwise.
+ *
+ * @param inputPath The ADIF log to enrich.
+ * @param outputPath The file to write the enriched log to, or empty for standard output.
+ */
+void AppController::enrichAdif(const std::string &inputPath, const std::string &outputPath)
+{
+	std::ifstream input(inputPath, std::ios::binary);
+
+	if (!input)
+	{
+		std::cerr << "Unable to open ADIF log " << inputPath << std::endl;
+		return;
+	}
+
+	std::error_code ec;
+
+	if (!outputPath.empty() && std::filesystem::equivalent(inputPath, outputPath, ec))
+	{
+		std::cerr << "The enriched log cannot replace the log being read" << std::endl;
+		return;
+	}
+
+	try
+	{
+		adif::Record record;
+
+		// First pass: the distinct callsigns, sorted so the second pass can find them by binary search
+		std::set<std::string> calls;
+		{
+			adif::AdifReader reader(input);
+
+			while (reader.next(record))
+			{
+				if (std::optional<ParsedCallsign> call = parseCall(record))
+				{
+					calls.insert(std::move(call->base));
+				}
+			}
+		}
+
+		const std::vector<std::string> terms(calls.begin(), calls.end());
+		calls.clear();
+
+		std::vector<std::vector<adif::Field>> stationFields(terms.size());
+
+		lookupCallsigns(terms, [&stationFields](size_t index, Callsign &&callsign)
+		{
+			stationFields[index] = adif::AdifWriter::callsignFields(callsign);
+		});
+
+		// Second pass: write every record, adding the fields it is missing
+		input.clear();
+		input.seekg(0);
+
+		std::ofstream file;
+
+		if (!outputPath.empty())
+		{
+			file.open(outputPath, std::ios::binary | std::ios::trunc);
+
+			if (!file)
+			{
+				std::cerr << "Unable to write ADIF log " << outputPath << std::endl;
+				return;
+			}
+		}
+
+		std::ostream &output = outputPath.empty() ? std::cout : file;
+
+		net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::RENDER);
+
+		adif::AdifReader reader(input);
+		adif::AdifWriter writer(output);
+
+		writer.writeHeader(reader.header());
+
+		size_t recordCount = 0;
+		size_t enrichedCount = 0;
+
+		while (reader.next(record))
+		{
+			recordCount++;
+
+			std::optional<ParsedCallsign> call = parseCall(record);
+			auto it = call ? std::lower_bound(terms.begin(), terms.end(), call->base) : terms.end();
+
+			if (it != terms.end() && *it == call->base && !stationFields[it - terms.begin()].empty())
+			{
+				// Away from home, as KH6/W1AW or W1AW/KH6, only the operator is the home record's
+				bool away = !call->locationPart().empty();
+				size_t fieldCount = record.fields.size();
+
+				auto addMissing = [&record](const adif::Field &field)
+				{
+					if (!record.find(field.name))
+					{
+						record.fields.push_back(field);
+					}
+				};
+
+				for (const adif::Field &field : stationFields[it - terms.begin()])
+				{
+					bool isOperatorField = std::find(operatorFields.begin(), operatorFields.end(), field.name)
+										   != operatorFields.end();
+
+					if (!away || isOperatorField)
+					{
+						addMissing(field);
+					}
+				}
+
+				if (away)
+				{
+					for (const adif::Field &field : awayFields(getPrefixResolver(), call->toString()))
+					{
+						addMissing(field);
+					}
+				}
+
+				enrichedCount += record.fields.size() > fieldCount ? 1 : 0;
+			}
+
+			writer.writeRecord(record);
+		}
+
+		output.flush();
+
+		std::cerr << "Enriched " << enrichedCount << " of " << recordCount << " QSOs" << std::endl;
+	}
+	catch (std::exception &e)
+	{
+		std::cerr << e.what() << std::endl;
+	}
+
+	updateConfigFromClientState();
+}
+
+/**
+ * @brief Looks up the DXCC entity of each callsign.
+ *
+ * Each distinct entity number is looked up once for the whole batch through fetchDXCCRecords(), so the local DXCC and
+ * prefix tables answer what they can and at most one request per entity goes to the QRZ API. A batch of any size
+ * therefore costs no more requests than there are DXCC entities.
+ *
+ * @param callsigns The callsign records.
+ * @return The DXCC entities of the callsigns, keyed by entity number.
+ */
+render::DXCCJoin AppController::joinDXCC(const std::vector<Callsign> &callsigns)
+{
+	std::set<std::string> entities;
+
+	for (const Callsign &callsign : callsigns)
+	{
+		if (!callsign.getDxcc().empty())
+		{
+			entities.insert(callsign.getDxcc());
+		}
+	}
+
+	render::DXCCJoin join;
+
+	for (const DXCC &record : fetchDXCCRecords(entities))
+	{
+		join.add(record);
+	}
+
+	return join;
+}
+
+/**
+ * @brief Fetches DXCC records based on the given search terms.
+ *
+ * Terms are answered locally first. Entity numbers are looked up in the local DXCC table, if it has been mirrored,
+ * and then in the prefix table when it carries them; callsigns are resolved by prefix. Then the lookup cache is
+ * consulted, as for callsigns: stale entities are used and refreshed, and cached "not found" answers are reported
+ * without a request. The remaining terms are fetched from the QRZ API concurrently, unless running offline, in which
+ * case they are reported as not found. If an authentication error occurs, the call is retried after refreshing the
+ * authentication token. Any errors that occur during the fetch process are printed once all calls have been made.
+ *
+ * @param searchTerms The set of search terms used to fetch the DXCC records.
+ * @return A vector of DXCC objects representing the fetched DXCC records, in search term order.
+ */
+std::vector<DXCC> AppController::fetchDXCCRecords(const std::set<std::string> &searchTerms)
+{
+	const std::vector<std::string> terms(searchTerms.begin(), searchTerms.end());
+
+	std::vector<std::optional<DXCC>> results(terms.size());
+
+	// Terms the local tables and the lookup cache could not answer, then the stale terms to refresh, and their
+	// indices in terms
+	std::vector<std::string> remoteTerms;
+	std::vector<size_t> remoteIndices;
+	std::vector<std::string> staleTerms;
+	std::vector<size_t> staleIndices;
+
+	const dxcc::PrefixResolver *resolver = getPrefixResolver();
+
+	bool anyNumeric = false;
+	std::vector<bool> numeric(terms.size());
+
+	for (size_t i = 0; i < terms.size(); ++i)
+	{
+		numeric[i] = std::all_of(terms[i].begin(), terms[i].end(), [](char c) { return c >= '0' && c <= '9'; });
+		anyNumeric = anyNumeric || numeric[i];
+	}
+
+	// Only load the DXCC table when it can answer something, since loading it may refresh it
+	const dxcc::DXCCTable *table = anyNumeric ? getDXCCTable() : nullptr;
+
+	cache::LookupCache *cache = getCache();
+
+	// Terms the cache knows QRZ has no entity for
+	std::vector<std::string> cachedNotFound;
+
+	for (size_t i = 0; i < terms.size(); ++i)
+	{
+		const std::string &term = terms[i];
+
+		if (numeric[i] && table)
+		{
+			if (const DXCC *record = table->find(term))
+			{
+				results[i] = *record;
+			}
+		}
+
+		if (!results[i] && resolver)
+		{
+			results[i] = numeric[i] ? resolver->findEntity(term) : resolver->resolve(term);
+		}
+
+		if (!results[i] && cache)
+		{
+			net::TraceRecorder::setThreadTag(term);
+			net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::CACHE);
+
+			std::optional<cache::LookupCache::Hit> hit = cache->lookup(cache::RecordType::DXCC, term);
+
+			if (hit && !hit->entry.isNotFound())
+			{
+				try
+				{
+					results[i] = DXCCMarshaler::FromXml(hit->entry.value);
+				}
+				catch (std::exception &)
+				{
+					// An unreadable entry is fetched again, and replaced
+				}
+			}
+
+			timer.stop();
+
+			if (hit && hit->entry.isNotFound())
+			{
+				countCacheEvent(cache::RecordType::DXCC, cache::LookupCache::Event::NOT_FOUND_HIT);
+				cachedNotFound.push_back(term);
+				continue;
+			}
+
+			if (results[i] && hit->freshness == cache::Freshness::STALE)
+			{
+				countCacheEvent(cache::RecordType::DXCC, cache::LookupCache::Event::STALE_HIT);
+				staleTerms.push_back(term);
+				staleIndices.push_back(i);
+			}
+			else
+			{
+				countCacheEvent(cache::RecordType::DXCC, results[i] ? cache::LookupCache::Event::HIT
+																	: cache::LookupCache::Event::MISS);
+			}
+		}
+
+		if (!results[i])
+		{
+			remoteTerms.push_back(term);
+			remoteIndices.push_back(i);
+		}
+	}
+
+	net::TraceRecorder::setThreadTag("");
+
+	std::vector<std::string> errors;
+
+	for (const std::string &term : cachedNotFound)
+	{
+		errors.push_back(std::format("Not found: {:s} (cached)", term));
+	}
+
+	if (m_offline)
+	{
+		if (!resolver && !remoteTerms.empty())
+		{
+			errors.push_back(std::format("No prefix table available at {:s}", m_prefixTablePath));
+		}
+
+		for (const std::string &term : remoteTerms)
+		{
+			errors.push_back(std::format("Not found in local DXCC data: {:s}", term));
+		}
+	}
+	else
+	{
+		// Terms from here on are refreshes of entities that have already been answered from the cache
+		const size_t missCount = remoteTerms.size();
+
+		remoteTerms.insert(remoteTerms.end(), staleTerms.begin(), staleTerms.end());
+		remoteIndices.insert(remoteIndices.end(), staleIndices.begin(), staleIndices.end());
+
+		auto fetchOne = [this, cache, missCount, &results, &remoteIndices](size_t index, const std::string &term)
+		{
+			if (index >= missCount)
+			{
+				revalidate(cache::RecordType::DXCC, term, [this, &term]()
+				{
+					return DXCCMarshaler::ToXML({client.fetchDXCC(term)});
+				});
+
+				return;
+			}
+
+			try
+			{
+				results[remoteIndices[index]] = client.fetchDXCC(term);
+			}
+			catch (NotFoundException &)
+			{
+				if (cache)
+				{
+					cache->putNotFound(cache::RecordType::DXCC, term);
+				}
+
+				throw;
+			}
+
+			if (cache)
+			{
+				net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::CACHE);
+
+				cache->put(cache::RecordType::DXCC, term, DXCCMarshaler::ToXML({*results[remoteIndices[index]]}));
+			}
+		};
+
+		std::vector<std::string> fetchErrors = fetchConcurrently(remoteTerms, fetchOne, true);
+
+		errors.insert(errors.end(), fetchErrors.begin(), fetchErrors.end());
+	}
+
+	for(const std::string& error : errors)
+	{
+		std::cerr << error << std::endl;
+	}
+
+	if (cache)
+	{
+		net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::CACHE);
+
+		try
+		{
+			cache->flush();
+		}
+		catch (std::exception &e)
+		{
+			std::cerr << e.what() << std::endl;
+		}
+	}
+
+	std::vector<DXCC> dxccs;
+	for (std::optional<DXCC> &result : results)
+	{
+		if (result)
+		{
+			dxccs.push_back(std::move(*result));
+		}
+	}
+
+	return dxccs;
+}
+
+/**
+ * @brief Returns the prefix table, loading it on first use.
+ *
+ * A missing prefix table is not an error, since DXCC lookups then go to the QRZ API. A table that exists but cannot
+ * be loaded is reported once, and not retried.
+ *
+ * @return The prefix resolver, or nullptr if there is no prefix table or it could not be loaded.
+ */
+const dxcc::PrefixResolver *AppController::getPrefixResolver()
+{
+	if (!m_prefixResolver && !m_prefixTablePath.empty() && std::filesystem::exists(m_prefixTablePath))
+	{
+		try
+		{
+			m_prefixResolver = dxcc::PrefixResolver::load(m_prefixTablePath);
+		}
+		catch (std::exception &e)
+		{
+			std::cerr << e.what() << std::endl;
+			m_prefixTablePath.clear();
+		}
+	}
+
+	return m_prefixResolver ? &*m_prefixResolver : nullptr;
+}
+
+/**
+ * @brief Returns the local DXCC table, loading it on first use and refreshing it when it is stale.
+ *
+ * The table only exists once `-a mirror` has been run. Once it is older than m_dxccTableMaxAge it is refreshed with a
+ * single bulk request, unless running offline. If the refresh fails, the stale table is still used, since entity data
+ * so rarely changes.
+ *
+ * @return The DXCC table, or nullptr if it has not been mirrored yet or could not be loaded.
+ */
+const dxcc::DXCCTable *AppController::getDXCCTable()
+{
+	if (!m_dxccTableLoaded && !m_dxccTablePath.empty() && std::filesystem::exists(m_dxccTablePath))
+	{
+		m_dxccTableLoaded = true;
+
+		try
+		{
+			m_dxccTable = dxcc::DXCCTable::load(m_dxccTablePath);
+		}
+		catch (std::exception &e)
+		{
+			std::cerr << e.what() << std::endl;
+		}
+
+		if (m_dxccTable && m_dxccTable->isStale(m_dxccTableMaxAge) && !m_offline && !refreshDXCCTable())
+		{
+			std::cerr << "Using the stale DXCC table at " << m_dxccTablePath << std::endl;
+		}
+	}
+
+	return m_dxccTable ? &*m_dxccTable : nullptr;
+}
+
+/**
+ * @brief Returns the lookup cache, opening it on first use.
+ *
+ * A cache file that cannot be read is reported once, and the run continues without a cache.
+ *
+ * @return The lookup cache, or nullptr if caching is disabled or the cache could not be opened.
+ */
+cache::LookupCache *AppController::getCache()
+{
+	if (!m_cache && !m_cachePath.empty())
+	{
+		try
+		{
+			m_cache.emplace(m_cachePath);
+			m_cache->setPolicies(m_cachePolicies);
+		}
+		catch (std::exception &e)
+		{
+			std::cerr << e.what() << std::endl;
+			m_cachePath.clear();
+		}
+	}
+
+	return m_cache ? &*m_cache : nullptr;
+}
+
+/**
+ * @brief Fetches the complete DXCC entity list in a single request and stores it as the local DXCC table.
+ *
+ * The request goes through fetchConcurrently(), so it is authenticated, retried and bounded like any other lookup.
+ *
+ * @return True if the table was refreshed, false if the fetch failed.
+ */
+bool AppController::refreshDXCCTable()
+{
+	std::vector<DXCC> records;
+
+	std::vector<std::string> errors = fetchConcurrently({"all"}, [this, &records](size_t, const std::string &)
+	{
+		records = client.fetchAllDXCC();
+	}, false);
+
+	for (const std::string &error : errors)
+	{
+		std::cerr << error << std::endl;
+	}
+
+	if (!errors.empty() || records.empty())
+	{
+		return false;
+	}
+
+	dxcc::DXCCTable table(std::move(records), dxcc::DXCCTable::Clock::now());
+
+	try
+	{
+		table.save(m_dxccTablePath);
+	}
+	catch (std::exception &e)
+	{
+		// The table can still serve this run
+		std::cerr << e.what() << std::endl;
+	}
+
+	m_dxccTable = std::move(table);
+	m_dxccTableLoaded = true;
+
+	return true;
+}
+
+/**
+ * @brief Mirrors the QRZ DXCC entity list into the local DXCC table.
+ *
+ * After this, DXCC lookups by entity number are answered from the table without any request, until it is older than
+ * m_dxccTableMaxAge.
+ */
+void AppController::mirrorDXCC()
+{
+	if (refreshDXCCTable())
+	{
+		std::cout << "Mirrored " << m_dxccTable->size() << " DXCC entities to " << m_dxccTablePath << std::endl;
+	}
+
+	updateConfigFromClientState();
+}
+
+/**
+ * @brief Fetches bios, from the lookup cache where possible and otherwise from the QRZ API.
+ *
+ * With the cache enabled, the callsign records are looked up first through lookupCallsigns(), for the date each bio
+ * was last changed. A cached bio stored with the same biodate is used as it is, so unchanged bios are never
+ * downloaded twice; the others are fetched concurrently by fetchConcurrently() and stored with their biodate. A
+ * cached bio that is stale is used too, and fetched again after the others to refresh the cache. Calls whose
+ * callsign lookup failed are skipped, as the error has already been reported. Without the cache every bio is fetched.
+ *
+ * @param terms The callsigns whose bios to fetch.
+ * @param onBio Called with the index of the term and its bio HTML as soon as the bio is available. It is called
+ * concurrently from several threads.
+ * @param onMissing Called with the index of every term that has no bio, as soon as its lookup has failed.
+ *
+ * @note This function assumes that the necessary APIs and client objects are properly initialized before calling this function.
+ */
+void AppController::fetchBios(const std::vector<std::string> &terms,
+							  const std::function<void(size_t, const std::string &)> &onBio,
+							  const std::function<void(size_t)> &onMissing)
+{
+	cache::LookupCache *cache = getCache();
+
+	// Without the cache there is no use for the biodates, so every call is taken to have a bio of unknown date
+	std::vector<std::optional<std::string>> biodates = cache ? lookupBiodates(terms)
+															 : std::vector<std::optional<std::string>>(terms.size(), "");
+
+	// Terms the cache could not answer, then the stale terms to refresh, and their indices in terms
+	std::vector<std::string> remoteTerms;
+	std::vector<size_t> remoteIndices;
+	std::vector<std::string> staleTerms;
+	std::vector<size_t> staleIndices;
+
+	for (size_t i = 0; i < terms.size(); ++i)
+	{
+		if (!biodates[i])
+		{
+			if (onMissing)
+			{
+				onMissing(i);
+			}
+
+			continue;
+		}
+
+		net::TraceRecorder::setThreadTag(terms[i]);
+		net::PhaseStats::Timer timer(cache ? m_phaseStats.get() : nullptr, net::Phase::CACHE);
+
+		std::optional<cache::LookupCache::Hit> hit;
+		std::optional<std::string> cached;
+
+		if (cache && !biodates[i]->empty())
+		{
+			hit = cache->lookup(cache::RecordType::BIO, terms[i]);
+			cached = hit ? getCachedBio(hit->entry, *biodates[i]) : std::nullopt;
+		}
+
+		timer.stop();
+
+		if (cached && hit->freshness == cache::Freshness::STALE)
+		{
+			countCacheEvent(cache::RecordType::BIO, cache::LookupCache::Event::STALE_HIT);
+			staleTerms.push_back(terms[i]);
+			staleIndices.push_back(i);
+
+			onBio(i, *cached);
+		}
+		else if (cached)
+		{
+			countCacheEvent(cache::RecordType::BIO, cache::LookupCache::Event::HIT);
+
+			onBio(i, *cached);
+		}
+		else
+		{
+			if (cache)
+			{
+				countCacheEvent(cache::RecordType::BIO, cache::LookupCache::Event::MISS);
+			}
+
+			remoteTerms.push_back(terms[i]);
+			remoteIndices.push_back(i);
+		}
+	}
+
+	net::TraceRecorder::setThreadTag("");
+
+	// Terms from here on are refreshes of bios that have already been served
+	const size_t missCount = remoteTerms.size();
+
+	remoteTerms.insert(remoteTerms.end(), staleTerms.begin(), staleTerms.end());
+	remoteIndices.insert(remoteIndices.end(), staleIndices.begin(), staleIndices.end());
+
+	auto fetchOne = [this, cache, missCount, &biodates, &remoteIndices, &onBio](size_t index, const std::string &call)
+	{
+		const std::string &biodate = *biodates[remoteIndices[index]];
+
+		if (index >= missCount)
+		{
+			revalidate(cache::RecordType::BIO, call, [this, &call, &biodate]()
+			{
+				return biodate + '\n' + client.fetchBio(call);
+			});
+
+			return;
+		}
+
+		std::string bio = client.fetchBio(call);
+
+		// Without a biodate there is no way to tell when the bio changes, so it is not cached
+		if (cache && !biodate.empty())
+		{
+			net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::CACHE);
+
+			cache->put(cache::RecordType::BIO, call, biodate + '\n' + bio);
+		}
+
+		onBio(remoteIndices[index], bio);
+	};
+
+	std::function<void(size_t)> onFailed;
+
+	if (onMissing)
+	{
+		onFailed = [missCount, &remoteIndices, &onMissing](size_t index)
+		{
+			if (index < missCount)
+			{
+				onMissing(remoteIndices[index]);
+			}
+		};
+	}
+
+	std::vector<std::string> errors = fetchConcurrently(remoteTerms, fetchOne, true, onFailed);
+
+	for(const std::string& error : errors)
+	{
+		std::cerr << error << std::endl;
+	}
 
-	renderer->Render(bios);
+	if (cache)
+	{
+		net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::CACHE);
 
-	updateConfigFromClientState();
+		try
+		{
+			cache->flush();
+		}
+		catch (std::exception &e)
+		{
+			std::cerr << e.what() << std::endl;
+		}
+	}
 }
 
 /**
- * @brief Fetches the callsign records based on the given search terms.
+ * @brief Writes bios to a directory, one CALL.html file per callsign.
  *
- * This function fetches the callsign records based on the provided search terms.
- * It makes API calls to retrieve the callsigns and stores them in a vector.
- * It handles authentication errors and retries the API call after refreshing the token.
- * It also displays a progress bar to show the progress of fetching the callsigns.
+ * The callsign records are looked up first, through the lookup cache, for the date each bio was last changed. Bios
+ * the archive already holds for that biodate are skipped, and bios in the lookup cache are written from there. The
+ * rest are fetched concurrently by fetchConcurrently() and streamed from the socket straight into their files, so a
+ * bio is never held in memory. The archive index is saved once the batch ends.
  *
- * @param searchTerms The set of search terms used to fetch the callsign records.
- * @return A vector of Callsign objects representing the fetched callsign records.
- *
- * @note This function assumes that the necessary APIs and client objects are properly initialized before calling this function.
- * @note This function prints any errors encountered during the API calls to the standard error stream.
- * @note This function sets the progress bar option and progress values to reflect the progress of fetching the callsigns.
+ * @param terms The callsigns whose bios to write.
+ * @param outputDir The directory to write the bios to. It is created if it does not exist.
  */
-std::vector<Callsign> AppController::fetchCallsignRecords(const std::set<std::string> &searchTerms)
+void AppController::exportBios(const std::vector<std::string> &terms, const std::string &outputDir)
 {
-	// Buffer for the output
-	std::vector<Callsign> callsigns;
+	std::optional<BioArchive> archive;
 
-	// Error buffer, we will display the errors after all API calls have been made and progress bar is removed
-	std::vector<std::string> errors;
+	try
+	{
+		archive.emplace(outputDir);
+	}
+	catch (std::exception &e)
+	{
+		std::cerr << e.what() << std::endl;
+		return;
+	}
 
-	// Display our progress bar
-	auto bar = buildProgressBar();
+	std::vector<std::optional<std::string>> biodates = lookupBiodates(terms);
 
-	// Progress bar value
-	auto progress = 0.0f;
+	cache::LookupCache *cache = getCache();
 
-	// Amount to advance the progress bar after each call
-	float tickSize = 100/searchTerms.size();
+	// Terms whose bios have to be downloaded, and their biodates
+	std::vector<std::string> remoteTerms;
+	std::vector<std::string> remoteBiodates;
 
-	// Use an iterator so we cen reset the current element in the event of authentication error
-	auto it = searchTerms.begin();
-	while (it != searchTerms.end())
-	{
-		const std::string &call = *it;
+	std::atomic<size_t> written = 0;
+	size_t unchanged = 0;
 
-		try
+	for (size_t i = 0; i < terms.size(); ++i)
+	{
+		if (!biodates[i])
 		{
-			// Hide the cursor - we do this on every iteration in case we hit an authentication error previously
-			showConsoleCursor(false);
-
-			// Update progress bar
-			bar->setOption(indicators::option::PostfixText{std::format("Fetching {:s}", call)});
-			bar->setProgress(progress);
-
-			progress += tickSize;
-
-			// Fetch the callsign and add it to the output buffer
-			Callsign callsign = client.fetchCallsign(call);
+			continue;
+		}
 
-			callsigns.push_back(callsign);
+		if (archive->isCurrent(terms[i], *biodates[i]))
+		{
+			unchanged++;
+			continue;
+		}
 
-			// Reset the fail counter
-			resetFailedCallCount();
+		std::optional<std::string> cached;
 
-			it++;
-		}
-		catch (AuthenticationException &e)
+		// The bio is downloaded anyway if it is stale, since it is streamed straight to its file
+		if (cache && !biodates[i]->empty())
 		{
-			// If we have not exceeded the max fail count, try to authenticate
-			if (m_failedCallCount < m_maxFailedCallCount)
+			std::optional<cache::LookupCache::Hit> hit = cache->lookup(cache::RecordType::BIO, terms[i]);
+
+			if (hit && hit->freshness == cache::Freshness::FRESH)
 			{
-				// Hide the progress bar and give the cursor back
-				eraseLine();
-				showConsoleCursor(true);
+				cached = getCachedBio(hit->entry, *biodates[i]);
+			}
+		}
 
-				// Ask the user for their password, and refresh the bearer token
-				refreshToken();
+		if (!cached)
+		{
+			remoteTerms.push_back(terms[i]);
+			remoteBiodates.push_back(*biodates[i]);
+			continue;
+		}
 
-				// Increment the error counter so we don't do this forever
-				m_failedCallCount++;
-			}
-			else
+		try
+		{
+			archive->write(terms[i], *biodates[i], [&cached](std::ostream &output)
 			{
-				// Save the error for display after we have mde all of our API calls
-				errors.push_back(std::format("QRZ API Error: {:s}", e.what()));
+				output << *cached;
+			});
 
-				it++;
-			}
+			written++;
 		}
 		catch (std::exception &e)
 		{
-			// Save the error for display after we have mde all of our API calls
-			errors.emplace_back(e.what());
-
-			it++;
+			std::cerr << e.what() << std::endl;
 		}
 	}
 
-	// Finalize and tear down the progress bar
-	bar->setOption(indicators::option::PostfixText{""});
-	bar->setProgress(100);
-	eraseLine();
-	showConsoleCursor(true);
+	auto fetchOne = [this, &archive, &remoteBiodates, &written](size_t index, const std::string &call)
+	{
+		archive->write(call, remoteBiodates[index], [this, &call](std::ostream &output)
+		{
+			client.fetchBio(call, output);
+		});
+
+		written++;
+	};
+
+	std::vector<std::string> errors = fetchConcurrently(remoteTerms, fetchOne, true);
 
-	// Print the errors, if any
 	for(const std::string& error : errors)
 	{
 		std::cerr << error << std::endl;
 	}
 
-	return callsigns;
+	try
+	{
+		archive->save();
+	}
+	catch (std::exception &e)
+	{
+		std::cerr << e.what() << std::endl;
+	}
+
+	std::cout << "Wrote " << written << " bios to " << outputDir << ", " << unchanged << " unchanged" << std::endl;
 }
 
 /**
- * @brief Fetches DXCC records based on the given search terms.
+ * @brief Looks up the date each callsign's bio was last changed.
  *
- * This function fetches DXCC records based on the provided search terms. It uses the QRZ API client to fetch the records
- * for each term in the searchTerms set. If an authentication error occurs, it retries the call after refreshing the
- * authentication token. Any errors that occur during the fetch process are stored in the errors vector.
+ * The callsign records are looked up through lookupCallsigns(), so they come from the lookup cache where possible.
  *
- * @param searchTerms The set of search terms used to fetch the DXCC records.
- * @return A vector of DXCC objects representing the fetched DXCC records.
+ * @param terms The callsigns.
+ * @return The biodate of each term, empty if the call has no biodate, or std::nullopt if its callsign lookup
+ * failed. The errors have already been reported.
  */
-std::vector<DXCC> AppController::fetchDXCCRecords(const std::set<std::string> &searchTerms)
+std::vector<std::optional<std::string>> AppController::lookupBiodates(const std::vector<std::string> &terms)
 {
-	std::vector<DXCC> dxccs;
-	std::vector<std::string> errors;
+	std::vector<std::optional<std::string>> biodates(terms.size());
+
+	lookupCallsigns(terms, [&biodates](size_t index, Callsign &&callsign)
+	{
+		biodates[index] = callsign.getBiodate();
+	});
 
-	showConsoleCursor(false);
+	return biodates;
+}
 
-	auto bar = buildProgressBar();
+/**
+ * @brief Reads a bio from a lookup cache entry, if it was stored for the given biodate.
+ *
+ * Bios are cached as their biodate, a line break and the bio HTML.
+ *
+ * @param entry The cache entry.
+ * @param biodate The date the bio was last changed, from the callsign record.
+ * @return The bio HTML, or std::nullopt if the entry records a "not found" answer or the bio has changed since it
+ * was stored.
+ */
+std::optional<std::string> AppController::getCachedBio(const cache::LookupCache::Entry &entry,
+													   const std::string &biodate)
+{
+	if (entry.isNotFound() || !entry.value.starts_with(biodate + '\n'))
+	{
+		return std::nullopt;
+	}
 
-	auto progress = 0.0f;
+	return entry.value.substr(biodate.size() + 1);
+}
 
-	float tickSize = 100/searchTerms.size();
+/**
+ * @brief Counts a lookup cache event in the cache statistics, and in the metrics if they are enabled.
+ *
+ * Lookups are counted in qrz_cache_lookups_total, by result, and refreshes of stale entries in
+ * qrz_cache_revalidations_total.
+ *
+ * @param type The record type.
+ * @param event The event.
+ */
+void AppController::countCacheEvent(cache::RecordType type, cache::LookupCache::Event event)
+{
+	if (cache::LookupCache *cache = getCache())
+	{
+		cache->count(type, event);
+	}
 
-	// Use an iterator so we cen reset the current element in the event of authentication error
-	auto it = searchTerms.begin();
-	while (it != searchTerms.end())
+	if (!m_metrics)
 	{
-		const std::string &term = *it;
+		return;
+	}
 
-		try
-		{
-			bar->setOption(indicators::option::PostfixText{std::format("Fetching {:s}", term)});
-			bar->setProgress(progress);
+	const std::string typeName(cache::recordTypeName(type));
 
-			progress += tickSize;
+	auto countLookup = [this, &typeName](const std::string &result)
+	{
+		m_metrics->counter("qrz_cache_lookups_total", "Lookups answered from the lookup cache, or not",
+						   {{"type", typeName}, {"result", result}}).increment();
+	};
 
-			dxccs.push_back(client.fetchDXCC(term));
+	auto countRevalidation = [this, &typeName](const std::string &result)
+	{
+		m_metrics->counter("qrz_cache_revalidations_total", "Refreshes of stale lookup cache entries",
+						   {{"type", typeName}, {"result", result}}).increment();
+	};
 
-			resetFailedCallCount();
+	switch (event)
+	{
+		case cache::LookupCache::Event::HIT:
+			countLookup("hit");
+			break;
+		case cache::LookupCache::Event::STALE_HIT:
+			countLookup("stale");
+			break;
+		case cache::LookupCache::Event::NOT_FOUND_HIT:
+			countLookup("not_found");
+			break;
+		case cache::LookupCache::Event::MISS:
+			countLookup("miss");
+			break;
+		case cache::LookupCache::Event::REVALIDATED:
+			countRevalidation("ok");
+			break;
+		case cache::LookupCache::Event::REVALIDATION_FAILED:
+			countRevalidation("failed");
+			break;
+		case cache::LookupCache::Event::NOT_FOUND_STORED:
+		case cache::LookupCache::Event::EXPIRED:
+		case cache::LookupCache::Event::EVICTED:
+			break;
+	}
+}
 
-			it++;
-		}
-		catch (AuthenticationException &e)
-		{
-			if (m_failedCallCount < m_maxFailedCallCount)
-			{
-				refreshToken();
+/**
+ * @brief Waits for a background compaction of the lookup cache to finish, reports it if it failed, and adds its
+ * evictions to the metrics.
+ *
+ * Compactions start when a command flushes the cache, and run while the command writes its output. Entries dropped
+ * by compactions are counted in qrz_cache_evictions_total, by reason, and the compactions themselves in
+ * qrz_cache_compactions_total.
+ */
+void AppController::finishCacheCompaction()
+{
+	if (!m_cache)
+	{
+		return;
+	}
 
-				m_failedCallCount++;
-			}
-			else
-			{
-				errors.push_back(std::format("QRZ API Error: {:s}", e.what()));
-				it++;
-			}
+	{
+		net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::CACHE);
+
+		try
+		{
+			m_cache->finishCompaction();
 		}
 		catch (std::exception &e)
 		{
-			errors.emplace_back(e.what());
-			it++;
+			std::cerr << e.what() << std::endl;
 		}
 	}
 
-	bar->setOption(indicators::option::PostfixText{""});
-	bar->setProgress(100);
+	if (!m_metrics)
+	{
+		return;
+	}
+
+	for (cache::RecordType type : {cache::RecordType::CALLSIGN, cache::RecordType::DXCC, cache::RecordType::BIO})
+	{
+		cache::LookupCache::Stats stats = m_cache->getStats(type);
+		const std::string typeName(cache::recordTypeName(type));
+
+		m_metrics->counter("qrz_cache_evictions_total", "Lookup cache entries dropped by compactions",
+						   {{"type", typeName}, {"reason", "expired"}}).increment(stats.expired);
+		m_metrics->counter("qrz_cache_evictions_total", "Lookup cache entries dropped by compactions",
+						   {{"type", typeName}, {"reason", "limit"}}).increment(stats.evicted);
+	}
 
-	eraseLine();
-	showConsoleCursor(true);
+	cache::LookupCache::CompactionStats compaction = m_cache->getCompactionStats();
 
-	for(const std::string& error : errors)
+	m_metrics->counter("qrz_cache_compactions_total", "Lookup cache compactions", {{"result", "ok"}})
+			.increment(compaction.runs);
+	m_metrics->counter("qrz_cache_compactions_total", "Lookup cache compactions", {{"result", "failed"}})
+			.increment(compaction.failures);
+}
+
+/**
+ * @brief Refreshes a stale lookup cache entry that has already been served.
+ *
+ * Stale entries are refreshed in the same batch as the lookups that missed the cache, after them. A failed refresh
+ * keeps the stale entry, and is counted rather than reported, since the record has already been used. A record
+ * QRZ no longer has is cached as "not found".
+ *
+ * @param type The record type.
+ * @param key The lookup key.
+ * @param fetch Fetches the record from the QRZ API and returns its cache value.
+ * @throws AuthenticationException If the session has expired, so fetchConcurrently() retries the refresh once the
+ * token has been refreshed.
+ */
+void AppController::revalidate(cache::RecordType type, const std::string &key,
+							   const std::function<std::string()> &fetch)
+{
+	cache::LookupCache *cache = getCache();
+
+	try
 	{
-		std::cerr << error << std::endl;
+		std::string value = fetch();
+
+		net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::CACHE);
+
+		cache->put(type, key, std::move(value));
+	}
+	catch (AuthenticationException &)
+	{
+		throw;
+	}
+	catch (NotFoundException &)
+	{
+		cache->putNotFound(type, key);
+	}
+	catch (std::exception &)
+	{
+		countCacheEvent(type, cache::LookupCache::Event::REVALIDATION_FAILED);
+		return;
 	}
 
-	return dxccs;
+	countCacheEvent(type, cache::LookupCache::Event::REVALIDATED);
 }
 
 /**
- * @brief Fetches and returns a vector of bios based on the given search terms.
+ * @brief Runs a fetch for every search term on a pool of worker threads.
  *
- * This function fetches the specified bio records and returns a vector of bio HTML strings.
- * It uses the QRZ API client to fetch the bios for each search term.
+ * Each pass hands the pending terms out to a pool of worker threads. The pool is sized to the client's maximum
+ * concurrency; the client's adaptive concurrency limiter and rate limiter decide how many requests are actually in
+ * flight at any moment.
  *
- * @param searchTerms The set of search terms used to fetch the bios.
- * @return A vector of strings representing the fetched bios.
+ * Authentication errors cannot be handled on a worker, since refreshing the token may prompt the user for their
+ * password. Terms that fail authentication are therefore collected, and once the pass has finished the token is
+ * refreshed on this thread and those terms are run again. After m_maxFailedCallCount consecutive failed passes the
+ * remaining terms are reported as errors.
  *
- * @note This function assumes that the necessary APIs and client objects are properly initialized before calling this function.
+ * The batch is bounded by the batch timeout, and Ctrl+C cancels it. Either way the lookups in flight are abandoned at
+ * their next check, the remaining terms are reported as timed out or cancelled, and the records fetched so far are
+ * kept.
+ *
+ * @param searchTerms The terms to fetch.
+ * @param fetchOne Callback that fetches the record for one term and stores it for the given index.
+ * @param showProgress Whether to display the progress bar while fetching.
+ * @param onFailed Called with the index of each term that could not be fetched, as soon as it has failed for good.
+ * @return The error messages for the terms that could not be fetched, in search term order.
  */
-std::vector<std::string> AppController::fetchBios(const std::set<std::string> &searchTerms)
+std::vector<std::string> AppController::fetchConcurrently(const std::vector<std::string> &searchTerms,
+														  const std::function<void(size_t, const std::string &)> &fetchOne,
+														  bool showProgress, const std::function<void(size_t)> &onFailed)
 {
-	std::vector<std::string> bios;
-	std::vector<std::string> errors;
+	// Errors keyed by term index, so they can be reported in a stable order
+	std::vector<std::pair<size_t, std::string>> errors;
 
-	// Use an iterator so we cen reset the current element in the event of authentication error
-	auto it = searchTerms.begin();
-	while (it != searchTerms.end())
+	if (searchTerms.empty())
 	{
-		const std::string &call = *it;
+		return {};
+	}
 
-		try
+	// Every batch gets a fresh retry budget, so one bad batch cannot starve the next
+	client.resetRetryBudget();
+
+	// Bound the whole batch, and let Ctrl+C cancel it while keeping the records fetched so far
+	const net::Deadline batchDeadline = net::Deadline::after(m_batchTimeout);
+	InterruptibleBatch interruptible(client, batchDeadline);
+
+	// The bar is drawn on its own thread, and only to a terminal that results are not being streamed to
+	std::unique_ptr<ProgressReporter> progress;
+	if (showProgress && ProgressReporter::isTerminal() && !(m_streaming && ProgressReporter::isTerminal(stdout)))
+	{
+		progress = std::make_unique<ProgressReporter>(buildProgressBar(), searchTerms.size());
+	}
+
+	// Guards the error buffers
+	std::mutex mutex;
+
+	// Indices of the terms still to be fetched
+	std::vector<size_t> pending(searchTerms.size());
+	std::iota(pending.begin(), pending.end(), 0);
+
+	while (!pending.empty())
+	{
+		// Start every pass with a valid session, so the workers do not race each other to refresh it
+		if (!client.tokenIsValid())
 		{
-			bios.push_back(client.fetchBio(call));
+			if (progress)
+			{
+				progress->suspend();
+			}
 
-			resetFailedCallCount();
+			refreshToken();
 
-			it++;
+			if (progress)
+			{
+				progress->resume();
+			}
 		}
-		catch (AuthenticationException &e)
+
+		std::vector<size_t> authFailures;
+		std::string authError;
+		std::atomic<size_t> next = 0;
+		const net::PhaseStats::Clock::time_point passStart = net::PhaseStats::Clock::now();
+
+		auto worker = [&]()
 		{
-			if (m_failedCallCount < m_maxFailedCallCount)
+			while (true)
 			{
-				refreshToken();
+				size_t slot = next.fetch_add(1);
+				if (slot >= pending.size())
+				{
+					break;
+				}
+
+				size_t index = pending[slot];
+				const std::string &term = searchTerms[index];
+
+				// Every term was queued when the pass started, and its phases are tagged with it
+				if (m_phaseStats)
+				{
+					m_phaseStats->record(net::Phase::QUEUE, passStart, net::PhaseStats::Clock::now());
+				}
+
+				net::TraceRecorder::setThreadTag(term);
+
+				try
+				{
+					// Once the batch is out of time, the remaining terms are reported without making a request
+					if (batchDeadline.expired())
+					{
+						throw DeadlineExceededException{std::format("{:s}: {:s}", batchDeadline.cancelled() ? "Cancelled" : "Timed out", term)};
+					}
+
+					fetchOne(index, term);
+				}
+				catch (AuthenticationException &e)
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					authFailures.push_back(index);
+					authError = e.what();
+
+					continue;
+				}
+				catch (std::exception &e)
+				{
+					{
+						std::lock_guard<std::mutex> lock(mutex);
+						errors.emplace_back(index, e.what());
+					}
+
+					if (onFailed)
+					{
+						onFailed(index);
+					}
+				}
+
+				if (progress)
+				{
+					progress->advance();
+				}
+			}
+		};
 
-				// Roll the iterator back to retry this call
-				it = std::prev(it);
+		size_t workerCount = std::min(pending.size(), static_cast<size_t>(std::max(client.getMaxConcurrency(), 1)));
 
-				m_failedCallCount++;
-			}
-			else
+		std::vector<std::thread> workers;
+		for (size_t i = 0; i < workerCount; ++i)
+		{
+			workers.emplace_back(worker);
+		}
+
+		for (std::thread &thread : workers)
+		{
+			thread.join();
+		}
+
+		pending.clear();
+
+		if (authFailures.empty())
+		{
+			resetFailedCallCount();
+		}
+		else if (m_failedCallCount < m_maxFailedCallCount && !batchDeadline.expired())
+		{
+			// Hide the progress bar and give the cursor back
+			if (progress)
 			{
-				errors.push_back(std::format("QRZ API Error: {:s}", e.what()));
+				progress->suspend();
+			}
 
-				it++;
+			// Ask the user for their password, and refresh the bearer token
+			refreshToken();
+
+			if (progress)
+			{
+				progress->resume();
 			}
+
+			// Increment the error counter so we don't do this forever
+			m_failedCallCount++;
+
+			std::sort(authFailures.begin(), authFailures.end());
+			pending = authFailures;
 		}
-		catch (std::exception &e)
+		else
 		{
-			errors.emplace_back(e.what());
+			for (size_t index : authFailures)
+			{
+				errors.emplace_back(index, std::format("QRZ API Error: {:s}", authError));
 
-			it++;
+				if (onFailed)
+				{
+					onFailed(index);
+				}
+			}
 		}
 	}
 
-	for(const std::string& error : errors)
+	// Finalize and tear down the progress bar
+	if (progress)
 	{
-		std::cerr << error << std::endl;
+		progress->finish();
+	}
+
+	std::stable_sort(errors.begin(), errors.end(), [](const auto &a, const auto &b)
+	{
+		return a.first < b.first;
+	});
+
+	std::vector<std::string> output;
+	for (auto &error : errors)
+	{
+		output.push_back(std::move(error.second));
 	}
 
-	return bios;
+	return output;
 }
 
 /**
@@ -454,7 +1936,12 @@ std::vector<std::string> AppController::fetchBios(const std::set<std::string> &s
  */
 void AppController::refreshToken()
 {
-
+	// Logging in is deferred until the API is needed, so this may be the first time a callsign is required
+	if (!config.hasCallsign())
+	{
+		config.setCallsign(getUserCallsignFromUser());
+		config.saveConfig();
+	}
 
 	std::string password = config.getPassword();
 
@@ -468,6 +1955,8 @@ void AppController::refreshToken()
 	client.setUsername(userCall);
 	client.setPassword(password);
 
+	SecureWipe(password);
+
 	client.fetchToken();
 
 	updateConfigFromClientState();
@@ -549,6 +2038,12 @@ bool AppController::getConfirmationFromUser(const std::string& prompt)
  */
 void AppController::updateConfigFromClientState()
 {
+	// Nothing to persist until the user has logged in
+	if (client.getUsername().empty())
+	{
+		return;
+	}
+
 	config.setCallsign(client.getUsername());
 	config.setSessionKey(client.getSessionKey());
 	config.setSessionExpiration(client.getSessionExpiration());
@@ -556,39 +2051,138 @@ void AppController::updateConfigFromClientState()
 }
 
 /**
- * @brief Resets the counter for failed API calls.
+ * @brief Prints the request throttling, retry, hedging, lookup cache and phase timing statistics to stderr.
  *
- * This function resets the counter for failed API calls. It sets the value of m_failedCallCount to 0.
+ * This reports the state of the client-side rate limiter and the adaptive concurrency limiter at the end of the run,
+ * which shows the request rate and concurrency the batch settled at, followed by the retry and hedging counters, and
+ * how each record type was served by the lookup cache and what its compactions dropped. The time spent in each phase
+ * follows, with its total, count and percentiles, to show where a slow batch spent its time.
  */
-void AppController::resetFailedCallCount()
+void AppController::printStats()
 {
-	m_failedCallCount = 0;
+	net::TokenBucket::Snapshot rate = client.getRateLimiterSnapshot();
+	net::AdaptiveConcurrencyLimiter::Snapshot concurrency = client.getConcurrencySnapshot();
+
+	std::cerr << "Request throttling" << std::endl;
+	std::cerr << std::format("  rate limit:        {:.1f} req/s (burst {:.0f})", rate.rate, rate.burst) << std::endl;
+	std::cerr << std::format("  requests:          {:d}", rate.acquired) << std::endl;
+	std::cerr << std::format("  rate limit waits:  {:d} ({:.3f} s total)", rate.waits,
+							 static_cast<double>(rate.totalWait.count()) / 1e6) << std::endl;
+	std::cerr << std::format("  concurrency limit: {:.2f} (min {:d}, max {:d})", concurrency.limit,
+							 concurrency.minLimit, concurrency.maxLimit) << std::endl;
+	std::cerr << std::format("  in flight:         {:d}", concurrency.inFlight) << std::endl;
+	std::cerr << std::format("  latency:           {:.1f} ms baseline, {:.1f} ms smoothed",
+							 concurrency.baselineLatencyMs, concurrency.smoothedLatencyMs) << std::endl;
+	std::cerr << std::format("  limit changes:     +{:d} / -{:d} ({:d} overload, {:d} timeout)",
+							 concurrency.increases, concurrency.decreases, concurrency.overloads,
+							 concurrency.timeouts) << std::endl;
+
+	net::RetryPolicy::Snapshot retry = client.getRetrySnapshot();
+
+	std::cerr << "Retries" << std::endl;
+	std::cerr << std::format("  max attempts:      {:d}", retry.maxAttempts) << std::endl;
+	std::cerr << std::format("  retries:           {:d} ({:.3f} s backoff)", retry.retries,
+							 static_cast<double>(retry.totalBackoff.count()) / 1e6) << std::endl;
+	std::cerr << std::format("  gave up:           {:d} out of attempts, {:d} out of budget", retry.attemptsExhausted,
+							 retry.budgetExhausted) << std::endl;
+	std::cerr << std::format("  budget left:       {:.1f}", retry.budget) << std::endl;
+
+	QRZClient::HedgeSnapshot hedge = client.getHedgeSnapshot();
+
+	if (hedge.percentile > 0)
+	{
+		std::cerr << "Hedging" << std::endl;
+		std::cerr << std::format("  hedge after:       p{:g} of recent latency ({:.1f} ms)", hedge.percentile,
+								 static_cast<double>(hedge.delay.count()) / 1000.0) << std::endl;
+		std::cerr << std::format("  hedges:            {:d} fired, {:d} won", hedge.fired, hedge.won) << std::endl;
+	}
+
+	if (m_cache)
+	{
+		std::cerr << "Lookup cache" << std::endl;
+
+		for (cache::RecordType type : {cache::RecordType::CALLSIGN, cache::RecordType::DXCC, cache::RecordType::BIO})
+		{
+			cache::LookupCache::Stats stats = m_cache->getStats(type);
+
+			std::cerr << std::format("  {:<19}{:d} fresh, {:d} stale, {:d} not found, {:d} missed",
+									 std::string(cache::recordTypeName(type)) + ":", stats.hits, stats.staleHits,
+									 stats.notFoundHits, stats.misses) << std::endl;
+			std::cerr << std::format("  {:<19}{:d} refreshed, {:d} refresh failed, {:d} not found stored", "",
+									 stats.revalidated, stats.revalidationFailures, stats.notFoundStored) << std::endl;
+			std::cerr << std::format("  {:<19}{:d} expired, {:d} evicted", "", stats.expired, stats.evicted)
+					  << std::endl;
+		}
+
+		cache::LookupCache::CompactionStats compaction = m_cache->getCompactionStats();
+
+		std::cerr << std::format("  compactions:       {:d} ({:d} failed, {:.1f} MiB written, {:.3f} s)",
+								 compaction.runs, compaction.failures,
+								 static_cast<double>(compaction.bytesWritten) / (1024.0 * 1024.0),
+								 static_cast<double>(compaction.time.count()) / 1e6) << std::endl;
+	}
+
+	if (!m_phaseStats)
+	{
+		return;
+	}
+
+	auto toMs = [](std::chrono::microseconds duration)
+	{
+		return static_cast<double>(duration.count()) / 1000.0;
+	};
+
+	std::cerr << "Phases (ms)" << std::endl;
+	std::cerr << std::format("  {:<12}{:>8}{:>12}{:>10}{:>10}{:>10}{:>10}", "phase", "count", "total", "p50", "p90",
+							 "p99", "max") << std::endl;
+
+	for (const net::PhaseStats::Summary &summary : m_phaseStats->summarize())
+	{
+		std::cerr << std::format("  {:<12}{:>8d}{:>12.1f}{:>10.1f}{:>10.1f}{:>10.1f}{:>10.1f}",
+								 net::PhaseStats::name(summary.phase), summary.count, toMs(summary.total),
+								 toMs(summary.p50), toMs(summary.p90), toMs(summary.p99), toMs(summary.max)) << std::endl;
+	}
 }
 
 /**
- * @brief Changes the visibility of the console cursor.
+ * @brief Writes the trace of the run to m_tracePath, if tracing is enabled.
  *
- * This function sets the visibility of the console cursor based on the value of the parameter `show`.
- * If `show` is `true`, the console cursor will be displayed. If `show` is `false`, the console cursor will be hidden.
- *
- * @param show A boolean value indicating whether to show or hide the console cursor.
+ * The trace is written once every request has finished, hedges included, so no thread is still recording.
  */
-inline void AppController::showConsoleCursor(bool const show) {
-	std::fputs(show ? "\033[?25h" : "\033[?25l", stderr);
+void AppController::writeTrace()
+{
+	if (!m_traceRecorder)
+	{
+		return;
+	}
+
+	std::ofstream output(m_tracePath, std::ios::trunc);
+
+	if (!output)
+	{
+		std::cerr << "Unable to write trace " << m_tracePath << std::endl;
+		return;
+	}
+
+	m_traceRecorder->write(output);
+
+	if (uint64_t dropped = m_traceRecorder->dropped())
+	{
+		std::cerr << "The trace is missing the " << dropped << " oldest spans" << std::endl;
+	}
 }
 
-#ifdef WIN32
 /**
- * @brief Erases the current line in the console.
+ * @brief Resets the counter for failed API calls.
  *
- * This function erases the current line in the console, allowing for output to be overwritten.
- * It uses the escape sequences "\x1b[1A" and "\x1b[2K" to move the cursor to the beginning of the line and clear all characters.
+ * This function resets the counter for failed API calls. It sets the value of m_failedCallCount to 0.
  */
-inline void AppController::eraseLine() {
-	std::fputs("\x1b[1A", stderr);
-	std::fputs("\x1b[2K", stderr);
+void AppController::resetFailedCallCount()
+{
+	m_failedCallCount = 0;
 }
 
+#ifdef WIN32
 /**
  * @brief Create a new instance of ProgressBar.
  *
@@ -602,16 +2196,6 @@ std::unique_ptr<ProgressBar> AppController::buildProgressBar()
 	return std::make_unique<DefaultProgressBar>();
 }
 #else
-/**
-* @brief Erases the current line in the console.
-*
-* This function erases the current line in the console, allowing for output to be overwritten.
-* It uses the escape sequence "\r\033[K" to move the cursor to the beginning of the line and clear all characters.
-*/
-inline void AppController::eraseLine() {
-	std::fputs("\r\033[K", stderr);
-}
-
 /**
  * @brief Create a new instance of ProgressBar.
  *
@@ -1,19 +1,32 @@
 #ifndef QRZ_APPCONTROLLER_H
 #define QRZ_APPCONTROLLER_H
 
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "AppCommand.h"
 #include "Configuration.h"
 #include "OutputFormat.h"
 #include "QRZClient.h"
 #include "Util.h"
+#include "cache/LookupCache.h"
+#include "dxcc/DXCCTable.h"
+#include "dxcc/PrefixResolver.h"
+#include "metrics/Registry.h"
+#include "metrics/TextFileExporter.h"
 #include "model/Callsign.h"
 #include "model/DXCC.h"
 #include "progressbar/ProgressBar.h"
+#include "progressbar/ProgressReporter.h"
 #include "render/CallsignConsoleRenderer.h"
 #include "render/CallsignXMLRenderer.h"
 #include "render/CallsignMarkdownRenderer.h"
+#include "render/DXCCJoin.h"
 #include "render/Renderer.h"
 
 namespace qrz
@@ -49,14 +62,80 @@ namespace qrz
 		// Maximum number of consecutive API call failures allowed before bailing out of the operation
 		const int m_maxFailedCallCount = 4;
 
+		// Time allowed for a whole batch of lookups. 0 means no limit
+		std::chrono::milliseconds m_batchTimeout{0};
+
 		// Flag to determine whether or not to display the progress bar
 		bool displayProgress = false;
 
+		// Path of the country file prefix table. Empty when there is none, or it failed to load
+		std::string m_prefixTablePath;
+
+		// Prefix table used to resolve DXCC entities locally, loaded on first use
+		std::optional<dxcc::PrefixResolver> m_prefixResolver;
+
+		// Path of the local DXCC table
+		std::string m_dxccTablePath;
+
+		// Mirror of the QRZ DXCC entity list, loaded on first use
+		std::optional<dxcc::DXCCTable> m_dxccTable;
+
+		// Whether loading the DXCC table has been attempted
+		bool m_dxccTableLoaded = false;
+
+		// Age after which the DXCC table is refreshed. Entities change rarely, so this is long
+		static constexpr std::chrono::hours m_dxccTableMaxAge{24 * 30};
+
+		// Whether lookups must be answered locally, without calling the QRZ API
+		bool m_offline = false;
+
+		// Whether callsign results are joined to their DXCC entities
+		bool m_withDxcc = false;
+
+		// Template for OutputFormat::TEMPLATE, validated when the command was parsed
+		std::string m_outputTemplate;
+
+		// Whether results are rendered in completion order rather than search term order
+		bool m_unordered = false;
+
+		// Whether results are being written to stdout as they arrive, where a progress bar would garble them
+		bool m_streaming = false;
+
+		// Most results held back waiting for an earlier search term, before they are rendered out of order
+		static constexpr size_t m_reorderWindow = 256;
+
+		// Path of the lookup cache. Empty when caching is disabled, or the cache failed to load
+		std::string m_cachePath;
+
+		// Results of previous lookups, opened on first use
+		std::optional<cache::LookupCache> m_cache;
+
+		// How long the cached entries of each record type are served, fresh, stale or "not found"
+		cache::CachePolicies m_cachePolicies;
+
+		// Time spent in each phase of the run, shared with the client. nullptr unless --stats or --trace is given
+		std::shared_ptr<net::PhaseStats> m_phaseStats;
+
+		// Timeline of every timed phase, written to m_tracePath once the command completes. nullptr unless --trace
+		std::shared_ptr<net::TraceRecorder> m_traceRecorder;
+
+		// File the trace is written to
+		std::string m_tracePath;
+
+		// Metrics of the run, shared with the client. nullptr unless --metrics is given
+		std::shared_ptr<metrics::Registry> m_metrics;
+
+		// Writes m_metrics to the metrics file while the command runs, and once more when it is destroyed
+		std::unique_ptr<metrics::TextFileExporter> m_metricsExporter;
+
+		// Time between metrics file writes, unless --metrics-interval is given
+		static constexpr std::chrono::seconds m_defaultMetricsInterval{15};
+
 		/**
-		 * @brief Initializes the application by setting up the necessary configurations and checking for authentication.
+		 * @brief Initializes the application by loading the saved login and session.
 		 *
-		 * This function is responsible for initializing the application. It performs various checks to verify that all
-		 * necessary configuration information is in place, and if not, gathers the information from the user.
+		 * This function only loads what is already in the configuration. Logging in is left to the first lookup that
+		 * needs the QRZ API, so lookups answered locally work without a network connection.
 		 */
 		void initialize();
 
@@ -81,9 +160,9 @@ namespace qrz
 		/**
 		 * @brief Fetches and renders bios based on the given search terms.
 		 *
-		 * This function fetches the specified callsign records and renders them.
+		 * This function fetches the specified bios and renders each one as it arrives.
 		 *
-		 * @param searchTerms The set of search terms used to fetch the callsign records.
+		 * @param searchTerms The set of search terms used to fetch the bios.
 		 */
 		void fetchAndRenderBios(const std::set<std::string> &searchTerms);
 
@@ -110,6 +189,46 @@ namespace qrz
 		 */
 		std::vector<Callsign> fetchCallsignRecords(const std::set<std::string> &searchTerms);
 
+		/**
+		 * @brief Looks up callsigns, from the lookup cache where possible and otherwise from the QRZ API.
+		 *
+		 * @param terms The callsigns to look up.
+		 * @param onResult Called with the index of the term and its record, for every callsign found. It is called
+		 * concurrently from several threads, so it must only touch state owned by that index.
+		 * @param onMissing Called with the index of every term that has no record, as soon as its lookup has failed.
+		 */
+		void lookupCallsigns(const std::vector<std::string> &terms,
+							 const std::function<void(size_t, Callsign &&)> &onResult,
+							 const std::function<void(size_t)> &onMissing = {});
+
+		/**
+		 * @brief Reads a callsign record from a lookup cache entry.
+		 *
+		 * @param entry The cache entry.
+		 * @return The record, or std::nullopt if the entry records a "not found" answer or cannot be read.
+		 */
+		static std::optional<Callsign> getCachedCallsign(const cache::LookupCache::Entry &entry);
+
+		/**
+		 * @brief Enriches an ADIF log with the QRZ details of each contacted station.
+		 *
+		 * Each distinct callsign is looked up once, and the log is streamed so only one QSO is held in memory.
+		 *
+		 * @param inputPath The ADIF log to enrich.
+		 * @param outputPath The file to write the enriched log to, or empty for standard output.
+		 */
+		void enrichAdif(const std::string &inputPath, const std::string &outputPath);
+
+		/**
+		 * @brief Looks up the DXCC entity of each callsign.
+		 *
+		 * Each distinct entity number is looked up only once for the batch.
+		 *
+		 * @param callsigns The callsign records.
+		 * @return The DXCC entities of the callsigns, keyed by entity number.
+		 */
+		render::DXCCJoin joinDXCC(const std::vector<Callsign> &callsigns);
+
 		/**
 		 * @brief Fetches DXCC records based on the given search terms.
 		 *
@@ -122,17 +241,137 @@ namespace qrz
 		std::vector<DXCC> fetchDXCCRecords(const std::set<std::string> &searchTerms);
 
 		/**
-		 * @brief Fetches and returns a vector of bios based on the given search terms.
+		 * @brief Returns the prefix table, loading it on first use.
 		 *
-		 * This function fetches the specified bio records and returns a vector of bio HTML strings.
-		 * It uses the QRZ API client to fetch the bios for each search term.
+		 * @return The prefix resolver, or nullptr if there is no prefix table or it could not be loaded.
+		 */
+		const dxcc::PrefixResolver *getPrefixResolver();
+
+		/**
+		 * @brief Returns the local DXCC table, loading it on first use and refreshing it when it is stale.
 		 *
-		 * @param searchTerms The set of search terms used to fetch the bios.
-		 * @return A vector of strings representing the fetched bios.
+		 * @return The DXCC table, or nullptr if it has not been mirrored yet or could not be loaded.
+		 */
+		const dxcc::DXCCTable *getDXCCTable();
+
+		/**
+		 * @brief Returns the lookup cache, opening it on first use.
+		 *
+		 * @return The lookup cache, or nullptr if caching is disabled or the cache could not be opened.
+		 */
+		cache::LookupCache *getCache();
+
+		/**
+		 * @brief Fetches the complete DXCC entity list in a single request and stores it as the local DXCC table.
+		 *
+		 * @return True if the table was refreshed, false if the fetch failed.
+		 */
+		bool refreshDXCCTable();
+
+		/**
+		 * @brief Mirrors the QRZ DXCC entity list into the local DXCC table.
+		 */
+		void mirrorDXCC();
+
+		/**
+		 * @brief Fetches bios, from the lookup cache where possible and otherwise from the QRZ API.
+		 *
+		 * Cached bios are used if the bio has not changed since, according to the biodate of the callsign record.
+		 *
+		 * @param terms The callsigns whose bios to fetch.
+		 * @param onBio Called with the index of the term and its bio HTML as soon as the bio is available. It is
+		 * called concurrently from several threads.
+		 * @param onMissing Called with the index of every term that has no bio, as soon as its lookup has failed.
 		 *
 		 * @note This function assumes that the necessary APIs and client objects are properly initialized before calling this function.
 		 */
-		std::vector<std::string> fetchBios(const std::set<std::string> &searchTerms);
+		void fetchBios(const std::vector<std::string> &terms,
+					   const std::function<void(size_t, const std::string &)> &onBio,
+					   const std::function<void(size_t)> &onMissing = {});
+
+		/**
+		 * @brief Writes bios to a directory, one CALL.html file per callsign.
+		 *
+		 * Bios that have not changed since they were last written are skipped, and the rest are streamed from the
+		 * QRZ API straight into their files.
+		 *
+		 * @param terms The callsigns whose bios to write.
+		 * @param outputDir The directory to write the bios to. It is created if it does not exist.
+		 */
+		void exportBios(const std::vector<std::string> &terms, const std::string &outputDir);
+
+		/**
+		 * @brief Looks up the date each callsign's bio was last changed.
+		 *
+		 * @param terms The callsigns.
+		 * @return The biodate of each term, empty if the call has no biodate, or std::nullopt if its callsign
+		 * lookup failed.
+		 */
+		std::vector<std::optional<std::string>> lookupBiodates(const std::vector<std::string> &terms);
+
+		/**
+		 * @brief Reads a bio from a lookup cache entry, if it was stored for the given biodate.
+		 *
+		 * @param entry The cache entry.
+		 * @param biodate The date the bio was last changed, from the callsign record.
+		 * @return The bio HTML, or std::nullopt if the entry records a "not found" answer or the bio has changed
+		 * since it was stored.
+		 */
+		static std::optional<std::string> getCachedBio(const cache::LookupCache::Entry &entry, const std::string &biodate);
+
+		/**
+		 * @brief Counts a lookup cache event in the cache statistics, and in the metrics if they are enabled.
+		 *
+		 * @param type The record type.
+		 * @param event The event.
+		 */
+		void countCacheEvent(cache::RecordType type, cache::LookupCache::Event event);
+
+		/**
+		 * @brief Waits for a background compaction of the lookup cache to finish, reports it if it failed, and adds
+		 * its evictions to the metrics.
+		 */
+		void finishCacheCompaction();
+
+		/**
+		 * @brief Refreshes a stale lookup cache entry that has already been served.
+		 *
+		 * @param type The record type.
+		 * @param key The lookup key.
+		 * @param fetch Fetches the record from the QRZ API and returns its cache value.
+		 * @throws AuthenticationException If the session has expired, so the refresh can be retried.
+		 */
+		void revalidate(cache::RecordType type, const std::string &key, const std::function<std::string()> &fetch);
+
+		/**
+		 * @brief Runs a fetch for every search term on a pool of worker threads.
+		 *
+		 * Terms are handed out to up to client.getMaxConcurrency() workers, and the client's adaptive concurrency
+		 * limiter decides how many of them actually have a request in flight. Terms that fail authentication are
+		 * retried after the token has been refreshed on the calling thread, up to m_maxFailedCallCount times. The
+		 * batch ends at m_batchTimeout or on Ctrl+C, and the terms not fetched by then are reported as errors.
+		 *
+		 * @param searchTerms The terms to fetch.
+		 * @param fetchOne Callback that fetches the record for one term and stores it for the given index. It is called
+		 * concurrently from several threads, so it must only touch state owned by that index.
+		 * @param showProgress Whether to display the progress bar while fetching.
+		 * @param onFailed Called with the index of each term that could not be fetched, as soon as it has failed for
+		 * good. It is called concurrently from several threads.
+		 * @return The error messages for the terms that could not be fetched, in search term order.
+		 */
+		std::vector<std::string> fetchConcurrently(const std::vector<std::string> &searchTerms,
+												   const std::function<void(size_t, const std::string &)> &fetchOne,
+												   bool showProgress, const std::function<void(size_t)> &onFailed = {});
+
+		/**
+		 * @brief Prints the request throttling, retry, hedging, lookup cache and phase timing statistics to stderr.
+		 */
+		void printStats();
+
+		/**
+		 * @brief Writes the trace of the run to m_tracePath, if tracing is enabled.
+		 */
+		void writeTrace();
 
 		/**
 		 * @brief Refreshes the access token by fetching a new token from the QRZ API
@@ -187,23 +426,6 @@ namespace qrz
 		 */
 		void updateConfigFromClientState();
 
-		/**
-		 * @brief Changes the visibility of the console cursor.
-		 *
-		 * This function sets the visibility of the console cursor based on the value of the parameter `show`.
-		 * If `show` is `true`, the console cursor will be displayed. If `show` is `false`, the console cursor will be hidden.
-		 *
-		 * @param show A boolean value indicating whether to show or hide the console cursor.
-		 */
-		void showConsoleCursor(const bool show);
-
-		/**
-		 * @brief Erases the current line in the console.
-		 *
-		 * This function erases the current line in the console, allowing for output to be overwritten.
-		 */
-		static void eraseLine();
-
 		/**
 		 * @brief Create a new instance of ProgressBar.
 		 *
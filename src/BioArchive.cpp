@@ -0,0 +1,204 @@
+#include "BioArchive.h"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "FileLock.h"
+
+using namespace qrz;
+
+/**
+ * @brief Opens the archive in the given directory, creating the directory if needed.
+ *
+ * @param directory The archive directory.
+ * @throws std::filesystem::filesystem_error If the directory cannot be created.
+ */
+BioArchive::BioArchive(std::filesystem::path directory) : m_directory(std::move(directory))
+{
+	std::filesystem::create_directories(m_directory);
+
+	m_biodates = readIndex(m_directory / m_indexName);
+}
+
+/**
+ * @brief Checks whether the archived bio for a callsign is up to date.
+ *
+ * @param call The callsign.
+ * @param biodate The date the bio was last changed, from the callsign record.
+ * @return True if the bio file exists and was written for this biodate.
+ */
+bool BioArchive::isCurrent(const std::string &call, const std::string &biodate) const
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		auto it = m_biodates.find(call);
+
+		if (biodate.empty() || it == m_biodates.end() || it->second != biodate)
+		{
+			return false;
+		}
+	}
+
+	std::error_code ec;
+
+	return std::filesystem::is_regular_file(pathFor(call), ec);
+}
+
+/**
+ * @brief Writes the bio for a callsign.
+ *
+ * The bio is written through a large buffer to CALL.html.tmp, which is trimmed to where writeBio left the put
+ * position and renamed over CALL.html. A retried download may rewind the stream, which leaves the tail of the failed
+ * attempt behind the bio, so trimming is needed.
+ *
+ * @param call The callsign.
+ * @param biodate The date the bio was last changed, or empty if unknown, in which case it is always downloaded again.
+ * @param writeBio Writes the bio HTML to the stream it is given. The bio is taken to end at the stream's put position
+ * once it returns.
+ * @throws std::runtime_error If the file cannot be written. Exceptions from writeBio are passed on.
+ */
+void BioArchive::write(const std::string &call, const std::string &biodate,
+					   const std::function<void(std::ostream &)> &writeBio)
+{
+	std::filesystem::path path = pathFor(call);
+	std::filesystem::path tempPath = path;
+	tempPath += ".tmp";
+
+	try
+	{
+		std::vector<char> buffer(m_writeBufferSize);
+		std::ofstream output;
+
+		// The buffer must be set before the file is opened to take effect
+		output.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		output.open(tempPath, std::ios::binary | std::ios::trunc);
+
+		if (!output)
+		{
+			throw std::runtime_error{std::format("Unable to write bio {:s}", tempPath.string())};
+		}
+
+		writeBio(output);
+
+		std::streampos end = output.tellp();
+		output.close();
+
+		if (!output || end < 0)
+		{
+			throw std::runtime_error{std::format("Unable to write bio {:s}", tempPath.string())};
+		}
+
+		std::filesystem::resize_file(tempPath, static_cast<std::uintmax_t>(end));
+		std::filesystem::rename(tempPath, path);
+	}
+	catch (...)
+	{
+		std::error_code ec;
+		std::filesystem::remove(tempPath, ec);
+		throw;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_biodates[call] = biodate;
+	m_written[call] = biodate;
+}
+
+/**
+ * @brief Writes the biodates of the bios written since the archive was opened to the index.
+ *
+ * The index is read again under the lock and merged, so bios written by other processes in the meantime keep their
+ * entries. Bios written without a biodate are dropped from the index, so they are downloaded again next time.
+ *
+ * @throws std::runtime_error If the index cannot be written.
+ */
+void BioArchive::save()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_written.empty())
+	{
+		return;
+	}
+
+	std::filesystem::path indexPath = m_directory / m_indexName;
+
+	FileLock fileLock(indexPath.string() + ".lock");
+
+	std::unordered_map<std::string, std::string> biodates = readIndex(indexPath);
+
+	for (const auto &[call, biodate] : m_written)
+	{
+		biodates[call] = biodate;
+	}
+
+	std::filesystem::path tempPath = indexPath;
+	tempPath += ".tmp";
+
+	{
+		std::ofstream output(tempPath, std::ios::trunc);
+
+		for (const auto &[call, biodate] : biodates)
+		{
+			if (!biodate.empty())
+			{
+				output << call << '\t' << biodate << '\n';
+			}
+		}
+
+		if (!output.flush())
+		{
+			throw std::runtime_error{std::format("Unable to write bio index {:s}", tempPath.string())};
+		}
+	}
+
+	std::filesystem::rename(tempPath, indexPath);
+
+	m_biodates = std::move(biodates);
+	m_written.clear();
+}
+
+/**
+ * @brief Returns the path of the bio file for a callsign.
+ *
+ * @param call The callsign.
+ * @return The path, e.g. DIR/W1AW.html. Slashes in portable calls are replaced with underscores.
+ */
+std::filesystem::path BioArchive::pathFor(const std::string &call) const
+{
+	std::string name = call;
+	std::replace(name.begin(), name.end(), '/', '_');
+
+	return m_directory / (name + ".html");
+}
+
+/**
+ * @brief Reads an index file.
+ *
+ * Each line is a callsign, a tab and a biodate. Malformed lines are skipped.
+ *
+ * @param path The index file.
+ * @return The biodates by callsign. Empty if the file does not exist.
+ */
+std::unordered_map<std::string, std::string> BioArchive::readIndex(const std::filesystem::path &path)
+{
+	std::unordered_map<std::string, std::string> biodates;
+	std::ifstream input(path);
+	std::string line;
+
+	while (std::getline(input, line))
+	{
+		size_t tab = line.find('\t');
+
+		if (tab != std::string::npos && tab > 0 && tab + 1 < line.size())
+		{
+			biodates[line.substr(0, tab)] = line.substr(tab + 1);
+		}
+	}
+
+	return biodates;
+}
@@ -0,0 +1,99 @@
+#ifndef QRZ_BIOARCHIVE_H
+#define QRZ_BIOARCHIVE_H
+
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+namespace qrz
+{
+	/**
+	 * @class BioArchive
+	 * @brief A directory of bios, one CALL.html file per callsign.
+	 *
+	 * The archive keeps an index of the biodate each file was written for, so a re-run only downloads the bios that
+	 * have changed since. Each bio is written to a temporary file and renamed into place, so an interrupted download
+	 * never replaces a complete bio. The index is merged with the one on disk under a lock when it is saved, so
+	 * several processes can share a directory.
+	 *
+	 * isCurrent() and write() may be called concurrently from the fetch workers.
+	 */
+	class BioArchive
+	{
+	public:
+		/**
+		 * @brief Opens the archive in the given directory, creating the directory if needed.
+		 *
+		 * @param directory The archive directory.
+		 * @throws std::filesystem::filesystem_error If the directory cannot be created.
+		 */
+		explicit BioArchive(std::filesystem::path directory);
+
+		/**
+		 * @brief Checks whether the archived bio for a callsign is up to date.
+		 *
+		 * @param call The callsign.
+		 * @param biodate The date the bio was last changed, from the callsign record.
+		 * @return True if the bio file exists and was written for this biodate.
+		 */
+		bool isCurrent(const std::string &call, const std::string &biodate) const;
+
+		/**
+		 * @brief Writes the bio for a callsign.
+		 *
+		 * @param call The callsign.
+		 * @param biodate The date the bio was last changed, or empty if unknown, in which case it is always
+		 * downloaded again.
+		 * @param writeBio Writes the bio HTML to the stream it is given. The bio is taken to end at the stream's put
+		 * position once it returns.
+		 * @throws std::runtime_error If the file cannot be written. Exceptions from writeBio are passed on.
+		 */
+		void write(const std::string &call, const std::string &biodate,
+				   const std::function<void(std::ostream &)> &writeBio);
+
+		/**
+		 * @brief Writes the biodates of the bios written since the archive was opened to the index.
+		 *
+		 * @throws std::runtime_error If the index cannot be written.
+		 */
+		void save();
+
+		/**
+		 * @brief Returns the path of the bio file for a callsign.
+		 *
+		 * @param call The callsign.
+		 * @return The path, e.g. DIR/W1AW.html. Slashes in portable calls are replaced with underscores.
+		 */
+		std::filesystem::path pathFor(const std::string &call) const;
+
+	private:
+		// Name of the index file in the archive directory
+		static inline const char *m_indexName = ".biodates";
+
+		// Size of the file buffer bios are written through, so each bio takes a few large writes
+		static constexpr size_t m_writeBufferSize = 256 * 1024;
+
+		std::filesystem::path m_directory;
+
+		mutable std::mutex m_mutex;
+
+		// Biodate each bio file was written for, by callsign
+		std::unordered_map<std::string, std::string> m_biodates;
+
+		// Biodates of the bios written since the archive was opened
+		std::unordered_map<std::string, std::string> m_written;
+
+		/**
+		 * @brief Reads an index file.
+		 *
+		 * @param path The index file.
+		 * @return The biodates by callsign. Empty if the file does not exist.
+		 */
+		static std::unordered_map<std::string, std::string> readIndex(const std::filesystem::path &path);
+	};
+}
+
+#endif //QRZ_BIOARCHIVE_H
@@ -0,0 +1,304 @@
+#include "CallsignNormalizer.h"
+
+#include <algorithm>
+
+#include "Util.h"
+
+using namespace qrz;
+
+namespace
+{
+	// Suffixes that describe how a station operates rather than where, so they do not change its entity
+	constexpr std::array<std::string_view, 5> operatingSuffixes = {"QRP", "QRPP", "LH", "LGT", "YL"};
+}
+
+// The DFA is evaluated at compile time, so its behaviour can be checked here
+static_assert(CallsignNormalizer::isValidBaseCall("W1AW"));
+static_assert(CallsignNormalizer::isValidBaseCall("2E0ABC"));
+static_assert(CallsignNormalizer::isValidBaseCall("4U1ITU"));
+static_assert(CallsignNormalizer::isValidBaseCall("k4rwr"));
+static_assert(!CallsignNormalizer::isValidBaseCall("W1"));
+static_assert(!CallsignNormalizer::isValidBaseCall("KH6"));
+static_assert(!CallsignNormalizer::isValidBaseCall("ABCDEF"));
+static_assert(!CallsignNormalizer::isValidBaseCall("W1-AW"));
+
+/**
+ * @brief Reassembles the callsign in prefix/base/suffix form.
+ *
+ * @return The full callsign.
+ */
+std::string ParsedCallsign::toString() const
+{
+	std::string output;
+
+	if (!prefix.empty())
+	{
+		output += prefix + "/";
+	}
+
+	output += base;
+
+	if (!suffix.empty())
+	{
+		output += "/" + suffix;
+	}
+
+	return output;
+}
+
+/**
+ * @brief Returns the part of the callsign that names where the station is operating from.
+ *
+ * A prefix always names a location. Single-character suffixes such as /P, /M or /4 and operating suffixes such as
+ * /QRP do not, and any other suffix does.
+ *
+ * @return The prefix, as in VE3/W1AW, or else a suffix that names a location, as in W1AW/KH6 or W1AW/MM. Empty if
+ * the station is operating from its home entity, as in W1AW/P or W1AW/QRP.
+ */
+std::string_view ParsedCallsign::locationPart() const
+{
+	if (!prefix.empty())
+	{
+		return prefix;
+	}
+
+	if (suffix.size() > 1
+		&& std::find(operatingSuffixes.begin(), operatingSuffixes.end(), suffix) == operatingSuffixes.end())
+	{
+		return suffix;
+	}
+
+	return {};
+}
+
+/**
+ * @brief Trims and uppercases a search term.
+ *
+ * @param term The raw search term.
+ * @return The trimmed, uppercased term.
+ */
+std::string CallsignNormalizer::clean(std::string_view term)
+{
+	const char *whitespace = " \t\r\n\f\v";
+
+	size_t first = term.find_first_not_of(whitespace);
+	if (first == std::string_view::npos)
+	{
+		return "";
+	}
+
+	size_t last = term.find_last_not_of(whitespace);
+
+	std::string output(term.substr(first, last - first + 1));
+	ToUpper(output);
+
+	return output;
+}
+
+/**
+ * @brief Parses a callsign into prefix, base callsign and suffix.
+ *
+ * The callsign is split on '/'. One part must be a base callsign; a part before it is a prefix (VE3/W1AW) and a part
+ * after it is a suffix (W1AW/P, W1AW/QRP, W1AW/VE3). When both parts of a two-part callsign look like base callsigns,
+ * the longer one is taken as the base callsign, as loggers conventionally do, with ties going to the second part.
+ *
+ * @param term The callsign to parse. It is trimmed and uppercased first.
+ * @return The parsed callsign, or std::nullopt if the term is not a valid callsign.
+ */
+std::optional<ParsedCallsign> CallsignNormalizer::parse(std::string_view term)
+{
+	std::string cleaned = clean(term);
+
+	std::vector<std::string_view> parts;
+	std::string_view remaining = cleaned;
+
+	while (true)
+	{
+		size_t slash = remaining.find('/');
+		parts.push_back(remaining.substr(0, slash));
+
+		if (slash == std::string_view::npos)
+		{
+			break;
+		}
+
+		remaining.remove_prefix(slash + 1);
+	}
+
+	ParsedCallsign output;
+
+	if (parts.size() == 1)
+	{
+		if (!isValidBaseCall(parts[0]))
+		{
+			return std::nullopt;
+		}
+
+		output.base = parts[0];
+	}
+	else if (parts.size() == 2)
+	{
+		bool firstIsBase = isValidBaseCall(parts[0]);
+		bool secondIsBase = isValidBaseCall(parts[1]);
+
+		if (firstIsBase && secondIsBase)
+		{
+			firstIsBase = parts[0].size() > parts[1].size();
+			secondIsBase = !firstIsBase;
+		}
+
+		if (secondIsBase && isValidDesignator(parts[0]))
+		{
+			output.prefix = parts[0];
+			output.base = parts[1];
+		}
+		else if (firstIsBase && isValidDesignator(parts[1]))
+		{
+			output.base = parts[0];
+			output.suffix = parts[1];
+		}
+		else
+		{
+			return std::nullopt;
+		}
+	}
+	else if (parts.size() == 3)
+	{
+		if (!isValidDesignator(parts[0]) || !isValidBaseCall(parts[1]) || !isValidDesignator(parts[2]))
+		{
+			return std::nullopt;
+		}
+
+		output.prefix = parts[0];
+		output.base = parts[1];
+		output.suffix = parts[2];
+	}
+	else
+	{
+		return std::nullopt;
+	}
+
+	return output;
+}
+
+/**
+ * @brief Normalizes one search term for callsign and bio lookups.
+ *
+ * QRZ keys its records by base callsign, so w1aw, W1AW and VE3/W1AW/P all normalize to W1AW. A bare base callsign, by
+ * far the most common term in large lists, is recognised in place without splitting it.
+ *
+ * @param term The raw search term.
+ * @return The base callsign to fetch, or std::nullopt if the term is not a valid callsign.
+ */
+std::optional<std::string> CallsignNormalizer::normalizeCallsign(std::string_view term)
+{
+	const char *whitespace = " \t\r\n\f\v";
+
+	size_t first = term.find_first_not_of(whitespace);
+	size_t last = term.find_last_not_of(whitespace);
+
+	if (first != std::string_view::npos)
+	{
+		std::string_view trimmed = term.substr(first, last - first + 1);
+
+		if (isValidBaseCall(trimmed))
+		{
+			std::string output(trimmed);
+			ToUpper(output);
+
+			return output;
+		}
+	}
+
+	std::optional<ParsedCallsign> parsed = parse(term);
+
+	if (!parsed)
+	{
+		return std::nullopt;
+	}
+
+	return std::move(parsed->base);
+}
+
+/**
+ * @brief Normalizes one search term for DXCC lookups.
+ *
+ * DXCC lookups take either an entity number or a callsign. Entity numbers have their leading zeros removed, and
+ * callsigns are kept whole, since the prefix of VE3/W1AW decides its entity.
+ *
+ * @param term The raw search term.
+ * @return The DXCC entity number or callsign to fetch, or std::nullopt if the term is neither.
+ */
+std::optional<std::string> CallsignNormalizer::normalizeDXCCTerm(std::string_view term)
+{
+	std::string cleaned = clean(term);
+
+	bool numeric = !cleaned.empty() && std::all_of(cleaned.begin(), cleaned.end(), [](char c) { return c >= '0' && c <= '9'; });
+
+	if (numeric)
+	{
+		size_t firstNonZero = cleaned.find_first_not_of('0');
+		return (firstNonZero == std::string::npos) ? "0" : cleaned.substr(firstNonZero);
+	}
+
+	if (std::optional<ParsedCallsign> parsed = parse(cleaned))
+	{
+		return parsed->toString();
+	}
+
+	return std::nullopt;
+}
+
+/**
+ * @brief Normalizes search terms for callsign and bio lookups.
+ *
+ * @param terms The raw search terms.
+ * @return The distinct base callsigns to fetch, and the rejected terms.
+ */
+CallsignNormalizer::Result CallsignNormalizer::normalizeCallsigns(const std::vector<std::string> &terms)
+{
+	Result output;
+
+	for (const std::string &term : terms)
+	{
+		std::optional<std::string> normalized = normalizeCallsign(term);
+
+		if (!normalized)
+		{
+			output.rejected.push_back(term);
+		}
+		else if (!output.terms.insert(std::move(*normalized)).second)
+		{
+			output.duplicates++;
+		}
+	}
+
+	return output;
+}
+
+/**
+ * @brief Normalizes search terms for DXCC lookups.
+ *
+ * @param terms The raw search terms.
+ * @return The distinct DXCC entity numbers and callsigns to fetch, and the rejected terms.
+ */
+CallsignNormalizer::Result CallsignNormalizer::normalizeDXCCTerms(const std::vector<std::string> &terms)
+{
+	Result output;
+
+	for (const std::string &term : terms)
+	{
+		std::optional<std::string> normalized = normalizeDXCCTerm(term);
+
+		if (!normalized)
+		{
+			output.rejected.push_back(term);
+		}
+		else if (!output.terms.insert(std::move(*normalized)).second)
+		{
+			output.duplicates++;
+		}
+	}
+
+	return output;
+}
@@ -0,0 +1,271 @@
+#ifndef QRZ_CALLSIGNNORMALIZER_H
+#define QRZ_CALLSIGNNORMALIZER_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace qrz::detail
+{
+	// Character classes used by the callsign DFA
+	enum CharClass : uint8_t
+	{
+		OTHER,
+		LETTER,
+		DIGIT,
+		CHAR_CLASS_COUNT
+	};
+
+	// Callsign DFA states. Every string starts in LETTERS, which also covers the empty string
+	enum class CallsignState : uint8_t
+	{
+		// Only letters seen so far
+		LETTERS,
+		// At least one digit seen, and the last character was a digit
+		DIGIT_LAST,
+		// At least one digit seen, and the last character was a letter. The only accepting state
+		LETTER_AFTER_DIGIT,
+		// An invalid character was seen
+		REJECT,
+		STATE_COUNT
+	};
+
+	using CallsignTransitions = std::array<std::array<CallsignState, CHAR_CLASS_COUNT>, static_cast<size_t>(CallsignState::STATE_COUNT)>;
+
+	/**
+	 * @brief Builds the table mapping every byte to its character class.
+	 *
+	 * @return The character class table.
+	 */
+	constexpr std::array<uint8_t, 256> buildCharClasses()
+	{
+		std::array<uint8_t, 256> table{};
+
+		for (int c = 0; c < 256; ++c)
+		{
+			if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'))
+			{
+				table[c] = LETTER;
+			}
+			else if (c >= '0' && c <= '9')
+			{
+				table[c] = DIGIT;
+			}
+			else
+			{
+				table[c] = OTHER;
+			}
+		}
+
+		return table;
+	}
+
+	/**
+	 * @brief Builds the callsign DFA transition table, indexed by state and character class.
+	 *
+	 * @return The transition table.
+	 */
+	constexpr CallsignTransitions buildCallsignTransitions()
+	{
+		CallsignTransitions table{};
+
+		for (auto &row : table)
+		{
+			row.fill(CallsignState::REJECT);
+		}
+
+		auto set = [&table](CallsignState from, CharClass charClass, CallsignState to)
+		{
+			table[static_cast<size_t>(from)][charClass] = to;
+		};
+
+		set(CallsignState::LETTERS, LETTER, CallsignState::LETTERS);
+		set(CallsignState::LETTERS, DIGIT, CallsignState::DIGIT_LAST);
+		set(CallsignState::DIGIT_LAST, DIGIT, CallsignState::DIGIT_LAST);
+		set(CallsignState::DIGIT_LAST, LETTER, CallsignState::LETTER_AFTER_DIGIT);
+		set(CallsignState::LETTER_AFTER_DIGIT, LETTER, CallsignState::LETTER_AFTER_DIGIT);
+		set(CallsignState::LETTER_AFTER_DIGIT, DIGIT, CallsignState::DIGIT_LAST);
+
+		return table;
+	}
+
+	inline constexpr std::array<uint8_t, 256> charClasses = buildCharClasses();
+
+	inline constexpr CallsignTransitions callsignTransitions = buildCallsignTransitions();
+}
+
+namespace qrz
+{
+	/**
+	 * @brief A callsign split into its parts.
+	 *
+	 * For VE3/W1AW/P the prefix is VE3, the base callsign is W1AW and the suffix is P. Prefix and suffix are empty when
+	 * absent.
+	 */
+	struct ParsedCallsign
+	{
+		std::string prefix;
+		std::string base;
+		std::string suffix;
+
+		/**
+		 * @brief Reassembles the callsign in prefix/base/suffix form.
+		 *
+		 * @return The full callsign.
+		 */
+		std::string toString() const;
+
+		/**
+		 * @brief Returns the part of the callsign that names where the station is operating from.
+		 *
+		 * @return The prefix, as in VE3/W1AW, or else a suffix that names a location, as in W1AW/KH6 or W1AW/MM.
+		 * Empty if the station is operating from its home entity, as in W1AW/P or W1AW/QRP.
+		 */
+		std::string_view locationPart() const;
+
+		bool operator==(const ParsedCallsign &) const = default;
+	};
+
+	/**
+	 * @class CallsignNormalizer
+	 * @brief Normalizes and validates search terms before any request is made.
+	 *
+	 * Terms are trimmed and uppercased, split into prefix, base callsign and suffix, and checked against the shape of
+	 * an amateur radio callsign. Malformed terms are rejected locally, and terms that resolve to the same record are
+	 * collapsed, so dirty input does not cost API calls.
+	 *
+	 * Base callsigns are recognised by a DFA over character classes. The character class table and the transition
+	 * table are built at compile time, so validating a callsign is a single table-driven pass over its characters.
+	 */
+	class CallsignNormalizer
+	{
+	public:
+		/**
+		 * @brief The outcome of normalizing a list of search terms.
+		 */
+		struct Result
+		{
+			// Distinct normalized terms to fetch
+			std::set<std::string> terms;
+
+			// Input terms that were rejected as malformed, in input order
+			std::vector<std::string> rejected;
+
+			// Number of input terms that collapsed into an earlier term
+			size_t duplicates = 0;
+		};
+
+		/**
+		 * @brief Checks whether a string has the shape of a base callsign.
+		 *
+		 * A base callsign is 3 to 10 letters and digits, contains a digit, and ends with a letter that follows the
+		 * last digit, e.g. W1AW, 2E0ABC or 4U1ITU. Lowercase letters are accepted.
+		 *
+		 * @param call The string to check.
+		 * @return True if the string is a plausible base callsign.
+		 */
+		static constexpr bool isValidBaseCall(std::string_view call)
+		{
+			if (call.size() < m_minBaseLength || call.size() > m_maxBaseLength)
+			{
+				return false;
+			}
+
+			detail::CallsignState state = detail::CallsignState::LETTERS;
+
+			for (char c : call)
+			{
+				state = detail::callsignTransitions[static_cast<size_t>(state)][detail::charClasses[static_cast<unsigned char>(c)]];
+			}
+
+			return state == detail::CallsignState::LETTER_AFTER_DIGIT;
+		}
+
+		/**
+		 * @brief Checks whether a string is a valid prefix or suffix designator.
+		 *
+		 * Designators are 1 to 4 letters and digits, e.g. VE3, KH6, P, MM or QRP.
+		 *
+		 * @param designator The string to check.
+		 * @return True if the string is a plausible designator.
+		 */
+		static constexpr bool isValidDesignator(std::string_view designator)
+		{
+			if (designator.empty() || designator.size() > m_maxDesignatorLength)
+			{
+				return false;
+			}
+
+			for (char c : designator)
+			{
+				uint8_t charClass = detail::charClasses[static_cast<unsigned char>(c)];
+
+				if (charClass != detail::LETTER && charClass != detail::DIGIT)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		/**
+		 * @brief Trims and uppercases a search term.
+		 *
+		 * @param term The raw search term.
+		 * @return The trimmed, uppercased term.
+		 */
+		static std::string clean(std::string_view term);
+
+		/**
+		 * @brief Parses a callsign into prefix, base callsign and suffix.
+		 *
+		 * @param term The callsign to parse. It is trimmed and uppercased first.
+		 * @return The parsed callsign, or std::nullopt if the term is not a valid callsign.
+		 */
+		static std::optional<ParsedCallsign> parse(std::string_view term);
+
+		/**
+		 * @brief Normalizes one search term for callsign and bio lookups.
+		 *
+		 * @param term The raw search term.
+		 * @return The base callsign to fetch, or std::nullopt if the term is not a valid callsign.
+		 */
+		static std::optional<std::string> normalizeCallsign(std::string_view term);
+
+		/**
+		 * @brief Normalizes one search term for DXCC lookups.
+		 *
+		 * @param term The raw search term.
+		 * @return The DXCC entity number or callsign to fetch, or std::nullopt if the term is neither.
+		 */
+		static std::optional<std::string> normalizeDXCCTerm(std::string_view term);
+
+		/**
+		 * @brief Normalizes search terms for callsign and bio lookups.
+		 *
+		 * @param terms The raw search terms.
+		 * @return The distinct base callsigns to fetch, and the rejected terms.
+		 */
+		static Result normalizeCallsigns(const std::vector<std::string> &terms);
+
+		/**
+		 * @brief Normalizes search terms for DXCC lookups.
+		 *
+		 * @param terms The raw search terms.
+		 * @return The distinct DXCC entity numbers and callsigns to fetch, and the rejected terms.
+		 */
+		static Result normalizeDXCCTerms(const std::vector<std::string> &terms);
+
+	private:
+		static constexpr size_t m_minBaseLength = 3;
+		static constexpr size_t m_maxBaseLength = 10;
+		static constexpr size_t m_maxDesignatorLength = 4;
+	};
+}
+
+#endif //QRZ_CALLSIGNNORMALIZER_H
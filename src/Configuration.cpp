@@ -1,5 +1,6 @@
 #include "Configuration.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <format>
 #include <iostream>
@@ -12,10 +13,35 @@
 #include <Poco/Crypto/CipherKey.h>
 #include <Poco/Crypto/CipherKeyImpl.h>
 
+#include "FileLock.h"
 #include "Util.h"
 
 using namespace qrz;
 
+namespace
+{
+	/**
+	 * @brief Sets a string setting at the root of a configuration, adding it if it is missing.
+	 *
+	 * @param cfg The configuration.
+	 * @param key The name of the setting.
+	 * @param value The value.
+	 */
+	void setString(libconfig::Config &cfg, const std::string &key, const std::string &value)
+	{
+		if(cfg.exists(key))
+		{
+			libconfig::Setting &setting = cfg.lookup(key);
+			setting = value;
+		}
+		else
+		{
+			libconfig::Setting &root = cfg.getRoot();
+			root.add(key, libconfig::Setting::TypeString) = value;
+		}
+	}
+}
+
 /**
  * @class Configuration
  *
@@ -48,6 +74,14 @@ Configuration::Configuration(const std::string &configDirPath) : configDirPath(c
 	loadConfig();
 }
 
+/**
+ * @brief Wipes the cached plaintext password from memory.
+ */
+Configuration::~Configuration()
+{
+	clearCredentialCache();
+}
+
 /**
  * @brief Returns the callsign value from the configuration.
  *
@@ -63,17 +97,26 @@ std::string Configuration::getCallsign()
 /**
 * @brief Retrieves the password value from the configuration.
 *
-* This function retrieves the password value from the configuration file.
+* This function retrieves the password value from the configuration file. The password is decrypted on first use and
+* then served from memory, so repeated re-authentication does not repeat the crypto setup.
 *
 * @return The password value as a string.
 */
 std::string Configuration::getPassword()
 {
+	if(m_passwordCached)
+	{
+		return m_cachedPassword;
+	}
+
 	if(hasPassword())
 	{
 		try
 		{
-			return decryptPassword(getValue(f_password));
+			m_cachedPassword = decryptPassword(getValue(f_password));
+			m_passwordCached = true;
+
+			return m_cachedPassword;
 		}
 		catch (Poco::IOException &e)
 		{
@@ -119,6 +162,12 @@ std::string Configuration::getSessionExpiration()
  */
 void Configuration::setCallsign(const std::string& callsign)
 {
+	// The cipher key is derived from the callsign, so a new callsign invalidates the cached credentials
+	if(callsign != getCallsign())
+	{
+		clearCredentialCache();
+	}
+
 	setValue(f_callsign, callsign);
 }
 
@@ -135,6 +184,10 @@ void Configuration::setPassword(const std::string& password)
 	try
 	{
 		setValue(f_password, encryptPassword(password));
+
+		SecureWipe(m_cachedPassword);
+		m_cachedPassword = password;
+		m_passwordCached = true;
 	}
 	catch (Poco::IOException &e)
 	{
@@ -255,6 +308,48 @@ std::string Configuration::getConfigFilePath()
 	return format("{:s}\\{:s}", configDirPath, m_fileName);
 }
 
+/**
+ * @brief Retrieves the default path of the country file prefix table.
+ *
+ * The prefix table is a cty.dat or cty.csv file, stored as `cty.dat` in the configuration directory.
+ *
+ * @return The path of the prefix table as a string. The file may not exist.
+ */
+std::string Configuration::getPrefixTablePath()
+{
+	const std::string configDirPath = getConfigDirPath();
+
+	return format("{:s}\\{:s}", configDirPath, m_prefixTableFileName);
+}
+
+/**
+ * @brief Retrieves the path of the local DXCC table.
+ *
+ * The DXCC table is the mirror of the QRZ DXCC entity list, stored as `dxcc.tsv` in the configuration directory.
+ *
+ * @return The path of the DXCC table as a string. The file may not exist.
+ */
+std::string Configuration::getDXCCTablePath()
+{
+	const std::string configDirPath = getConfigDirPath();
+
+	return format("{:s}\\{:s}", configDirPath, m_dxccTableFileName);
+}
+
+/**
+ * @brief Retrieves the path of the lookup cache.
+ *
+ * The lookup cache holds the results of previous QRZ API lookups, stored as `cache.log` in the configuration directory.
+ *
+ * @return The path of the lookup cache as a string. The file may not exist.
+ */
+std::string Configuration::getCachePath()
+{
+	const std::string configDirPath = getConfigDirPath();
+
+	return format("{:s}\\{:s}", configDirPath, m_cacheFileName);
+}
+
 #else
 
 /**
@@ -295,6 +390,48 @@ std::string Configuration::getConfigFilePath()
 	return format("{:s}/{:s}", configDirPath, m_fileName);
 }
 
+/**
+ * @brief Retrieves the default path of the country file prefix table.
+ *
+ * The prefix table is a cty.dat or cty.csv file, stored as `cty.dat` in the configuration directory.
+ *
+ * @return The path of the prefix table as a string. The file may not exist.
+ */
+std::string Configuration::getPrefixTablePath()
+{
+	const std::string configDirPath = getConfigDirPath();
+
+	return format("{:s}/{:s}", configDirPath, m_prefixTableFileName);
+}
+
+/**
+ * @brief Retrieves the path of the local DXCC table.
+ *
+ * The DXCC table is the mirror of the QRZ DXCC entity list, stored as `dxcc.tsv` in the configuration directory.
+ *
+ * @return The path of the DXCC table as a string. The file may not exist.
+ */
+std::string Configuration::getDXCCTablePath()
+{
+	const std::string configDirPath = getConfigDirPath();
+
+	return format("{:s}/{:s}", configDirPath, m_dxccTableFileName);
+}
+
+/**
+ * @brief Retrieves the path of the lookup cache.
+ *
+ * The lookup cache holds the results of previous QRZ API lookups, stored as `cache.log` in the configuration directory.
+ *
+ * @return The path of the lookup cache as a string. The file may not exist.
+ */
+std::string Configuration::getCachePath()
+{
+	const std::string configDirPath = getConfigDirPath();
+
+	return format("{:s}/{:s}", configDirPath, m_cacheFileName);
+}
+
 #endif
 
 /**
@@ -317,12 +454,22 @@ void Configuration::loadConfig()
 /**
  * @brief Saves the current configuration settings to a file.
  *
- * This function saves the current configuration settings to a file. If the configuration
- * directory does not exist, it will be created. The configuration is written using the
- * libconfig library.
+ * This function saves the current configuration settings to a file. Nothing is written unless a value has changed
+ * since the configuration was loaded or last saved. If the configuration directory does not exist, it will be created.
+ *
+ * While holding an exclusive lock on `qrz.cfg.lock`, the file is read again and only the values changed by this
+ * process are merged into it, so values saved by a parallel invocation since this one loaded, such as a session key
+ * it refreshed, are kept. The result is written to a temporary file which is then renamed over `qrz.cfg`. Readers
+ * therefore see either the old or the new file, never a partial one, and parallel invocations cannot interleave
+ * their writes or lose each other's changes. The merged file then becomes this process's configuration.
  */
 void Configuration::saveConfig()
 {
+	if (m_dirtyKeys.empty())
+	{
+		return;
+	}
+
 	std::string configDirPath = getConfigDirPath();
 	std::string configFilePath = getConfigFilePath();
 
@@ -331,7 +478,48 @@ void Configuration::saveConfig()
 		std::filesystem::create_directories(configDirPath);
 	}
 
-	m_cfg.writeFile(configFilePath);
+	FileLock lock(configFilePath + ".lock");
+
+	libconfig::Config merged;
+
+	if (std::filesystem::exists(configFilePath))
+	{
+		merged.readFile(configFilePath);
+	}
+
+	for (const std::string &key : m_dirtyKeys)
+	{
+		setString(merged, key, getValue(key));
+	}
+
+	std::string tempFilePath = configFilePath + ".tmp";
+
+	merged.writeFile(tempFilePath);
+
+	std::filesystem::rename(tempFilePath, configFilePath);
+
+	m_dirtyKeys.clear();
+
+	// Pick up what other invocations saved. The cached password is only kept if the stored one is unchanged
+	std::string storedPassword = getValue(f_password);
+
+	m_cfg.readFile(configFilePath);
+
+	if (getValue(f_password) != storedPassword)
+	{
+		SecureWipe(m_cachedPassword);
+		m_passwordCached = false;
+	}
+}
+
+/**
+ * @brief Checks whether the configuration has unsaved changes.
+ *
+ * @return True if a value has changed since the configuration was loaded or last saved, false otherwise.
+ */
+bool Configuration::isDirty() const
+{
+	return !m_dirtyKeys.empty();
 }
 
 /**
@@ -355,23 +543,23 @@ std::string Configuration::getValue(const std::string& key)
  *
  * This function sets the value associated with the given key in the configuration file.
  * If the key already exists in the configuration, the value will be updated. If the key does not exist,
- * a new key-value pair will be added to the configuration.
+ * a new key-value pair will be added to the configuration. Setting a key to the value it already holds is a no-op,
+ * so that the configuration is only marked dirty by real changes.
  *
  * @param key The key for which the value needs to be set.
  * @param value The value to be associated with the key.
  */
 void Configuration::setValue(const std::string& key, const std::string& value)
 {
-	if(m_cfg.exists(key))
+	std::string current;
+	if(m_cfg.lookupValue(key, current) && current == value)
 	{
-		libconfig::Setting &setting = m_cfg.lookup(key);
-		setting = value;
-	}
-	else
-	{
-		libconfig::Setting &root = m_cfg.getRoot();
-		root.add(key, libconfig::Setting::TypeString) = value;
+		return;
 	}
+
+	setString(m_cfg, key, value);
+
+	m_dirtyKeys.insert(key);
 }
 
 /**
@@ -404,7 +592,7 @@ bool Configuration::hasValue(const std::string& key)
  */
 std::string Configuration::encryptPassword(const std::string &password)
 {
-	Poco::Crypto::Cipher::Ptr cipher = createCipher();
+	Poco::Crypto::Cipher::Ptr cipher = getCipher();
 	return cipher->encryptString(password, Poco::Crypto::Cipher::ENC_BASE64);
 }
 
@@ -419,10 +607,31 @@ std::string Configuration::encryptPassword(const std::string &password)
  */
 std::string Configuration::decryptPassword(const std::string &encrypted)
 {
-	Poco::Crypto::Cipher::Ptr cipher = createCipher();
+	Poco::Crypto::Cipher::Ptr cipher = getCipher();
 	return cipher->decryptString(encrypted, Poco::Crypto::Cipher::ENC_BASE64);
 }
 
+/**
+ * @brief Returns the cipher for the current callsign, creating it on first use.
+ *
+ * Building the cipher derives the passkey from the callsign and sets up an AES-256 key, so the result is cached and
+ * only rebuilt when the callsign changes.
+ *
+ * @return A pointer to the cached instance of Poco::Crypto::Cipher.
+ */
+Poco::Crypto::Cipher::Ptr Configuration::getCipher()
+{
+	std::string callsign = getCallsign();
+
+	if(m_cipher.isNull() || m_cipherCallsign != callsign)
+	{
+		m_cipher = createCipher();
+		m_cipherCallsign = callsign;
+	}
+
+	return m_cipher;
+}
+
 /**
  * @brief Creates an instance of Poco::Crypto::Cipher.
  *
@@ -440,9 +649,27 @@ Poco::Crypto::Cipher::Ptr Configuration::createCipher()
 	Poco::Crypto::CipherKey key("aes-256-cbc", passwordKey, iv);
 	Poco::Crypto::Cipher::Ptr cipher = Poco::Crypto::CipherFactory::defaultFactory().createCipher(key);
 
+	SecureWipe(passkey);
+	std::fill(passwordKey.begin(), passwordKey.end(), 0);
+
 	return cipher;
 }
 
+/**
+ * @brief Drops the cached cipher and wipes the cached password.
+ *
+ * This function is called when the callsign changes, since the cipher key is derived from it, and on destruction so
+ * that the plaintext password does not outlive the process.
+ */
+void Configuration::clearCredentialCache()
+{
+	SecureWipe(m_cachedPassword);
+	m_passwordCached = false;
+
+	m_cipher.reset();
+	m_cipherCallsign.clear();
+}
+
 /**
  * @brief Creates a passkey for encryption/decryption.
  *
@@ -1,6 +1,7 @@
 #ifndef QRZ_CONFIGURATION_H
 #define QRZ_CONFIGURATION_H
 
+#include <set>
 #include <string>
 
 #include <libconfig.h++>
@@ -38,6 +39,11 @@ namespace qrz
 
 		explicit Configuration(const std::string &configDirPath);
 
+		/**
+		 * @brief Wipes the cached plaintext password from memory.
+		 */
+		~Configuration();
+
 		/**
 		 * @brief Returns the callsign value from the configuration.
 		 *
@@ -154,14 +160,59 @@ namespace qrz
 		/**
 		 * @brief Saves the current configuration settings to a file.
 		 *
-		 * This function saves the current configuration settings to a file. If the configuration
-		 * directory does not exist, it will be created.
+		 * This function saves the current configuration settings to a file, but only if a value has changed since
+		 * the configuration was loaded or last saved. If the configuration directory does not exist, it will be created.
+		 * The file is replaced atomically while holding a lock, so concurrent processes never see a partial file.
 		 */
 		void saveConfig();
+
+		/**
+		 * @brief Checks whether the configuration has unsaved changes.
+		 *
+		 * @return True if a value has changed since the configuration was loaded or last saved, false otherwise.
+		 */
+		bool isDirty() const;
+
+		/**
+		 * @brief Retrieves the default path of the country file prefix table.
+		 *
+		 * The prefix table is a cty.dat or cty.csv file, stored as `cty.dat` in the configuration directory.
+		 *
+		 * @return The path of the prefix table as a string. The file may not exist.
+		 */
+		std::string getPrefixTablePath();
+
+		/**
+		 * @brief Retrieves the path of the local DXCC table.
+		 *
+		 * The DXCC table is the mirror of the QRZ DXCC entity list, stored as `dxcc.tsv` in the configuration directory.
+		 *
+		 * @return The path of the DXCC table as a string. The file may not exist.
+		 */
+		std::string getDXCCTablePath();
+
+		/**
+		 * @brief Retrieves the path of the lookup cache.
+		 *
+		 * The lookup cache holds the results of previous QRZ API lookups, stored as `cache.log` in the configuration
+		 * directory.
+		 *
+		 * @return The path of the lookup cache as a string. The file may not exist.
+		 */
+		std::string getCachePath();
 	private:
 		// Name for the config file
 		static inline const char *m_fileName = "qrz.cfg";
 
+		// Name for the country file prefix table
+		static inline const char *m_prefixTableFileName = "cty.dat";
+
+		// Name for the local DXCC table
+		static inline const char *m_dxccTableFileName = "dxcc.tsv";
+
+		// Name for the lookup cache
+		static inline const char *m_cacheFileName = "cache.log";
+
 		// String to use as the initialization vector for password encryption
 		static const std::string ivStr_;
 
@@ -171,6 +222,21 @@ namespace qrz
 		// Path to the directory that contains the config file
 		std::string configDirPath;
 
+		// Keys changed since the configuration was loaded or last saved. Only these are merged into the file on save
+		std::set<std::string> m_dirtyKeys;
+
+		// Cipher used for password encryption, built once per callsign
+		Poco::AutoPtr<Poco::Crypto::Cipher> m_cipher;
+
+		// Callsign the cached cipher was derived from
+		std::string m_cipherCallsign;
+
+		// Decrypted password, held for the life of the process and wiped on destruction
+		std::string m_cachedPassword;
+
+		// Whether m_cachedPassword holds the current password
+		bool m_passwordCached = false;
+
 		// Field names
 		static inline const char *f_callsign = "callsign";
 		static inline const char *f_password = "password";
@@ -190,7 +256,8 @@ namespace qrz
 		/**
 		 * @brief Sets the value associated with the given key in the configuration.
 		 *
-		 * This function sets the value associated with the given key in the configuration file.
+		 * This function sets the value associated with the given key in the configuration file. The configuration is
+		 * only marked dirty if the value actually changes.
 		 *
 		 * @param key The key for which the value needs to be set.
 		 * @param value The value to be associated with the key.
@@ -254,6 +321,15 @@ namespace qrz
 		 */
 		std::string decryptPassword(const std::string &encrypted);
 
+		/**
+		 * @brief Returns the cipher for the current callsign, creating it on first use.
+		 *
+		 * The cipher is cached and only rebuilt when the callsign changes.
+		 *
+		 * @return A pointer to the cached instance of Poco::Crypto::Cipher.
+		 */
+		Poco::AutoPtr<Poco::Crypto::Cipher> getCipher();
+
 		/**
 		 * @brief Creates an instance of Poco::Crypto::Cipher.
 		 *
@@ -263,6 +339,11 @@ namespace qrz
 		 */
 		Poco::AutoPtr<Poco::Crypto::Cipher> createCipher();
 
+		/**
+		 * @brief Drops the cached cipher and wipes the cached password.
+		 */
+		void clearCredentialCache();
+
 		/**
 		 * @brief Creates a passkey for encryption/decryption.
 		 *
@@ -0,0 +1,96 @@
+#include "FileLock.h"
+
+#include <format>
+#include <stdexcept>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+using namespace qrz;
+
+#ifdef WIN32
+/**
+ * @brief Acquires a lock on the given lock file, blocking until it is available.
+ *
+ * On Windows the lock is taken with LockFileEx over the first byte of the lock file.
+ *
+ * @param lockFilePath Path to the lock file. It is created if it does not exist.
+ * @param exclusive True for an exclusive (writer) lock, false for a shared (reader) lock.
+ */
+FileLock::FileLock(const std::string &lockFilePath, bool exclusive)
+{
+	HANDLE handle = CreateFileA(lockFilePath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+								nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		throw std::runtime_error(std::format("Unable to open lock file {:s}", lockFilePath));
+	}
+
+	OVERLAPPED overlapped = {};
+	DWORD flags = exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0;
+
+	if (!LockFileEx(handle, flags, 0, 1, 0, &overlapped))
+	{
+		CloseHandle(handle);
+		throw std::runtime_error(std::format("Unable to lock {:s}", lockFilePath));
+	}
+
+	m_handle = handle;
+}
+
+/**
+ * @brief Releases the lock and closes the lock file.
+ */
+FileLock::~FileLock()
+{
+	if (m_handle != nullptr)
+	{
+		OVERLAPPED overlapped = {};
+		UnlockFileEx(static_cast<HANDLE>(m_handle), 0, 1, 0, &overlapped);
+		CloseHandle(static_cast<HANDLE>(m_handle));
+	}
+}
+#else
+/**
+ * @brief Acquires a lock on the given lock file, blocking until it is available.
+ *
+ * On POSIX systems the lock is taken with flock(), which is released automatically if the process dies.
+ *
+ * @param lockFilePath Path to the lock file. It is created if it does not exist.
+ * @param exclusive True for an exclusive (writer) lock, false for a shared (reader) lock.
+ */
+FileLock::FileLock(const std::string &lockFilePath, bool exclusive)
+{
+	m_fd = ::open(lockFilePath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+
+	if (m_fd < 0)
+	{
+		throw std::runtime_error(std::format("Unable to open lock file {:s}", lockFilePath));
+	}
+
+	if (::flock(m_fd, exclusive ? LOCK_EX : LOCK_SH) != 0)
+	{
+		::close(m_fd);
+		m_fd = -1;
+		throw std::runtime_error(std::format("Unable to lock {:s}", lockFilePath));
+	}
+}
+
+/**
+ * @brief Releases the lock and closes the lock file.
+ */
+FileLock::~FileLock()
+{
+	if (m_fd >= 0)
+	{
+		::flock(m_fd, LOCK_UN);
+		::close(m_fd);
+	}
+}
+#endif
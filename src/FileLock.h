@@ -0,0 +1,51 @@
+#ifndef QRZ_FILELOCK_H
+#define QRZ_FILELOCK_H
+
+#include <string>
+
+namespace qrz
+{
+	/**
+	 * @class FileLock
+	 * @brief RAII advisory lock on a lock file, used to serialize writers across processes.
+	 *
+	 * The lock is acquired in the constructor and released in the destructor. The lock file itself is never removed,
+	 * only locked, so that every process contends on the same inode.
+	 *
+	 * Example Usage:
+	 *
+	 * {
+	 *     FileLock lock("/home/user/.config/qrz/qrz.cfg.lock");
+	 *     // write the protected file
+	 * }
+	 */
+	class FileLock
+	{
+	public:
+		/**
+		 * @brief Acquires a lock on the given lock file, blocking until it is available.
+		 *
+		 * @param lockFilePath Path to the lock file. It is created if it does not exist.
+		 * @param exclusive True for an exclusive (writer) lock, false for a shared (reader) lock.
+		 *
+		 * @throws std::runtime_error If the lock file cannot be opened or locked.
+		 */
+		explicit FileLock(const std::string &lockFilePath, bool exclusive = true);
+
+		~FileLock();
+
+		FileLock(const FileLock &) = delete;
+		FileLock &operator=(const FileLock &) = delete;
+
+	private:
+#ifdef WIN32
+		// Handle to the open lock file
+		void *m_handle = nullptr;
+#else
+		// Descriptor of the open lock file
+		int m_fd = -1;
+#endif
+	};
+}
+
+#endif //QRZ_FILELOCK_H
@@ -0,0 +1,170 @@
+#include "MappedFile.h"
+
+#include <format>
+#include <stdexcept>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace qrz;
+
+#ifdef WIN32
+/**
+ * @brief Maps a file into memory.
+ *
+ * On Windows the file is mapped with CreateFileMapping and MapViewOfFile. The file handle is closed once the view
+ * exists, since the mapping keeps the file open.
+ *
+ * @param path Path of the file.
+ * @param access How the mapping will be read.
+ * @param mode Whether the mapping may be written to.
+ */
+MappedFile::MappedFile(const std::string &path, Access access, Mode mode)
+		: m_writable(mode == Mode::READ_WRITE)
+{
+	DWORD accessFlag = access == Access::RANDOM ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN;
+	DWORD desiredAccess = m_writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+	HANDLE file = CreateFileA(path.c_str(), desiredAccess, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+							  nullptr, OPEN_EXISTING, accessFlag, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		throw std::runtime_error(std::format("Unable to open {:s}", path));
+	}
+
+	LARGE_INTEGER size;
+
+	if (!GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		throw std::runtime_error(std::format("Unable to read the size of {:s}", path));
+	}
+
+	m_size = static_cast<size_t>(size.QuadPart);
+
+	// Empty files cannot be mapped, and have nothing to read
+	if (m_size == 0)
+	{
+		CloseHandle(file);
+		return;
+	}
+
+	m_mapping = CreateFileMappingA(file, nullptr, m_writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+
+	if (m_mapping == nullptr)
+	{
+		throw std::runtime_error(std::format("Unable to map {:s}", path));
+	}
+
+	m_data = static_cast<char *>(MapViewOfFile(m_mapping, m_writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+
+	if (m_data == nullptr)
+	{
+		CloseHandle(m_mapping);
+		throw std::runtime_error(std::format("Unable to map {:s}", path));
+	}
+}
+
+/**
+ * @brief Unmaps the file.
+ */
+MappedFile::~MappedFile()
+{
+	if (m_data != nullptr)
+	{
+		UnmapViewOfFile(m_data);
+		CloseHandle(m_mapping);
+	}
+}
+#else
+/**
+ * @brief Maps a file into memory.
+ *
+ * On POSIX systems the file is mapped with mmap() and the kernel is told how it will be read: sequential mappings
+ * are read ahead aggressively, random ones only page by page. The descriptor is closed once the mapping exists, since
+ * the mapping keeps the file open.
+ *
+ * @param path Path of the file.
+ * @param access How the mapping will be read.
+ * @param mode Whether the mapping may be written to.
+ */
+MappedFile::MappedFile(const std::string &path, Access access, Mode mode)
+		: m_writable(mode == Mode::READ_WRITE)
+{
+	int fd = ::open(path.c_str(), (m_writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+
+	if (fd < 0)
+	{
+		throw std::runtime_error(std::format("Unable to open {:s}", path));
+	}
+
+	struct stat status{};
+
+	if (::fstat(fd, &status) != 0)
+	{
+		::close(fd);
+		throw std::runtime_error(std::format("Unable to read the size of {:s}", path));
+	}
+
+	m_size = static_cast<size_t>(status.st_size);
+
+	// Empty files cannot be mapped, and have nothing to read
+	if (m_size == 0)
+	{
+		::close(fd);
+		return;
+	}
+
+	// Writable mappings are shared, so writes reach the file and the other processes mapping it
+	void *data = m_writable ? ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+							: ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+
+	if (data == MAP_FAILED)
+	{
+		throw std::runtime_error(std::format("Unable to map {:s}", path));
+	}
+
+	::madvise(data, m_size, access == Access::RANDOM ? MADV_RANDOM : MADV_SEQUENTIAL);
+
+	m_data = static_cast<char *>(data);
+}
+
+/**
+ * @brief Unmaps the file.
+ */
+MappedFile::~MappedFile()
+{
+	if (m_data != nullptr)
+	{
+		::munmap(m_data, m_size);
+	}
+}
+#endif
+
+/**
+ * @brief Returns the contents of the file.
+ *
+ * @return The contents, valid for the lifetime of this object. Empty for an empty file.
+ */
+std::string_view MappedFile::view() const
+{
+	return {m_data, m_size};
+}
+
+/**
+ * @brief Returns the contents of the file for writing.
+ *
+ * @return The start of the mapping, or nullptr for a read-only mapping or an empty file.
+ */
+char *MappedFile::writableData() const
+{
+	return m_writable ? m_data : nullptr;
+}
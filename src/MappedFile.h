@@ -0,0 +1,93 @@
+#ifndef QRZ_MAPPEDFILE_H
+#define QRZ_MAPPEDFILE_H
+
+#include <string>
+#include <string_view>
+
+namespace qrz
+{
+	/**
+	 * @class MappedFile
+	 * @brief RAII memory mapping of a whole file.
+	 *
+	 * The file is mapped in the constructor and unmapped in the destructor. Its contents are read straight from the
+	 * page cache, without being copied into a buffer first. Mappings are read-only unless opened with
+	 * Mode::READ_WRITE, in which case writes go to the file and are seen by every process that maps it.
+	 *
+	 * Example Usage:
+	 *
+	 * MappedFile file("calls.txt");
+	 * std::string_view text = file.view();
+	 */
+	class MappedFile
+	{
+	public:
+		/**
+		 * @brief How the mapping will be read, so the kernel can read ahead or not.
+		 */
+		enum class Access
+		{
+			// Front to back, such as a list of terms
+			SEQUENTIAL,
+
+			// At scattered offsets, such as an index searched by key
+			RANDOM
+		};
+
+		/**
+		 * @brief Whether the mapping may be written to.
+		 */
+		enum class Mode
+		{
+			READ_ONLY,
+
+			// Shared with the file, which must be writable
+			READ_WRITE
+		};
+
+		/**
+		 * @brief Maps a file into memory.
+		 *
+		 * @param path Path of the file.
+		 * @param access How the mapping will be read.
+		 * @param mode Whether the mapping may be written to.
+		 *
+		 * @throws std::runtime_error If the file cannot be opened or mapped.
+		 */
+		explicit MappedFile(const std::string &path, Access access = Access::SEQUENTIAL, Mode mode = Mode::READ_ONLY);
+
+		~MappedFile();
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile &operator=(const MappedFile &) = delete;
+
+		/**
+		 * @brief Returns the contents of the file.
+		 *
+		 * @return The contents, valid for the lifetime of this object. Empty for an empty file.
+		 */
+		std::string_view view() const;
+
+		/**
+		 * @brief Returns the contents of the file for writing.
+		 *
+		 * @return The start of the mapping, or nullptr for a read-only mapping or an empty file.
+		 */
+		char *writableData() const;
+
+	private:
+		// Start of the mapping, or nullptr for an empty file
+		char *m_data = nullptr;
+
+		bool m_writable = false;
+
+		size_t m_size = 0;
+
+#ifdef WIN32
+		// Handle to the file mapping object
+		void *m_mapping = nullptr;
+#endif
+	};
+}
+
+#endif //QRZ_MAPPEDFILE_H
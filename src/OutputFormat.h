@@ -12,7 +12,9 @@ namespace qrz
 		CSV,
 		JSON,
 		MD,
-		XML
+		XML,
+		ADIF,
+		TEMPLATE
 	};
 }
 
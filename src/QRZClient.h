@@ -1,16 +1,29 @@
 #ifndef QRZ_QRZCLIENT_H
 #define QRZ_QRZCLIENT_H
 
+#include <algorithm>
+#include <array>
+#include <cctype>
 #include <chrono>
+#include <condition_variable>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <Poco/DateTimeFormatter.h>
 #include <Poco/DateTimeParser.h>
+#include <Poco/CountingStream.h>
 #include <Poco/Exception.h>
+#include <Poco/InflatingStream.h>
 #include <Poco/LocalDateTime.h>
 #include <Poco/StreamCopier.h>
+#include <Poco/String.h>
 #include <Poco/URI.h>
 #include <Poco/DOM/Document.h>
 #include <Poco/DOM/DOMParser.h>
@@ -22,14 +35,27 @@
 #include <Poco/Net/HTTPResponse.h>
 #include <Poco/Net/HTTPSClientSession.h>
 #include <Poco/Net/NameValueCollection.h>
+#include <Poco/Net/NetException.h>
+#include <Poco/Net/SSLException.h>
 #include <Poco/Net/SSLManager.h>
 #include <Poco/SAX/SAXException.h>
 
 #include "exception/AuthenticationException.h"
+#include "exception/DeadlineExceededException.h"
+#include "exception/NotFoundException.h"
+#include "metrics/Registry.h"
 #include "model/Callsign.h"
 #include "model/CallsignMarshaler.h"
 #include "model/DXCC.h"
 #include "model/DXCCMarshaler.h"
+#include "net/AdaptiveConcurrencyLimiter.h"
+#include "net/Deadline.h"
+#include "net/GuardedInputStream.h"
+#include "net/LatencyWindow.h"
+#include "net/PhaseStats.h"
+#include "net/RetryPolicy.h"
+#include "net/TokenBucket.h"
+#include "Util.h"
 
 namespace qrz
 {
@@ -82,6 +108,17 @@ namespace qrz
 	class QRZClient
 	{
 	public:
+		/**
+		 * @brief The QRZ API endpoints, for per-endpoint metrics and hedging.
+		 */
+		enum class Endpoint
+		{
+			CALLSIGN,
+			DXCC,
+			HTML,
+			LOGIN
+		};
+
 		QRZClient() = default;
 
 		/**
@@ -94,10 +131,14 @@ namespace qrz
 		 */
 		explicit QRZClient(Configuration &config)
 		{
+			std::string password = config.getPassword();
+
 			setUsername(config.getCallsign());
-			setPassword(config.getPassword());
+			setPassword(password);
 			setSessionKey(config.getSessionKey());
 			setSessionExpiration(config.getSessionExpiration());
+
+			SecureWipe(password);
 		}
 
 		/**
@@ -120,6 +161,17 @@ namespace qrz
 			setSessionExpiration(sessionExpiration);
 		}
 
+		/**
+		 * @brief Wipes the password from memory.
+		 */
+		virtual ~QRZClient()
+		{
+			SecureWipe(m_password);
+		}
+
+		QRZClient(const QRZClient &) = default;
+		QRZClient &operator=(const QRZClient &) = default;
+
 		/**
 		 * @brief Get the username currently used for authentication with the QRZ API.
 		 *
@@ -163,10 +215,13 @@ namespace qrz
 		 * This method sets the password that is used for authentication with the QRZ API.
 		 * The password is required for making requests to the API.
 		 *
+		 * The previous password is wiped from memory first.
+		 *
 		 * @param password A constant reference to a string representing the password.
 		 */
 		void setPassword(const std::string &password)
 		{
+			SecureWipe(m_password);
 			m_password = password;
 		}
 
@@ -229,91 +284,487 @@ namespace qrz
 		 * @brief Sends a request to the QRZ API and returns the response.
 		 *
 		 * This method sends a request to the QRZ API with the specified URI and returns the response as a QrzResponse
-		 * object.
+		 * object. The connect, send and receive timeouts are applied to the session, each limited to the time left
+		 * before the deadline, so a stuck peer cannot hold the request past it. With phase stats enabled, the connect,
+		 * first byte and transfer phases are timed. With compression enabled, gzip and deflate responses are accepted
+		 * and inflated as they are read, so the compressed body is never buffered.
 		 *
 		 * @param uri The URI of the API endpoint to send the request to.
+		 * @param deadline The deadline for the lookup this request belongs to.
 		 * @return A QrzResponse object containing the HTTP response and body.
+		 * @throws Poco::TimeoutException If a phase of the request timed out.
 		 */
-		virtual QrzResponse sendRequest(Poco::URI &uri)
+		virtual QrzResponse sendRequest(Poco::URI &uri, const net::Deadline &deadline)
 		{
-			std::string path = Poco::format("/xml/%s/", m_apiVersion);
-			uri.setPath(path);
-			uri.addQueryParameter("agent", m_userAgent);
+			return transfer(uri, deadline, nullptr);
+		}
 
-			// Create a session
-			const Poco::Net::Context::Ptr ptrContext = new Poco::Net::Context(Poco::Net::Context::CLIENT_USE, "", "", "", Poco::Net::Context::VERIFY_NONE, 9, false, "ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
-			Poco::Net::HTTPSClientSession session(uri.getHost(), uri.getPort(), ptrContext);
+		/**
+		 * @brief Sends a request to the QRZ API, writing a successful response body to a stream as it is received.
+		 *
+		 * Like sendRequest(), but the body of an HTTP_OK response is decoded straight into the stream in large
+		 * blocks instead of being held in memory, and the returned QrzResponse has an empty body. Error bodies are
+		 * returned as usual.
+		 *
+		 * @param uri The URI of the API endpoint to send the request to.
+		 * @param deadline The deadline for the lookup this request belongs to.
+		 * @param body The stream to write the body to.
+		 * @return A QrzResponse object containing the HTTP response, and the body if the request failed.
+		 * @throws Poco::TimeoutException If a phase of the request timed out.
+		 */
+		virtual QrzResponse streamRequest(Poco::URI &uri, const net::Deadline &deadline, std::ostream &body)
+		{
+			return transfer(uri, deadline, &body);
+		}
 
-			// Prepare a GET request
-			Poco::Net::HTTPRequest request(Poco::Net::HTTPRequest::HTTP_GET, uri.toString());
+		/**
+		 * @brief Sends a request to the QRZ API, retrying transient failures.
+		 *
+		 * All API calls go through this method. Each attempt is made by executeHedged(), which applies the rate and
+		 * concurrency limits and, if enabled, hedges slow requests. Timeouts, network errors and HTTP 408, 429 and 5xx responses are retried with jittered
+		 * exponential backoff, for as long as the retry policy allows; a Retry-After header from the server is
+		 * honoured up to the maximum backoff delay. Other errors are returned or thrown immediately.
+		 *
+		 * No attempt is started, and no backoff is slept, past the deadline.
+		 *
+		 * When the body is streamed, every attempt rewinds the stream to where it started, so a retry overwrites
+		 * any partial body left by a failed attempt. The caller trims the stream to the final body.
+		 *
+		 * @param endpoint The endpoint the request is for.
+		 * @param uri The URI of the API endpoint to send the request to.
+		 * @param deadline The deadline for the lookup this request belongs to.
+		 * @param body The seekable stream to write a successful response body to, or nullptr to return it.
+		 * @return A QrzResponse object containing the HTTP response and body of the last attempt.
+		 * @throws Poco::Exception If the last attempt failed with a network error.
+		 * @throws DeadlineExceededException If the deadline passed or was cancelled before a response was received.
+		 */
+		QrzResponse execute(Endpoint endpoint, Poco::URI &uri, const net::Deadline &deadline = net::Deadline(),
+							std::ostream *body = nullptr)
+		{
+			m_retryPolicy->recordRequest();
 
-			// Send Request
-			session.sendRequest(request);
+			const std::streampos bodyStart = body ? body->tellp() : std::streampos(0);
 
-			// Get the response
-			Poco::Net::HTTPResponse response;
+			for (int attempt = 1;; ++attempt)
+			{
+				throwIfExpired(deadline);
 
-			std::istream& rs = session.receiveResponse(response);
-			std::string body;
-			Poco::StreamCopier::copyToString(rs, body);
+				// sendRequest() adds to the URI, so every attempt starts from a fresh copy
+				Poco::URI attemptUri(uri);
+
+				std::chrono::milliseconds retryAfter{0};
+
+				if (body)
+				{
+					body->clear();
+					body->seekp(bodyStart);
+				}
+
+				try
+				{
+					QrzResponse response = executeHedged(endpoint, attemptUri, deadline, body);
+
+					int status = response.getHttpResponse().getStatus();
+
+					if (!net::RetryPolicy::isRetryableStatus(status) || deadline.expired() || !m_retryPolicy->allowRetry(attempt))
+					{
+						return response;
+					}
+
+					retryAfter = parseRetryAfter(response.getHttpResponse());
+				}
+				catch (Poco::Exception &ex)
+				{
+					if (deadline.expired())
+					{
+						throwIfExpired(deadline);
+					}
+
+					if (!isRetryable(ex) || !m_retryPolicy->allowRetry(attempt))
+					{
+						throw;
+					}
+				}
+
+				std::chrono::milliseconds delay = std::max(m_retryPolicy->backoff(attempt),
+														   std::min(retryAfter, m_retryPolicy->getMaxDelay()));
+
+				if (m_requestMetrics)
+				{
+					m_requestMetrics->retries.increment();
+				}
+
+				deadline.sleepFor(delay);
+			}
+		}
+
+		/**
+		 * @brief Sets the client-side request rate limit.
+		 *
+		 * @param requestsPerSecond Sustained number of requests allowed per second. Also used as the burst size.
+		 */
+		void setRequestRate(double requestsPerSecond)
+		{
+			m_rateLimiter->setRate(requestsPerSecond, requestsPerSecond);
+		}
+
+		/**
+		 * @brief Sets the upper bound for the number of concurrent requests.
+		 *
+		 * The adaptive concurrency limiter never allows more than this many requests in flight.
+		 *
+		 * @param maxConcurrency The maximum number of requests in flight.
+		 */
+		void setMaxConcurrency(int maxConcurrency)
+		{
+			m_concurrencyLimiter->setBounds(1, maxConcurrency);
+		}
+
+		/**
+		 * @brief Get the upper bound for the number of concurrent requests.
+		 *
+		 * @return The maximum number of requests the client will ever have in flight.
+		 */
+		int getMaxConcurrency() const
+		{
+			return m_concurrencyLimiter->getMaxLimit();
+		}
+
+		/**
+		 * @brief Get the current state of the rate limiter.
+		 *
+		 * @return A snapshot of the token bucket.
+		 */
+		net::TokenBucket::Snapshot getRateLimiterSnapshot() const
+		{
+			return m_rateLimiter->snapshot();
+		}
+
+		/**
+		 * @brief Get the current state of the adaptive concurrency limiter.
+		 *
+		 * @return A snapshot of the concurrency limiter.
+		 */
+		net::AdaptiveConcurrencyLimiter::Snapshot getConcurrencySnapshot() const
+		{
+			return m_concurrencyLimiter->snapshot();
+		}
+
+		/**
+		 * @brief Replaces the retry policy.
+		 *
+		 * @param maxAttempts Maximum number of attempts per request, including the first.
+		 * @param baseDelay Upper bound of the delay before the first retry.
+		 * @param maxDelay Upper bound of the delay before any retry.
+		 */
+		void setRetryPolicy(int maxAttempts, std::chrono::milliseconds baseDelay, std::chrono::milliseconds maxDelay)
+		{
+			m_retryPolicy = std::make_shared<net::RetryPolicy>(maxAttempts, baseDelay, maxDelay, m_retryBudgetRatio,
+															   m_minRetryBudget);
+		}
+
+		/**
+		 * @brief Refills the retry budget. Called at the start of every batch of lookups.
+		 */
+		void resetRetryBudget()
+		{
+			m_retryPolicy->resetBudget();
+		}
+
+		/**
+		 * @brief Get the current state of the retry policy.
+		 *
+		 * @return A snapshot of the retry policy.
+		 */
+		net::RetryPolicy::Snapshot getRetrySnapshot() const
+		{
+			return m_retryPolicy->snapshot();
+		}
+
+		/**
+		 * @brief Sets the time allowed to establish a connection.
+		 *
+		 * Like the other socket timeouts, it is further limited by the time left before the lookup deadline.
+		 *
+		 * @param connectTimeout Time allowed to establish the TCP connection and TLS session.
+		 */
+		void setConnectTimeout(std::chrono::milliseconds connectTimeout)
+		{
+			m_connectTimeout = connectTimeout;
+		}
+
+		/**
+		 * @brief Sets the time allowed for each send on the socket.
+		 *
+		 * @param sendTimeout Time allowed for each send.
+		 */
+		void setSendTimeout(std::chrono::milliseconds sendTimeout)
+		{
+			m_sendTimeout = sendTimeout;
+		}
+
+		/**
+		 * @brief Sets the time allowed for each receive on the socket.
+		 *
+		 * @param receiveTimeout Time allowed for each receive.
+		 */
+		void setReceiveTimeout(std::chrono::milliseconds receiveTimeout)
+		{
+			m_receiveTimeout = receiveTimeout;
+		}
+
+		/**
+		 * @brief Sets the time allowed for a whole lookup, including retries and backoff.
+		 *
+		 * @param lookupTimeout The time allowed per lookup. 0 means no limit.
+		 */
+		void setLookupTimeout(std::chrono::milliseconds lookupTimeout)
+		{
+			m_lookupTimeout = lookupTimeout;
+		}
+
+		/**
+		 * @brief Sets the deadline for the current batch of lookups.
+		 *
+		 * Every lookup ends by this deadline, and cancelling it stops every lookup in the batch.
+		 *
+		 * @param batchDeadline The batch deadline. A default-constructed deadline means no limit.
+		 */
+		void setBatchDeadline(const net::Deadline &batchDeadline)
+		{
+			m_batchDeadline = batchDeadline;
+		}
+
+		/**
+		 * @brief Point-in-time view of request hedging, for reporting.
+		 */
+		struct HedgeSnapshot
+		{
+			// Latency percentile after which a hedge is sent, or 0 if hedging is disabled
+			double percentile = 0;
+
+			// Delay after which a hedge of a callsign lookup would currently be sent
+			std::chrono::microseconds delay{0};
+
+			// Number of hedge requests sent
+			uint64_t fired = 0;
+
+			// Number of hedge requests that answered before the original request
+			uint64_t won = 0;
+		};
+
+		/**
+		 * @brief Enables or disables request hedging.
+		 *
+		 * When enabled, a callsign or DXCC request that has not been answered within the given percentile of recent
+		 * latency for its endpoint is duplicated on a second connection, and whichever response arrives first is used.
+		 * This trades a little extra load for a much shorter tail latency. Latency is only kept in memory, so until a
+		 * run has made m_minHedgeSamples requests to an endpoint, including every single-call run, the hedge is sent
+		 * after the fixed m_defaultHedgeDelay instead.
+		 *
+		 * @param percentile The latency percentile, between 0 and 100, after which to send a hedge. 0 disables hedging.
+		 */
+		void setHedgePercentile(double percentile)
+		{
+			std::lock_guard<std::mutex> lock(m_hedging->mutex);
+
+			m_hedging->percentile = std::clamp(percentile, 0.0, 100.0);
+		}
+
+		/**
+		 * @brief Get the request hedging counters.
+		 *
+		 * @return A snapshot of the hedging state.
+		 */
+		HedgeSnapshot getHedgeSnapshot() const
+		{
+			HedgeSnapshot output;
 
-			// Check HTTP response status
-			if (response.getStatus() != Poco::Net::HTTPResponse::HTTP_OK)
 			{
-				std::cerr << "HTTP error: " << response.getStatus() << ' ' << response.getReason() << std::endl;
+				std::lock_guard<std::mutex> lock(m_hedging->mutex);
+
+				output.percentile = m_hedging->percentile;
+				output.fired = m_hedging->fired;
+				output.won = m_hedging->won;
 			}
 
-			QrzResponse output{response, body};
+			output.delay = hedgeDelay(Endpoint::CALLSIGN, output.percentile);
 
 			return output;
 		}
 
+		/**
+		 * @brief Waits for any requests that lost a hedge race to finish.
+		 *
+		 * Losing requests are left to complete in the background so the winner can be returned immediately. This must
+		 * be called before the client is destroyed.
+		 */
+		void waitForHedges()
+		{
+			std::vector<std::future<void>> losers;
+
+			{
+				std::lock_guard<std::mutex> lock(m_hedging->mutex);
+
+				losers.swap(m_hedging->losers);
+			}
+
+			for (std::future<void> &loser : losers)
+			{
+				loser.wait();
+			}
+		}
+
+		/**
+		 * @brief Enables or disables timing of the phases of each request and lookup.
+		 *
+		 * @param phaseStats The stats to record to, or nullptr to disable timing. Shared so the caller can time its
+		 * own phases, such as rendering, alongside the client's.
+		 */
+		void setPhaseStats(std::shared_ptr<net::PhaseStats> phaseStats)
+		{
+			m_phaseStats = std::move(phaseStats);
+		}
+
+		/**
+		 * @brief Enables or disables request metrics.
+		 *
+		 * When enabled, the client records the latency of each lookup per endpoint, the errors per endpoint, the
+		 * number of retries, the number of requests in flight and the hedge requests fired and won in the registry.
+		 *
+		 * @param registry The registry to record to, or nullptr to disable metrics.
+		 */
+		void setMetrics(const std::shared_ptr<metrics::Registry> &registry)
+		{
+			m_requestMetrics = registry ? std::make_shared<RequestMetrics>(*registry) : nullptr;
+		}
+
+		/**
+		 * @brief Get whether compressed responses are requested.
+		 *
+		 * @return True if gzip and deflate responses are accepted.
+		 */
+		bool getCompression() const
+		{
+			return m_compression;
+		}
+
+		/**
+		 * @brief Enables or disables compressed responses.
+		 *
+		 * Callsign and DXCC XML is very repetitive, so compressed responses are a fraction of the size, which matters
+		 * most on slow links. Enabled by default.
+		 *
+		 * @param compression True to accept gzip and deflate responses.
+		 */
+		void setCompression(bool compression)
+		{
+			m_compression = compression;
+		}
+
+		/**
+		 * @brief Reads a response body, inflating it if it is compressed.
+		 *
+		 * The body is inflated as it is read from the stream, so only the decoded body is held in memory.
+		 *
+		 * @param input The response stream.
+		 * @param encoding The Content-Encoding of the response: gzip, deflate, identity or empty.
+		 * @param body The string to store the decoded body in.
+		 * @throws Poco::DataFormatException If the encoding is not supported or the compressed data is corrupt.
+		 */
+		static void readBody(std::istream &input, const std::string &encoding, std::string &body)
+		{
+			decodeBody(input, encoding, [&body](std::istream &decoded)
+			{
+				Poco::StreamCopier::copyToString(decoded, body);
+			});
+		}
+
+		/**
+		 * @brief Reads a response body into a stream, inflating it if it is compressed.
+		 *
+		 * The body is copied in blocks of m_streamBufferSize, so large bodies are written with few, large writes.
+		 *
+		 * @param input The response stream.
+		 * @param encoding The Content-Encoding of the response: gzip, deflate, identity or empty.
+		 * @param body The stream to write the decoded body to.
+		 * @return The number of decoded bytes written.
+		 * @throws Poco::DataFormatException If the encoding is not supported or the compressed data is corrupt.
+		 */
+		static std::streamsize readBody(std::istream &input, const std::string &encoding, std::ostream &body)
+		{
+			std::streamsize written = 0;
+
+			decodeBody(input, encoding, [&body, &written](std::istream &decoded)
+			{
+				written = Poco::StreamCopier::copyStream(decoded, body, m_streamBufferSize);
+			});
+
+			return written;
+		}
+
 		/**
 		 * @brief Fetches a Callsign object for a given callsign string.
 		 *
 		 * This function fetches the callsign information for a given callsign by making a request to the QRZ API.
 		 * If the session key is not valid, it fetches a new token before making the request.
-		 * If the response status is not HTTP_OK, it prints the HTTP error message to standard error output.
-		 * If any Poco exception occurs during the process, it prints the Poco error message to standard error output.
+		 * Transient failures are retried by execute(). If the final response status is not HTTP_OK, or a Poco exception
+		 * is still thrown after retrying, a std::runtime_error describing the failure is thrown. The lookup is bounded
+		 * by the lookup timeout and the batch deadline.
 		 *
 		 * @param call The callsign to fetch information for.
 		 * @return The Callsign object containing the fetched callsign information.
+		 * @throws std::runtime_error If the callsign could not be fetched.
+		 * @throws DeadlineExceededException If the lookup timed out or the batch was cancelled.
+		 * @throws NotFoundException If the QRZ API has no record for the callsign.
 		 */
 		Callsign fetchCallsign(const std::string call)
 		{
+			net::PhaseStats::Timer lookupTimer(m_phaseStats.get(), net::Phase::LOOKUP);
+
 			Callsign callsign;
 			callsign.setCall(call);
 
-			if (!tokenIsValid())
-			{
-				fetchToken();
-			}
+			std::string sessionKey = validSessionKey();
 
 			try
 			{
 				Poco::URI uri(m_baseUrl);
 
 				uri.addQueryParameter("callsign", call);
-				uri.addQueryParameter("s", m_sessionKey);
+				uri.addQueryParameter("s", sessionKey);
 
-				QrzResponse response = sendRequest(uri);
+				QrzResponse response = executeFor(Endpoint::CALLSIGN, uri, m_batchDeadline.narrowed(m_lookupTimeout));
 				const Poco::Net::HTTPResponse &httpResponse = response.getHttpResponse();
 
 				if (httpResponse.getStatus() == Poco::Net::HTTPResponse::HTTP_OK)
 				{
+					net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::PARSE);
+
 					validateResponse(response.getBody());
 
+					timer.next(net::Phase::MARSHAL);
+
 					CallsignMarshaler marshaler;
 					callsign = marshaler.FromXml(response.getBody());
 				}
 				else
 				{
-					std::cerr << "HTTP error: " << httpResponse.getReason() << std::endl;
+					throw std::runtime_error{"HTTP error for " + call + ": " + httpResponse.getReason()};
 				}
 			}
+			catch (DeadlineExceededException &ex)
+			{
+				throw DeadlineExceededException{std::string(ex.what()) + ": " + call};
+			}
+			catch (Poco::TimeoutException &)
+			{
+				throw DeadlineExceededException{"Timed out: " + call};
+			}
 			catch (Poco::Exception& ex)
 			{
-				std::cerr << "Poco error: " << ex.displayText() << std::endl;
+				// Transient errors have already been retried, so report the failure rather than returning an empty record
+				throw std::runtime_error{"Poco error for " + call + ": " + ex.displayText()};
 			}
 
 			return callsign;
@@ -324,18 +775,20 @@ namespace qrz
 		 *
 		 * This method fetches the biography information for the specified callsign by making a request to the QRZ API.
 		 * If the session key is not valid, it fetches a new token before making the request.
-		 * If the response status is not HTTP_OK, it prints an HTTP error message to standard error output.
-		 * If any Poco exception occurs during the process, it prints a Poco error message to standard error output.
+		 * Transient failures are retried by execute(). If the final response status is not HTTP_OK, or a Poco exception
+		 * is still thrown after retrying, a std::runtime_error describing the failure is thrown. The lookup is bounded
+		 * by the lookup timeout and the batch deadline.
 		 *
 		 * @param call The callsign for which to fetch the biography information.
 		 * @return A string containing the fetched biography information.
+		 * @throws std::runtime_error If the biography could not be fetched.
+		 * @throws DeadlineExceededException If the lookup timed out or the batch was cancelled.
 		 */
 		std::string fetchBio(const std::string call)
 		{
-			if (!tokenIsValid())
-			{
-				fetchToken();
-			}
+			net::PhaseStats::Timer lookupTimer(m_phaseStats.get(), net::Phase::LOOKUP);
+
+			std::string sessionKey = validSessionKey();
 
 			std::string output;
 
@@ -344,9 +797,9 @@ namespace qrz
 				Poco::URI uri(m_baseUrl);
 
 				uri.addQueryParameter("html", call);
-				uri.addQueryParameter("s", m_sessionKey);
+				uri.addQueryParameter("s", sessionKey);
 
-				QrzResponse response = sendRequest(uri);
+				QrzResponse response = executeFor(Endpoint::HTML, uri, m_batchDeadline.narrowed(m_lookupTimeout));
 				const Poco::Net::HTTPResponse &httpResponse = response.getHttpResponse();
 
 				if (httpResponse.getStatus() == Poco::Net::HTTPResponse::HTTP_OK)
@@ -355,67 +808,203 @@ namespace qrz
 				}
 				else
 				{
-					std::cerr << "HTTP error: " << httpResponse.getReason() << std::endl;
+					throw std::runtime_error{"HTTP error for " + call + ": " + httpResponse.getReason()};
 				}
 			}
+			catch (DeadlineExceededException &ex)
+			{
+				throw DeadlineExceededException{std::string(ex.what()) + ": " + call};
+			}
+			catch (Poco::TimeoutException &)
+			{
+				throw DeadlineExceededException{"Timed out: " + call};
+			}
 			catch (Poco::Exception& ex)
 			{
-				std::cerr << "Poco error: " << ex.displayText() << std::endl;
+				// Transient errors have already been retried, so report the failure rather than returning an empty record
+				throw std::runtime_error{"Poco error for " + call + ": " + ex.displayText()};
 			}
 
 			return output;
 		}
 
 		/**
-		 * @brief Fetches the DXCC information for a given query string.
+		 * @brief Fetches the biography information for a given callsign, writing it to a stream as it is received.
 		 *
-		 * This function fetches the DXCC information for the specified query by making a request to the QRZ API.
-		 * If the session key is not valid, it fetches a new token before making the request.
-		 * If the response status is not HTTP_OK, it prints an HTTP error message to standard error output.
-		 * If any Poco exception occurs during the process, it prints a Poco error message to standard error output.
+		 * Like fetchBio(const std::string), but the bio HTML is decoded from the socket straight into the stream, so
+		 * it is never held in memory. The stream must be seekable, such as a file: a retry rewinds it to where it
+		 * started, and may leave the tail of an earlier, longer partial body after the bio. Once this returns, the
+		 * bio ends at the stream's put position.
 		 *
-		 * @param query The query string for which to fetch the DXCC information.
-		 * @return The DXCC object containing the fetched DXCC information if successful, otherwise an empty DXCC object.
+		 * @param call The callsign for which to fetch the biography information.
+		 * @param bio The stream to write the bio HTML to.
+		 * @throws std::runtime_error If the biography could not be fetched.
+		 * @throws DeadlineExceededException If the lookup timed out or the batch was cancelled.
 		 */
-		DXCC fetchDXCC(const std::string query)
+		void fetchBio(const std::string call, std::ostream &bio)
 		{
-			DXCC dxcc;
+			net::PhaseStats::Timer lookupTimer(m_phaseStats.get(), net::Phase::LOOKUP);
 
-			if (!tokenIsValid())
+			std::string sessionKey = validSessionKey();
+
+			try
+			{
+				Poco::URI uri(m_baseUrl);
+
+				uri.addQueryParameter("html", call);
+				uri.addQueryParameter("s", sessionKey);
+
+				QrzResponse response = executeFor(Endpoint::HTML, uri, m_batchDeadline.narrowed(m_lookupTimeout), &bio);
+				const Poco::Net::HTTPResponse &httpResponse = response.getHttpResponse();
+
+				if (httpResponse.getStatus() != Poco::Net::HTTPResponse::HTTP_OK)
+				{
+					throw std::runtime_error{"HTTP error for " + call + ": " + httpResponse.getReason()};
+				}
+			}
+			catch (DeadlineExceededException &ex)
+			{
+				throw DeadlineExceededException{std::string(ex.what()) + ": " + call};
+			}
+			catch (Poco::TimeoutException &)
 			{
-				fetchToken();
+				throw DeadlineExceededException{"Timed out: " + call};
 			}
+			catch (Poco::Exception& ex)
+			{
+				// Transient errors have already been retried, so report the failure rather than returning an empty record
+				throw std::runtime_error{"Poco error for " + call + ": " + ex.displayText()};
+			}
+		}
+
+		/**
+		 * @brief Fetches the DXCC information for a given query string.
+		 *
+		 * This function fetches the DXCC information for the specified query by making a request to the QRZ API.
+		 * If the session key is not valid, it fetches a new token before making the request.
+		 * Transient failures are retried by execute(). If the final response status is not HTTP_OK, or a Poco exception
+		 * is still thrown after retrying, a std::runtime_error describing the failure is thrown. The lookup is bounded
+		 * by the lookup timeout and the batch deadline.
+		 *
+		 * @param query The query string for which to fetch the DXCC information.
+		 * @return The DXCC object containing the fetched DXCC information.
+		 * @throws std::runtime_error If the DXCC information could not be fetched.
+		 * @throws DeadlineExceededException If the lookup timed out or the batch was cancelled.
+		 * @throws NotFoundException If the QRZ API has no such DXCC entity.
+		 */
+		DXCC fetchDXCC(const std::string query)
+		{
+			net::PhaseStats::Timer lookupTimer(m_phaseStats.get(), net::Phase::LOOKUP);
+
+			DXCC dxcc;
+
+			std::string sessionKey = validSessionKey();
 
 			try
 			{
 				Poco::URI uri(m_baseUrl);
 
 				uri.addQueryParameter("dxcc", query);
-				uri.addQueryParameter("s", m_sessionKey);
+				uri.addQueryParameter("s", sessionKey);
 
-				QrzResponse response = sendRequest(uri);
+				QrzResponse response = executeFor(Endpoint::DXCC, uri, m_batchDeadline.narrowed(m_lookupTimeout));
 				const Poco::Net::HTTPResponse &httpResponse = response.getHttpResponse();
 
 				if (httpResponse.getStatus() == Poco::Net::HTTPResponse::HTTP_OK)
 				{
+					net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::PARSE);
+
 					validateResponse(response.getBody());
 
+					timer.next(net::Phase::MARSHAL);
+
 					DXCCMarshaler marshaler;
 					dxcc = marshaler.FromXml(response.getBody());
 				}
 				else
 				{
-					std::cerr << "HTTP error: " << httpResponse.getReason() << std::endl;
+					throw std::runtime_error{"HTTP error for " + query + ": " + httpResponse.getReason()};
 				}
 			}
+			catch (DeadlineExceededException &ex)
+			{
+				throw DeadlineExceededException{std::string(ex.what()) + ": " + query};
+			}
+			catch (Poco::TimeoutException &)
+			{
+				throw DeadlineExceededException{"Timed out: " + query};
+			}
 			catch (Poco::Exception& ex)
 			{
-				std::cerr << "Poco error: " << ex.displayText() << std::endl;
+				// Transient errors have already been retried, so report the failure rather than returning an empty record
+				throw std::runtime_error{"Poco error for " + query + ": " + ex.displayText()};
 			}
 
 			return dxcc;
 		}
 
+		/**
+		 * @brief Fetches every DXCC entity in a single request.
+		 *
+		 * This function requests dxcc=all from the QRZ API, which returns the complete entity list, and parses it in
+		 * one pass. It is used to build the local DXCC table, so that later DXCC lookups need no request at all.
+		 * Failures are handled as in fetchDXCC().
+		 *
+		 * @return The DXCC objects for every entity.
+		 * @throws std::runtime_error If the entity list could not be fetched.
+		 * @throws DeadlineExceededException If the request timed out or the batch was cancelled.
+		 */
+		std::vector<DXCC> fetchAllDXCC()
+		{
+			net::PhaseStats::Timer lookupTimer(m_phaseStats.get(), net::Phase::LOOKUP);
+
+			const std::string query = "all";
+
+			std::vector<DXCC> dxccs;
+
+			std::string sessionKey = validSessionKey();
+
+			try
+			{
+				Poco::URI uri(m_baseUrl);
+
+				uri.addQueryParameter("dxcc", query);
+				uri.addQueryParameter("s", sessionKey);
+
+				QrzResponse response = executeFor(Endpoint::DXCC, uri, m_batchDeadline.narrowed(m_lookupTimeout));
+				const Poco::Net::HTTPResponse &httpResponse = response.getHttpResponse();
+
+				if (httpResponse.getStatus() == Poco::Net::HTTPResponse::HTTP_OK)
+				{
+					net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::PARSE);
+
+					validateResponse(response.getBody());
+
+					timer.next(net::Phase::MARSHAL);
+
+					dxccs = DXCCMarshaler::FromXmlList(response.getBody());
+				}
+				else
+				{
+					throw std::runtime_error{"HTTP error for " + query + ": " + httpResponse.getReason()};
+				}
+			}
+			catch (DeadlineExceededException &ex)
+			{
+				throw DeadlineExceededException{std::string(ex.what()) + ": " + query};
+			}
+			catch (Poco::TimeoutException &)
+			{
+				throw DeadlineExceededException{"Timed out: " + query};
+			}
+			catch (Poco::Exception& ex)
+			{
+				throw std::runtime_error{"Poco error for " + query + ": " + ex.displayText()};
+			}
+
+			return dxccs;
+		}
+
 		/**
 		 * @brief Fetches a token from a QRZ API.
 		 *
@@ -434,12 +1023,42 @@ namespace qrz
 		 */
 		void fetchToken()
 		{
+			std::lock_guard<std::mutex> lock(*m_sessionMutex);
+
+			login();
+		}
+
+		/**
+		 * @brief Checks if the token is valid.
+		 *
+		 * This function checks if the session timestamp is greater than the current timestamp.
+		 * If it is, then the token is valid, otherwise it is not.
+		 *
+		 * @return True if the token is valid, false otherwise.
+		 */
+		bool tokenIsValid()
+		{
+			std::lock_guard<std::mutex> lock(*m_sessionMutex);
+
+			return sessionIsCurrent();
+		}
+
+	protected:
+		/**
+		 * @brief Logs in to the QRZ API and stores the session key, for fetchToken() and validSessionKey().
+		 *
+		 * The caller must hold m_sessionMutex.
+		 */
+		void login()
+		{
+			net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::AUTH);
+
 			Poco::URI uri(m_baseUrl);
 
 			uri.addQueryParameter("username", m_username);
 			uri.addQueryParameter("password", m_password);
 
-			QrzResponse response = sendRequest(uri);
+			QrzResponse response = executeFor(Endpoint::LOGIN, uri);
 			const Poco::Net::HTTPResponse &httpResponse = response.getHttpResponse();
 
 			if (httpResponse.getStatus() == Poco::Net::HTTPResponse::HTTP_OK)
@@ -504,21 +1123,37 @@ namespace qrz
 		}
 
 		/**
-		 * @brief Checks if the token is valid.
+		 * @brief Checks whether the session has not yet expired. The caller must hold m_sessionMutex.
 		 *
-		 * This function checks if the session timestamp is greater than the current timestamp.
-		 * If it is, then the token is valid, otherwise it is not.
-		 *
-		 * @return True if the token is valid, false otherwise.
+		 * @return True if the session timestamp is in the future.
 		 */
-		bool tokenIsValid()
+		bool sessionIsCurrent() const
 		{
 			Poco::Timestamp now;
 
 			return (m_sessionTimestamp > now);
 		}
 
-	protected:
+		/**
+		 * @brief Returns the session key for a request, logging in first if the session has expired.
+		 *
+		 * Workers that find the session expired mid-batch wait for the first of them to log in and then use its key,
+		 * so the session is refreshed once rather than once per worker.
+		 *
+		 * @return A copy of the session key, taken under the lock.
+		 */
+		std::string validSessionKey()
+		{
+			std::lock_guard<std::mutex> lock(*m_sessionMutex);
+
+			if (!sessionIsCurrent())
+			{
+				login();
+			}
+
+			return m_sessionKey;
+		}
+
 		// Time format used by the QRZ API
 		static inline const std::string m_timeFormat = "%Y-%m-%d %H:%M:%S";
 
@@ -543,6 +1178,628 @@ namespace qrz
 		// Expiration time for the session token. Estimated to be 24 hours
 		Poco::Timestamp m_sessionTimestamp;
 
+		// Guards the session key and expiration while worker threads use and refresh them. Shared, like the limiters,
+		// so copies of the client stay copyable
+		std::shared_ptr<std::mutex> m_sessionMutex = std::make_shared<std::mutex>();
+
+		// Default sustained request rate, in requests per second
+		static constexpr double m_defaultRequestRate = 10.0;
+
+		// Default upper bound for concurrent requests
+		static constexpr int m_defaultMaxConcurrency = 8;
+
+		// Client-side token bucket limiting the request rate. Shared so copies of the client share one budget
+		std::shared_ptr<net::TokenBucket> m_rateLimiter = std::make_shared<net::TokenBucket>(m_defaultRequestRate, m_defaultRequestRate);
+
+		// AIMD limit on the number of requests in flight
+		std::shared_ptr<net::AdaptiveConcurrencyLimiter> m_concurrencyLimiter = std::make_shared<net::AdaptiveConcurrencyLimiter>(2, 1, m_defaultMaxConcurrency);
+
+		/**
+		 * @brief Shared state for request hedging.
+		 */
+		struct HedgeState
+		{
+			std::mutex mutex;
+
+			// Latency percentile after which a hedge is sent, or 0 if hedging is disabled
+			double percentile = 0;
+
+			uint64_t fired = 0;
+			uint64_t won = 0;
+
+			// Requests that lost a hedge race and are still running
+			std::vector<std::future<void>> losers;
+
+			// Latency of recent successful requests, indexed by Endpoint, so a bio or a login does not move the hedge
+			// delay of a callsign lookup
+			std::array<net::LatencyWindow, 4> latencies{net::LatencyWindow(256), net::LatencyWindow(256),
+														net::LatencyWindow(256), net::LatencyWindow(256)};
+		};
+
+		// Hedge delay used until enough latency samples have been collected
+		static constexpr std::chrono::milliseconds m_defaultHedgeDelay{1000};
+
+		// Number of latency samples needed before the hedge delay follows the configured percentile
+		static constexpr size_t m_minHedgeSamples = 8;
+
+		// Request hedging state. Shared so copies of the client share their latency histories
+		std::shared_ptr<HedgeState> m_hedging = std::make_shared<HedgeState>();
+
+		// Whether gzip and deflate responses are accepted
+		bool m_compression = true;
+
+		// Block size for bodies streamed by streamRequest()
+		static constexpr size_t m_streamBufferSize = 64 * 1024;
+
+		// Time allowed to establish the TCP connection and TLS session
+		std::chrono::milliseconds m_connectTimeout = std::chrono::seconds(10);
+
+		// Time allowed for each send on the socket
+		std::chrono::milliseconds m_sendTimeout = std::chrono::seconds(10);
+
+		// Time allowed for each receive on the socket
+		std::chrono::milliseconds m_receiveTimeout = std::chrono::seconds(30);
+
+		// Time allowed for a whole lookup, including retries and backoff. 0 means no limit
+		std::chrono::milliseconds m_lookupTimeout = std::chrono::seconds(60);
+
+		// Deadline for the batch currently being fetched. Lookup deadlines are derived from it
+		net::Deadline m_batchDeadline;
+
+		// Retries added to the retry budget per request, i.e. at most 20% extra load from retries
+		static constexpr double m_retryBudgetRatio = 0.2;
+
+		// Retries available at the start of every batch
+		static constexpr double m_minRetryBudget = 10.0;
+
+		// Time spent in each phase of requests and lookups, or nullptr when not timed
+		std::shared_ptr<net::PhaseStats> m_phaseStats;
+
+		// Retry policy for transient failures: 4 attempts, backoff from 250ms up to 8s
+		std::shared_ptr<net::RetryPolicy> m_retryPolicy = std::make_shared<net::RetryPolicy>(4, std::chrono::milliseconds(250), std::chrono::seconds(8), m_retryBudgetRatio, m_minRetryBudget);
+
+		/**
+		 * @brief The client's metrics, looked up in the registry once so recording never touches it.
+		 */
+		struct RequestMetrics
+		{
+			explicit RequestMetrics(metrics::Registry &registry)
+				: latency{&lookupLatency(registry, "callsign"), &lookupLatency(registry, "dxcc"),
+						  &lookupLatency(registry, "html"), &lookupLatency(registry, "login")},
+				  errors{&lookupErrors(registry, "callsign"), &lookupErrors(registry, "dxcc"),
+						 &lookupErrors(registry, "html"), &lookupErrors(registry, "login")},
+				  retries(registry.counter("qrz_retries_total", "Requests retried after a transient failure")),
+				  inFlight(registry.gauge("qrz_requests_in_flight", "Requests sent and not yet answered")),
+				  receivedBytes(registry.counter("qrz_response_bytes_total", "Response body bytes, as received and "
+												 "after decompression", {{"encoding", "wire"}})),
+				  decodedBytes(registry.counter("qrz_response_bytes_total", "Response body bytes, as received and "
+												"after decompression", {{"encoding", "decoded"}})),
+				  hedgesFired(registry.counter("qrz_hedges_total", "Hedge requests sent, and those that answered first",
+											   {{"result", "fired"}})),
+				  hedgesWon(registry.counter("qrz_hedges_total", "Hedge requests sent, and those that answered first",
+											 {{"result", "won"}}))
+			{
+			}
+
+			static metrics::Histogram &lookupLatency(metrics::Registry &registry, const std::string &endpoint)
+			{
+				return registry.histogram("qrz_request_duration_seconds", "Time to get an answer from the QRZ API, "
+										  "including retries", {{"endpoint", endpoint}});
+			}
+
+			static metrics::Counter &lookupErrors(metrics::Registry &registry, const std::string &endpoint)
+			{
+				return registry.counter("qrz_request_errors_total", "Requests that failed after any retries",
+										{{"endpoint", endpoint}});
+			}
+
+			// Indexed by Endpoint
+			std::array<metrics::Histogram *, 4> latency;
+			std::array<metrics::Counter *, 4> errors;
+
+			metrics::Counter &retries;
+			metrics::Gauge &inFlight;
+			metrics::Counter &receivedBytes;
+			metrics::Counter &decodedBytes;
+			metrics::Counter &hedgesFired;
+			metrics::Counter &hedgesWon;
+		};
+
+		// Request metrics, or nullptr when disabled. Shared so copies of the client record to the same metrics
+		std::shared_ptr<RequestMetrics> m_requestMetrics;
+
+		/**
+		 * @brief Sends a request to the QRZ API, for sendRequest() and streamRequest().
+		 *
+		 * @param uri The URI of the API endpoint to send the request to.
+		 * @param deadline The deadline for the lookup this request belongs to.
+		 * @param stream The stream to write the body of an HTTP_OK response to, or nullptr to return it.
+		 * @return A QrzResponse object containing the HTTP response, and the body unless it was streamed.
+		 * @throws Poco::TimeoutException If a phase of the request timed out.
+		 * @throws DeadlineExceededException If the deadline passed or was cancelled while the body was being received.
+		 */
+		QrzResponse transfer(Poco::URI &uri, const net::Deadline &deadline, std::ostream *stream)
+		{
+			std::string path = Poco::format("/xml/%s/", m_apiVersion);
+			uri.setPath(path);
+			uri.addQueryParameter("agent", m_userAgent);
+
+			// Create a session
+			const Poco::Net::Context::Ptr ptrContext = new Poco::Net::Context(Poco::Net::Context::CLIENT_USE, "", "", "", Poco::Net::Context::VERIFY_NONE, 9, false, "ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+			Poco::Net::HTTPSClientSession session(uri.getHost(), uri.getPort(), ptrContext);
+
+			session.setTimeout(toTimespan(deadline.clamp(m_connectTimeout)), toTimespan(deadline.clamp(m_sendTimeout)),
+							   toTimespan(deadline.clamp(m_receiveTimeout)));
+
+			// Prepare a GET request
+			Poco::Net::HTTPRequest request(Poco::Net::HTTPRequest::HTTP_GET, uri.toString());
+
+			if (m_compression)
+			{
+				request.set("Accept-Encoding", "gzip, deflate");
+			}
+
+			// The session connects when the request is first sent, so that phase covers DNS, TCP and TLS
+			net::PhaseStats::Timer timer(m_phaseStats.get(), net::Phase::CONNECT);
+
+			// Send Request
+			session.sendRequest(request);
+
+			timer.next(net::Phase::FIRST_BYTE);
+
+			// Get the response
+			Poco::Net::HTTPResponse response;
+
+			std::istream& rs = session.receiveResponse(response);
+
+			timer.next(net::Phase::TRANSFER);
+
+			// A peer that keeps sending slowly never trips the receive timeout, so the deadline is checked and the
+			// timeout narrowed to what is left of it before every receive
+			net::GuardedInputStream guarded(rs, [this, &session, &deadline]()
+			{
+				if (deadline.expired())
+				{
+					return false;
+				}
+
+				session.socket().setReceiveTimeout(toTimespan(deadline.clamp(m_receiveTimeout)));
+
+				return true;
+			});
+
+			std::string body;
+			Poco::CountingInputStream counter(guarded);
+			std::streamsize decoded;
+
+			try
+			{
+				if (stream && response.getStatus() == Poco::Net::HTTPResponse::HTTP_OK)
+				{
+					decoded = readBody(counter, response.get("Content-Encoding", ""), *stream);
+				}
+				else
+				{
+					readBody(counter, response.get("Content-Encoding", ""), body);
+					decoded = static_cast<std::streamsize>(body.size());
+				}
+			}
+			catch (const Poco::Exception &)
+			{
+				// A receive timeout clamped to the deadline is reported as the deadline
+				throwIfExpired(deadline);
+				throw;
+			}
+
+			timer.stop();
+
+			if (guarded.stopped())
+			{
+				throwIfExpired(deadline);
+			}
+
+			if (m_requestMetrics)
+			{
+				m_requestMetrics->receivedBytes.increment(counter.chars());
+				m_requestMetrics->decodedBytes.increment(decoded);
+			}
+
+			// Check HTTP response status
+			if (response.getStatus() != Poco::Net::HTTPResponse::HTTP_OK)
+			{
+				std::cerr << "HTTP error: " << response.getStatus() << ' ' << response.getReason() << std::endl;
+			}
+
+			QrzResponse output{response, body};
+
+			return output;
+		}
+
+		/**
+		 * @brief Sends a request to an endpoint through execute(), recording its latency and any failure.
+		 *
+		 * @param endpoint The endpoint the request is for.
+		 * @param uri The URI of the API endpoint to send the request to.
+		 * @param deadline The deadline for the lookup this request belongs to.
+		 * @param body The seekable stream to write a successful response body to, or nullptr to return it.
+		 * @return A QrzResponse object containing the HTTP response and body of the last attempt.
+		 */
+		QrzResponse executeFor(Endpoint endpoint, Poco::URI &uri, const net::Deadline &deadline = net::Deadline(),
+							   std::ostream *body = nullptr)
+		{
+			if (!m_requestMetrics)
+			{
+				return execute(endpoint, uri, deadline, body);
+			}
+
+			auto index = static_cast<size_t>(endpoint);
+			auto start = std::chrono::steady_clock::now();
+
+			try
+			{
+				QrzResponse response = execute(endpoint, uri, deadline, body);
+
+				m_requestMetrics->latency[index]->record(
+						std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+
+				if (response.getHttpResponse().getStatus() != Poco::Net::HTTPResponse::HTTP_OK)
+				{
+					m_requestMetrics->errors[index]->increment();
+				}
+
+				return response;
+			}
+			catch (...)
+			{
+				m_requestMetrics->errors[index]->increment();
+				throw;
+			}
+		}
+
+		/**
+		 * @brief Sends a single request through the client-side rate limiter and adaptive concurrency limiter.
+		 *
+		 * It waits for a concurrency slot and a rate limiter token, for no longer than the deadline allows, sends the
+		 * request with sendRequest(), or streamRequest() if the body is streamed, and reports the latency and outcome
+		 * back to the concurrency limiter. HTTP 429 and 5xx responses and network errors are reported as overload, and
+		 * Poco timeouts as timeouts, so the limiter backs off when QRZ is struggling.
+		 *
+		 * @param endpoint The endpoint the request is for, whose latency history a success is recorded in.
+		 * @param uri The URI of the API endpoint to send the request to.
+		 * @param deadline The deadline for the lookup this request belongs to.
+		 * @param body The stream to write a successful response body to, or nullptr to return it.
+		 * @return A QrzResponse object containing the HTTP response and body.
+		 * @throws DeadlineExceededException If the deadline passed before the request could be sent.
+		 */
+		QrzResponse executeOnce(Endpoint endpoint, Poco::URI &uri, const net::Deadline &deadline,
+								std::ostream *body = nullptr)
+		{
+			using Outcome = net::AdaptiveConcurrencyLimiter::Outcome;
+
+			throwIfExpired(deadline);
+
+			// The limiters only give up once the deadline has expired, so these always throw
+			if (!m_concurrencyLimiter->acquire(deadline))
+			{
+				throwIfExpired(deadline);
+			}
+
+			if (!m_rateLimiter->acquire(deadline))
+			{
+				m_concurrencyLimiter->releaseUnused();
+				throwIfExpired(deadline);
+			}
+
+			if (m_requestMetrics)
+			{
+				m_requestMetrics->inFlight.add(1);
+			}
+
+			auto start = std::chrono::steady_clock::now();
+
+			auto release = [this, start](Outcome outcome)
+			{
+				auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+				m_concurrencyLimiter->release(outcome, latency);
+
+				if (m_requestMetrics)
+				{
+					m_requestMetrics->inFlight.add(-1);
+				}
+			};
+
+			try
+			{
+				QrzResponse response = body ? streamRequest(uri, deadline, *body) : sendRequest(uri, deadline);
+
+				Poco::Net::HTTPResponse::HTTPStatus status = response.getHttpResponse().getStatus();
+
+				if (status == Poco::Net::HTTPResponse::HTTP_TOO_MANY_REQUESTS || status >= Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR)
+				{
+					release(Outcome::OVERLOAD);
+				}
+				else
+				{
+					release(Outcome::SUCCESS);
+
+					auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+					m_hedging->latencies[static_cast<size_t>(endpoint)].record(latency);
+				}
+
+				return response;
+			}
+			catch (Poco::TimeoutException &)
+			{
+				release(Outcome::TIMEOUT);
+				throw;
+			}
+			catch (...)
+			{
+				release(Outcome::OVERLOAD);
+				throw;
+			}
+		}
+
+		/**
+		 * @brief Sends a single request, hedging it if it is slow.
+		 *
+		 * If hedging is disabled this is just executeOnce(). Otherwise the request is started on a separate thread,
+		 * and if it has not been answered once the hedge delay has passed, a duplicate is started on a second
+		 * connection. The first response to arrive is returned; the other request is left to finish in the
+		 * background and is collected later. If every attempt fails, the last error is rethrown.
+		 *
+		 * Both attempts go through the rate and concurrency limiters, so hedging cannot exceed the configured load.
+		 * Streamed requests are never hedged, since both attempts would write to the same stream. Only callsign and
+		 * DXCC lookups are hedged: bios are large enough that a duplicate costs real bandwidth, and a duplicate login
+		 * would only open a second session.
+		 *
+		 * @param endpoint The endpoint the request is for, whose recent latency sets the hedge delay.
+		 * @param uri The URI of the API endpoint to send the request to.
+		 * @param deadline The deadline for the lookup this request belongs to.
+		 * @param body The stream to write a successful response body to, or nullptr to return it.
+		 * @return A QrzResponse object containing the HTTP response and body of the first response.
+		 */
+		QrzResponse executeHedged(Endpoint endpoint, Poco::URI &uri, const net::Deadline &deadline,
+								  std::ostream *body = nullptr)
+		{
+			double percentile;
+
+			{
+				std::lock_guard<std::mutex> lock(m_hedging->mutex);
+
+				percentile = m_hedging->percentile;
+
+				// Forget the losers of earlier races that have finished by now
+				std::erase_if(m_hedging->losers, [](const std::future<void> &loser)
+				{
+					return loser.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+				});
+			}
+
+			if (percentile <= 0 || body || (endpoint != Endpoint::CALLSIGN && endpoint != Endpoint::DXCC))
+			{
+				return executeOnce(endpoint, uri, deadline, body);
+			}
+
+			struct Race
+			{
+				std::mutex mutex;
+				std::condition_variable done;
+				std::optional<QrzResponse> response;
+				bool hedgeWon = false;
+				int failures = 0;
+				std::exception_ptr error;
+			};
+
+			auto race = std::make_shared<Race>();
+
+			auto attempt = [this, race, endpoint, uri, deadline](bool hedge)
+			{
+				Poco::URI attemptUri(uri);
+
+				try
+				{
+					QrzResponse response = executeOnce(endpoint, attemptUri, deadline);
+
+					std::lock_guard<std::mutex> lock(race->mutex);
+
+					if (!race->response)
+					{
+						race->response = std::move(response);
+						race->hedgeWon = hedge;
+					}
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(race->mutex);
+
+					race->failures++;
+					race->error = std::current_exception();
+				}
+
+				race->done.notify_all();
+			};
+
+			std::vector<std::future<void>> attempts;
+			attempts.push_back(std::async(std::launch::async, attempt, false));
+
+			std::unique_lock<std::mutex> lock(race->mutex);
+
+			auto finished = [&race, &attempts]()
+			{
+				return race->response.has_value() || race->failures == static_cast<int>(attempts.size());
+			};
+
+			std::chrono::microseconds delay = hedgeDelay(endpoint, percentile);
+
+			if (!race->done.wait_for(lock, deadline.clamp(std::chrono::duration_cast<std::chrono::milliseconds>(delay)), finished) &&
+				!deadline.expired())
+			{
+				attempts.push_back(std::async(std::launch::async, attempt, true));
+
+				std::lock_guard<std::mutex> hedgeLock(m_hedging->mutex);
+				m_hedging->fired++;
+
+				if (m_requestMetrics)
+				{
+					m_requestMetrics->hedgesFired.increment();
+				}
+			}
+
+			race->done.wait(lock, finished);
+
+			if (race->hedgeWon)
+			{
+				std::lock_guard<std::mutex> hedgeLock(m_hedging->mutex);
+				m_hedging->won++;
+
+				if (m_requestMetrics)
+				{
+					m_requestMetrics->hedgesWon.increment();
+				}
+			}
+
+			std::optional<QrzResponse> response = std::move(race->response);
+			std::exception_ptr error = race->error;
+
+			lock.unlock();
+
+			// Hand the attempts over instead of letting the futures block here until the slower request finishes
+			{
+				std::lock_guard<std::mutex> hedgeLock(m_hedging->mutex);
+
+				for (std::future<void> &pending : attempts)
+				{
+					m_hedging->losers.push_back(std::move(pending));
+				}
+			}
+
+			if (!response)
+			{
+				std::rethrow_exception(error);
+			}
+
+			return *response;
+		}
+
+		/**
+		 * @brief Computes how long to wait for a response before sending a hedge.
+		 *
+		 * @param endpoint The endpoint the request is for.
+		 * @param percentile The latency percentile to use.
+		 * @return The given percentile of the endpoint's recent latency, or m_defaultHedgeDelay until there are enough
+		 * samples.
+		 */
+		std::chrono::microseconds hedgeDelay(Endpoint endpoint, double percentile) const
+		{
+			std::optional<std::chrono::microseconds> delay =
+					m_hedging->latencies[static_cast<size_t>(endpoint)].percentile(percentile, m_minHedgeSamples);
+
+			return delay.value_or(m_defaultHedgeDelay);
+		}
+
+		/**
+		 * @brief Throws if the deadline has passed or has been cancelled.
+		 *
+		 * @param deadline The deadline to check.
+		 * @throws DeadlineExceededException If work should stop.
+		 */
+		static void throwIfExpired(const net::Deadline &deadline)
+		{
+			if (deadline.cancelled())
+			{
+				throw DeadlineExceededException{"Cancelled"};
+			}
+
+			if (deadline.expired())
+			{
+				throw DeadlineExceededException{"Timed out"};
+			}
+		}
+
+		/**
+		 * @brief Wraps a response stream in an inflating stream if the body is compressed, and passes it on.
+		 *
+		 * @param input The response stream.
+		 * @param encoding The Content-Encoding of the response: gzip, deflate, identity or empty.
+		 * @param copy Called with the stream to read the decoded body from.
+		 * @throws Poco::DataFormatException If the encoding is not supported.
+		 */
+		template<typename Copy>
+		static void decodeBody(std::istream &input, const std::string &encoding, Copy copy)
+		{
+			if (encoding.empty() || Poco::icompare(encoding, "identity") == 0)
+			{
+				copy(input);
+			}
+			else if (Poco::icompare(encoding, "gzip") == 0 || Poco::icompare(encoding, "x-gzip") == 0)
+			{
+				Poco::InflatingInputStream inflater(input, Poco::InflatingStreamBuf::STREAM_GZIP);
+				copy(inflater);
+			}
+			else if (Poco::icompare(encoding, "deflate") == 0)
+			{
+				Poco::InflatingInputStream inflater(input, Poco::InflatingStreamBuf::STREAM_ZLIB);
+				copy(inflater);
+			}
+			else
+			{
+				throw Poco::DataFormatException("Unsupported Content-Encoding", encoding);
+			}
+		}
+
+		/**
+		 * @brief Converts a duration to a Poco::Timespan.
+		 *
+		 * @param duration The duration to convert.
+		 * @return The equivalent Timespan.
+		 */
+		static Poco::Timespan toTimespan(std::chrono::milliseconds duration)
+		{
+			return Poco::Timespan(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+		}
+
+		/**
+		 * @brief Checks whether a failed request is worth retrying.
+		 *
+		 * Timeouts and network errors (refused or reset connections, connections closed without a response) are
+		 * transient. DNS failures and TLS errors are not, since retrying them would just fail again.
+		 *
+		 * @param ex The exception thrown by the request.
+		 * @return True if the request should be retried.
+		 */
+		static bool isRetryable(const Poco::Exception &ex)
+		{
+			if (dynamic_cast<const Poco::Net::DNSException *>(&ex) != nullptr ||
+				dynamic_cast<const Poco::Net::SSLException *>(&ex) != nullptr)
+			{
+				return false;
+			}
+
+			return dynamic_cast<const Poco::TimeoutException *>(&ex) != nullptr ||
+				   dynamic_cast<const Poco::IOException *>(&ex) != nullptr;
+		}
+
+		/**
+		 * @brief Reads the delay requested by a Retry-After header.
+		 *
+		 * Only the delay-seconds form is supported; an HTTP date or a missing header yields zero.
+		 *
+		 * @param response The HTTP response.
+		 * @return The requested delay, or zero.
+		 */
+		static std::chrono::milliseconds parseRetryAfter(const Poco::Net::HTTPResponse &response)
+		{
+			const std::string &value = response.get("Retry-After", "");
+
+			if (value.empty() || !std::all_of(value.begin(), value.end(), [](unsigned char c) { return std::isdigit(c); }))
+			{
+				return std::chrono::milliseconds{0};
+			}
+
+			return std::chrono::seconds(std::stoll(value.substr(0, 9)));
+		}
+
 		/**
 		 * @brief This function validates the response from the QRZDatabase API.
 		 *
@@ -551,6 +1808,7 @@ namespace qrz
 		 * @param responseBody The response body returned by the API.
 		 * @throws std::runtime_error if the XML response is invalid, the session element is not found,
 		 *         or an error element is found with either "Session Timeout" or "Invalid session key" text.
+		 * @throws NotFoundException if the error element reports that there is no such record, e.g. "Not found: W1XYZ".
 		 */
 		static void validateResponse(const std::string &responseBody)
 		{
@@ -580,6 +1838,10 @@ namespace qrz
 					{
 						throw AuthenticationException{errorText};
 					}
+					else if (errorText.starts_with("Not found"))
+					{
+						throw NotFoundException{errorText};
+					}
 					else
 					{
 						throw std::runtime_error{errorText};
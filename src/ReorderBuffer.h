@@ -0,0 +1,150 @@
+#ifndef QRZ_REORDERBUFFER_H
+#define QRZ_REORDERBUFFER_H
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace qrz
+{
+	/**
+	 * @class ReorderBuffer
+	 * @brief Puts results that complete out of order back into input order, as early as possible.
+	 *
+	 * Each input index is settled exactly once, either with a result by push() or without one by skip(). Results are
+	 * emitted in index order as soon as every earlier index has settled, so the head of the line is never held back
+	 * by the batch as a whole. Unordered buffers emit each result as it is pushed.
+	 *
+	 * At most window results are held. If the head of the line is still outstanding when the window fills, the held
+	 * results are emitted past it, and the head is emitted whenever it arrives. This keeps memory bounded, and never
+	 * blocks the workers pushing results, which could deadlock a fetch pass that is waiting for them.
+	 *
+	 * push() and skip() may be called from several threads. Results are emitted on the calling thread, one at a time.
+	 *
+	 * Example Usage:
+	 *
+	 * ReorderBuffer<Callsign> buffer(1024, [&renderer](Callsign &&callsign) { renderer.RenderOne(callsign); });
+	 * buffer.push(1, std::move(second));
+	 * buffer.push(0, std::move(first)); // emits first, then second
+	 *
+	 * @tparam T The type of the results.
+	 */
+	template<typename T>
+	class ReorderBuffer
+	{
+	public:
+		/**
+		 * @brief Creates a buffer.
+		 *
+		 * @param window Most results held back waiting for an earlier index.
+		 * @param emit Called with each result, in order.
+		 * @param ordered False to emit results in completion order instead.
+		 */
+		ReorderBuffer(size_t window, std::function<void(T &&)> emit, bool ordered = true)
+				: m_window(window), m_emit(std::move(emit)), m_ordered(ordered)
+		{
+		}
+
+		/**
+		 * @brief Settles an index with its result.
+		 *
+		 * @param index The input index of the result.
+		 * @param value The result.
+		 */
+		void push(size_t index, T &&value)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			// Unordered results, and heads that were skipped over when the window filled, go straight out
+			if (!m_ordered || index < m_next)
+			{
+				m_emit(std::move(value));
+				return;
+			}
+
+			m_held.emplace(index, std::move(value));
+			drain();
+		}
+
+		/**
+		 * @brief Settles an index that has no result, such as a term that was not found.
+		 *
+		 * @param index The input index.
+		 */
+		void skip(size_t index)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (!m_ordered || index < m_next)
+			{
+				return;
+			}
+
+			m_held.emplace(index, std::nullopt);
+			drain();
+		}
+
+		/**
+		 * @brief Emits every result still held, in index order, whether or not the indices before it have settled.
+		 */
+		void finish()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			for (auto &[index, value] : m_held)
+			{
+				if (value)
+				{
+					m_emit(std::move(*value));
+				}
+
+				m_next = index + 1;
+			}
+
+			m_held.clear();
+		}
+
+	private:
+		/**
+		 * @brief Emits the results at the head of the line, jumping the head forward if the window is full.
+		 */
+		void drain()
+		{
+			if (m_held.size() > m_window)
+			{
+				m_next = m_held.begin()->first;
+			}
+
+			while (!m_held.empty() && m_held.begin()->first == m_next)
+			{
+				auto head = m_held.extract(m_held.begin());
+
+				if (head.mapped())
+				{
+					m_emit(std::move(*head.mapped()));
+				}
+
+				m_next++;
+			}
+		}
+
+		const size_t m_window;
+
+		const std::function<void(T &&)> m_emit;
+
+		const bool m_ordered;
+
+		std::mutex m_mutex;
+
+		// The index at the head of the line, the next to be emitted
+		size_t m_next = 0;
+
+		// Settled indices after the head, and their results, or std::nullopt for skipped indices
+		std::map<size_t, std::optional<T>> m_held;
+	};
+}
+
+#endif //QRZ_REORDERBUFFER_H
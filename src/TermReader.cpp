@@ -0,0 +1,183 @@
+#include "TermReader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "MappedFile.h"
+#include "TermSet.h"
+
+using namespace qrz;
+
+namespace
+{
+	/**
+	 * @brief The terms of one chunk of a list.
+	 */
+	struct Chunk
+	{
+		// Start and end of the chunk. It starts at the beginning of a line and ends after a line break
+		const char *begin = nullptr;
+		const char *end = nullptr;
+
+		// Distinct normalized terms of the chunk
+		TermSet terms;
+
+		// Rejected lines, in chunk order
+		std::vector<std::string> rejected;
+
+		// Number of lines that normalized to a term, including duplicates
+		size_t accepted = 0;
+	};
+
+	/**
+	 * @brief Splits a chunk into lines and normalizes each one.
+	 *
+	 * Line breaks are found with memchr(), which the C library implements with vector instructions, so the scan runs
+	 * many bytes per cycle.
+	 *
+	 * @param chunk The chunk.
+	 * @param normalize Normalizes each line.
+	 */
+	void normalizeChunk(Chunk &chunk, TermReader::Normalizer normalize)
+	{
+		const char *whitespace = " \t\r\n\f\v";
+
+		for (const char *position = chunk.begin; position < chunk.end;)
+		{
+			const auto *lineBreak = static_cast<const char *>(std::memchr(position, '\n', chunk.end - position));
+			const char *lineEnd = (lineBreak != nullptr) ? lineBreak : chunk.end;
+
+			std::string_view line(position, lineEnd - position);
+			position = lineEnd + 1;
+
+			size_t first = line.find_first_not_of(whitespace);
+
+			if (first == std::string_view::npos)
+			{
+				continue;
+			}
+
+			if (std::optional<std::string> term = normalize(line))
+			{
+				chunk.terms.insert(*term);
+				chunk.accepted++;
+			}
+			else
+			{
+				chunk.rejected.emplace_back(line.substr(first, line.find_last_not_of(whitespace) - first + 1));
+			}
+		}
+	}
+}
+
+/**
+ * @brief Reads and normalizes the terms of a file.
+ *
+ * Files are memory mapped, and split into one chunk per core, down to a chunk of m_minChunkSize. Standard input cannot
+ * be mapped, so it is read into memory first.
+ *
+ * @param path Path of the file, or "-" to read standard input.
+ * @param normalize Normalizes each term.
+ * @return The distinct normalized terms, and the rejected lines in file order.
+ */
+CallsignNormalizer::Result TermReader::read(const std::string &path, Normalizer normalize)
+{
+	auto chunksFor = [](size_t size)
+	{
+		size_t cores = std::max(1u, std::thread::hardware_concurrency());
+
+		return std::clamp<size_t>(size / m_minChunkSize, 1, cores);
+	};
+
+	if (path == "-")
+	{
+		std::ostringstream input;
+		input << std::cin.rdbuf();
+
+		std::string text = std::move(input).str();
+
+		return split(text, normalize, chunksFor(text.size()));
+	}
+
+	MappedFile file(path);
+
+	return split(file.view(), normalize, chunksFor(file.view().size()));
+}
+
+/**
+ * @brief Normalizes the terms of a list held in memory.
+ *
+ * Chunk boundaries are moved forward to the next line break, so no line is split between two chunks. The first chunk
+ * is normalized on the calling thread. Rejected lines are concatenated in chunk order, so they keep their list order.
+ *
+ * @param text The list, one term per line.
+ * @param normalize Normalizes each term.
+ * @param chunks Number of chunks to split the list into, each normalized on its own thread.
+ * @return The distinct normalized terms, and the rejected lines in list order.
+ */
+CallsignNormalizer::Result TermReader::split(std::string_view text, Normalizer normalize, size_t chunks)
+{
+	// Every chunk holds at least one byte, so an empty list is a single empty chunk
+	chunks = std::clamp<size_t>(chunks, 1, std::max<size_t>(text.size(), 1));
+
+	std::vector<Chunk> parts(chunks);
+	const char *end = text.data() + text.size();
+	const char *begin = text.data();
+
+	for (size_t i = 0; i < chunks; ++i)
+	{
+		parts[i].begin = begin;
+
+		if (i + 1 == chunks)
+		{
+			parts[i].end = end;
+			break;
+		}
+
+		const char *target = std::max(begin, text.data() + text.size() * (i + 1) / chunks);
+		const auto *lineBreak = static_cast<const char *>(std::memchr(target, '\n', end - target));
+
+		parts[i].end = (lineBreak != nullptr) ? lineBreak + 1 : end;
+		begin = parts[i].end;
+	}
+
+	{
+		std::vector<std::jthread> workers;
+
+		for (size_t i = 1; i < chunks; ++i)
+		{
+			workers.emplace_back(normalizeChunk, std::ref(parts[i]), normalize);
+		}
+
+		normalizeChunk(parts[0], normalize);
+	}
+
+	CallsignNormalizer::Result output;
+	size_t accepted = 0;
+
+	for (size_t i = 1; i < chunks; ++i)
+	{
+		parts[0].terms.merge(parts[i].terms);
+	}
+
+	for (Chunk &part : parts)
+	{
+		accepted += part.accepted;
+		std::move(part.rejected.begin(), part.rejected.end(), std::back_inserter(output.rejected));
+	}
+
+	parts[0].terms.forEach([&output](std::string_view term)
+	{
+		output.terms.emplace(term);
+	});
+
+	output.duplicates = accepted - output.terms.size();
+
+	return output;
+}
@@ -0,0 +1,59 @@
+#ifndef QRZ_TERMREADER_H
+#define QRZ_TERMREADER_H
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "CallsignNormalizer.h"
+
+namespace qrz
+{
+	/**
+	 * @class TermReader
+	 * @brief Reads search terms from a list with one term per line, such as a club roster or a contest log dump.
+	 *
+	 * The file is memory mapped and cut into chunks at line breaks, one per core. Each chunk is split into lines and
+	 * normalized on its own thread, deduplicating into its own TermSet, and the sets are merged at the end, so only
+	 * distinct terms are ever copied into the std::set handed to the lookups. Blank lines are skipped.
+	 *
+	 * Example Usage:
+	 *
+	 * CallsignNormalizer::Result result = TermReader::read("roster.txt", CallsignNormalizer::normalizeCallsign);
+	 */
+	class TermReader
+	{
+	public:
+		/**
+		 * @brief Normalizes one term, returning std::nullopt to reject it.
+		 */
+		using Normalizer = std::optional<std::string> (*)(std::string_view);
+
+		/**
+		 * @brief Reads and normalizes the terms of a file.
+		 *
+		 * @param path Path of the file, or "-" to read standard input.
+		 * @param normalize Normalizes each term.
+		 * @return The distinct normalized terms, and the rejected lines in file order.
+		 *
+		 * @throws std::runtime_error If the file cannot be read.
+		 */
+		static CallsignNormalizer::Result read(const std::string &path, Normalizer normalize);
+
+		/**
+		 * @brief Normalizes the terms of a list held in memory.
+		 *
+		 * @param text The list, one term per line.
+		 * @param normalize Normalizes each term.
+		 * @param chunks Number of chunks to split the list into, each normalized on its own thread.
+		 * @return The distinct normalized terms, and the rejected lines in list order.
+		 */
+		static CallsignNormalizer::Result split(std::string_view text, Normalizer normalize, size_t chunks);
+
+	private:
+		// Smallest chunk worth a thread of its own
+		static constexpr size_t m_minChunkSize = 1 << 20;
+	};
+}
+
+#endif //QRZ_TERMREADER_H
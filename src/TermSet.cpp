@@ -0,0 +1,148 @@
+#include "TermSet.h"
+
+#include <algorithm>
+#include <bit>
+
+using namespace qrz;
+
+/**
+ * @brief Creates an empty set.
+ *
+ * @param expectedSize Number of terms to size the table for.
+ */
+TermSet::TermSet(size_t expectedSize)
+{
+	m_slots.resize(std::bit_ceil(std::max(m_minCapacity, expectedSize * 8 / m_maxLoadEighths + 1)));
+	m_arena.reserve(expectedSize * 8);
+}
+
+/**
+ * @brief Adds a term to the set.
+ *
+ * @param term The term. It must not be empty.
+ * @return True if the term was added, false if it was already in the set.
+ */
+bool TermSet::insert(std::string_view term)
+{
+	return insert(term, hash(term));
+}
+
+/**
+ * @brief Adds every term of another set.
+ *
+ * The other set's stored hashes are reused, so no term is hashed twice.
+ *
+ * @param other The set to merge.
+ * @return The number of terms that were already in this set.
+ */
+size_t TermSet::merge(const TermSet &other)
+{
+	size_t duplicates = 0;
+
+	for (const Slot &slot : other.m_slots)
+	{
+		if (slot.length != 0 &&
+			!insert(std::string_view(other.m_arena.data() + slot.offset, slot.length), slot.hash))
+		{
+			duplicates++;
+		}
+	}
+
+	return duplicates;
+}
+
+/**
+ * @brief Returns the number of terms in the set.
+ *
+ * @return The number of terms.
+ */
+size_t TermSet::size() const
+{
+	return m_size;
+}
+
+/**
+ * @brief Hashes a term with 32 bit FNV-1a.
+ *
+ * @param term The term.
+ * @return The hash.
+ */
+uint32_t TermSet::hash(std::string_view term)
+{
+	uint32_t value = 2166136261u;
+
+	for (char c : term)
+	{
+		value = (value ^ static_cast<unsigned char>(c)) * 16777619u;
+	}
+
+	return value;
+}
+
+/**
+ * @brief Adds a term whose hash is already known.
+ *
+ * Slots are probed linearly from the hash. The stored hash is compared before the characters, so a probe rarely
+ * touches the arena for a term that isn't there.
+ *
+ * @param term The term.
+ * @param termHash The hash of the term.
+ * @return True if the term was added, false if it was already in the set.
+ */
+bool TermSet::insert(std::string_view term, uint32_t termHash)
+{
+	size_t mask = m_slots.size() - 1;
+
+	for (size_t index = termHash & mask;; index = (index + 1) & mask)
+	{
+		Slot &slot = m_slots[index];
+
+		if (slot.length == 0)
+		{
+			slot.hash = termHash;
+			slot.offset = static_cast<uint32_t>(m_arena.size());
+			slot.length = static_cast<uint32_t>(term.size());
+			m_arena.append(term);
+
+			if (++m_size * 8 > m_slots.size() * m_maxLoadEighths)
+			{
+				grow();
+			}
+
+			return true;
+		}
+
+		if (slot.hash == termHash && std::string_view(m_arena.data() + slot.offset, slot.length) == term)
+		{
+			return false;
+		}
+	}
+}
+
+/**
+ * @brief Doubles the table and reinserts every slot, using the stored hashes.
+ */
+void TermSet::grow()
+{
+	std::vector<Slot> slots(m_slots.size() * 2);
+	size_t mask = slots.size() - 1;
+
+	for (const Slot &slot : m_slots)
+	{
+		if (slot.length == 0)
+		{
+			continue;
+		}
+
+		size_t index = slot.hash & mask;
+
+		while (slots[index].length != 0)
+		{
+			index = (index + 1) & mask;
+		}
+
+		slots[index] = slot;
+	}
+
+	m_slots = std::move(slots);
+}
@@ -0,0 +1,118 @@
+#ifndef QRZ_TERMSET_H
+#define QRZ_TERMSET_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace qrz
+{
+	/**
+	 * @class TermSet
+	 * @brief A compact set of short strings, used to deduplicate search terms read from large lists.
+	 *
+	 * The characters of every term are packed into a single arena, and the table itself is an open-addressing array of
+	 * 12 byte slots holding a term's hash, offset and length, probed linearly. A million distinct callsigns take about
+	 * 10 MB, with no allocation per term, where a std::set<std::string> takes several times that.
+	 */
+	class TermSet
+	{
+	public:
+		/**
+		 * @brief Creates an empty set.
+		 *
+		 * @param expectedSize Number of terms to size the table for.
+		 */
+		explicit TermSet(size_t expectedSize = 0);
+
+		/**
+		 * @brief Adds a term to the set.
+		 *
+		 * @param term The term. It must not be empty.
+		 * @return True if the term was added, false if it was already in the set.
+		 */
+		bool insert(std::string_view term);
+
+		/**
+		 * @brief Adds every term of another set.
+		 *
+		 * @param other The set to merge.
+		 * @return The number of terms that were already in this set.
+		 */
+		size_t merge(const TermSet &other);
+
+		/**
+		 * @brief Returns the number of terms in the set.
+		 *
+		 * @return The number of terms.
+		 */
+		size_t size() const;
+
+		/**
+		 * @brief Calls a function with every term, in no particular order.
+		 *
+		 * @param visit Called with each term. The view is valid until the set is next modified.
+		 */
+		template<typename Visitor>
+		void forEach(Visitor &&visit) const
+		{
+			for (const Slot &slot : m_slots)
+			{
+				if (slot.length != 0)
+				{
+					visit(std::string_view(m_arena.data() + slot.offset, slot.length));
+				}
+			}
+		}
+
+	private:
+		/**
+		 * @brief A table entry. Empty slots have a length of 0.
+		 */
+		struct Slot
+		{
+			uint32_t hash = 0;
+			uint32_t offset = 0;
+			uint32_t length = 0;
+		};
+
+		/**
+		 * @brief Hashes a term with 32 bit FNV-1a.
+		 *
+		 * @param term The term.
+		 * @return The hash.
+		 */
+		static uint32_t hash(std::string_view term);
+
+		/**
+		 * @brief Adds a term whose hash is already known.
+		 *
+		 * @param term The term.
+		 * @param termHash The hash of the term.
+		 * @return True if the term was added, false if it was already in the set.
+		 */
+		bool insert(std::string_view term, uint32_t termHash);
+
+		/**
+		 * @brief Doubles the table and reinserts every slot, using the stored hashes.
+		 */
+		void grow();
+
+		// Number of slots before the table first grows
+		static constexpr size_t m_minCapacity = 64;
+
+		// Occupied slots per 8 slots at which the table grows
+		static constexpr size_t m_maxLoadEighths = 6;
+
+		// Slots of the table. Its size is a power of two
+		std::vector<Slot> m_slots;
+
+		// Characters of every term, back to back
+		std::string m_arena;
+
+		size_t m_size = 0;
+	};
+}
+
+#endif //QRZ_TERMSET_H
@@ -119,4 +119,27 @@ namespace qrz
 
 		return ss.str();
 	}
+
+	/**
+	 * @brief Overwrite the contents of a string with zeros and clear it.
+	 *
+	 * This function overwrites every character of the string, including any spare capacity, through a volatile pointer
+	 * so that the compiler cannot elide the stores, and then clears the string. The string is first resized to its
+	 * capacity, which never reallocates, so that the spare capacity is part of the string while it is written.
+	 *
+	 * @param input The string to be wiped.
+	 */
+	void SecureWipe(std::string &input)
+	{
+		input.resize(input.capacity());
+
+		volatile char *p = input.data();
+
+		for (size_t i = 0; i < input.size(); ++i)
+		{
+			p[i] = '\0';
+		}
+
+		input.clear();
+	}
 }
\ No newline at end of file
@@ -49,6 +49,16 @@ namespace qrz
 	 * @return The CSV string representation of the vector.
 	 */
 	extern std::string VectorToCSV(const std::vector<std::string> &vec);
+
+	/**
+	 * @brief Overwrite the contents of a string with zeros and clear it.
+	 *
+	 * This function is used to scrub sensitive values, such as passwords, from memory once they are no longer needed.
+	 * The writes are made through a volatile pointer so that the compiler cannot optimize them away.
+	 *
+	 * @param[in,out] input The string to be wiped.
+	 */
+	extern void SecureWipe(std::string &input);
 }
 
 #endif //QRZ_UTIL_H
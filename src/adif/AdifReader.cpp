@@ -0,0 +1,213 @@
+#include "AdifReader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <format>
+#include <stdexcept>
+
+using namespace qrz;
+using namespace qrz::adif;
+
+namespace
+{
+	using Traits = std::char_traits<char>;
+
+	// Longest tag accepted between < and >, so a stray < cannot swallow the rest of the file
+	constexpr size_t maxTagLength = 256;
+
+	// Largest field data accepted, so a corrupt length cannot exhaust memory
+	constexpr size_t maxDataLength = 16 * 1024 * 1024;
+
+	/**
+	 * @brief Compares a tag name to an upper case name, ignoring case.
+	 *
+	 * @param name The tag name from the file.
+	 * @param upper The upper case name.
+	 * @return True if they are the same name.
+	 */
+	bool isTag(std::string_view name, std::string_view upper)
+	{
+		return std::equal(name.begin(), name.end(), upper.begin(), upper.end(), [](char a, char b)
+		{
+			return std::toupper(static_cast<unsigned char>(a)) == b;
+		});
+	}
+}
+
+/**
+ * @brief Constructs a reader and reads the file header, if there is one.
+ *
+ * Per the ADIF specification, a file has a header unless its first character is '<'. The header runs up to the <EOH>
+ * tag, and may itself contain fields such as ADIF_VER.
+ *
+ * @param input The ADIF stream. It must outlive the reader.
+ * @throws std::runtime_error If the header is malformed.
+ */
+AdifReader::AdifReader(std::istream &input) : m_input(input)
+{
+	Traits::int_type first = m_input.rdbuf()->sgetc();
+
+	if (Traits::eq_int_type(first, Traits::eof()) || Traits::to_char_type(first) == '<')
+	{
+		return;
+	}
+
+	Field field;
+
+	while (readTag(field, &m_header))
+	{
+		if (isTag(field.name, "EOH"))
+		{
+			return;
+		}
+	}
+
+	throw std::runtime_error{"ADIF header has no <EOH> tag"};
+}
+
+/**
+ * @brief Returns the file header, up to and including its <EOH> tag.
+ *
+ * @return The header text, or an empty string if the file has no header.
+ */
+const std::string &AdifReader::header() const
+{
+	return m_header;
+}
+
+/**
+ * @brief Reads the next record.
+ *
+ * A final record with no <EOR> tag is still returned, since some loggers omit it.
+ *
+ * @param record Receives the record's fields.
+ * @return True if a record was read, false at the end of the input.
+ * @throws std::runtime_error If a field is malformed or truncated.
+ */
+bool AdifReader::next(Record &record)
+{
+	record.fields.clear();
+
+	Field field;
+
+	while (readTag(field, nullptr))
+	{
+		if (isTag(field.name, "EOR"))
+		{
+			if (!record.fields.empty())
+			{
+				return true;
+			}
+		}
+		else if (!isTag(field.name, "EOH"))
+		{
+			record.fields.push_back(std::move(field));
+			field = Field{};
+		}
+	}
+
+	return !record.fields.empty();
+}
+
+/**
+ * @brief Reads the next tag and its data, if it has any.
+ *
+ * Tags are <NAME:LENGTH> or <NAME:LENGTH:TYPE> followed by exactly LENGTH bytes of data, or <EOH> and <EOR>, which
+ * have none. Data is read by its length, so it may contain '<' and line breaks.
+ *
+ * @param field Receives the field name, data and type. For <EOH> and <EOR> only the name is set.
+ * @param skipped Receives the raw text read, including the text before the tag, if not null.
+ * @return True if a tag was read, false at the end of the input.
+ * @throws std::runtime_error If the tag is malformed or its data is truncated.
+ */
+bool AdifReader::readTag(Field &field, std::string *skipped)
+{
+	std::streambuf *buffer = m_input.rdbuf();
+	Traits::int_type c;
+
+	// Skip to the start of the next tag
+	while (!Traits::eq_int_type(c = buffer->sbumpc(), Traits::eof()) && Traits::to_char_type(c) != '<')
+	{
+		if (skipped)
+		{
+			skipped->push_back(Traits::to_char_type(c));
+		}
+	}
+
+	if (Traits::eq_int_type(c, Traits::eof()))
+	{
+		return false;
+	}
+
+	std::string tag;
+
+	while (!Traits::eq_int_type(c = buffer->sbumpc(), Traits::eof()) && Traits::to_char_type(c) != '>')
+	{
+		tag.push_back(Traits::to_char_type(c));
+
+		if (tag.size() > maxTagLength)
+		{
+			throw std::runtime_error{std::format("Malformed ADIF tag <{:s}", tag.substr(0, 32))};
+		}
+	}
+
+	if (Traits::eq_int_type(c, Traits::eof()))
+	{
+		throw std::runtime_error{std::format("Unterminated ADIF tag <{:s}", tag)};
+	}
+
+	if (skipped)
+	{
+		skipped->push_back('<');
+		skipped->append(tag);
+		skipped->push_back('>');
+	}
+
+	size_t colon = tag.find(':');
+
+	field.name = tag.substr(0, colon);
+	field.value.clear();
+	field.type.clear();
+
+	if (field.name.empty())
+	{
+		throw std::runtime_error{std::format("Malformed ADIF tag <{:s}>", tag)};
+	}
+
+	if (colon == std::string::npos)
+	{
+		return true;
+	}
+
+	std::string_view spec = std::string_view(tag).substr(colon + 1);
+	size_t typeColon = spec.find(':');
+	std::string_view lengthText = spec.substr(0, typeColon);
+
+	if (typeColon != std::string_view::npos)
+	{
+		field.type = spec.substr(typeColon + 1);
+	}
+
+	size_t length = 0;
+	auto [end, error] = std::from_chars(lengthText.data(), lengthText.data() + lengthText.size(), length);
+
+	if (lengthText.empty() || error != std::errc{} || end != lengthText.data() + lengthText.size() || length > maxDataLength)
+	{
+		throw std::runtime_error{std::format("Malformed ADIF tag <{:s}>", tag)};
+	}
+
+	field.value.resize(length);
+
+	if (buffer->sgetn(field.value.data(), static_cast<std::streamsize>(length)) != static_cast<std::streamsize>(length))
+	{
+		throw std::runtime_error{std::format("Truncated data for ADIF field {:s}", field.name)};
+	}
+
+	if (skipped)
+	{
+		skipped->append(field.value);
+	}
+
+	return true;
+}
@@ -0,0 +1,63 @@
+#ifndef QRZ_ADIFREADER_H
+#define QRZ_ADIFREADER_H
+
+#include <istream>
+#include <string>
+
+#include "AdifRecord.h"
+
+namespace qrz::adif
+{
+	/**
+	 * @class AdifReader
+	 * @brief Reads ADIF (.adi) files one record at a time.
+	 *
+	 * Only the record being read is held in memory, so logs of any size are read in constant memory. The header, if
+	 * the file has one, is kept verbatim so it can be written back unchanged. Text between fields is ignored, as the
+	 * ADIF specification allows.
+	 */
+	class AdifReader
+	{
+	public:
+		/**
+		 * @brief Constructs a reader and reads the file header, if there is one.
+		 *
+		 * @param input The ADIF stream. It must outlive the reader.
+		 * @throws std::runtime_error If the header is malformed.
+		 */
+		explicit AdifReader(std::istream &input);
+
+		/**
+		 * @brief Returns the file header, up to and including its <EOH> tag.
+		 *
+		 * @return The header text, or an empty string if the file has no header.
+		 */
+		const std::string &header() const;
+
+		/**
+		 * @brief Reads the next record.
+		 *
+		 * @param record Receives the record's fields.
+		 * @return True if a record was read, false at the end of the input.
+		 * @throws std::runtime_error If a field is malformed or truncated.
+		 */
+		bool next(Record &record);
+
+	private:
+		std::istream &m_input;
+
+		std::string m_header;
+
+		/**
+		 * @brief Reads the next tag and its data, if it has any.
+		 *
+		 * @param field Receives the field name, data and type. For <EOH> and <EOR> only the name is set.
+		 * @param skipped Receives the raw text read, including the text before the tag, if not null.
+		 * @return True if a tag was read, false at the end of the input.
+		 * @throws std::runtime_error If the tag is malformed or its data is truncated.
+		 */
+		bool readTag(Field &field, std::string *skipped);
+	};
+}
+
+#endif //QRZ_ADIFREADER_H
@@ -0,0 +1,55 @@
+#ifndef QRZ_ADIFRECORD_H
+#define QRZ_ADIFRECORD_H
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace qrz::adif
+{
+	/**
+	 * @brief One ADIF data specifier, e.g. <CALL:4>W1AW.
+	 */
+	struct Field
+	{
+		// Field name, as written in the file
+		std::string name;
+
+		// Field data
+		std::string value;
+
+		// Data type indicator, or empty when the file gave none
+		std::string type;
+	};
+
+	/**
+	 * @brief One ADIF record, i.e. the fields up to an <EOR> tag, in file order.
+	 */
+	struct Record
+	{
+		std::vector<Field> fields;
+
+		/**
+		 * @brief Finds a field by name. ADIF field names are case-insensitive.
+		 *
+		 * @param name The field name.
+		 * @return The field, or nullptr if the record has no such field.
+		 */
+		const Field *find(std::string_view name) const
+		{
+			auto it = std::find_if(fields.begin(), fields.end(), [name](const Field &field)
+			{
+				return std::equal(field.name.begin(), field.name.end(), name.begin(), name.end(), [](char a, char b)
+				{
+					return std::toupper(static_cast<unsigned char>(a)) == std::toupper(static_cast<unsigned char>(b));
+				});
+			});
+
+			return it == fields.end() ? nullptr : &*it;
+		}
+	};
+}
+
+#endif //QRZ_ADIFRECORD_H
@@ -0,0 +1,225 @@
+#include "AdifWriter.h"
+
+#include <charconv>
+#include <cmath>
+#include <format>
+#include <string>
+
+using namespace qrz;
+using namespace qrz::adif;
+
+namespace
+{
+	/**
+	 * @brief Converts a decimal degree coordinate to the ADIF location format, e.g. N041 42.887.
+	 *
+	 * @param decimal The coordinate in decimal degrees, as returned by the QRZ API.
+	 * @param positive Hemisphere letter for positive values, N or E.
+	 * @param negative Hemisphere letter for negative values, S or W.
+	 * @return The ADIF location, or an empty string if the coordinate is missing or invalid.
+	 */
+	std::string toLocation(std::string_view decimal, char positive, char negative)
+	{
+		double degrees = 0;
+		auto [end, error] = std::from_chars(decimal.data(), decimal.data() + decimal.size(), degrees);
+
+		if (decimal.empty() || error != std::errc{} || end != decimal.data() + decimal.size() || std::fabs(degrees) > 180.0)
+		{
+			return "";
+		}
+
+		double magnitude = std::fabs(degrees);
+		int whole = static_cast<int>(magnitude);
+		double minutes = (magnitude - whole) * 60.0;
+
+		// Rounding can carry the minutes up to 60
+		if (minutes >= 59.9995)
+		{
+			whole++;
+			minutes = 0;
+		}
+
+		return std::format("{:c}{:03d} {:06.3f}", degrees < 0 ? negative : positive, whole, minutes);
+	}
+
+	/**
+	 * @brief An ADIF field written for every callsign record.
+	 */
+	struct CallsignTag
+	{
+		// The start of the data specifier, up to the length, e.g. "<NAME:"
+		std::string_view prefix;
+
+		// Stores the field value for a callsign in the buffer, or clears it when there is none
+		void (*value)(const Callsign &, std::string &);
+	};
+
+	/**
+	 * @brief Stores a zone number, or nothing when the zone is unknown.
+	 *
+	 * @param zone The zone, 0 when unknown.
+	 * @param out The value buffer.
+	 */
+	void zoneValue(int zone, std::string &out)
+	{
+		out.clear();
+
+		if (zone > 0)
+		{
+			out.append(std::to_string(zone));
+		}
+	}
+
+	// The fields describing the contacted station, in the order they are written
+	const CallsignTag callsignTags[] = {
+		{"<CALL:", [](const Callsign &c, std::string &out) { out.assign(c.getCall()); }},
+		{"<NAME:", [](const Callsign &c, std::string &out) { out.assign(c.getNameFmt()); }},
+		{"<QTH:", [](const Callsign &c, std::string &out)
+		{
+			out.assign(c.getCity().empty() ? c.getAddr2() : c.getCity());
+		}},
+		{"<STATE:", [](const Callsign &c, std::string &out) { out.assign(c.getState()); }},
+		{"<CNTY:", [](const Callsign &c, std::string &out)
+		{
+			out.clear();
+
+			if (!c.getState().empty() && !c.getCounty().empty())
+			{
+				out.append(c.getState()).append(",").append(c.getCounty());
+			}
+		}},
+		{"<COUNTRY:", [](const Callsign &c, std::string &out) { out.assign(c.getCountry()); }},
+		{"<DXCC:", [](const Callsign &c, std::string &out) { out.assign(c.getDxcc()); }},
+		{"<GRIDSQUARE:", [](const Callsign &c, std::string &out) { out.assign(c.getGrid()); }},
+		{"<CQZ:", [](const Callsign &c, std::string &out) { zoneValue(c.getCqzone(), out); }},
+		{"<ITUZ:", [](const Callsign &c, std::string &out) { zoneValue(c.getItuzone(), out); }},
+		{"<LAT:", [](const Callsign &c, std::string &out) { out.assign(toLocation(c.getLat(), 'N', 'S')); }},
+		{"<LON:", [](const Callsign &c, std::string &out) { out.assign(toLocation(c.getLon(), 'E', 'W')); }},
+		{"<IOTA:", [](const Callsign &c, std::string &out) { out.assign(c.getIota()); }},
+		{"<EMAIL:", [](const Callsign &c, std::string &out) { out.assign(c.getEmail()); }},
+	};
+}
+
+/**
+ * @brief Constructs a writer.
+ *
+ * @param output The stream to write to. It must outlive the writer.
+ */
+AdifWriter::AdifWriter(std::ostream &output) : m_output(output)
+{
+}
+
+/**
+ * @brief Writes a header read by AdifReader, unchanged.
+ *
+ * @param header The header text, including its <EOH> tag. Nothing is written if it is empty.
+ */
+void AdifWriter::writeHeader(std::string_view header)
+{
+	if (!header.empty())
+	{
+		m_output << header << '\n';
+	}
+}
+
+/**
+ * @brief Writes a record, followed by <EOR>.
+ *
+ * @param record The record.
+ */
+void AdifWriter::writeRecord(const Record &record)
+{
+	for (const Field &field : record.fields)
+	{
+		writeField(field);
+	}
+
+	m_output << "<EOR>\n";
+}
+
+/**
+ * @brief Writes the header used for logs this program creates.
+ *
+ * The header text is built once, so writing it is a single stream insertion.
+ */
+void AdifWriter::writeHeader()
+{
+	static const std::string header = std::format("Generated by {}\n<ADIF_VER:{}>{} <PROGRAMID:{}>{} <EOH>\n", m_programId,
+												  m_adifVersion.size(), m_adifVersion, m_programId.size(), m_programId);
+
+	m_output << header;
+}
+
+/**
+ * @brief Writes a callsign record as an ADIF record, followed by <EOR>.
+ *
+ * The fields are written straight from the record through the callsign tag table, whose "<NAME:" prefixes are
+ * constants, so no Field objects are built.
+ *
+ * @param callsign The callsign record.
+ * @param extraFields Additional fields to write before <EOR>, such as joined DXCC data.
+ */
+void AdifWriter::writeCallsign(const Callsign &callsign, const std::vector<Field> &extraFields)
+{
+	for (const CallsignTag &tag : callsignTags)
+	{
+		tag.value(callsign, m_value);
+
+		if (!m_value.empty())
+		{
+			m_output << tag.prefix << m_value.size() << '>' << m_value << ' ';
+		}
+	}
+
+	for (const Field &field : extraFields)
+	{
+		writeField(field);
+	}
+
+	m_output << "<EOR>\n";
+}
+
+/**
+ * @brief Maps a QRZ callsign record to the ADIF fields describing the contacted station.
+ *
+ * Fields the QRZ record has no value for are left out. Zones of 0 mean the zone is unknown, and coordinates are
+ * converted from decimal degrees to the ADIF location format.
+ *
+ * @param callsign The callsign record.
+ * @return The fields, e.g. NAME, QTH, GRIDSQUARE, CQZ and ITUZ.
+ */
+std::vector<Field> AdifWriter::callsignFields(const Callsign &callsign)
+{
+	std::vector<Field> fields;
+	std::string value;
+
+	for (const CallsignTag &tag : callsignTags)
+	{
+		tag.value(callsign, value);
+
+		if (!value.empty())
+		{
+			// The prefix is "<NAME:"
+			fields.push_back(Field{std::string(tag.prefix.substr(1, tag.prefix.size() - 2)), value, ""});
+		}
+	}
+
+	return fields;
+}
+
+/**
+ * @brief Writes one field as a length-prefixed data specifier.
+ *
+ * @param field The field.
+ */
+void AdifWriter::writeField(const Field &field)
+{
+	m_output << '<' << field.name << ':' << field.value.size();
+
+	if (!field.type.empty())
+	{
+		m_output << ':' << field.type;
+	}
+
+	m_output << '>' << field.value << ' ';
+}
@@ -0,0 +1,88 @@
+#ifndef QRZ_ADIFWRITER_H
+#define QRZ_ADIFWRITER_H
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "AdifRecord.h"
+#include "../model/Callsign.h"
+
+namespace qrz::adif
+{
+	/**
+	 * @class AdifWriter
+	 * @brief Writes ADIF (.adi) files one record at a time.
+	 *
+	 * Each record is written as soon as it is complete, on a line of its own, so output is streamed in constant memory.
+	 */
+	class AdifWriter
+	{
+	public:
+		/**
+		 * @brief Constructs a writer.
+		 *
+		 * @param output The stream to write to. It must outlive the writer.
+		 */
+		explicit AdifWriter(std::ostream &output);
+
+		/**
+		 * @brief Writes a header read by AdifReader, unchanged.
+		 *
+		 * @param header The header text, including its <EOH> tag. Nothing is written if it is empty.
+		 */
+		void writeHeader(std::string_view header);
+
+		/**
+		 * @brief Writes the header used for logs this program creates.
+		 */
+		void writeHeader();
+
+		/**
+		 * @brief Writes a callsign record as an ADIF record, followed by <EOR>.
+		 *
+		 * @param callsign The callsign record.
+		 * @param extraFields Additional fields to write before <EOR>, such as joined DXCC data.
+		 */
+		void writeCallsign(const Callsign &callsign, const std::vector<Field> &extraFields = {});
+
+		/**
+		 * @brief Writes a record, followed by <EOR>.
+		 *
+		 * @param record The record.
+		 */
+		void writeRecord(const Record &record);
+
+		/**
+		 * @brief Maps a QRZ callsign record to the ADIF fields describing the contacted station.
+		 *
+		 * Fields the QRZ record has no value for are left out.
+		 *
+		 * @param callsign The callsign record.
+		 * @return The fields, e.g. NAME, QTH, GRIDSQUARE, CQZ and ITUZ.
+		 */
+		static std::vector<Field> callsignFields(const Callsign &callsign);
+
+	private:
+		// ADIF version the generated header declares
+		static constexpr std::string_view m_adifVersion = "3.1.4";
+
+		// Program name the generated header declares
+		static constexpr std::string_view m_programId = "qrz";
+
+		std::ostream &m_output;
+
+		// Buffer for field values, reused across records
+		std::string m_value;
+
+		/**
+		 * @brief Writes one field as a length-prefixed data specifier.
+		 *
+		 * @param field The field.
+		 */
+		void writeField(const Field &field);
+	};
+}
+
+#endif //QRZ_ADIFWRITER_H
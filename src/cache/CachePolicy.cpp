@@ -0,0 +1,148 @@
+#include "CachePolicy.h"
+
+#include <charconv>
+#include <format>
+#include <stdexcept>
+#include <string>
+
+using namespace qrz;
+using namespace qrz::cache;
+
+/**
+ * @brief Returns the name of a record type, as used on the command line and in statistics.
+ *
+ * @param type The record type.
+ * @return The name, e.g. "callsign".
+ */
+std::string_view cache::recordTypeName(RecordType type)
+{
+	switch (type)
+	{
+		case RecordType::CALLSIGN:
+			return "callsign";
+		case RecordType::DXCC:
+			return "dxcc";
+		case RecordType::BIO:
+			return "bio";
+	}
+
+	return "unknown";
+}
+
+/**
+ * @brief Classifies a cached entry by its age.
+ *
+ * @param age Time since the entry was fetched. Entries from the future, written by a host with a fast clock, are
+ * treated as just fetched.
+ * @param notFound Whether the entry records a "not found" answer.
+ * @return Whether the entry is fresh, stale or expired.
+ */
+Freshness CachePolicy::classify(std::chrono::seconds age, bool notFound) const
+{
+	if (notFound)
+	{
+		return age <= notFoundMaxAge && notFoundMaxAge.count() > 0 ? Freshness::FRESH : Freshness::EXPIRED;
+	}
+
+	if (age <= maxAge)
+	{
+		return Freshness::FRESH;
+	}
+
+	return age <= maxAge + staleFor ? Freshness::STALE : Freshness::EXPIRED;
+}
+
+/**
+ * @brief Returns the policy of a record type.
+ *
+ * @param type The record type.
+ * @return The policy.
+ */
+const CachePolicy &CachePolicies::get(RecordType type) const
+{
+	return m_policies[static_cast<size_t>(type)];
+}
+
+/**
+ * @brief Changes the policy of one record type from a specification.
+ *
+ * The settings are checked before any of them is applied, so a bad specification leaves the policy unchanged.
+ *
+ * @param spec The specification, e.g. "dxcc=max-age:2592000,not-found:0".
+ * @throws std::invalid_argument If the specification names an unknown type or key, or a value is not a number.
+ */
+void CachePolicies::apply(std::string_view spec)
+{
+	size_t equals = spec.find('=');
+
+	if (equals == std::string_view::npos)
+	{
+		throw std::invalid_argument{std::format("Expected type=key:value,... in {:s}", spec)};
+	}
+
+	std::string_view typeName = spec.substr(0, equals);
+	CachePolicy *policy = nullptr;
+
+	for (RecordType type : {RecordType::CALLSIGN, RecordType::DXCC, RecordType::BIO})
+	{
+		if (recordTypeName(type) == typeName)
+		{
+			policy = &m_policies[static_cast<size_t>(type)];
+		}
+	}
+
+	if (policy == nullptr)
+	{
+		throw std::invalid_argument{std::format("Unknown record type {:s}, expected callsign, dxcc or bio", typeName)};
+	}
+
+	CachePolicy updated = *policy;
+	std::string_view settings = spec.substr(equals + 1);
+
+	while (!settings.empty())
+	{
+		size_t comma = settings.find(',');
+		std::string_view setting = settings.substr(0, comma);
+		settings = comma == std::string_view::npos ? std::string_view() : settings.substr(comma + 1);
+
+		size_t colon = setting.find(':');
+		std::string_view key = setting.substr(0, colon);
+		std::string_view value = colon == std::string_view::npos ? std::string_view() : setting.substr(colon + 1);
+
+		int64_t number = 0;
+		auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), number);
+
+		if (value.empty() || error != std::errc{} || end != value.data() + value.size() || number < 0)
+		{
+			throw std::invalid_argument{std::format("Expected a number in {:s}", setting)};
+		}
+
+		if (key == "max-age")
+		{
+			updated.maxAge = std::chrono::seconds(number);
+		}
+		else if (key == "stale")
+		{
+			updated.staleFor = std::chrono::seconds(number);
+		}
+		else if (key == "not-found")
+		{
+			updated.notFoundMaxAge = std::chrono::seconds(number);
+		}
+		else if (key == "max-entries")
+		{
+			updated.maxEntries = static_cast<uint64_t>(number);
+		}
+		else if (key == "max-bytes")
+		{
+			updated.maxBytes = static_cast<uint64_t>(number);
+		}
+		else
+		{
+			throw std::invalid_argument{std::format(
+					"Unknown setting {:s}, expected max-age, stale, not-found, max-entries or max-bytes", key)};
+		}
+	}
+
+	*policy = updated;
+}
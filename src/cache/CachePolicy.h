@@ -0,0 +1,140 @@
+#ifndef QRZ_CACHEPOLICY_H
+#define QRZ_CACHEPOLICY_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace qrz::cache
+{
+	/**
+	 * @brief The kinds of record held in the cache. Each has its own key space.
+	 */
+	enum class RecordType : uint8_t
+	{
+		CALLSIGN,
+		DXCC,
+		BIO
+	};
+
+	// Number of record types, for tables indexed by RecordType
+	constexpr size_t recordTypeCount = 3;
+
+	/**
+	 * @brief Returns the name of a record type, as used on the command line and in statistics.
+	 *
+	 * @param type The record type.
+	 * @return The name, e.g. "callsign".
+	 */
+	std::string_view recordTypeName(RecordType type);
+
+	/**
+	 * @brief How a cached entry may be used, according to its age.
+	 */
+	enum class Freshness : uint8_t
+	{
+		// Served as it is
+		FRESH,
+
+		// Served, and fetched again to replace it
+		STALE,
+
+		// Not served, and fetched again
+		EXPIRED
+	};
+
+	/**
+	 * @struct CachePolicy
+	 * @brief How long the cached entries of one record type are used, and how many are kept.
+	 *
+	 * An entry is fresh up to maxAge. For staleFor after that it is stale: it is still served, and it is refreshed
+	 * from the QRZ API in the same run. "Not found" answers are kept for notFoundMaxAge, and never served stale, so a
+	 * new call is found soon after it is issued.
+	 *
+	 * When the cache is compacted, expired entries are dropped, and entries are evicted until the type is within
+	 * maxEntries and maxBytes.
+	 */
+	struct CachePolicy
+	{
+		// Age up to which an entry is fresh
+		std::chrono::seconds maxAge{0};
+
+		// How long past maxAge an entry is served while it is refreshed. 0 disables stale-while-revalidate
+		std::chrono::seconds staleFor{0};
+
+		// Age up to which a "not found" answer is served. 0 disables negative caching
+		std::chrono::seconds notFoundMaxAge{0};
+
+		// Most entries kept. 0 for no limit
+		uint64_t maxEntries = 0;
+
+		// Most bytes of keys and values kept. 0 for no limit
+		uint64_t maxBytes = 0;
+
+		/**
+		 * @brief Classifies a cached entry by its age.
+		 *
+		 * @param age Time since the entry was fetched.
+		 * @param notFound Whether the entry records a "not found" answer.
+		 * @return Whether the entry is fresh, stale or expired.
+		 */
+		Freshness classify(std::chrono::seconds age, bool notFound) const;
+	};
+
+	/**
+	 * @class CachePolicies
+	 * @brief The cache policy of every record type.
+	 *
+	 * Each type starts with a default suited to how often its records change: callsign records are fresh for a week,
+	 * DXCC entities for a month and bios for a year, since a bio is only used while its biodate matches anyway. The
+	 * sizes are limited so the whole cache stays under about 1.5 GiB, and the number of entries is not.
+	 *
+	 * Example Usage:
+	 *
+	 * CachePolicies policies;
+	 * policies.apply("callsign=max-age:86400,stale:604800");
+	 * policies.get(RecordType::CALLSIGN).maxAge; // 86400 s
+	 */
+	class CachePolicies
+	{
+	public:
+		/**
+		 * @brief Returns the policy of a record type.
+		 *
+		 * @param type The record type.
+		 * @return The policy.
+		 */
+		const CachePolicy &get(RecordType type) const;
+
+		/**
+		 * @brief Changes the policy of one record type from a specification.
+		 *
+		 * The specification is a record type name, '=' and a comma separated list of key:value settings. The keys
+		 * max-age, stale and not-found take seconds, and max-entries and max-bytes take counts. Settings that are left
+		 * out keep their current value.
+		 *
+		 * @param spec The specification, e.g. "dxcc=max-age:2592000,not-found:0".
+		 * @throws std::invalid_argument If the specification names an unknown type or key, or a value is not a
+		 * number.
+		 */
+		void apply(std::string_view spec);
+
+	private:
+		std::array<CachePolicy, recordTypeCount> m_policies = {
+				// Callsign records: fresh for a week, then served stale for a month. A record is about 2 KiB
+				CachePolicy{std::chrono::hours(24 * 7), std::chrono::hours(24 * 30), std::chrono::hours(24), 0,
+							512ull * 1024 * 1024},
+				// DXCC entities: fresh for a month, then served stale for three months. There are only a few hundred
+				CachePolicy{std::chrono::hours(24 * 30), std::chrono::hours(24 * 90), std::chrono::hours(24), 0,
+							16ull * 1024 * 1024},
+				// Bios: fresh for a year, then served stale for another. A call QRZ does not know is cached as a
+				// callsign, so bios are never looked up for it
+				CachePolicy{std::chrono::hours(24 * 365), std::chrono::hours(24 * 365), std::chrono::seconds(0), 0,
+							1024ull * 1024 * 1024}
+		};
+	};
+}
+
+#endif //QRZ_CACHEPOLICY_H
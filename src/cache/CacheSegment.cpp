@@ -0,0 +1,272 @@
+#include "CacheSegment.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+using namespace qrz;
+using namespace qrz::cache;
+
+namespace
+{
+	// First bytes of every segment file
+	constexpr char segmentMagic[8] = {'Q', 'R', 'Z', 'S', 'E', 'G', '1', '\n'};
+
+	// Written in native byte order, so a segment from a machine of the other byte order is rejected
+	constexpr uint32_t byteOrderMark = 0x01020304;
+
+	/**
+	 * @brief The fixed-size start of a segment file.
+	 */
+	struct Header
+	{
+		char magic[8];
+		uint32_t byteOrder;
+		uint32_t slotSize;
+		uint64_t count;
+		uint64_t dataSize;
+	};
+
+	/**
+	 * @brief One index entry. The key is stored at offset in the data area, and the value straight after it.
+	 */
+	struct Slot
+	{
+		uint64_t offset;
+		uint32_t keyLength;
+		uint32_t valueLength;
+		int64_t storedAt;
+	};
+
+	static_assert(sizeof(Header) == 32 && sizeof(Slot) == 24, "The segment layout must not depend on padding");
+
+	// Size of an entry's slot and reference byte
+	constexpr uint64_t entryOverhead = sizeof(Slot) + 1;
+}
+
+/**
+ * @brief Maps a segment file.
+ *
+ * Only the header is checked here, against the size of the file. Slots are checked as they are read, so opening a
+ * segment does not touch its index. The file is mapped writable for its reference bytes, or read-only if that fails,
+ * e.g. in a cache directory shared read-only.
+ *
+ * @param path Path of the segment. A missing file is an empty segment.
+ * @throws std::runtime_error If the file is not a segment, or is damaged.
+ */
+CacheSegment::CacheSegment(const std::string &path)
+{
+	if (!std::filesystem::exists(path))
+	{
+		return;
+	}
+
+	try
+	{
+		m_file.emplace(path, MappedFile::Access::RANDOM, MappedFile::Mode::READ_WRITE);
+	}
+	catch (std::runtime_error &)
+	{
+		m_file.emplace(path, MappedFile::Access::RANDOM);
+	}
+
+	std::string_view file = m_file->view();
+	Header header{};
+
+	if (file.size() >= sizeof(header))
+	{
+		std::memcpy(&header, file.data(), sizeof(header));
+	}
+
+	if (file.size() < sizeof(header) || std::memcmp(header.magic, segmentMagic, sizeof(segmentMagic)) != 0
+		|| header.byteOrder != byteOrderMark || header.slotSize != sizeof(Slot))
+	{
+		throw std::runtime_error{std::format("{:s} is not a lookup cache segment", path)};
+	}
+
+	uint64_t available = file.size() - sizeof(header);
+
+	if (header.count > available / entryOverhead || header.dataSize != available - header.count * entryOverhead)
+	{
+		throw std::runtime_error{std::format("Lookup cache segment {:s} is damaged", path)};
+	}
+
+	m_count = static_cast<size_t>(header.count);
+	m_index = file.substr(sizeof(header), m_count * sizeof(Slot));
+	m_data = file.substr(sizeof(header) + m_index.size(), static_cast<size_t>(header.dataSize));
+
+	if (char *writable = m_file->writableData())
+	{
+		m_references = reinterpret_cast<uint8_t *>(writable + sizeof(header) + m_index.size() + m_data.size());
+	}
+}
+
+/**
+ * @brief Looks up a key.
+ *
+ * @param key The key.
+ * @return The record, or std::nullopt if the segment does not have the key.
+ */
+std::optional<CacheSegment::Record> CacheSegment::find(std::string_view key) const
+{
+	std::optional<size_t> index = indexOf(key);
+
+	return index ? at(*index) : std::nullopt;
+}
+
+/**
+ * @brief Looks up the position of a key in the index.
+ *
+ * @param key The key.
+ * @return The position, or std::nullopt if the segment does not have the key.
+ */
+std::optional<size_t> CacheSegment::indexOf(std::string_view key) const
+{
+	size_t low = 0;
+	size_t high = m_count;
+
+	while (low < high)
+	{
+		size_t middle = low + (high - low) / 2;
+		std::optional<Record> record = at(middle);
+
+		if (!record)
+		{
+			// A damaged slot leaves the order unknown, so the key is treated as missing
+			return std::nullopt;
+		}
+
+		if (record->key == key)
+		{
+			return middle;
+		}
+
+		if (record->key < key)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return std::nullopt;
+}
+
+/**
+ * @brief Returns the record at a position of the index.
+ *
+ * @param index The position, below size().
+ * @return The record, or std::nullopt if its slot points outside the segment.
+ */
+std::optional<CacheSegment::Record> CacheSegment::at(size_t index) const
+{
+	Slot slot{};
+	std::memcpy(&slot, m_index.data() + index * sizeof(Slot), sizeof(slot));
+
+	if (slot.offset > m_data.size() || uint64_t(slot.keyLength) + slot.valueLength > m_data.size() - slot.offset)
+	{
+		return std::nullopt;
+	}
+
+	bool referenced = m_references != nullptr && std::atomic_ref<uint8_t>(m_references[index]).load(
+			std::memory_order_relaxed) != 0;
+
+	return Record{m_data.substr(slot.offset, slot.keyLength),
+				  m_data.substr(slot.offset + slot.keyLength, slot.valueLength), slot.storedAt, referenced};
+}
+
+/**
+ * @brief Marks the record at a position of the index as used.
+ *
+ * The byte is only written if it is not set yet, so entries used over and over do not keep dirtying their page.
+ * Concurrent writers all store the same value, so the writes need no lock.
+ *
+ * @param index The position, below size().
+ */
+void CacheSegment::touch(size_t index) const
+{
+	if (m_references == nullptr || index >= m_count)
+	{
+		return;
+	}
+
+	std::atomic_ref<uint8_t> reference(m_references[index]);
+
+	if (reference.load(std::memory_order_relaxed) == 0)
+	{
+		reference.store(1, std::memory_order_relaxed);
+	}
+}
+
+/**
+ * @brief Returns the number of entries.
+ *
+ * @return The entry count.
+ */
+size_t CacheSegment::size() const
+{
+	return m_count;
+}
+
+/**
+ * @brief Writes a segment, replacing any segment at the path.
+ *
+ * The segment is written to a temporary file and renamed into place, so readers see either the old segment or the
+ * complete new one. Every record of the new segment starts out unreferenced, which is the sweep of the clock: an
+ * entry survives the next compaction by being used again. The caller must hold the cache's write lock.
+ *
+ * @param path Path of the segment.
+ * @param records The records, sorted by key with no duplicate keys.
+ * @return The size of the segment in bytes.
+ * @throws std::runtime_error If the segment cannot be written.
+ */
+uint64_t CacheSegment::write(const std::string &path, const std::vector<Record> &records)
+{
+	Header header{};
+	std::memcpy(header.magic, segmentMagic, sizeof(segmentMagic));
+	header.byteOrder = byteOrderMark;
+	header.slotSize = sizeof(Slot);
+	header.count = records.size();
+
+	std::vector<Slot> slots;
+	slots.reserve(records.size());
+
+	for (const Record &record : records)
+	{
+		slots.push_back(Slot{header.dataSize, static_cast<uint32_t>(record.key.size()),
+							 static_cast<uint32_t>(record.value.size()), record.storedAt});
+		header.dataSize += record.key.size() + record.value.size();
+	}
+
+	const std::string temporaryPath = path + ".tmp";
+
+	{
+		std::ofstream output(temporaryPath, std::ios::binary | std::ios::trunc);
+
+		output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		output.write(reinterpret_cast<const char *>(slots.data()), std::streamsize(slots.size() * sizeof(Slot)));
+
+		for (const Record &record : records)
+		{
+			output << record.key << record.value;
+		}
+
+		const std::vector<char> references(records.size(), 0);
+		output.write(references.data(), std::streamsize(references.size()));
+
+		if (!output.flush())
+		{
+			throw std::runtime_error{std::format("Unable to write lookup cache segment {:s}", temporaryPath)};
+		}
+	}
+
+	std::filesystem::rename(temporaryPath, path);
+
+	return sizeof(header) + header.count * entryOverhead + header.dataSize;
+}
@@ -0,0 +1,131 @@
+#ifndef QRZ_CACHESEGMENT_H
+#define QRZ_CACHESEGMENT_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../MappedFile.h"
+
+namespace qrz::cache
+{
+	/**
+	 * @class CacheSegment
+	 * @brief An immutable, memory-mapped table of cache entries, sorted by key.
+	 *
+	 * A segment file holds a fixed-size header, an index of fixed-size slots sorted by key, the keys and values the
+	 * slots point at, and a reference byte per entry. Opening a segment maps it and checks the header, so it costs the
+	 * same whatever the number of entries; lookups binary search the index in place. Every process using the cache
+	 * maps the same file, so they share one copy of it in the page cache.
+	 *
+	 * Apart from the reference bytes, segments are never modified. A new one is written next to the old and renamed
+	 * over it, so a process that has the old one mapped keeps reading it undisturbed.
+	 *
+	 * The reference bytes are the use bits of a CLOCK eviction scheme: touch() sets an entry's byte through a shared
+	 * mapping, so an entry used by any process is seen as used by the next compaction. Each entry costs one byte, and
+	 * a byte already set is not written again, so tracking use dirties at most one page per 4096 entries. If the file
+	 * cannot be opened for writing, the segment is mapped read-only and touch() does nothing.
+	 *
+	 * Example Usage:
+	 *
+	 * CacheSegment segment("cache.seg");
+	 * if (auto record = segment.find("C\tW1AW")) { record->value; }
+	 */
+	class CacheSegment
+	{
+	public:
+		/**
+		 * @brief An entry of a segment. The views point into the mapping, or into the records passed to write().
+		 */
+		struct Record
+		{
+			std::string_view key;
+
+			std::string_view value;
+
+			// When the record was fetched from the QRZ API, in seconds since the epoch
+			int64_t storedAt = 0;
+
+			// Whether the record was used since the segment was written. Not written by write()
+			bool referenced = false;
+		};
+
+		/**
+		 * @brief Maps a segment file.
+		 *
+		 * @param path Path of the segment. A missing file is an empty segment.
+		 * @throws std::runtime_error If the file is not a segment, or is damaged.
+		 */
+		explicit CacheSegment(const std::string &path);
+
+		/**
+		 * @brief Looks up a key.
+		 *
+		 * @param key The key.
+		 * @return The record, or std::nullopt if the segment does not have the key.
+		 */
+		std::optional<Record> find(std::string_view key) const;
+
+		/**
+		 * @brief Looks up the position of a key in the index.
+		 *
+		 * @param key The key.
+		 * @return The position, or std::nullopt if the segment does not have the key.
+		 */
+		std::optional<size_t> indexOf(std::string_view key) const;
+
+		/**
+		 * @brief Returns the record at a position of the index.
+		 *
+		 * @param index The position, below size().
+		 * @return The record, or std::nullopt if its slot points outside the segment.
+		 */
+		std::optional<Record> at(size_t index) const;
+
+		/**
+		 * @brief Marks the record at a position of the index as used.
+		 *
+		 * @param index The position, below size().
+		 */
+		void touch(size_t index) const;
+
+		/**
+		 * @brief Returns the number of entries.
+		 *
+		 * @return The entry count.
+		 */
+		size_t size() const;
+
+		/**
+		 * @brief Writes a segment, replacing any segment at the path.
+		 *
+		 * The segment is written to a temporary file and renamed into place, so readers see either the old segment or
+		 * the complete new one. Every record of the new segment starts out unreferenced. The caller must hold the
+		 * cache's write lock.
+		 *
+		 * @param path Path of the segment.
+		 * @param records The records, sorted by key with no duplicate keys.
+		 * @return The size of the segment in bytes.
+		 * @throws std::runtime_error If the segment cannot be written.
+		 */
+		static uint64_t write(const std::string &path, const std::vector<Record> &records);
+
+	private:
+		std::optional<MappedFile> m_file;
+
+		// The slots, sorted by key
+		std::string_view m_index;
+
+		// The keys and values the slots point at
+		std::string_view m_data;
+
+		// One reference byte per slot, or nullptr if the segment is mapped read-only
+		uint8_t *m_references = nullptr;
+
+		size_t m_count = 0;
+	};
+}
+
+#endif //QRZ_CACHESEGMENT_H
@@ -0,0 +1,892 @@
+#include "LookupCache.h"
+
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "../FileLock.h"
+
+using namespace qrz;
+using namespace qrz::cache;
+
+namespace
+{
+	// Largest value accepted when loading, so a corrupt length cannot exhaust memory
+	constexpr int64_t maxValueLength = 64 * 1024 * 1024;
+
+	/**
+	 * @brief Returns the tag written for a record type.
+	 *
+	 * @param type The record type.
+	 * @return The tag character.
+	 */
+	char typeTag(RecordType type)
+	{
+		switch (type)
+		{
+			case RecordType::CALLSIGN:
+				return 'C';
+			case RecordType::DXCC:
+				return 'D';
+			case RecordType::BIO:
+				return 'B';
+		}
+
+		return '?';
+	}
+
+	/**
+	 * @brief Returns the record type of a map key.
+	 *
+	 * @param mapKey The map key, see LookupCache::makeKey().
+	 * @return The record type, or std::nullopt if the key has no known tag.
+	 */
+	std::optional<RecordType> typeOfKey(std::string_view mapKey)
+	{
+		for (RecordType type : {RecordType::CALLSIGN, RecordType::DXCC, RecordType::BIO})
+		{
+			if (!mapKey.empty() && mapKey.front() == typeTag(type))
+			{
+				return type;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Parses an unsigned decimal number that makes up the whole of a string.
+	 *
+	 * @param text The text.
+	 * @param value Receives the number.
+	 * @return True if the text is a number.
+	 */
+	bool parseNumber(std::string_view text, int64_t &value)
+	{
+		auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+		return !text.empty() && error == std::errc{} && end == text.data() + text.size() && value >= 0;
+	}
+}
+
+/**
+ * @brief Returns whether the entry records that the QRZ API had no such record.
+ *
+ * @return True for a "not found" entry, which is stored with an empty value.
+ */
+bool LookupCache::Entry::isNotFound() const
+{
+	return value.empty();
+}
+
+/**
+ * @brief Opens the cache at the given path, loading its entries if the file exists.
+ *
+ * @param path Path to the cache log. It is created by the first flush(), and the segment is kept next to it.
+ * @param compactLogSize Size in bytes beyond which flush() merges the log into the segment.
+ * @throws std::runtime_error If a file exists but is not a cache file.
+ */
+LookupCache::LookupCache(std::string path, size_t compactLogSize)
+		: m_path(std::move(path)),
+		  m_pointerPath(std::filesystem::path(m_path).replace_extension(".current").string()),
+		  m_compactLogSize(compactLogSize)
+{
+	load();
+}
+
+/**
+ * @brief Waits for a running compaction to finish.
+ *
+ * A compaction that fails now is not reported, and the log it would have emptied is compacted by a later run.
+ */
+LookupCache::~LookupCache()
+{
+	if (m_compactor.joinable())
+	{
+		m_compactor.join();
+	}
+}
+
+/**
+ * @brief Looks up a cached result.
+ *
+ * Entries of the log and of this process are found first, since they are newer, and then the segment is searched.
+ * An entry found in the segment is marked as used, so compactions keep it over unused ones.
+ *
+ * @param type The record type.
+ * @param key The lookup key, e.g. a normalized callsign.
+ * @return The entry, or std::nullopt if there is none.
+ */
+std::optional<LookupCache::Entry> LookupCache::get(RecordType type, const std::string &key) const
+{
+	std::string mapKey = makeKey(type, key);
+
+	{
+		std::scoped_lock lock(m_mutex);
+
+		auto it = m_entries.find(mapKey);
+
+		if (it != m_entries.end())
+		{
+			return it->second;
+		}
+	}
+
+	// The segment's entries are never modified, so it is searched without the lock
+	std::optional<size_t> index = m_segment ? m_segment->indexOf(mapKey) : std::nullopt;
+	std::optional<CacheSegment::Record> record = index ? m_segment->at(*index) : std::nullopt;
+
+	if (!record)
+	{
+		return std::nullopt;
+	}
+
+	m_segment->touch(*index);
+
+	return toEntry(*record);
+}
+
+/**
+ * @brief Looks up a cached result that may be served under the policy of its record type.
+ *
+ * @param type The record type.
+ * @param key The lookup key, e.g. a normalized callsign.
+ * @return The entry and whether it is stale, or std::nullopt if there is none or it has expired.
+ */
+std::optional<LookupCache::Hit> LookupCache::lookup(RecordType type, const std::string &key) const
+{
+	std::optional<Entry> entry = get(type, key);
+
+	if (!entry)
+	{
+		return std::nullopt;
+	}
+
+	CachePolicy policy;
+
+	{
+		std::scoped_lock lock(m_mutex);
+
+		policy = m_policies.get(type);
+	}
+
+	auto age = std::chrono::duration_cast<std::chrono::seconds>(Clock::now() - entry->storedAt);
+	Freshness freshness = policy.classify(age, entry->isNotFound());
+
+	if (freshness == Freshness::EXPIRED)
+	{
+		return std::nullopt;
+	}
+
+	return Hit{std::move(*entry), freshness};
+}
+
+/**
+ * @brief Stores a result, to be written to disk by the next flush().
+ *
+ * Keys containing tabs or line breaks are not stored, since they cannot be written to the log.
+ *
+ * @param type The record type.
+ * @param key The lookup key, e.g. a normalized callsign.
+ * @param value The serialized record.
+ */
+void LookupCache::put(RecordType type, const std::string &key, std::string value)
+{
+	if (key.empty() || key.find_first_of("\t\r\n") != std::string::npos)
+	{
+		return;
+	}
+
+	std::string mapKey = makeKey(type, key);
+
+	std::scoped_lock lock(m_mutex);
+
+	m_entries[mapKey] = Entry{std::move(value), Clock::now()};
+	m_pending.push_back(std::move(mapKey));
+}
+
+/**
+ * @brief Stores that the QRZ API has no record for a key, to be written to disk by the next flush().
+ *
+ * Nothing is stored if the policy of the record type disables negative caching.
+ *
+ * @param type The record type.
+ * @param key The lookup key, e.g. a normalized callsign.
+ */
+void LookupCache::putNotFound(RecordType type, const std::string &key)
+{
+	{
+		std::scoped_lock lock(m_mutex);
+
+		if (m_policies.get(type).notFoundMaxAge.count() == 0)
+		{
+			return;
+		}
+	}
+
+	put(type, key, "");
+	count(type, Event::NOT_FOUND_STORED);
+}
+
+/**
+ * @brief Replaces the policies used by lookup().
+ *
+ * @param policies The policy of every record type.
+ */
+void LookupCache::setPolicies(const CachePolicies &policies)
+{
+	std::scoped_lock lock(m_mutex);
+
+	m_policies = policies;
+}
+
+/**
+ * @brief Counts an event for the statistics.
+ *
+ * @param type The record type.
+ * @param event The event.
+ */
+void LookupCache::count(RecordType type, Event event)
+{
+	m_events[static_cast<size_t>(type)][static_cast<size_t>(event)].fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the event counts of a record type.
+ *
+ * @param type The record type.
+ * @return The counts.
+ */
+LookupCache::Stats LookupCache::getStats(RecordType type) const
+{
+	const auto &events = m_events[static_cast<size_t>(type)];
+
+	auto countOf = [&events](Event event)
+	{
+		return events[static_cast<size_t>(event)].load(std::memory_order_relaxed);
+	};
+
+	return Stats{countOf(Event::HIT), countOf(Event::STALE_HIT), countOf(Event::NOT_FOUND_HIT), countOf(Event::MISS),
+				 countOf(Event::REVALIDATED), countOf(Event::REVALIDATION_FAILED), countOf(Event::NOT_FOUND_STORED),
+				 countOf(Event::EXPIRED), countOf(Event::EVICTED)};
+}
+
+/**
+ * @brief Returns the compaction counts.
+ *
+ * @return The counts.
+ */
+LookupCache::CompactionStats LookupCache::getCompactionStats() const
+{
+	return CompactionStats{m_compactions.load(std::memory_order_relaxed),
+						   m_compactionFailures.load(std::memory_order_relaxed),
+						   m_compactedBytes.load(std::memory_order_relaxed),
+						   std::chrono::microseconds(m_compactionMicroseconds.load(std::memory_order_relaxed))};
+}
+
+/**
+ * @brief Appends the entries stored since the last flush to the cache file, and starts a compaction if the log has
+ * outgrown the compaction size.
+ *
+ * Each entry is written as a line holding its type tag, key, fetch time and value length, followed by the value and
+ * a line break. The append happens while holding the cache lock, so entries from concurrent processes never
+ * interleave. The compaction runs on a background thread once the append is done, so flush() does not wait for it.
+ *
+ * @throws std::runtime_error If the file cannot be written, or the previous compaction failed.
+ */
+void LookupCache::flush()
+{
+	std::scoped_lock lock(m_mutex);
+
+	if (!m_compactionError.empty())
+	{
+		throw std::runtime_error{std::exchange(m_compactionError, {})};
+	}
+
+	if (m_pending.empty())
+	{
+		return;
+	}
+
+	std::filesystem::path parent = std::filesystem::path(m_path).parent_path();
+
+	if (!parent.empty() && !std::filesystem::exists(parent))
+	{
+		std::filesystem::create_directories(parent);
+	}
+
+	FileLock fileLock(m_path + ".lock");
+
+	bool isNew = !std::filesystem::exists(m_path) || std::filesystem::file_size(m_path) == 0;
+
+	std::ofstream output(m_path, std::ios::binary | std::ios::app);
+
+	if (!output)
+	{
+		throw std::runtime_error{std::format("Unable to write lookup cache {:s}", m_path)};
+	}
+
+	if (isNew)
+	{
+		output << m_header << '\n';
+	}
+
+	for (const std::string &mapKey : m_pending)
+	{
+		const Entry &entry = m_entries.at(mapKey);
+		auto storedAt = std::chrono::duration_cast<std::chrono::seconds>(entry.storedAt.time_since_epoch()).count();
+
+		output << mapKey << '\t' << storedAt << '\t' << entry.value.size() << '\n' << entry.value << '\n';
+	}
+
+	if (!output.flush())
+	{
+		throw std::runtime_error{std::format("Unable to write lookup cache {:s}", m_path)};
+	}
+
+	m_pending.clear();
+	output.close();
+
+	if (std::filesystem::file_size(m_path) > m_compactLogSize)
+	{
+		startCompaction();
+	}
+}
+
+/**
+ * @brief Waits for a running compaction to finish.
+ *
+ * Called from the thread that calls flush(), never alongside it.
+ *
+ * @throws std::runtime_error If the compaction failed.
+ */
+void LookupCache::finishCompaction()
+{
+	if (m_compactor.joinable())
+	{
+		m_compactor.join();
+	}
+
+	std::scoped_lock lock(m_mutex);
+
+	if (!m_compactionError.empty())
+	{
+		throw std::runtime_error{std::exchange(m_compactionError, {})};
+	}
+}
+
+/**
+ * @brief Returns the number of cached entries.
+ *
+ * @return The entry count.
+ */
+size_t LookupCache::size() const
+{
+	std::scoped_lock lock(m_mutex);
+
+	if (!m_segment)
+	{
+		return m_entries.size();
+	}
+
+	size_t count = m_segment->size();
+
+	for (const auto &[mapKey, entry] : m_entries)
+	{
+		if (!m_segment->find(mapKey))
+		{
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/**
+ * @brief Loads the entries of the log, and maps the segment.
+ *
+ * Missing files are an empty cache. No lock is taken: a compaction writes the new segment and points to it before it
+ * empties the log, so reading the log first and the segment second finds every entry, at worst twice. A compaction
+ * may also remove the segment between reading the pointer and mapping it, in which case the pointer is read again.
+ *
+ * @throws std::runtime_error If a file is not a cache file.
+ */
+void LookupCache::load()
+{
+	readLog(m_path, m_entries);
+
+	uint64_t generation = readGeneration();
+
+	while (!std::filesystem::exists(segmentPath(generation)))
+	{
+		uint64_t current = readGeneration();
+
+		if (current == generation)
+		{
+			break;
+		}
+
+		generation = current;
+	}
+
+	m_segment.emplace(segmentPath(generation));
+}
+
+/**
+ * @brief Returns the path of a generation of the segment.
+ *
+ * Generation 0 is the segment of a cache that has never been compacted, or was compacted before segments had
+ * generations.
+ *
+ * @param generation The generation.
+ * @return The log path with a .seg extension for generation 0, or with .<generation>.seg for later ones.
+ */
+std::string LookupCache::segmentPath(uint64_t generation) const
+{
+	std::filesystem::path path(m_path);
+
+	if (generation == 0)
+	{
+		return path.replace_extension(".seg").string();
+	}
+
+	return path.replace_extension(std::format(".{:d}.seg", generation)).string();
+}
+
+/**
+ * @brief Reads the generation of the current segment from the pointer file.
+ *
+ * @return The generation, or 0 if there is no pointer file.
+ * @throws std::runtime_error If the pointer file is not a generation.
+ */
+uint64_t LookupCache::readGeneration() const
+{
+	std::ifstream input(m_pointerPath);
+
+	if (!input)
+	{
+		return 0;
+	}
+
+	std::string line;
+	int64_t generation = 0;
+
+	if (!std::getline(input, line) || !parseNumber(line, generation))
+	{
+		throw std::runtime_error{std::format("{:s} is not a lookup cache pointer", m_pointerPath)};
+	}
+
+	return static_cast<uint64_t>(generation);
+}
+
+/**
+ * @brief Points the pointer file at a generation of the segment.
+ *
+ * The pointer is written to a temporary file and renamed into place. Unlike a segment, the pointer file is never
+ * mapped, so it can be replaced on every platform.
+ *
+ * @param generation The generation.
+ * @throws std::runtime_error If the pointer file cannot be written.
+ */
+void LookupCache::writeGeneration(uint64_t generation) const
+{
+	const std::string temporaryPath = m_pointerPath + ".tmp";
+
+	{
+		std::ofstream output(temporaryPath, std::ios::trunc);
+
+		if (!(output << generation << '\n') || !output.flush())
+		{
+			throw std::runtime_error{std::format("Unable to write lookup cache pointer {:s}", temporaryPath)};
+		}
+	}
+
+	std::filesystem::rename(temporaryPath, m_pointerPath);
+}
+
+/**
+ * @brief Removes the segments older than a generation that no process has mapped.
+ *
+ * POSIX systems remove a mapped file once the last mapping is gone, so every old segment goes at once. Windows
+ * refuses to remove a mapped file, so a segment still open in another run is left for a later compaction to remove.
+ *
+ * @param generation The current generation.
+ */
+void LookupCache::removeOldSegments(uint64_t generation) const
+{
+	std::error_code error;
+
+	std::filesystem::remove(segmentPath(0), error);
+
+	std::filesystem::path directory = std::filesystem::path(m_path).parent_path();
+	std::string prefix = std::filesystem::path(m_path).stem().string() + ".";
+
+	for (const auto &file : std::filesystem::directory_iterator(directory.empty() ? "." : directory, error))
+	{
+		std::string name = file.path().filename().string();
+		std::string_view number = std::string_view(name).substr(0, name.size() - std::string_view(".seg").size());
+		int64_t fileGeneration = 0;
+
+		if (name.starts_with(prefix) && name.ends_with(".seg") && number.size() > prefix.size()
+			&& parseNumber(number.substr(prefix.size()), fileGeneration)
+			&& static_cast<uint64_t>(fileGeneration) < generation)
+		{
+			std::filesystem::remove(file.path(), error);
+		}
+	}
+}
+
+/**
+ * @brief Starts a compaction on the background thread, unless one is running.
+ *
+ * The caller must hold m_mutex.
+ */
+void LookupCache::startCompaction()
+{
+	if (m_compacting.exchange(true))
+	{
+		// The running compaction empties the log, including what was just appended
+		return;
+	}
+
+	if (m_compactor.joinable())
+	{
+		m_compactor.join();
+	}
+
+	m_compactor = std::thread(&LookupCache::runCompaction, this);
+}
+
+/**
+ * @brief Takes the write lock and compacts the cache, if no other process has done so. Runs on m_compactor.
+ *
+ * While the write lock is held, other processes wait to append to the log, but their lookups carry on. A failure is
+ * kept to be reported by the next flush() or finishCompaction().
+ */
+void LookupCache::runCompaction()
+{
+	auto start = std::chrono::steady_clock::now();
+
+	CachePolicies policies;
+
+	{
+		std::scoped_lock lock(m_mutex);
+
+		policies = m_policies;
+	}
+
+	try
+	{
+		FileLock fileLock(m_path + ".lock");
+
+		if (std::filesystem::file_size(m_path) > m_compactLogSize)
+		{
+			m_compactedBytes.fetch_add(compact(policies), std::memory_order_relaxed);
+			m_compactions.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	catch (std::exception &e)
+	{
+		m_compactionFailures.fetch_add(1, std::memory_order_relaxed);
+
+		std::scoped_lock lock(m_mutex);
+
+		m_compactionError = std::format("Unable to compact lookup cache {:s}: {:s}", m_path, e.what());
+	}
+
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	m_compactionMicroseconds.fetch_add(elapsed.count(), std::memory_order_relaxed);
+
+	m_compacting = false;
+}
+
+/**
+ * @brief Merges the log into a new segment, dropping expired entries and evicting entries over the limits, and
+ * empties the log.
+ *
+ * The newest segment and log are read back from disk, since other processes may have written to them since this one
+ * opened the cache. The two are merged in key order, log entries replacing segment entries, and the segment values
+ * are copied straight from the mapping into the new file. The new segment is written as the next generation, and the
+ * pointer file is switched to it before the log is emptied. The old segment stays mapped by this process and any
+ * other that opened it, and disappears once the last of them exits.
+ *
+ * Keys start with their type tag, so the entries of each record type are a run of the merged entries, and each run
+ * is trimmed to the limits of its type. Entries from the log were stored since the last compaction, so they count as
+ * used.
+ *
+ * @param policies The policy of every record type.
+ * @return The size of the new segment in bytes.
+ * @throws std::runtime_error If the segment cannot be written.
+ */
+uint64_t LookupCache::compact(const CachePolicies &policies)
+{
+	const uint64_t generation = readGeneration();
+
+	CacheSegment current(segmentPath(generation));
+
+	std::unordered_map<std::string, Entry> logged;
+	readLog(m_path, logged);
+
+	std::vector<const std::pair<const std::string, Entry> *> sortedLog;
+	sortedLog.reserve(logged.size());
+
+	for (const auto &item : logged)
+	{
+		sortedLog.push_back(&item);
+	}
+
+	std::sort(sortedLog.begin(), sortedLog.end(), [](const auto *a, const auto *b)
+	{
+		return a->first < b->first;
+	});
+
+	std::vector<CacheSegment::Record> merged;
+	merged.reserve(current.size() + sortedLog.size());
+
+	auto fromLog = [](const std::pair<const std::string, Entry> *item)
+	{
+		auto storedAt = std::chrono::duration_cast<std::chrono::seconds>(item->second.storedAt.time_since_epoch());
+
+		return CacheSegment::Record{item->first, item->second.value, storedAt.count(), true};
+	};
+
+	size_t next = 0;
+
+	for (size_t i = 0; i < current.size(); ++i)
+	{
+		std::optional<CacheSegment::Record> record = current.at(i);
+
+		if (!record)
+		{
+			continue;
+		}
+
+		while (next < sortedLog.size() && sortedLog[next]->first < record->key)
+		{
+			merged.push_back(fromLog(sortedLog[next++]));
+		}
+
+		if (next < sortedLog.size() && sortedLog[next]->first == record->key)
+		{
+			merged.push_back(fromLog(sortedLog[next++]));
+		}
+		else
+		{
+			merged.push_back(*record);
+		}
+	}
+
+	while (next < sortedLog.size())
+	{
+		merged.push_back(fromLog(sortedLog[next++]));
+	}
+
+	std::vector<uint8_t> keep(merged.size(), 1);
+
+	for (size_t begin = 0, end = 0; begin < merged.size(); begin = end)
+	{
+		std::optional<RecordType> type = typeOfKey(merged[begin].key);
+
+		while (end < merged.size() && typeOfKey(merged[end].key) == type)
+		{
+			end++;
+		}
+
+		if (type)
+		{
+			selectSurvivors(*type, policies.get(*type), std::span(merged).subspan(begin, end - begin),
+							std::span(keep).subspan(begin, end - begin));
+		}
+	}
+
+	std::vector<CacheSegment::Record> survivors;
+	survivors.reserve(merged.size());
+
+	for (size_t i = 0; i < merged.size(); ++i)
+	{
+		if (keep[i])
+		{
+			survivors.push_back(merged[i]);
+		}
+	}
+
+	uint64_t bytesWritten = CacheSegment::write(segmentPath(generation + 1), survivors);
+
+	writeGeneration(generation + 1);
+
+	{
+		std::ofstream output(m_path, std::ios::binary | std::ios::trunc);
+
+		if (!(output << m_header << '\n') || !output.flush())
+		{
+			throw std::runtime_error{std::format("Unable to write lookup cache {:s}", m_path)};
+		}
+	}
+
+	removeOldSegments(generation + 1);
+
+	return bytesWritten;
+}
+
+/**
+ * @brief Chooses which entries of one record type a compaction keeps.
+ *
+ * Expired entries are dropped first, since lookup() would not serve them. If the rest are over the entry or byte
+ * limit, entries are evicted until they are not: unused ones before used ones, and the longest fetched first within
+ * each. This is a CLOCK sweep done once per compaction, with the fetch time breaking ties between entries that have
+ * the same use bit.
+ *
+ * @param type The record type.
+ * @param policy The policy of the record type.
+ * @param records The merged entries of the record type.
+ * @param keep Receives 0 for each entry to drop.
+ */
+void LookupCache::selectSurvivors(RecordType type, const CachePolicy &policy,
+								  std::span<const CacheSegment::Record> records, std::span<uint8_t> keep)
+{
+	const int64_t now = std::chrono::duration_cast<std::chrono::seconds>(Clock::now().time_since_epoch()).count();
+
+	std::vector<size_t> candidates;
+	candidates.reserve(records.size());
+
+	uint64_t entries = 0;
+	uint64_t bytes = 0;
+
+	for (size_t i = 0; i < records.size(); ++i)
+	{
+		const CacheSegment::Record &record = records[i];
+
+		if (policy.classify(std::chrono::seconds(now - record.storedAt), record.value.empty()) == Freshness::EXPIRED)
+		{
+			keep[i] = 0;
+			count(type, Event::EXPIRED);
+			continue;
+		}
+
+		candidates.push_back(i);
+		entries++;
+		bytes += record.key.size() + record.value.size();
+	}
+
+	auto overLimit = [&policy, &entries, &bytes]()
+	{
+		return (policy.maxEntries > 0 && entries > policy.maxEntries)
+			|| (policy.maxBytes > 0 && bytes > policy.maxBytes);
+	};
+
+	if (!overLimit())
+	{
+		return;
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [&records](size_t a, size_t b)
+	{
+		return std::tie(records[a].referenced, records[a].storedAt)
+			 < std::tie(records[b].referenced, records[b].storedAt);
+	});
+
+	for (size_t i : candidates)
+	{
+		if (!overLimit())
+		{
+			break;
+		}
+
+		keep[i] = 0;
+		entries--;
+		bytes -= records[i].key.size() + records[i].value.size();
+		count(type, Event::EVICTED);
+	}
+}
+
+/**
+ * @brief Reads the entries of a log.
+ *
+ * Reading stops at the first incomplete entry, such as one left by a process that died while appending.
+ *
+ * @param path Path of the log. A missing file has no entries.
+ * @param entries Receives the entries, later ones replacing earlier ones.
+ * @throws std::runtime_error If the file is not a cache log.
+ */
+void LookupCache::readLog(const std::string &path, std::unordered_map<std::string, Entry> &entries)
+{
+	std::ifstream input(path, std::ios::binary);
+
+	if (!input)
+	{
+		return;
+	}
+
+	std::string line;
+
+	if (!std::getline(input, line))
+	{
+		return;
+	}
+
+	if (line != m_header)
+	{
+		throw std::runtime_error{std::format("{:s} is not a lookup cache", path)};
+	}
+
+	while (std::getline(input, line))
+	{
+		// <type tag>\t<key>\t<fetch time>\t<value length>
+		size_t keyEnd = line.find('\t', 2);
+		size_t timeEnd = keyEnd == std::string::npos ? keyEnd : line.find('\t', keyEnd + 1);
+
+		int64_t storedAt = 0;
+		int64_t length = 0;
+
+		if (timeEnd == std::string::npos
+			|| !parseNumber(std::string_view(line).substr(keyEnd + 1, timeEnd - keyEnd - 1), storedAt)
+			|| !parseNumber(std::string_view(line).substr(timeEnd + 1), length)
+			|| length > maxValueLength)
+		{
+			break;
+		}
+
+		std::string value(static_cast<size_t>(length), '\0');
+
+		if (!input.read(value.data(), length) || input.get() != '\n')
+		{
+			break;
+		}
+
+		entries[line.substr(0, keyEnd)] = Entry{std::move(value), Clock::time_point{std::chrono::seconds{storedAt}}};
+	}
+}
+
+/**
+ * @brief Converts a segment record into an entry.
+ *
+ * @param record The record.
+ * @return The entry.
+ */
+LookupCache::Entry LookupCache::toEntry(const CacheSegment::Record &record)
+{
+	return Entry{std::string(record.value), Clock::time_point{std::chrono::seconds{record.storedAt}}};
+}
+
+/**
+ * @brief Builds the map key for a record type and lookup key.
+ *
+ * @param type The record type.
+ * @param key The lookup key.
+ * @return The map key, which is also how the entry is written to disk.
+ */
+std::string LookupCache::makeKey(RecordType type, const std::string &key)
+{
+	std::string mapKey;
+	mapKey.reserve(key.size() + 2);
+	mapKey.push_back(typeTag(type));
+	mapKey.push_back('\t');
+	mapKey.append(key);
+
+	return mapKey;
+}
@@ -0,0 +1,398 @@
+#ifndef QRZ_LOOKUPCACHE_H
+#define QRZ_LOOKUPCACHE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "CachePolicy.h"
+#include "CacheSegment.h"
+
+namespace qrz::cache
+{
+	/**
+	 * @class LookupCache
+	 * @brief A persistent cache of QRZ API lookup results, shared by every run.
+	 *
+	 * On disk the cache is an immutable CacheSegment, which every process maps and marks the entries it uses in, and
+	 * an append-only log of the entries stored since the segment was written: a header line, then one length-prefixed
+	 * entry per stored result. Later entries for the same key replace earlier ones, and log entries replace segment
+	 * entries. New entries are appended by flush() while holding a lock, so concurrent processes can share the files.
+	 * A log damaged by a crash is read up to the damaged entry.
+	 *
+	 * Only the log is parsed when the cache is opened. Once it outgrows the compaction size, flush() starts merging it
+	 * into a new segment on a background thread, and the log is emptied. Each compaction writes the next generation
+	 * of the segment to a file of its own and then points a small pointer file at it, since a mapped file cannot be
+	 * replaced on every platform. Old generations are removed once no process has them mapped. Compaction drops
+	 * expired entries, and evicts entries until each record type is within the limits of its CachePolicy: first those
+	 * no process has used since the last compaction, then those used, oldest first. Readers are never blocked by a
+	 * compaction, in this process or any other, since they keep reading the segment they mapped.
+	 *
+	 * lookup() judges each entry by the CachePolicy of its record type. "Not found" answers are stored as entries with
+	 * an empty value, which earlier versions cannot read, and so fetch again.
+	 *
+	 * get(), lookup() and put() may be called concurrently from the fetch workers.
+	 */
+	class LookupCache
+	{
+	public:
+		using Clock = std::chrono::system_clock;
+
+		/**
+		 * @brief A cached lookup result.
+		 */
+		struct Entry
+		{
+			// The serialized record
+			std::string value;
+
+			// When the record was fetched from the QRZ API
+			Clock::time_point storedAt;
+
+			/**
+			 * @brief Returns whether the entry records that the QRZ API had no such record.
+			 *
+			 * @return True for a "not found" entry.
+			 */
+			bool isNotFound() const;
+		};
+
+		/**
+		 * @brief A cached entry that may be served, and whether it should be refreshed.
+		 */
+		struct Hit
+		{
+			Entry entry;
+
+			// FRESH, or STALE if the entry is served but should be fetched again
+			Freshness freshness = Freshness::FRESH;
+		};
+
+		/**
+		 * @brief Things that happen to cached entries, counted for the statistics.
+		 */
+		enum class Event : uint8_t
+		{
+			// A fresh entry was served
+			HIT,
+
+			// A stale entry was served, and queued to be refreshed
+			STALE_HIT,
+
+			// A "not found" entry was served
+			NOT_FOUND_HIT,
+
+			// There was no usable entry, so the record was fetched
+			MISS,
+
+			// A stale entry was refreshed from the QRZ API
+			REVALIDATED,
+
+			// Refreshing a stale entry failed, so it was kept
+			REVALIDATION_FAILED,
+
+			// A "not found" answer was stored
+			NOT_FOUND_STORED,
+
+			// An entry was dropped by a compaction because it had expired
+			EXPIRED,
+
+			// An entry was dropped by a compaction to keep the record type within its limits
+			EVICTED
+		};
+
+		/**
+		 * @brief Event counts for one record type.
+		 */
+		struct Stats
+		{
+			uint64_t hits = 0;
+			uint64_t staleHits = 0;
+			uint64_t notFoundHits = 0;
+			uint64_t misses = 0;
+			uint64_t revalidated = 0;
+			uint64_t revalidationFailures = 0;
+			uint64_t notFoundStored = 0;
+			uint64_t expired = 0;
+			uint64_t evicted = 0;
+		};
+
+		/**
+		 * @brief Compactions run by this process.
+		 */
+		struct CompactionStats
+		{
+			uint64_t runs = 0;
+			uint64_t failures = 0;
+
+			// Size of the segments written
+			uint64_t bytesWritten = 0;
+
+			// Time spent compacting, including waiting for the write lock
+			std::chrono::microseconds time{0};
+		};
+
+		/**
+		 * @brief Opens the cache at the given path, loading its entries if the file exists.
+		 *
+		 * @param path Path to the cache log. It is created by the first flush(), and the segment is kept next to it.
+		 * @param compactLogSize Size in bytes beyond which flush() merges the log into the segment.
+		 * @throws std::runtime_error If a file exists but is not a cache file.
+		 */
+		explicit LookupCache(std::string path, size_t compactLogSize = m_defaultCompactLogSize);
+
+		/**
+		 * @brief Waits for a running compaction to finish.
+		 */
+		~LookupCache();
+
+		LookupCache(const LookupCache &) = delete;
+		LookupCache &operator=(const LookupCache &) = delete;
+
+		/**
+		 * @brief Looks up a cached result.
+		 *
+		 * @param type The record type.
+		 * @param key The lookup key, e.g. a normalized callsign.
+		 * @return The entry, or std::nullopt if there is none.
+		 */
+		std::optional<Entry> get(RecordType type, const std::string &key) const;
+
+		/**
+		 * @brief Looks up a cached result that may be served under the policy of its record type.
+		 *
+		 * @param type The record type.
+		 * @param key The lookup key, e.g. a normalized callsign.
+		 * @return The entry and whether it is stale, or std::nullopt if there is none or it has expired.
+		 */
+		std::optional<Hit> lookup(RecordType type, const std::string &key) const;
+
+		/**
+		 * @brief Stores a result, to be written to disk by the next flush().
+		 *
+		 * @param type The record type.
+		 * @param key The lookup key, e.g. a normalized callsign.
+		 * @param value The serialized record.
+		 */
+		void put(RecordType type, const std::string &key, std::string value);
+
+		/**
+		 * @brief Stores that the QRZ API has no record for a key, to be written to disk by the next flush().
+		 *
+		 * Nothing is stored if the policy of the record type disables negative caching.
+		 *
+		 * @param type The record type.
+		 * @param key The lookup key, e.g. a normalized callsign.
+		 */
+		void putNotFound(RecordType type, const std::string &key);
+
+		/**
+		 * @brief Replaces the policies used by lookup().
+		 *
+		 * @param policies The policy of every record type.
+		 */
+		void setPolicies(const CachePolicies &policies);
+
+		/**
+		 * @brief Counts an event for the statistics.
+		 *
+		 * @param type The record type.
+		 * @param event The event.
+		 */
+		void count(RecordType type, Event event);
+
+		/**
+		 * @brief Returns the event counts of a record type.
+		 *
+		 * @param type The record type.
+		 * @return The counts.
+		 */
+		Stats getStats(RecordType type) const;
+
+		/**
+		 * @brief Returns the compaction counts.
+		 *
+		 * @return The counts.
+		 */
+		CompactionStats getCompactionStats() const;
+
+		/**
+		 * @brief Appends the entries stored since the last flush to the cache file, and starts a compaction if the log
+		 * has outgrown the compaction size.
+		 *
+		 * @throws std::runtime_error If the file cannot be written, or the previous compaction failed.
+		 */
+		void flush();
+
+		/**
+		 * @brief Waits for a running compaction to finish.
+		 *
+		 * Called from the thread that calls flush(), never alongside it.
+		 *
+		 * @throws std::runtime_error If the compaction failed.
+		 */
+		void finishCompaction();
+
+		/**
+		 * @brief Returns the number of cached entries.
+		 *
+		 * @return The entry count.
+		 */
+		size_t size() const;
+
+	private:
+		// First line of every cache file
+		static inline const char *m_header = "# qrz lookup cache v1";
+
+		// Log size at which flush() compacts, unless another is given. Small enough to parse in a few milliseconds
+		static constexpr size_t m_defaultCompactLogSize = 4 * 1024 * 1024;
+
+		std::string m_path;
+
+		// Path of the file holding the generation of the current segment, the log path with a .current extension
+		std::string m_pointerPath;
+
+		const size_t m_compactLogSize;
+
+		mutable std::mutex m_mutex;
+
+		// Entries of the log, and entries stored by this process, by type tag and key, see makeKey()
+		std::unordered_map<std::string, Entry> m_entries;
+
+		// The segment as it was when the cache was opened. Newer segments are left to the next process
+		std::optional<CacheSegment> m_segment;
+
+		// Keys stored since the last flush
+		std::vector<std::string> m_pending;
+
+		CachePolicies m_policies;
+
+		// Event counts, indexed by record type and then by event
+		std::array<std::array<std::atomic<uint64_t>, 9>, recordTypeCount> m_events{};
+
+		// Runs compact(), at most one at a time
+		std::thread m_compactor;
+		std::atomic<bool> m_compacting = false;
+
+		// Why the last compaction failed, until it is reported. Guarded by m_mutex
+		std::string m_compactionError;
+
+		std::atomic<uint64_t> m_compactions = 0;
+		std::atomic<uint64_t> m_compactionFailures = 0;
+		std::atomic<uint64_t> m_compactedBytes = 0;
+		std::atomic<int64_t> m_compactionMicroseconds = 0;
+
+		/**
+		 * @brief Loads the entries of the log, and maps the segment.
+		 *
+		 * @throws std::runtime_error If a file is not a cache file.
+		 */
+		void load();
+
+		/**
+		 * @brief Returns the path of a generation of the segment.
+		 *
+		 * @param generation The generation.
+		 * @return The log path with a .seg extension for generation 0, or with .<generation>.seg for later ones.
+		 */
+		std::string segmentPath(uint64_t generation) const;
+
+		/**
+		 * @brief Reads the generation of the current segment from the pointer file.
+		 *
+		 * @return The generation, or 0 if there is no pointer file.
+		 * @throws std::runtime_error If the pointer file is not a generation.
+		 */
+		uint64_t readGeneration() const;
+
+		/**
+		 * @brief Points the pointer file at a generation of the segment.
+		 *
+		 * The caller must hold the write lock.
+		 *
+		 * @param generation The generation.
+		 * @throws std::runtime_error If the pointer file cannot be written.
+		 */
+		void writeGeneration(uint64_t generation) const;
+
+		/**
+		 * @brief Removes the segments older than a generation that no process has mapped.
+		 *
+		 * The caller must hold the write lock.
+		 *
+		 * @param generation The current generation.
+		 */
+		void removeOldSegments(uint64_t generation) const;
+
+		/**
+		 * @brief Starts a compaction on the background thread, unless one is running.
+		 *
+		 * The caller must hold m_mutex.
+		 */
+		void startCompaction();
+
+		/**
+		 * @brief Takes the write lock and compacts the cache, if no other process has done so. Runs on m_compactor.
+		 */
+		void runCompaction();
+
+		/**
+		 * @brief Merges the log into a new segment, dropping expired entries and evicting entries over the limits, and
+		 * empties the log.
+		 *
+		 * The caller must hold the write lock.
+		 *
+		 * @param policies The policy of every record type.
+		 * @return The size of the new segment in bytes.
+		 * @throws std::runtime_error If the segment cannot be written.
+		 */
+		uint64_t compact(const CachePolicies &policies);
+
+		/**
+		 * @brief Chooses which entries of one record type a compaction keeps.
+		 *
+		 * @param type The record type.
+		 * @param policy The policy of the record type.
+		 * @param records The merged entries of the record type.
+		 * @param keep Receives 0 for each entry to drop.
+		 */
+		void selectSurvivors(RecordType type, const CachePolicy &policy, std::span<const CacheSegment::Record> records,
+							 std::span<uint8_t> keep);
+
+		/**
+		 * @brief Reads the entries of a log.
+		 *
+		 * @param path Path of the log. A missing file has no entries.
+		 * @param entries Receives the entries, later ones replacing earlier ones.
+		 * @throws std::runtime_error If the file is not a cache log.
+		 */
+		static void readLog(const std::string &path, std::unordered_map<std::string, Entry> &entries);
+
+		/**
+		 * @brief Converts a segment record into an entry.
+		 *
+		 * @param record The record.
+		 * @return The entry.
+		 */
+		static Entry toEntry(const CacheSegment::Record &record);
+
+		/**
+		 * @brief Builds the map key for a record type and lookup key.
+		 *
+		 * @param type The record type.
+		 * @param key The lookup key.
+		 * @return The map key, which is also how the entry is written to disk.
+		 */
+		static std::string makeKey(RecordType type, const std::string &key);
+	};
+}
+
+#endif //QRZ_LOOKUPCACHE_H
@@ -0,0 +1,259 @@
+#include "DXCCTable.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+#include "../FileLock.h"
+
+using namespace qrz;
+using namespace qrz::dxcc;
+
+namespace
+{
+	// Number of tab-separated fields in each record line
+	constexpr size_t fieldCount = 11;
+
+	/**
+	 * @brief Replaces the characters that separate fields and records with spaces.
+	 *
+	 * @param value The field value.
+	 * @return The value, safe to write as one field.
+	 */
+	std::string sanitize(std::string value)
+	{
+		std::replace_if(value.begin(), value.end(), [](char c) { return c == '\t' || c == '\n' || c == '\r'; }, ' ');
+
+		return value;
+	}
+}
+
+/**
+ * @brief Constructs a table from a list of DXCC records.
+ *
+ * @param records The records. Records without a numeric entity number are dropped.
+ * @param fetchedAt When the records were fetched from the QRZ API.
+ */
+DXCCTable::DXCCTable(std::vector<DXCC> records, Clock::time_point fetchedAt) : m_fetchedAt(fetchedAt)
+{
+	std::erase_if(records, [](const DXCC &record) { return parseEntity(record.getDxcc()) < 0; });
+
+	std::sort(records.begin(), records.end(), [](const DXCC &a, const DXCC &b)
+	{
+		return parseEntity(a.getDxcc()) < parseEntity(b.getDxcc());
+	});
+
+	m_records = std::move(records);
+
+	if (!m_records.empty())
+	{
+		m_index.assign(parseEntity(m_records.back().getDxcc()) + 1, 0);
+	}
+
+	for (size_t i = 0; i < m_records.size(); ++i)
+	{
+		m_index[parseEntity(m_records[i].getDxcc())] = static_cast<uint16_t>(i + 1);
+	}
+}
+
+/**
+ * @brief Loads a table from a file written by save().
+ *
+ * @param path Path to the table file.
+ * @return The table.
+ * @throws std::runtime_error If the file cannot be read or is not a DXCC table.
+ */
+DXCCTable DXCCTable::load(const std::string &path)
+{
+	std::ifstream input(path);
+
+	if (!input)
+	{
+		throw std::runtime_error{std::format("Unable to open DXCC table {:s}", path)};
+	}
+
+	std::string line;
+	std::getline(input, line);
+
+	std::string_view header = line;
+	int64_t fetchedAt = 0;
+
+	if (!header.starts_with(m_header) || header.size() <= std::string_view(m_header).size())
+	{
+		throw std::runtime_error{std::format("{:s} is not a DXCC table", path)};
+	}
+
+	header.remove_prefix(std::string_view(m_header).size() + 1);
+	std::from_chars(header.data(), header.data() + header.size(), fetchedAt);
+
+	std::vector<DXCC> records;
+
+	while (std::getline(input, line))
+	{
+		if (line.empty())
+		{
+			continue;
+		}
+
+		std::array<std::string, fieldCount> fields;
+		std::string_view remaining = line;
+
+		for (size_t i = 0; i < fieldCount; ++i)
+		{
+			size_t tab = remaining.find('\t');
+
+			if (tab == std::string_view::npos && i + 1 < fieldCount)
+			{
+				throw std::runtime_error{std::format("Truncated record in DXCC table {:s}", path)};
+			}
+
+			fields[i] = remaining.substr(0, tab);
+			remaining.remove_prefix(tab == std::string_view::npos ? remaining.size() : tab + 1);
+		}
+
+		DXCC &record = records.emplace_back();
+		record.setDxcc(fields[0]);
+		record.setCc(fields[1]);
+		record.setCcc(fields[2]);
+		record.setName(fields[3]);
+		record.setContinent(fields[4]);
+		record.setItuzone(fields[5]);
+		record.setCqzone(fields[6]);
+		record.setTimezone(fields[7]);
+		record.setLat(fields[8]);
+		record.setLon(fields[9]);
+		record.setNotes(fields[10]);
+	}
+
+	return DXCCTable{std::move(records), Clock::time_point{std::chrono::seconds{fetchedAt}}};
+}
+
+/**
+ * @brief Writes the table to a file, replacing it atomically.
+ *
+ * The table is written to a temporary file and renamed over the old one while holding a lock, so concurrent
+ * processes never see a partial table.
+ *
+ * @param path Path to the table file. Its directory is created if needed.
+ * @throws std::runtime_error If the file cannot be written.
+ */
+void DXCCTable::save(const std::string &path) const
+{
+	std::filesystem::path parent = std::filesystem::path(path).parent_path();
+
+	if (!parent.empty() && !std::filesystem::exists(parent))
+	{
+		std::filesystem::create_directories(parent);
+	}
+
+	FileLock lock(path + ".lock");
+
+	std::string tempFilePath = path + ".tmp";
+
+	{
+		std::ofstream output(tempFilePath, std::ios::trunc);
+
+		if (!output)
+		{
+			throw std::runtime_error{std::format("Unable to write DXCC table {:s}", tempFilePath)};
+		}
+
+		auto fetchedAt = std::chrono::duration_cast<std::chrono::seconds>(m_fetchedAt.time_since_epoch()).count();
+
+		output << m_header << '\t' << fetchedAt << '\n';
+
+		for (const DXCC &record : m_records)
+		{
+			output << sanitize(record.getDxcc()) << '\t'
+				   << sanitize(record.getCc()) << '\t'
+				   << sanitize(record.getCcc()) << '\t'
+				   << sanitize(record.getName()) << '\t'
+				   << sanitize(record.getContinent()) << '\t'
+				   << sanitize(record.getItuzone()) << '\t'
+				   << sanitize(record.getCqzone()) << '\t'
+				   << sanitize(record.getTimezone()) << '\t'
+				   << sanitize(record.getLat()) << '\t'
+				   << sanitize(record.getLon()) << '\t'
+				   << sanitize(record.getNotes()) << '\n';
+		}
+
+		if (!output.flush())
+		{
+			throw std::runtime_error{std::format("Unable to write DXCC table {:s}", tempFilePath)};
+		}
+	}
+
+	std::filesystem::rename(tempFilePath, path);
+}
+
+/**
+ * @brief Finds a DXCC entity by its entity number.
+ *
+ * @param dxcc The entity number, e.g. 291.
+ * @return The record, or nullptr if the table has no entity with that number.
+ */
+const DXCC *DXCCTable::find(std::string_view dxcc) const
+{
+	int64_t entity = parseEntity(dxcc);
+
+	if (entity < 0 || static_cast<size_t>(entity) >= m_index.size() || m_index[entity] == 0)
+	{
+		return nullptr;
+	}
+
+	return &m_records[m_index[entity] - 1];
+}
+
+/**
+ * @brief Returns the number of entities in the table.
+ *
+ * @return The entity count.
+ */
+size_t DXCCTable::size() const
+{
+	return m_records.size();
+}
+
+/**
+ * @brief Returns when the records were fetched from the QRZ API.
+ *
+ * @return The fetch time.
+ */
+DXCCTable::Clock::time_point DXCCTable::getFetchedAt() const
+{
+	return m_fetchedAt;
+}
+
+/**
+ * @brief Checks whether the table is older than the given age.
+ *
+ * @param maxAge The maximum age.
+ * @return True if the records were fetched more than maxAge ago.
+ */
+bool DXCCTable::isStale(std::chrono::seconds maxAge) const
+{
+	return Clock::now() - m_fetchedAt > maxAge;
+}
+
+/**
+ * @brief Parses an entity number.
+ *
+ * @param dxcc The entity number as text.
+ * @return The entity number, or -1 if it is not a number the index accepts.
+ */
+int64_t DXCCTable::parseEntity(std::string_view dxcc)
+{
+	uint32_t entity = 0;
+	auto [end, error] = std::from_chars(dxcc.data(), dxcc.data() + dxcc.size(), entity);
+
+	if (dxcc.empty() || error != std::errc{} || end != dxcc.data() + dxcc.size() || entity > m_maxEntity)
+	{
+		return -1;
+	}
+
+	return entity;
+}
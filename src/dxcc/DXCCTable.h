@@ -0,0 +1,112 @@
+#ifndef QRZ_DXCCTABLE_H
+#define QRZ_DXCCTABLE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../model/DXCC.h"
+
+namespace qrz::dxcc
+{
+	/**
+	 * @class DXCCTable
+	 * @brief A local mirror of the complete QRZ DXCC entity list.
+	 *
+	 * The records are held sorted by entity number, with a direct-address index from entity number to record, so a
+	 * lookup is a single array access. Entity numbers are small and dense (there are a few hundred), which keeps the
+	 * index to a couple of kilobytes.
+	 *
+	 * On disk the table is a tab-separated file, one entity per line, after a header line recording when the list was
+	 * fetched. It is replaced atomically while holding a lock, like the configuration file.
+	 */
+	class DXCCTable
+	{
+	public:
+		using Clock = std::chrono::system_clock;
+
+		DXCCTable() = default;
+
+		/**
+		 * @brief Constructs a table from a list of DXCC records.
+		 *
+		 * @param records The records. Records without a numeric entity number are dropped.
+		 * @param fetchedAt When the records were fetched from the QRZ API.
+		 */
+		DXCCTable(std::vector<DXCC> records, Clock::time_point fetchedAt);
+
+		/**
+		 * @brief Loads a table from a file written by save().
+		 *
+		 * @param path Path to the table file.
+		 * @return The table.
+		 * @throws std::runtime_error If the file cannot be read or is not a DXCC table.
+		 */
+		static DXCCTable load(const std::string &path);
+
+		/**
+		 * @brief Writes the table to a file, replacing it atomically.
+		 *
+		 * @param path Path to the table file. Its directory is created if needed.
+		 * @throws std::runtime_error If the file cannot be written.
+		 */
+		void save(const std::string &path) const;
+
+		/**
+		 * @brief Finds a DXCC entity by its entity number.
+		 *
+		 * @param dxcc The entity number, e.g. 291.
+		 * @return The record, or nullptr if the table has no entity with that number.
+		 */
+		const DXCC *find(std::string_view dxcc) const;
+
+		/**
+		 * @brief Returns the number of entities in the table.
+		 *
+		 * @return The entity count.
+		 */
+		size_t size() const;
+
+		/**
+		 * @brief Returns when the records were fetched from the QRZ API.
+		 *
+		 * @return The fetch time.
+		 */
+		Clock::time_point getFetchedAt() const;
+
+		/**
+		 * @brief Checks whether the table is older than the given age.
+		 *
+		 * @param maxAge The maximum age.
+		 * @return True if the records were fetched more than maxAge ago.
+		 */
+		bool isStale(std::chrono::seconds maxAge) const;
+
+	private:
+		// First line of every table file
+		static inline const char *m_header = "# qrz dxcc table v1";
+
+		// Largest entity number the index accepts
+		static constexpr uint32_t m_maxEntity = 9999;
+
+		// Records, sorted by entity number
+		std::vector<DXCC> m_records;
+
+		// Entity number to position in m_records plus one, or 0 when there is no such entity
+		std::vector<uint16_t> m_index;
+
+		Clock::time_point m_fetchedAt;
+
+		/**
+		 * @brief Parses an entity number.
+		 *
+		 * @param dxcc The entity number as text.
+		 * @return The entity number, or -1 if it is not a number the index accepts.
+		 */
+		static int64_t parseEntity(std::string_view dxcc);
+	};
+}
+
+#endif //QRZ_DXCCTABLE_H
@@ -0,0 +1,500 @@
+#include "PrefixResolver.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include "../CallsignNormalizer.h"
+
+using namespace qrz;
+using namespace qrz::dxcc;
+
+namespace
+{
+	constexpr const char *whitespace = " \t\r\n";
+
+	/**
+	 * @brief Removes leading and trailing whitespace.
+	 *
+	 * @param text The text to trim.
+	 * @return The trimmed text.
+	 */
+	std::string_view trim(std::string_view text)
+	{
+		size_t first = text.find_first_not_of(whitespace);
+
+		if (first == std::string_view::npos)
+		{
+			return {};
+		}
+
+		return text.substr(first, text.find_last_not_of(whitespace) - first + 1);
+	}
+
+	/**
+	 * @brief Parses a number from a field of the prefix table.
+	 *
+	 * @param text The field.
+	 * @return The number.
+	 * @throws std::runtime_error If the field is not a number.
+	 */
+	template<typename T>
+	T parseNumber(std::string_view text)
+	{
+		text = trim(text);
+
+		if (!text.empty() && text.front() == '+')
+		{
+			text.remove_prefix(1);
+		}
+
+		T value{};
+		auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+		if (error != std::errc{} || end != text.data() + text.size())
+		{
+			throw std::runtime_error{std::format("Malformed number in prefix table: '{:s}'", text)};
+		}
+
+		return value;
+	}
+
+	/**
+	 * @brief Splits off the next field, up to a separator.
+	 *
+	 * @param text The remaining text, advanced past the separator.
+	 * @param separator The field separator.
+	 * @return The trimmed field, or std::nullopt if the separator was not found.
+	 */
+	std::optional<std::string_view> nextField(std::string_view &text, char separator)
+	{
+		size_t end = text.find(separator);
+
+		if (end == std::string_view::npos)
+		{
+			return std::nullopt;
+		}
+
+		std::string_view field = trim(text.substr(0, end));
+		text.remove_prefix(end + 1);
+
+		return field;
+	}
+
+	/**
+	 * @brief Flips the sign of a value stored positive to the west, without ever producing -0.
+	 *
+	 * @param value The value, positive to the west as cty stores it.
+	 * @return The value, positive to the east.
+	 */
+	float toEastPositive(float value)
+	{
+		return 0.0f - value;
+	}
+}
+
+/**
+ * @brief Loads a prefix table from a file.
+ *
+ * @param path Path to a cty.dat or cty.csv file.
+ * @return The resolver.
+ * @throws std::runtime_error If the file cannot be read or is malformed.
+ */
+PrefixResolver PrefixResolver::load(const std::string &path)
+{
+	std::ifstream input(path, std::ios::binary);
+
+	if (!input)
+	{
+		throw std::runtime_error{std::format("Unable to open prefix table {:s}", path)};
+	}
+
+	return parse(input);
+}
+
+/**
+ * @brief Parses a prefix table.
+ *
+ * The format is detected from the first line: a cty.dat entity header ends with a colon, and a cty.csv record ends
+ * with a semicolon.
+ *
+ * @param input Stream holding the contents of a cty.dat or cty.csv file.
+ * @return The resolver.
+ * @throws std::runtime_error If the table is malformed.
+ */
+PrefixResolver PrefixResolver::parse(std::istream &input)
+{
+	const std::string text{std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+
+	PrefixResolver output;
+	PrefixTrie::Builder builder;
+
+	std::string_view firstLine = trim(std::string_view(text).substr(0, text.find('\n', text.find_first_not_of(whitespace))));
+
+	if (!firstLine.empty() && firstLine.back() == ':')
+	{
+		output.parseDat(text, builder);
+	}
+	else
+	{
+		output.parseCsv(text, builder);
+	}
+
+	output.m_trie = builder.build();
+
+	return output;
+}
+
+/**
+ * @brief Parses the contents of a cty.dat file.
+ *
+ * Each entity is a header of eight colon-terminated fields, followed by its prefixes, which may run over several lines
+ * and end with a semicolon:
+ *
+ *     Sov Mil Order of Malta:   15:  28:  EU:   41.90:   -12.43:    -1.0:  1A:
+ *         1A;
+ *
+ * @param text The file contents.
+ * @param builder Builder to add the prefixes to.
+ */
+void PrefixResolver::parseDat(std::string_view text, PrefixTrie::Builder &builder)
+{
+	while (!trim(text).empty())
+	{
+		std::array<std::string_view, 8> fields;
+
+		for (std::string_view &field : fields)
+		{
+			std::optional<std::string_view> next = nextField(text, ':');
+
+			if (!next)
+			{
+				throw std::runtime_error{"Truncated entity header in prefix table"};
+			}
+
+			field = *next;
+		}
+
+		std::optional<std::string_view> aliases = nextField(text, ';');
+
+		if (!aliases)
+		{
+			throw std::runtime_error{std::format("Unterminated prefix list for {:s} in prefix table", fields[0])};
+		}
+
+		Entity entity;
+		entity.name = fields[0];
+		entity.prefix = fields[7];
+
+		Location defaults;
+		defaults.cqZone = parseNumber<uint8_t>(fields[1]);
+		defaults.ituZone = parseNumber<uint8_t>(fields[2]);
+		fields[3].copy(defaults.continent, 2);
+		defaults.lat = parseNumber<float>(fields[4]);
+		defaults.lon = parseNumber<float>(fields[5]);
+		defaults.utcOffset = parseNumber<float>(fields[6]);
+
+		bool waeOnly = entity.prefix.starts_with('*');
+
+		addEntity(std::move(entity), defaults, *aliases, builder, waeOnly);
+	}
+}
+
+/**
+ * @brief Parses the contents of a cty.csv file.
+ *
+ * Each entity is one line of comma-separated fields, with its prefixes separated by spaces in the last field:
+ *
+ *     1A,Sov Mil Order of Malta,246,EU,15,28,41.90,-12.43,-1.0,1A;
+ *
+ * @param text The file contents.
+ * @param builder Builder to add the prefixes to.
+ */
+void PrefixResolver::parseCsv(std::string_view text, PrefixTrie::Builder &builder)
+{
+	while (!text.empty())
+	{
+		size_t end = text.find('\n');
+		std::string_view line = trim(text.substr(0, end));
+		text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+
+		if (line.empty())
+		{
+			continue;
+		}
+
+		std::array<std::string_view, 9> fields;
+
+		for (std::string_view &field : fields)
+		{
+			std::optional<std::string_view> next = nextField(line, ',');
+
+			if (!next)
+			{
+				throw std::runtime_error{std::format("Truncated record in prefix table: {:s}", line)};
+			}
+
+			field = *next;
+		}
+
+		std::optional<std::string_view> aliases = nextField(line, ';');
+
+		if (!aliases)
+		{
+			throw std::runtime_error{std::format("Unterminated prefix list for {:s} in prefix table", fields[1])};
+		}
+
+		Entity entity;
+		entity.prefix = fields[0];
+		entity.name = fields[1];
+		entity.dxcc = fields[2];
+
+		Location defaults;
+		fields[3].copy(defaults.continent, 2);
+		defaults.cqZone = parseNumber<uint8_t>(fields[4]);
+		defaults.ituZone = parseNumber<uint8_t>(fields[5]);
+		defaults.lat = parseNumber<float>(fields[6]);
+		defaults.lon = parseNumber<float>(fields[7]);
+		defaults.utcOffset = parseNumber<float>(fields[8]);
+
+		bool waeOnly = entity.prefix.starts_with('*');
+
+		addEntity(std::move(entity), defaults, *aliases, builder, waeOnly);
+	}
+}
+
+/**
+ * @brief Adds an entity and its prefixes to the table.
+ *
+ * @param entity The entity.
+ * @param defaults The entity's default location.
+ * @param aliases The entity's prefix list, separated by commas or whitespace.
+ * @param builder Builder to add the prefixes to.
+ * @param waeOnly Whether the entity only counts for the WAE award, and so must not claim its entity number.
+ */
+void PrefixResolver::addEntity(Entity entity, Location defaults, std::string_view aliases, PrefixTrie::Builder &builder,
+							   bool waeOnly)
+{
+	uint32_t entityIndex = static_cast<uint32_t>(m_entities.size());
+
+	if (waeOnly)
+	{
+		entity.prefix.erase(0, 1);
+	}
+
+	entity.location = static_cast<uint32_t>(m_locations.size());
+	defaults.entity = entityIndex;
+	m_locations.push_back(defaults);
+
+	if (!entity.dxcc.empty() && !waeOnly)
+	{
+		m_entitiesByDxcc.emplace(entity.dxcc, entityIndex);
+	}
+
+	m_entities.push_back(std::move(entity));
+
+	while (true)
+	{
+		size_t first = aliases.find_first_not_of(" \t\r\n,");
+
+		if (first == std::string_view::npos)
+		{
+			break;
+		}
+
+		aliases.remove_prefix(first);
+
+		size_t end = std::min(aliases.find_first_of(" \t\r\n,"), aliases.size());
+
+		addAlias(aliases.substr(0, end), defaults, builder);
+		aliases.remove_prefix(end);
+	}
+}
+
+/**
+ * @brief Adds a single prefix, with any location overrides, to the table.
+ *
+ * A leading '=' marks an exact callsign rather than a prefix. The prefix may be followed by overrides of its
+ * entity's location: (CQ zone), [ITU zone], <lat/lon>, {continent} and ~UTC offset~.
+ *
+ * @param alias The prefix, e.g. K, =W1AW or KH6(31)[61].
+ * @param defaults The location of the prefix's entity.
+ * @param builder Builder to add the prefix to.
+ */
+void PrefixResolver::addAlias(std::string_view alias, const Location &defaults, PrefixTrie::Builder &builder)
+{
+	bool exact = alias.starts_with('=');
+
+	if (exact)
+	{
+		alias.remove_prefix(1);
+	}
+
+	size_t keyEnd = std::min(alias.find_first_of("([<{~"), alias.size());
+
+	std::string key = CallsignNormalizer::clean(alias.substr(0, keyEnd));
+	std::string_view overrides = alias.substr(keyEnd);
+
+	if (key.empty())
+	{
+		return;
+	}
+
+	Location location = defaults;
+
+	while (!overrides.empty())
+	{
+		char open = overrides.front();
+		char close = (open == '(') ? ')' : (open == '[') ? ']' : (open == '<') ? '>' : (open == '{') ? '}' : '~';
+
+		size_t end = overrides.find(close, 1);
+
+		if (end == std::string_view::npos)
+		{
+			throw std::runtime_error{std::format("Unterminated override in prefix table: {:s}", alias)};
+		}
+
+		std::string_view value = overrides.substr(1, end - 1);
+		overrides.remove_prefix(end + 1);
+
+		switch (open)
+		{
+			case '(':
+				location.cqZone = parseNumber<uint8_t>(value);
+				break;
+			case '[':
+				location.ituZone = parseNumber<uint8_t>(value);
+				break;
+			case '<':
+			{
+				size_t slash = value.find('/');
+
+				if (slash == std::string_view::npos)
+				{
+					throw std::runtime_error{std::format("Malformed position override in prefix table: {:s}", alias)};
+				}
+
+				location.lat = parseNumber<float>(value.substr(0, slash));
+				location.lon = parseNumber<float>(value.substr(slash + 1));
+				break;
+			}
+			case '{':
+				value.copy(location.continent, 2);
+				break;
+			case '~':
+				location.utcOffset = parseNumber<float>(value);
+				break;
+			default:
+				throw std::runtime_error{std::format("Unknown override in prefix table: {:s}", alias)};
+		}
+	}
+
+	uint32_t locationIndex = m_entities[defaults.entity].location;
+
+	if (location != defaults)
+	{
+		locationIndex = static_cast<uint32_t>(m_locations.size());
+		m_locations.push_back(location);
+	}
+
+	builder.insert(key, locationIndex, exact);
+}
+
+/**
+ * @brief Resolves the DXCC entity of a callsign.
+ *
+ * Exact callsigns in the table are checked first. Otherwise the entity comes from the callsign's prefix, as in
+ * VE3/W1AW, or from a suffix that names a location, as in W1AW/KH6, and failing both from the base callsign.
+ * Single-character suffixes such as /P, /M or /4 and operating suffixes such as /QRP leave the entity unchanged.
+ *
+ * @param callsign The callsign, which may carry a prefix or suffix such as VE3/W1AW or W1AW/KH6.
+ * @return The DXCC record, or std::nullopt if the callsign is malformed, maritime or aeronautical mobile, or
+ * matches no prefix.
+ */
+std::optional<DXCC> PrefixResolver::resolve(std::string_view callsign) const
+{
+	std::string cleaned = CallsignNormalizer::clean(callsign);
+
+	uint32_t location = m_trie.findExact(cleaned);
+
+	if (location == PrefixTrie::npos)
+	{
+		std::optional<ParsedCallsign> parsed = CallsignNormalizer::parse(cleaned);
+
+		if (!parsed || parsed->suffix == "MM" || parsed->suffix == "AM")
+		{
+			return std::nullopt;
+		}
+
+		std::string_view key = parsed->locationPart();
+
+		location = m_trie.find(key.empty() ? std::string_view(parsed->base) : key);
+	}
+
+	if (location == PrefixTrie::npos)
+	{
+		return std::nullopt;
+	}
+
+	return toDXCC(location);
+}
+
+/**
+ * @brief Finds a DXCC entity by its entity number.
+ *
+ * @param dxcc The entity number, e.g. 291.
+ * @return The DXCC record, or std::nullopt if the table has no entity with that number.
+ */
+std::optional<DXCC> PrefixResolver::findEntity(std::string_view dxcc) const
+{
+	auto it = m_entitiesByDxcc.find(std::string(dxcc));
+
+	if (it == m_entitiesByDxcc.end())
+	{
+		return std::nullopt;
+	}
+
+	return toDXCC(m_entities[it->second].location);
+}
+
+/**
+ * @brief Returns the number of entities in the table.
+ *
+ * @return The entity count.
+ */
+size_t PrefixResolver::entityCount() const
+{
+	return m_entities.size();
+}
+
+/**
+ * @brief Builds a DXCC record for a location.
+ *
+ * cty stores longitude and UTC offset positive to the west, so both are flipped to match the QRZ API, which has them
+ * positive to the east.
+ *
+ * @param location Index of the location in m_locations.
+ * @return The DXCC record.
+ */
+DXCC PrefixResolver::toDXCC(uint32_t location) const
+{
+	const Location &place = m_locations[location];
+	const Entity &entity = m_entities[place.entity];
+
+	DXCC output;
+
+	output.setDxcc(entity.dxcc);
+	output.setName(entity.name);
+	output.setContinent(std::string(place.continent, std::find(place.continent, place.continent + 2, '\0')));
+	output.setCqzone(std::to_string(place.cqZone));
+	output.setItuzone(std::to_string(place.ituZone));
+	output.setTimezone(std::format("{:g}", toEastPositive(place.utcOffset)));
+	output.setLat(std::format("{:.2f}", place.lat));
+	output.setLon(std::format("{:.2f}", toEastPositive(place.lon)));
+
+	return output;
+}
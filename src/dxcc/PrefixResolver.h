@@ -0,0 +1,162 @@
+#ifndef QRZ_PREFIXRESOLVER_H
+#define QRZ_PREFIXRESOLVER_H
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "PrefixTrie.h"
+#include "../model/DXCC.h"
+
+namespace qrz::dxcc
+{
+	/**
+	 * @class PrefixResolver
+	 * @brief Resolves callsigns to DXCC entities offline, from a country file prefix table.
+	 *
+	 * The table is loaded from a cty.dat or cty.csv file, as published at country-files.com. Every prefix and exact
+	 * callsign in the file is loaded into a PrefixTrie, so resolving a callsign is one walk down the trie followed by
+	 * a lookup in a flat array of locations.
+	 *
+	 * Prefixes may override the CQ zone, ITU zone, continent, position or UTC offset of their entity, so each one
+	 * maps to a location rather than directly to an entity. cty.dat does not carry DXCC entity numbers, so records
+	 * resolved from it have an empty entity number and cannot be found with findEntity(). cty.csv carries them.
+	 */
+	class PrefixResolver
+	{
+	public:
+		PrefixResolver() = default;
+
+		/**
+		 * @brief Loads a prefix table from a file.
+		 *
+		 * @param path Path to a cty.dat or cty.csv file.
+		 * @return The resolver.
+		 * @throws std::runtime_error If the file cannot be read or is malformed.
+		 */
+		static PrefixResolver load(const std::string &path);
+
+		/**
+		 * @brief Parses a prefix table.
+		 *
+		 * @param input Stream holding the contents of a cty.dat or cty.csv file.
+		 * @return The resolver.
+		 * @throws std::runtime_error If the table is malformed.
+		 */
+		static PrefixResolver parse(std::istream &input);
+
+		/**
+		 * @brief Resolves the DXCC entity of a callsign.
+		 *
+		 * @param callsign The callsign, which may carry a prefix or suffix such as VE3/W1AW or W1AW/KH6.
+		 * @return The DXCC record, or std::nullopt if the callsign is malformed, maritime or aeronautical mobile, or
+		 * matches no prefix.
+		 */
+		std::optional<DXCC> resolve(std::string_view callsign) const;
+
+		/**
+		 * @brief Finds a DXCC entity by its entity number.
+		 *
+		 * @param dxcc The entity number, e.g. 291.
+		 * @return The DXCC record, or std::nullopt if the table has no entity with that number.
+		 */
+		std::optional<DXCC> findEntity(std::string_view dxcc) const;
+
+		/**
+		 * @brief Returns the number of entities in the table.
+		 *
+		 * @return The entity count.
+		 */
+		size_t entityCount() const;
+
+	private:
+		struct Entity
+		{
+			std::string name;
+
+			// Primary prefix, without cty's '*' marker for WAE-only entities
+			std::string prefix;
+
+			// DXCC entity number, empty if the table does not carry it
+			std::string dxcc;
+
+			// Index of the entity's default location in m_locations
+			uint32_t location = 0;
+		};
+
+		struct Location
+		{
+			uint32_t entity = 0;
+			uint8_t cqZone = 0;
+			uint8_t ituZone = 0;
+			char continent[2] = {};
+
+			// Position and UTC offset as cty stores them: longitude and offset are positive to the west
+			float lat = 0;
+			float lon = 0;
+			float utcOffset = 0;
+
+			bool operator==(const Location &) const = default;
+		};
+
+		std::vector<Entity> m_entities;
+
+		std::vector<Location> m_locations;
+
+		PrefixTrie m_trie;
+
+		// Entity number to entity index
+		std::unordered_map<std::string, uint32_t> m_entitiesByDxcc;
+
+		/**
+		 * @brief Parses the contents of a cty.dat file.
+		 *
+		 * @param text The file contents.
+		 * @param builder Builder to add the prefixes to.
+		 */
+		void parseDat(std::string_view text, PrefixTrie::Builder &builder);
+
+		/**
+		 * @brief Parses the contents of a cty.csv file.
+		 *
+		 * @param text The file contents.
+		 * @param builder Builder to add the prefixes to.
+		 */
+		void parseCsv(std::string_view text, PrefixTrie::Builder &builder);
+
+		/**
+		 * @brief Adds an entity and its prefixes to the table.
+		 *
+		 * @param entity The entity.
+		 * @param defaults The entity's default location.
+		 * @param aliases The entity's prefix list, separated by commas or whitespace.
+		 * @param builder Builder to add the prefixes to.
+		 * @param waeOnly Whether the entity only counts for the WAE award, and so must not claim its entity number.
+		 */
+		void addEntity(Entity entity, Location defaults, std::string_view aliases, PrefixTrie::Builder &builder,
+					   bool waeOnly);
+
+		/**
+		 * @brief Adds a single prefix, with any location overrides, to the table.
+		 *
+		 * @param alias The prefix, e.g. K, =W1AW or KH6(31)[61].
+		 * @param defaults The location of the prefix's entity.
+		 * @param builder Builder to add the prefix to.
+		 */
+		void addAlias(std::string_view alias, const Location &defaults, PrefixTrie::Builder &builder);
+
+		/**
+		 * @brief Builds a DXCC record for a location.
+		 *
+		 * @param location Index of the location in m_locations.
+		 * @return The DXCC record.
+		 */
+		DXCC toDXCC(uint32_t location) const;
+	};
+}
+
+#endif //QRZ_PREFIXRESOLVER_H
@@ -0,0 +1,177 @@
+#include "PrefixTrie.h"
+
+#include <algorithm>
+#include <deque>
+
+using namespace qrz::dxcc;
+
+/**
+ * @brief Constructs a builder holding only the root node.
+ */
+PrefixTrie::Builder::Builder() : m_nodes(1)
+{}
+
+/**
+ * @brief Adds a key to the trie. A later insert of the same key replaces the earlier value.
+ *
+ * @param key The prefix or callsign, in uppercase.
+ * @param value The value to map the key to.
+ * @param exact True if the key only matches a whole callsign, false if it matches as a prefix.
+ */
+void PrefixTrie::Builder::insert(std::string_view key, uint32_t value, bool exact)
+{
+	uint32_t node = 0;
+
+	for (char c : key)
+	{
+		auto it = m_nodes[node].children.find(c);
+
+		if (it == m_nodes[node].children.end())
+		{
+			uint32_t child = static_cast<uint32_t>(m_nodes.size());
+
+			m_nodes[node].children.emplace(c, child);
+			m_nodes.emplace_back();
+
+			node = child;
+		}
+		else
+		{
+			node = it->second;
+		}
+	}
+
+	if (exact)
+	{
+		m_nodes[node].exactValue = value;
+	}
+	else
+	{
+		m_nodes[node].prefixValue = value;
+	}
+}
+
+/**
+ * @brief Flattens the collected keys into a trie.
+ *
+ * Nodes are numbered breadth-first, so the children of every node are contiguous and its edges can be stored as one
+ * run of labels and targets.
+ *
+ * @return The trie.
+ */
+PrefixTrie PrefixTrie::Builder::build() const
+{
+	PrefixTrie output;
+
+	output.m_nodes.clear();
+	output.m_nodes.reserve(m_nodes.size());
+	output.m_labels.reserve(m_nodes.size());
+	output.m_targets.reserve(m_nodes.size());
+
+	// Builder node indices, in the order they are numbered in the flat trie
+	std::deque<uint32_t> queue{0};
+	uint32_t nextIndex = 1;
+
+	while (!queue.empty())
+	{
+		const Node &source = m_nodes[queue.front()];
+		queue.pop_front();
+
+		PrefixTrie::Node &node = output.m_nodes.emplace_back();
+		node.firstEdge = static_cast<uint32_t>(output.m_labels.size());
+		node.edgeCount = static_cast<uint32_t>(source.children.size());
+		node.prefixValue = source.prefixValue;
+		node.exactValue = source.exactValue;
+
+		// std::map iterates in key order, so the labels come out sorted
+		for (const auto &[label, child] : source.children)
+		{
+			output.m_labels.push_back(label);
+			output.m_targets.push_back(nextIndex++);
+			queue.push_back(child);
+		}
+	}
+
+	return output;
+}
+
+/**
+ * @brief Constructs an empty trie.
+ */
+PrefixTrie::PrefixTrie() : m_nodes(1)
+{}
+
+/**
+ * @brief Finds the value for a callsign.
+ *
+ * @param callsign The callsign, in uppercase.
+ * @return The value of the exact match for the callsign if there is one, otherwise the value of its longest
+ * matching prefix, or npos if nothing matches.
+ */
+uint32_t PrefixTrie::find(std::string_view callsign) const
+{
+	uint32_t node = 0;
+	uint32_t longestPrefix = m_nodes[0].prefixValue;
+
+	for (char c : callsign)
+	{
+		const Node &current = m_nodes[node];
+
+		const char *first = m_labels.data() + current.firstEdge;
+		const char *last = first + current.edgeCount;
+		const char *edge = std::find(first, last, c);
+
+		if (edge == last)
+		{
+			return longestPrefix;
+		}
+
+		node = m_targets[edge - m_labels.data()];
+
+		if (m_nodes[node].prefixValue != npos)
+		{
+			longestPrefix = m_nodes[node].prefixValue;
+		}
+	}
+
+	return (m_nodes[node].exactValue != npos) ? m_nodes[node].exactValue : longestPrefix;
+}
+
+/**
+ * @brief Finds the value of an exact match for a callsign, ignoring prefixes.
+ *
+ * @param callsign The callsign, in uppercase.
+ * @return The value of the exact match for the callsign, or npos if there is none.
+ */
+uint32_t PrefixTrie::findExact(std::string_view callsign) const
+{
+	uint32_t node = 0;
+
+	for (char c : callsign)
+	{
+		const Node &current = m_nodes[node];
+
+		const char *first = m_labels.data() + current.firstEdge;
+		const char *last = first + current.edgeCount;
+		const char *edge = std::find(first, last, c);
+
+		if (edge == last)
+		{
+			return npos;
+		}
+
+		node = m_targets[edge - m_labels.data()];
+	}
+
+	return m_nodes[node].exactValue;
+}
+
+/**
+ * @brief Returns the number of nodes in the trie.
+ *
+ * @return The node count, including the root.
+ */
+size_t PrefixTrie::nodeCount() const
+{
+	return m_nodes.size();
+}
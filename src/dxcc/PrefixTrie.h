@@ -0,0 +1,114 @@
+#ifndef QRZ_PREFIXTRIE_H
+#define QRZ_PREFIXTRIE_H
+
+#include <cstdint>
+#include <map>
+#include <string_view>
+#include <vector>
+
+namespace qrz::dxcc
+{
+	/**
+	 * @class PrefixTrie
+	 * @brief An immutable trie mapping callsign prefixes and exact callsigns to values.
+	 *
+	 * The trie is assembled with a PrefixTrie::Builder and then flattened into three arrays: the nodes, and the labels
+	 * and targets of their edges. The edges of a node are contiguous and sorted, so a lookup is a single walk down the
+	 * trie touching a handful of cache lines, with no allocation.
+	 *
+	 * Each node holds two values: one for keys that match as a prefix (W1 matches W1AW), and one for keys that only
+	 * match the whole callsign (cty.dat's =W1AW entries). An exact match always wins over a prefix match.
+	 */
+	class PrefixTrie
+	{
+	public:
+		// Value returned when nothing matches
+		static constexpr uint32_t npos = UINT32_MAX;
+
+		/**
+		 * @class Builder
+		 * @brief Collects keys for a PrefixTrie, then flattens them into one.
+		 */
+		class Builder
+		{
+		public:
+			Builder();
+
+			/**
+			 * @brief Adds a key to the trie. A later insert of the same key replaces the earlier value.
+			 *
+			 * @param key The prefix or callsign, in uppercase.
+			 * @param value The value to map the key to.
+			 * @param exact True if the key only matches a whole callsign, false if it matches as a prefix.
+			 */
+			void insert(std::string_view key, uint32_t value, bool exact);
+
+			/**
+			 * @brief Flattens the collected keys into a trie.
+			 *
+			 * @return The trie.
+			 */
+			PrefixTrie build() const;
+
+		private:
+			struct Node
+			{
+				std::map<char, uint32_t> children;
+				uint32_t prefixValue = npos;
+				uint32_t exactValue = npos;
+			};
+
+			std::vector<Node> m_nodes;
+		};
+
+		PrefixTrie();
+
+		/**
+		 * @brief Finds the value for a callsign.
+		 *
+		 * @param callsign The callsign, in uppercase.
+		 * @return The value of the exact match for the callsign if there is one, otherwise the value of its longest
+		 * matching prefix, or npos if nothing matches.
+		 */
+		uint32_t find(std::string_view callsign) const;
+
+		/**
+		 * @brief Finds the value of an exact match for a callsign, ignoring prefixes.
+		 *
+		 * @param callsign The callsign, in uppercase.
+		 * @return The value of the exact match for the callsign, or npos if there is none.
+		 */
+		uint32_t findExact(std::string_view callsign) const;
+
+		/**
+		 * @brief Returns the number of nodes in the trie.
+		 *
+		 * @return The node count, including the root.
+		 */
+		size_t nodeCount() const;
+
+	private:
+		struct Node
+		{
+			// Index of the node's first edge in m_labels and m_targets
+			uint32_t firstEdge = 0;
+
+			// Number of edges leaving the node
+			uint32_t edgeCount = 0;
+
+			uint32_t prefixValue = npos;
+			uint32_t exactValue = npos;
+		};
+
+		// Nodes in breadth-first order, the root first
+		std::vector<Node> m_nodes;
+
+		// Edge labels, sorted within each node
+		std::vector<char> m_labels;
+
+		// Edge target node indices, parallel to m_labels
+		std::vector<uint32_t> m_targets;
+	};
+}
+
+#endif //QRZ_PREFIXTRIE_H
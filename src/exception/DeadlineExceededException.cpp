@@ -0,0 +1,6 @@
+#include "DeadlineExceededException.h"
+
+const char* qrz::DeadlineExceededException::what() const noexcept
+{
+	return m_message.c_str();
+};
\ No newline at end of file
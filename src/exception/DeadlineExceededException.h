@@ -0,0 +1,27 @@
+#ifndef QRZ_DEADLINEEXCEEDEDEXCEPTION_H
+#define QRZ_DEADLINEEXCEEDEDEXCEPTION_H
+
+#include <exception>
+#include <string>
+
+namespace qrz
+{
+	/**
+	 * @class DeadlineExceededException
+	 * @brief Represents an exception that is thrown when a lookup runs out of time or is cancelled.
+	 *
+	 * This exception class inherits from std::exception class.
+	 */
+	class DeadlineExceededException : public std::exception
+	{
+	public:
+		explicit DeadlineExceededException(std::string_view message = "Timed out") : m_message(message)
+		{}
+
+		const char *what() const noexcept override;
+
+	private :
+		std::string m_message;
+	};
+}
+#endif //QRZ_DEADLINEEXCEEDEDEXCEPTION_H
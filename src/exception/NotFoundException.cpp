@@ -0,0 +1,6 @@
+#include "NotFoundException.h"
+
+const char* qrz::NotFoundException::what() const noexcept
+{
+	return m_message.c_str();
+};
\ No newline at end of file
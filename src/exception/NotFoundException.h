@@ -0,0 +1,27 @@
+#ifndef QRZ_NOTFOUNDEXCEPTION_H
+#define QRZ_NOTFOUNDEXCEPTION_H
+
+#include <exception>
+#include <string>
+
+namespace qrz
+{
+	/**
+	 * @class NotFoundException
+	 * @brief Represents an exception that is thrown when the QRZ API has no record for a lookup.
+	 *
+	 * This exception class inherits from std::exception class.
+	 */
+	class NotFoundException : public std::exception
+	{
+	public:
+		explicit NotFoundException(std::string_view message = "Not found") : m_message(message)
+		{}
+
+		const char *what() const noexcept override;
+
+	private :
+		std::string m_message;
+	};
+}
+#endif //QRZ_NOTFOUNDEXCEPTION_H
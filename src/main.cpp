@@ -1,11 +1,15 @@
 #include <iostream>
+#include <stdexcept>
 
 #include <argparse/argparse.hpp>
 
 #include "Action.h"
 #include "AppController.h"
+#include "CallsignNormalizer.h"
 #include "OutputFormat.h"
+#include "TermReader.h"
 #include "Util.h"
+#include "render/CallsignTemplate.h"
 
 using namespace qrz;
 
@@ -19,11 +23,99 @@ int main(int argc, char **argv)
 
 	program.add_argument("-a", "--action")
 			.default_value("callsign")
-			.help("Specify the action to perform. callsign[default]|bio|dxcc|login");
+			.help("Specify the action to perform. callsign[default]|bio|dxcc|mirror|adif|login");
 
 	program.add_argument("-f", "--format")
 			.default_value("console")
-			.help("Specify the output format. Console[default]|CSV|JSON|XML|MD");
+			.help("Specify the output format. Console[default]|CSV|JSON|XML|MD|ADIF");
+
+	program.add_argument("--stats")
+			.default_value(false)
+			.implicit_value(true)
+			.help("Print request statistics and per-phase timings to stderr when the command completes");
+
+	program.add_argument("--metrics")
+			.help("Write request latency, cache, retry and error metrics to this file in the Prometheus text format");
+
+	program.add_argument("--metrics-interval")
+			.scan<'g', double>()
+			.help("Seconds between writes of the metrics file [default: 15]");
+
+	program.add_argument("--trace")
+			.help("Write a timeline of every lookup to this file as Chrome trace-event JSON, for chrome://tracing or Perfetto");
+
+	program.add_argument("--rate")
+			.scan<'g', double>()
+			.help("Maximum QRZ API requests per second [default: 10]");
+
+	program.add_argument("--concurrency")
+			.scan<'i', int>()
+			.help("Maximum number of concurrent QRZ API requests [default: 8]");
+
+	program.add_argument("--hedge")
+			.scan<'g', double>()
+			.help("Duplicate requests slower than this percentile of recent latency, e.g. 95 [default: off]");
+
+	program.add_argument("--connect-timeout")
+			.scan<'g', double>()
+			.help("Seconds allowed to connect to the QRZ API [default: 10]");
+
+	program.add_argument("--send-timeout")
+			.scan<'g', double>()
+			.help("Seconds allowed for each send to the QRZ API [default: 10]");
+
+	program.add_argument("--receive-timeout")
+			.scan<'g', double>()
+			.help("Seconds allowed for each receive from the QRZ API [default: 30]");
+
+	program.add_argument("--lookup-timeout")
+			.scan<'g', double>()
+			.help("Seconds allowed for each lookup, including retries [default: 60]");
+
+	program.add_argument("--batch-timeout")
+			.scan<'g', double>()
+			.help("Seconds allowed for the whole batch of lookups [default: no limit]");
+
+	program.add_argument("--cty")
+			.help("cty.dat or cty.csv prefix table used to resolve DXCC entities locally [default: cty.dat in the config dir]");
+
+	program.add_argument("--offline")
+			.default_value(false)
+			.implicit_value(true)
+			.help("Answer DXCC lookups from the local prefix and DXCC tables only, without calling the QRZ API");
+
+	program.add_argument("-i", "--input")
+			.help("Read search terms from this file, one per line, or - for standard input");
+
+	program.add_argument("-o", "--output")
+			.help("File to write the enriched ADIF log to [default: stdout]");
+
+	program.add_argument("--output-dir")
+			.help("Directory to write each bio to, as CALL.html. Unchanged bios are not downloaded again");
+
+	program.add_argument("--no-cache")
+			.default_value(false)
+			.implicit_value(true)
+			.help("Fetch every callsign from the QRZ API, without reading or updating the lookup cache");
+
+	program.add_argument("--cache-policy")
+			.append()
+			.help("Seconds the lookup cache serves one record type (callsign, dxcc or bio), and how many entries and "
+				  "bytes it keeps, e.g. callsign=max-age:86400,stale:604800,not-found:3600,max-bytes:104857600. "
+				  "May be repeated");
+
+	program.add_argument("--template")
+			.help("Write each callsign as one line of this template, e.g. \"{call}\\t{grid}\\t{lat},{lon}\"");
+
+	program.add_argument("--unordered")
+			.default_value(false)
+			.implicit_value(true)
+			.help("Write callsigns and bios as each lookup completes, rather than in search term order");
+
+	program.add_argument("--with-dxcc")
+			.default_value(false)
+			.implicit_value(true)
+			.help("Add the DXCC entity name, continent and zones to each callsign result");
 
 	try
 	{
@@ -59,6 +151,15 @@ int main(int argc, char **argv)
 	{
 		command.setAction(Action::DXCC_ACTION);
 	}
+	else if(action == "MIRROR")
+	{
+		searchInputRequired = false;
+		command.setAction(Action::DXCC_MIRROR_ACTION);
+	}
+	else if(action == "ADIF")
+	{
+		command.setAction(Action::ADIF_ENRICH_ACTION);
+	}
 	else if(action == "LOGIN")
 	{
 		searchInputRequired = false;
@@ -85,23 +186,232 @@ int main(int argc, char **argv)
 	{
 		command.setFormat(OutputFormat::MD);
 	}
+	else if(format == "ADIF")
+	{
+		// ADIF records describe stations, so only callsign results can be written as ADIF
+		if(command.getAction() != Action::CALLSIGN_ACTION)
+		{
+			std::cerr << "The ADIF format is only available for the callsign action" << std::endl;
+			return 1;
+		}
+
+		command.setFormat(OutputFormat::ADIF);
+	}
+
+	command.setShowStats(program.get<bool>("--stats"));
+
+	if(auto rate = program.present<double>("--rate"))
+	{
+		command.setRequestRate(*rate);
+	}
+
+	if(auto concurrency = program.present<int>("--concurrency"))
+	{
+		command.setMaxConcurrency(*concurrency);
+	}
+
+	if(auto hedge = program.present<double>("--hedge"))
+	{
+		command.setHedgePercentile(*hedge);
+	}
+
+	if(auto timeout = program.present<double>("--connect-timeout"))
+	{
+		command.setConnectTimeout(*timeout);
+	}
+
+	if(auto timeout = program.present<double>("--send-timeout"))
+	{
+		command.setSendTimeout(*timeout);
+	}
+
+	if(auto timeout = program.present<double>("--receive-timeout"))
+	{
+		command.setReceiveTimeout(*timeout);
+	}
+
+	if(auto timeout = program.present<double>("--lookup-timeout"))
+	{
+		command.setLookupTimeout(*timeout);
+	}
+
+	if(auto timeout = program.present<double>("--batch-timeout"))
+	{
+		command.setBatchTimeout(*timeout);
+	}
+
+	if(auto prefixTable = program.present<std::string>("--cty"))
+	{
+		command.setPrefixTablePath(*prefixTable);
+	}
+
+	command.setOffline(program.get<bool>("--offline"));
+	command.setWithDxcc(program.get<bool>("--with-dxcc"));
+	command.setUseCache(!program.get<bool>("--no-cache"));
+
+	if(auto specs = program.present<std::vector<std::string>>("--cache-policy"))
+	{
+		cache::CachePolicies policies;
+
+		for(const std::string &spec : *specs)
+		{
+			try
+			{
+				policies.apply(spec);
+			}
+			catch (const std::invalid_argument &err)
+			{
+				std::cerr << "Invalid cache policy: " << err.what() << std::endl;
+				return 1;
+			}
+		}
+
+		command.setCachePolicies(policies);
+	}
+	command.setUnordered(program.get<bool>("--unordered"));
+
+	if(auto output = program.present<std::string>("--output"))
+	{
+		command.setOutputPath(*output);
+	}
+
+	if(auto outputDir = program.present<std::string>("--output-dir"))
+	{
+		if(command.getAction() != Action::BIO_ACTION)
+		{
+			std::cerr << "An output directory is only available for the bio action" << std::endl;
+			return 1;
+		}
+
+		command.setOutputDir(*outputDir);
+	}
+
+	if(auto outputTemplate = program.present<std::string>("--template"))
+	{
+		if(command.getAction() != Action::CALLSIGN_ACTION)
+		{
+			std::cerr << "A template is only available for the callsign action" << std::endl;
+			return 1;
+		}
+
+		if(program.is_used("-f") || command.getWithDxcc())
+		{
+			std::cerr << "A template cannot be combined with --format or --with-dxcc" << std::endl;
+			return 1;
+		}
+
+		// Report a bad template before logging in
+		try
+		{
+			render::CallsignTemplate::compile(*outputTemplate);
+		}
+		catch (const std::invalid_argument &err)
+		{
+			std::cerr << "Invalid template: " << err.what() << std::endl;
+			return 1;
+		}
+
+		command.setFormat(OutputFormat::TEMPLATE);
+		command.setOutputTemplate(*outputTemplate);
+	}
+
+	if(auto trace = program.present<std::string>("--trace"))
+	{
+		command.setTracePath(*trace);
+	}
+
+	if(auto metrics = program.present<std::string>("--metrics"))
+	{
+		command.setMetricsPath(*metrics);
+	}
+
+	if(auto interval = program.present<double>("--metrics-interval"))
+	{
+		command.setMetricsInterval(*interval);
+	}
+
+	if(command.getOffline() && command.getAction() != Action::DXCC_ACTION)
+	{
+		std::cerr << "Only DXCC lookups can be answered offline" << std::endl;
+		return 1;
+	}
 
 	// Handle search input, is necessary
 	if(searchInputRequired)
 	{
+		auto inputPath = program.present<std::string>("--input");
+
 		// If we have no input, print help and exit
-		if(!program.is_used("search"))
+		if(!program.is_used("search") && !inputPath)
 		{
 			std::cout << program << std::endl;
 			return 1;
 		}
 
-		auto rawSearchList = program.get<std::vector<std::string>>("search");
+		auto rawSearchList = program.is_used("search")
+				? program.get<std::vector<std::string>>("search")
+				: std::vector<std::string>{};
 
-		// Convert the vector to a set, we do not want duplicates
-		std::set<std::string> searchList(rawSearchList.begin(), rawSearchList.end());
+		// The ADIF action takes the log to enrich, not search terms
+		if(command.getAction() == Action::ADIF_ENRICH_ACTION)
+		{
+			if(inputPath)
+			{
+				std::cerr << "The adif action takes its log as the search argument, not --input" << std::endl;
+				return 1;
+			}
+
+			if(rawSearchList.size() != 1)
+			{
+				std::cerr << "The adif action takes exactly one ADIF log" << std::endl;
+				return 1;
+			}
 
-		command.setSearchTerms(searchList);
+			command.setInputPath(rawSearchList.front());
+		}
+		else
+		{
+			// Validate and normalize the terms locally, so malformed and duplicate terms never cost an API call
+			CallsignNormalizer::Result normalized = (command.getAction() == Action::DXCC_ACTION)
+					? CallsignNormalizer::normalizeDXCCTerms(rawSearchList)
+					: CallsignNormalizer::normalizeCallsigns(rawSearchList);
+
+			// Large lists are mapped and normalized in parallel, and only their distinct terms are copied
+			if(inputPath)
+			{
+				TermReader::Normalizer normalize = (command.getAction() == Action::DXCC_ACTION)
+						? CallsignNormalizer::normalizeDXCCTerm
+						: CallsignNormalizer::normalizeCallsign;
+
+				try
+				{
+					CallsignNormalizer::Result fromInput = TermReader::read(*inputPath, normalize);
+
+					normalized.terms.merge(fromInput.terms);
+					normalized.duplicates += fromInput.duplicates + fromInput.terms.size();
+					normalized.rejected.insert(normalized.rejected.end(),
+											   fromInput.rejected.begin(), fromInput.rejected.end());
+				}
+				catch (const std::runtime_error &err)
+				{
+					std::cerr << err.what() << std::endl;
+					return 1;
+				}
+			}
+
+			for(const std::string &rejected : normalized.rejected)
+			{
+				std::cerr << "Ignoring invalid search term: " << rejected << std::endl;
+			}
+
+			if(normalized.terms.empty())
+			{
+				std::cerr << "No valid search terms" << std::endl;
+				return 1;
+			}
+
+			command.setSearchTerms(normalized.terms);
+		}
 	}
 
 	controller.handleCommand(command);
@@ -0,0 +1,137 @@
+#include "Histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+using namespace qrz::metrics;
+
+/**
+ * @brief Records a value.
+ *
+ * The maximum is raised with a compare-and-swap loop, which only retries when another thread raised it at the same
+ * time.
+ *
+ * @param value The value. Negative values are recorded as 0, and values beyond the range as its maximum.
+ */
+void Histogram::record(std::chrono::microseconds value)
+{
+	uint64_t clamped = std::min<uint64_t>(static_cast<uint64_t>(std::max<int64_t>(value.count(), 0)), m_maxValue);
+
+	m_buckets[bucketOf(clamped)].fetch_add(1, std::memory_order_relaxed);
+	m_count.fetch_add(1, std::memory_order_relaxed);
+	m_sum.fetch_add(clamped, std::memory_order_relaxed);
+
+	uint64_t max = m_max.load(std::memory_order_relaxed);
+
+	while (clamped > max && !m_max.compare_exchange_weak(max, clamped, std::memory_order_relaxed))
+	{
+	}
+}
+
+/**
+ * @brief Returns the given percentile of the recorded values.
+ *
+ * Uses the nearest-rank method over the bucket counts.
+ *
+ * @param percentile The percentile, between 0 and 100.
+ * @return The highest value equivalent to the percentile's bucket, or 0 if nothing was recorded.
+ */
+std::chrono::microseconds Histogram::percentile(double percentile) const
+{
+	uint64_t total = count();
+
+	if (total == 0)
+	{
+		return std::chrono::microseconds{0};
+	}
+
+	double clamped = std::clamp(percentile, 0.0, 100.0);
+	uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(total))), 1);
+
+	uint64_t seen = 0;
+
+	for (size_t bucket = 0; bucket < m_bucketCount; ++bucket)
+	{
+		seen += m_buckets[bucket].load(std::memory_order_relaxed);
+
+		if (seen >= rank)
+		{
+			// The bucket's range may reach past the largest value actually recorded
+			uint64_t highest = std::min(highestValueOf(bucket), m_max.load(std::memory_order_relaxed));
+
+			return std::chrono::microseconds(static_cast<int64_t>(highest));
+		}
+	}
+
+	return max();
+}
+
+/**
+ * @brief Returns the number of recorded values.
+ *
+ * @return The count.
+ */
+uint64_t Histogram::count() const
+{
+	return m_count.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the sum of the recorded values.
+ *
+ * @return The sum.
+ */
+std::chrono::microseconds Histogram::sum() const
+{
+	return std::chrono::microseconds(static_cast<int64_t>(m_sum.load(std::memory_order_relaxed)));
+}
+
+/**
+ * @brief Returns the largest recorded value.
+ *
+ * @return The maximum, or 0 if nothing was recorded.
+ */
+std::chrono::microseconds Histogram::max() const
+{
+	return std::chrono::microseconds(static_cast<int64_t>(m_max.load(std::memory_order_relaxed)));
+}
+
+/**
+ * @brief Returns the bucket a value is counted in.
+ *
+ * Values in [2^(b+k), 2^(b+k+1)), where b is m_subBucketBits, share a set of 2^b buckets each 2^k wide.
+ *
+ * @param value The value, at most m_maxValue.
+ * @return The bucket index.
+ */
+size_t Histogram::bucketOf(uint64_t value)
+{
+	if (value < m_subBucketCount)
+	{
+		return static_cast<size_t>(value);
+	}
+
+	int shift = std::bit_width(value) - m_subBucketBits - 1;
+
+	return static_cast<size_t>((shift + 1) * m_subBucketCount + ((value >> shift) - m_subBucketCount));
+}
+
+/**
+ * @brief Returns the highest value counted in a bucket.
+ *
+ * @param bucket The bucket index.
+ * @return The value.
+ */
+uint64_t Histogram::highestValueOf(size_t bucket)
+{
+	if (bucket < m_subBucketCount)
+	{
+		return bucket;
+	}
+
+	uint64_t shift = bucket / m_subBucketCount - 1;
+	uint64_t subBucket = bucket % m_subBucketCount;
+
+	return ((m_subBucketCount + subBucket) << shift) + ((uint64_t{1} << shift) - 1);
+}
@@ -0,0 +1,100 @@
+#ifndef QRZ_HISTOGRAM_H
+#define QRZ_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace qrz::metrics
+{
+	/**
+	 * @class Histogram
+	 * @brief A latency histogram with HDR-style log-linear buckets, recorded without locks.
+	 *
+	 * Values below 2^m_subBucketBits microseconds each have a bucket of their own. Above that, every power of two is
+	 * split into 2^m_subBucketBits equal buckets, so a percentile is never off by more than 1% of its value, from a
+	 * microsecond up to days, in a fixed 35 KB of counters.
+	 *
+	 * Recording is a handful of relaxed atomic increments. Reading walks the buckets, so it is meant for periodic
+	 * exposition, not the hot path. Readings taken while values are recorded are not an exact point in time, which is
+	 * fine for monitoring.
+	 *
+	 * This class is thread safe.
+	 */
+	class Histogram
+	{
+	public:
+		/**
+		 * @brief Records a value.
+		 *
+		 * @param value The value. Negative values are recorded as 0, and values beyond the range as its maximum.
+		 */
+		void record(std::chrono::microseconds value);
+
+		/**
+		 * @brief Returns the given percentile of the recorded values.
+		 *
+		 * @param percentile The percentile, between 0 and 100.
+		 * @return The highest value equivalent to the percentile's bucket, or 0 if nothing was recorded.
+		 */
+		std::chrono::microseconds percentile(double percentile) const;
+
+		/**
+		 * @brief Returns the number of recorded values.
+		 *
+		 * @return The count.
+		 */
+		uint64_t count() const;
+
+		/**
+		 * @brief Returns the sum of the recorded values.
+		 *
+		 * @return The sum.
+		 */
+		std::chrono::microseconds sum() const;
+
+		/**
+		 * @brief Returns the largest recorded value.
+		 *
+		 * @return The maximum, or 0 if nothing was recorded.
+		 */
+		std::chrono::microseconds max() const;
+
+	private:
+		// Buckets per power of two. 7 bits keeps the error of each bucket below 1%
+		static constexpr int m_subBucketBits = 7;
+		static constexpr uint64_t m_subBucketCount = uint64_t{1} << m_subBucketBits;
+
+		// Largest value that can be told apart from larger ones, about 12.7 days
+		static constexpr uint64_t m_maxValue = (uint64_t{1} << 40) - 1;
+
+		// Exact buckets, plus a set of sub-buckets for each power of two from 2^m_subBucketBits up to m_maxValue
+		static constexpr size_t m_bucketCount = (40 - m_subBucketBits + 1) * m_subBucketCount;
+
+		/**
+		 * @brief Returns the bucket a value is counted in.
+		 *
+		 * @param value The value, at most m_maxValue.
+		 * @return The bucket index.
+		 */
+		static size_t bucketOf(uint64_t value);
+
+		/**
+		 * @brief Returns the highest value counted in a bucket.
+		 *
+		 * @param bucket The bucket index.
+		 * @return The value.
+		 */
+		static uint64_t highestValueOf(size_t bucket);
+
+		std::array<std::atomic<uint64_t>, m_bucketCount> m_buckets{};
+
+		std::atomic<uint64_t> m_count = 0;
+		std::atomic<uint64_t> m_sum = 0;
+		std::atomic<uint64_t> m_max = 0;
+	};
+}
+
+#endif //QRZ_HISTOGRAM_H
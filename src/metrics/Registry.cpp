@@ -0,0 +1,231 @@
+#include "Registry.h"
+
+#include <format>
+#include <stdexcept>
+
+using namespace qrz::metrics;
+
+namespace
+{
+	// Quantiles written for each histogram
+	constexpr double quantiles[] = {0.5, 0.9, 0.99};
+
+	/**
+	 * @brief Formats labels for the exposition format, e.g. {endpoint="callsign"}.
+	 *
+	 * @param labels The labels.
+	 * @param extra An additional label to append, such as the quantile, or empty for none.
+	 * @return The label set, or an empty string if there are no labels.
+	 */
+	std::string formatLabels(const Labels &labels, const std::string &extra = "")
+	{
+		if (labels.empty() && extra.empty())
+		{
+			return "";
+		}
+
+		std::string output = "{";
+
+		for (const auto &[name, value] : labels)
+		{
+			if (output.size() > 1)
+			{
+				output += ',';
+			}
+
+			output += name + "=\"";
+
+			for (char c : value)
+			{
+				switch (c)
+				{
+					case '\\':
+						output += "\\\\";
+						break;
+					case '"':
+						output += "\\\"";
+						break;
+					case '\n':
+						output += "\\n";
+						break;
+					default:
+						output += c;
+				}
+			}
+
+			output += '"';
+		}
+
+		if (!extra.empty())
+		{
+			output += (output.size() > 1 ? "," : "") + extra;
+		}
+
+		return output + "}";
+	}
+
+	/**
+	 * @brief Converts microseconds to the seconds Prometheus expects for durations.
+	 *
+	 * @param duration The duration.
+	 * @return The duration in seconds.
+	 */
+	double toSeconds(std::chrono::microseconds duration)
+	{
+		return static_cast<double>(duration.count()) / 1e6;
+	}
+}
+
+/**
+ * @brief Returns a counter, creating it on first use.
+ *
+ * @param name The metric name, e.g. qrz_retries_total.
+ * @param help The description written with the metric.
+ * @param labels The labels of the series.
+ * @return The counter.
+ * @throws std::invalid_argument If the name is already used by another type of metric.
+ */
+Counter &Registry::counter(const std::string &name, const std::string &help, const Labels &labels)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	Series &series = findOrAdd(name, help, labels, Type::COUNTER);
+
+	if (!series.counter)
+	{
+		series.counter = std::make_unique<Counter>();
+	}
+
+	return *series.counter;
+}
+
+/**
+ * @brief Returns a gauge, creating it on first use.
+ *
+ * @param name The metric name, e.g. qrz_requests_in_flight.
+ * @param help The description written with the metric.
+ * @param labels The labels of the series.
+ * @return The gauge.
+ * @throws std::invalid_argument If the name is already used by another type of metric.
+ */
+Gauge &Registry::gauge(const std::string &name, const std::string &help, const Labels &labels)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	Series &series = findOrAdd(name, help, labels, Type::GAUGE);
+
+	if (!series.gauge)
+	{
+		series.gauge = std::make_unique<Gauge>();
+	}
+
+	return *series.gauge;
+}
+
+/**
+ * @brief Returns a latency histogram, creating it on first use.
+ *
+ * @param name The metric name, e.g. qrz_request_duration_seconds.
+ * @param help The description written with the metric.
+ * @param labels The labels of the series.
+ * @return The histogram.
+ * @throws std::invalid_argument If the name is already used by another type of metric.
+ */
+Histogram &Registry::histogram(const std::string &name, const std::string &help, const Labels &labels)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	Series &series = findOrAdd(name, help, labels, Type::HISTOGRAM);
+
+	if (!series.histogram)
+	{
+		series.histogram = std::make_unique<Histogram>();
+	}
+
+	return *series.histogram;
+}
+
+/**
+ * @brief Writes every metric in the Prometheus text exposition format.
+ *
+ * Histograms are written as summaries: their p50, p90 and p99 as quantiles, in seconds, plus their sum and count.
+ * The HDR buckets are much finer than Prometheus histogram buckets, so quantiles carry more information.
+ *
+ * @param output The stream to write to.
+ */
+void Registry::writePrometheus(std::ostream &output) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (const auto &[name, family] : m_families)
+	{
+		const char *type = family.type == Type::COUNTER ? "counter" : family.type == Type::GAUGE ? "gauge" : "summary";
+
+		output << "# HELP " << name << ' ' << family.help << '\n';
+		output << "# TYPE " << name << ' ' << type << '\n';
+
+		for (const Series &series : family.series)
+		{
+			if (series.counter)
+			{
+				output << name << formatLabels(series.labels) << ' ' << series.counter->value() << '\n';
+			}
+			else if (series.gauge)
+			{
+				output << name << formatLabels(series.labels) << ' ' << series.gauge->value() << '\n';
+			}
+			else if (series.histogram)
+			{
+				for (double quantile : quantiles)
+				{
+					output << name << formatLabels(series.labels, std::format("quantile=\"{}\"", quantile)) << ' '
+						   << std::format("{}", toSeconds(series.histogram->percentile(quantile * 100))) << '\n';
+				}
+
+				output << name << "_sum" << formatLabels(series.labels) << ' '
+					   << std::format("{}", toSeconds(series.histogram->sum())) << '\n';
+				output << name << "_count" << formatLabels(series.labels) << ' ' << series.histogram->count() << '\n';
+			}
+		}
+	}
+}
+
+/**
+ * @brief Returns the series with the given name and labels, creating it on first use.
+ *
+ * Must be called with m_mutex held.
+ *
+ * @param name The metric name.
+ * @param help The description written with the metric.
+ * @param labels The labels of the series.
+ * @param type The kind of metric.
+ * @return The series. Its metric is created by the caller if it is new.
+ * @throws std::invalid_argument If the name is already used by another type of metric.
+ */
+Registry::Series &Registry::findOrAdd(const std::string &name, const std::string &help, const Labels &labels, Type type)
+{
+	auto [it, added] = m_families.try_emplace(name);
+	Family &family = it->second;
+
+	if (added)
+	{
+		family.type = type;
+		family.help = help;
+	}
+	else if (family.type != type)
+	{
+		throw std::invalid_argument("Metric " + name + " is already registered with another type");
+	}
+
+	for (Series &series : family.series)
+	{
+		if (series.labels == labels)
+		{
+			return series;
+		}
+	}
+
+	family.series.push_back(Series{labels, nullptr, nullptr, nullptr});
+
+	return family.series.back();
+}
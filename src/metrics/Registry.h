@@ -0,0 +1,191 @@
+#ifndef QRZ_REGISTRY_H
+#define QRZ_REGISTRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Histogram.h"
+
+namespace qrz::metrics
+{
+	/**
+	 * @brief Label names and values identifying one series of a metric, e.g. {{"endpoint", "callsign"}}.
+	 */
+	using Labels = std::vector<std::pair<std::string, std::string>>;
+
+	/**
+	 * @class Counter
+	 * @brief A count that only goes up, incremented without locks.
+	 */
+	class Counter
+	{
+	public:
+		/**
+		 * @brief Adds to the count.
+		 *
+		 * @param amount The amount to add.
+		 */
+		void increment(uint64_t amount = 1)
+		{
+			m_value.fetch_add(amount, std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Returns the count.
+		 *
+		 * @return The count.
+		 */
+		uint64_t value() const
+		{
+			return m_value.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<uint64_t> m_value = 0;
+	};
+
+	/**
+	 * @class Gauge
+	 * @brief A value that goes up and down, such as the number of requests in flight, updated without locks.
+	 */
+	class Gauge
+	{
+	public:
+		/**
+		 * @brief Adds to the value.
+		 *
+		 * @param amount The amount to add, negative to subtract.
+		 */
+		void add(int64_t amount)
+		{
+			m_value.fetch_add(amount, std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Returns the value.
+		 *
+		 * @return The value.
+		 */
+		int64_t value() const
+		{
+			return m_value.load(std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<int64_t> m_value = 0;
+	};
+
+	/**
+	 * @class Registry
+	 * @brief Owns the counters, gauges and histograms of a run, and writes them in the Prometheus text format.
+	 *
+	 * Metrics are created, or found, by name and labels. That takes a lock, so callers look their metrics up once and
+	 * keep the reference, which stays valid for the life of the registry. Updating a metric never touches the
+	 * registry.
+	 *
+	 * This class is thread safe.
+	 */
+	class Registry
+	{
+	public:
+		/**
+		 * @brief Returns a counter, creating it on first use.
+		 *
+		 * @param name The metric name, e.g. qrz_retries_total.
+		 * @param help The description written with the metric.
+		 * @param labels The labels of the series.
+		 * @return The counter.
+		 * @throws std::invalid_argument If the name is already used by another type of metric.
+		 */
+		Counter &counter(const std::string &name, const std::string &help, const Labels &labels = {});
+
+		/**
+		 * @brief Returns a gauge, creating it on first use.
+		 *
+		 * @param name The metric name, e.g. qrz_requests_in_flight.
+		 * @param help The description written with the metric.
+		 * @param labels The labels of the series.
+		 * @return The gauge.
+		 * @throws std::invalid_argument If the name is already used by another type of metric.
+		 */
+		Gauge &gauge(const std::string &name, const std::string &help, const Labels &labels = {});
+
+		/**
+		 * @brief Returns a latency histogram, creating it on first use.
+		 *
+		 * @param name The metric name, e.g. qrz_request_duration_seconds.
+		 * @param help The description written with the metric.
+		 * @param labels The labels of the series.
+		 * @return The histogram.
+		 * @throws std::invalid_argument If the name is already used by another type of metric.
+		 */
+		Histogram &histogram(const std::string &name, const std::string &help, const Labels &labels = {});
+
+		/**
+		 * @brief Writes every metric in the Prometheus text exposition format.
+		 *
+		 * @param output The stream to write to.
+		 */
+		void writePrometheus(std::ostream &output) const;
+
+	private:
+		/**
+		 * @brief The kinds of metric a family can hold.
+		 */
+		enum class Type
+		{
+			COUNTER,
+			GAUGE,
+			HISTOGRAM
+		};
+
+		/**
+		 * @brief One series of a metric, identified by its labels.
+		 */
+		struct Series
+		{
+			Labels labels;
+
+			// Exactly one of these is set, matching the family's type
+			std::unique_ptr<Counter> counter;
+			std::unique_ptr<Gauge> gauge;
+			std::unique_ptr<Histogram> histogram;
+		};
+
+		/**
+		 * @brief All the series sharing a metric name.
+		 */
+		struct Family
+		{
+			Type type = Type::COUNTER;
+			std::string help;
+			std::vector<Series> series;
+		};
+
+		/**
+		 * @brief Returns the series with the given name and labels, creating it on first use.
+		 *
+		 * @param name The metric name.
+		 * @param help The description written with the metric.
+		 * @param labels The labels of the series.
+		 * @param type The kind of metric.
+		 * @return The series. Its metric is created by the caller if it is new.
+		 * @throws std::invalid_argument If the name is already used by another type of metric.
+		 */
+		Series &findOrAdd(const std::string &name, const std::string &help, const Labels &labels, Type type);
+
+		mutable std::mutex m_mutex;
+
+		// Families by name, so the exposition is in a stable order
+		std::map<std::string, Family> m_families;
+	};
+}
+
+#endif //QRZ_REGISTRY_H
@@ -0,0 +1,83 @@
+#include "TextFileExporter.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+using namespace qrz::metrics;
+
+/**
+ * @brief Starts writing the registry to a file.
+ *
+ * @param registry The registry to write.
+ * @param path The file to write to.
+ * @param interval Time between writes.
+ */
+TextFileExporter::TextFileExporter(std::shared_ptr<const Registry> registry, std::string path,
+								   std::chrono::milliseconds interval)
+		: m_registry(std::move(registry)), m_path(std::move(path)),
+		  m_interval(std::max(interval, std::chrono::milliseconds(100)))
+{
+	m_thread = std::thread([this]()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		while (!m_stopped.wait_for(lock, m_interval, [this]() { return m_stopping; }))
+		{
+			lock.unlock();
+			write();
+			lock.lock();
+		}
+	});
+}
+
+/**
+ * @brief Stops the periodic writes and writes the file one last time.
+ */
+TextFileExporter::~TextFileExporter()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+
+	m_stopped.notify_all();
+	m_thread.join();
+
+	write();
+}
+
+/**
+ * @brief Writes the file now.
+ *
+ * The registry is written to a temporary file that is then renamed over the file, so readers never see a partly
+ * written file. Failures are not reported beyond the return value, so a full disk never stops a run.
+ *
+ * @return Whether the file was written.
+ */
+bool TextFileExporter::write() const
+{
+	const std::string temporaryPath = m_path + ".tmp";
+
+	{
+		std::ofstream output(temporaryPath, std::ios::trunc);
+
+		if (!output)
+		{
+			return false;
+		}
+
+		m_registry->writePrometheus(output);
+
+		if (!output.flush())
+		{
+			return false;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(temporaryPath, m_path, ec);
+
+	return !ec;
+}
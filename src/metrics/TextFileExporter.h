@@ -0,0 +1,66 @@
+#ifndef QRZ_TEXTFILEEXPORTER_H
+#define QRZ_TEXTFILEEXPORTER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "Registry.h"
+
+namespace qrz::metrics
+{
+	/**
+	 * @class TextFileExporter
+	 * @brief Periodically writes a registry to a file in the Prometheus text format.
+	 *
+	 * The file is replaced atomically by writing a temporary file next to it and renaming it over the old one, so it
+	 * can be scraped at any time, e.g. by the node_exporter textfile collector. The file is written once more when the
+	 * exporter is destroyed, so it ends with the final values of the run.
+	 */
+	class TextFileExporter
+	{
+	public:
+		/**
+		 * @brief Starts writing the registry to a file.
+		 *
+		 * @param registry The registry to write.
+		 * @param path The file to write to.
+		 * @param interval Time between writes.
+		 */
+		TextFileExporter(std::shared_ptr<const Registry> registry, std::string path, std::chrono::milliseconds interval);
+
+		/**
+		 * @brief Stops the periodic writes and writes the file one last time.
+		 */
+		~TextFileExporter();
+
+		TextFileExporter(const TextFileExporter &) = delete;
+		TextFileExporter &operator=(const TextFileExporter &) = delete;
+
+		/**
+		 * @brief Writes the file now.
+		 *
+		 * @return Whether the file was written.
+		 */
+		bool write() const;
+
+	private:
+		std::shared_ptr<const Registry> m_registry;
+
+		std::string m_path;
+
+		std::chrono::milliseconds m_interval;
+
+		// Guards m_stopping, and lets the writer thread sleep until the next write or until it is stopped
+		std::mutex m_mutex;
+		std::condition_variable m_stopped;
+		bool m_stopping = false;
+
+		std::thread m_thread;
+	};
+}
+
+#endif //QRZ_TEXTFILEEXPORTER_H
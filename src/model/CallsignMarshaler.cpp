@@ -133,9 +133,12 @@ Callsign CallsignMarshaler::FromXml(const std::string &xml_str)
  * The resulting XML structure has a root element named "QRZDatabase" and each Callsign object is nested under a "Callsign" element.
  *
  * @param callsigns The vector of Callsign objects to be converted.
+ * @param extraElements Optional callback returning additional name and value pairs to append to each Callsign
+ * element, such as joined DXCC entity columns.
  * @return The XML string representation of the Callsign objects.
  */
-std::string CallsignMarshaler::ToXML(const std::vector<Callsign> &callsigns)
+std::string CallsignMarshaler::ToXML(const std::vector<Callsign> &callsigns,
+									 const std::function<std::vector<std::pair<std::string, std::string>>(const Callsign &)> &extraElements)
 {
 	Poco::AutoPtr<Poco::XML::Document> pDoc = new Poco::XML::Document;
 
@@ -197,6 +200,14 @@ std::string CallsignMarshaler::ToXML(const std::vector<Callsign> &callsigns)
 		pCallsignElement->appendChild(pDoc->createElement("attn"))->appendChild(pDoc->createTextNode(callsign.getAttn()));
 		pCallsignElement->appendChild(pDoc->createElement("nickname"))->appendChild(pDoc->createTextNode(callsign.getNickname()));
 		pCallsignElement->appendChild(pDoc->createElement("name_fmt"))->appendChild(pDoc->createTextNode(callsign.getNameFmt()));
+
+		if (extraElements)
+		{
+			for (const auto &[name, value] : extraElements(callsign))
+			{
+				pCallsignElement->appendChild(pDoc->createElement(name))->appendChild(pDoc->createTextNode(value));
+			}
+		}
 	}
 
 	std::ostringstream stream;
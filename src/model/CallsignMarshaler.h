@@ -1,6 +1,9 @@
 #ifndef QRZ_CALLSIGNMARSHALER_H
 #define QRZ_CALLSIGNMARSHALER_H
 
+#include <functional>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "Callsign.h"
@@ -33,9 +36,12 @@ namespace qrz
 		 * The resulting XML structure has a root element named "QRZDatabase" and each Callsign object is nested under a "Callsign" element.
 		 *
 		 * @param callsigns The vector of Callsign objects to be converted to XML.
+		 * @param extraElements Optional callback returning additional name and value pairs to append to each Callsign
+		 * element, such as joined DXCC entity columns.
 		 * @return The XML string representation of the Callsign objects.
 		 */
-		static std::string ToXML(const std::vector<Callsign> &callsign);
+		static std::string ToXML(const std::vector<Callsign> &callsign,
+								 const std::function<std::vector<std::pair<std::string, std::string>>(const Callsign &)> &extraElements = {});
 	};
 }
 
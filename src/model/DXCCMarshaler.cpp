@@ -16,6 +16,83 @@
 
 using namespace qrz;
 
+namespace
+{
+	/**
+	 * @brief Parses a QRZ API response and returns its QRZDatabase root element.
+	 *
+	 * @param xml_str The XML string to parse.
+	 * @return The parsed document, whose document element is QRZDatabase.
+	 *
+	 * @throws std::runtime_error If there is an error parsing the XML or if the root is not QRZDatabase.
+	 */
+	Poco::AutoPtr<Poco::XML::Document> ParseDatabase(const std::string &xml_str)
+	{
+		Poco::XML::DOMParser parser;
+		Poco::AutoPtr<Poco::XML::Document> pDoc;
+
+		try
+		{
+			pDoc = parser.parseString(xml_str);
+		}
+		catch (Poco::Exception& e)
+		{
+			throw std::runtime_error(std::format("XML Parse error: {:s}", e.message()));
+		}
+
+		Poco::XML::Element* rootElement = pDoc->documentElement();
+		if (rootElement->nodeName() != "QRZDatabase")
+		{
+			throw std::runtime_error("Invalid XML - root not is not QRZDatabase");
+		}
+
+		return pDoc;
+	}
+
+	/**
+	 * @brief Populates a DXCC object from a DXCC element.
+	 *
+	 * @param dxccElement The DXCC element.
+	 * @return A DXCC object holding the element's fields.
+	 */
+	DXCC FromElement(Poco::XML::Element *dxccElement)
+	{
+		Poco::XML::Node* currChild = dxccElement->firstChild();
+
+		DXCC dxcc;
+
+		while (currChild)
+		{
+			if (currChild->nodeType() == Poco::XML::Node::ELEMENT_NODE)
+			{
+				Poco::XML::Element *currentElement = static_cast<Poco::XML::Element *>(currChild);
+
+				const std::string name = currentElement->nodeName();
+				const std::string value = currentElement->innerText();
+
+				if (!name.empty() && !value.empty())
+				{
+					if (name == "dxcc") dxcc.setDxcc(value);
+					else if (name == "cc") dxcc.setCc(value);
+					else if (name == "ccc") dxcc.setCcc(value);
+					else if (name == "name") dxcc.setName(value);
+					else if (name == "continent") dxcc.setContinent(value);
+					else if (name == "ituzone") dxcc.setItuzone(value);
+					else if (name == "cqzone") dxcc.setCqzone(value);
+					else if (name == "timezone") dxcc.setTimezone(value);
+					else if (name == "lat") dxcc.setLat(value);
+					else if (name == "lon") dxcc.setLon(value);
+					else if (name == "notes") dxcc.setNotes(value);
+				}
+			}
+
+			currChild = currChild->nextSibling();
+		}
+
+		return dxcc;
+	}
+}
+
 /**
  * @brief Converts an XML string representation of a DXCC record to a DXCC object.
  *
@@ -30,63 +107,44 @@ using namespace qrz;
  */
 DXCC DXCCMarshaler::FromXml(const std::string& xml_str)
 {
-	Poco::XML::DOMParser parser;
-	Poco::AutoPtr<Poco::XML::Document> pDoc;
-
-	try
-	{
-		pDoc = parser.parseString(xml_str);
-	}
-	catch (Poco::Exception& e)
-	{
-		throw std::runtime_error(std::format("XML Parse error: {:s}", e.message()));
-	}
+	Poco::AutoPtr<Poco::XML::Document> pDoc = ParseDatabase(xml_str);
 
-	Poco::XML::Element* rootElement = pDoc->documentElement();
-	if (rootElement->nodeName() != "QRZDatabase")
-	{
-		throw std::runtime_error("Invalid XML - root not is not QRZDatabase");
-	}
-
-	Poco::XML::Element* dxccElement = rootElement->getChildElement("DXCC");
+	Poco::XML::Element* dxccElement = pDoc->documentElement()->getChildElement("DXCC");
 	if (dxccElement == nullptr)
 	{
 		throw std::runtime_error("Invalid XML - no DXCC child");
 	}
 
-	Poco::XML::Node* currChild = dxccElement->firstChild();
+	return FromElement(dxccElement);
+}
+
+/**
+ * @brief Converts an XML string holding any number of DXCC records to DXCC objects.
+ *
+ * This is used for the response to a dxcc=all request, which holds every DXCC entity. The document is parsed once,
+ * and the DXCC children of the root are converted in a single walk.
+ *
+ * @param xml_str The XML string representation of the DXCC records.
+ *
+ * @return Returns the DXCC objects, in document order.
+ *
+ * @throws std::runtime_error If there is an error parsing the XML or if the XML is invalid.
+ */
+std::vector<DXCC> DXCCMarshaler::FromXmlList(const std::string &xml_str)
+{
+	Poco::AutoPtr<Poco::XML::Document> pDoc = ParseDatabase(xml_str);
 
-	DXCC dxcc;
+	std::vector<DXCC> output;
 
-	while (currChild)
+	for (Poco::XML::Node *currChild = pDoc->documentElement()->firstChild(); currChild; currChild = currChild->nextSibling())
 	{
-		if (currChild->nodeType() == Poco::XML::Node::ELEMENT_NODE)
+		if (currChild->nodeType() == Poco::XML::Node::ELEMENT_NODE && currChild->nodeName() == "DXCC")
 		{
-			Poco::XML::Element *currentElement = static_cast<Poco::XML::Element *>(currChild);
-
-			const std::string name = currentElement->nodeName();
-			const std::string value = currentElement->innerText();
-
-			if (!name.empty() && !value.empty())
-			{
-				if (name == "dxcc") dxcc.setDxcc(value);
-				else if (name == "cc") dxcc.setCc(value);
-				else if (name == "ccc") dxcc.setCcc(value);
-				else if (name == "name") dxcc.setName(value);
-				else if (name == "continent") dxcc.setContinent(value);
-				else if (name == "ituzone") dxcc.setItuzone(value);
-				else if (name == "cqzone") dxcc.setCqzone(value);
-				else if (name == "timezone") dxcc.setTimezone(value);
-				else if (name == "lat") dxcc.setLat(value);
-				else if (name == "lon") dxcc.setLon(value);
-				else if (name == "notes") dxcc.setNotes(value);
-			}
+			output.push_back(FromElement(static_cast<Poco::XML::Element *>(currChild)));
 		}
-
-		currChild = currChild->nextSibling();
 	}
 
-	return dxcc;
+	return output;
 }
 
 /**
@@ -26,6 +26,20 @@ namespace qrz
 		 */
 		static DXCC FromXml(const std::string &xml_str);
 
+		/**
+		 * @brief Converts an XML string holding any number of DXCC records to DXCC objects.
+		 *
+		 * This function parses a response holding several DXCC elements, such as the response to a dxcc=all request,
+		 * in a single pass.
+		 *
+		 * @param xml_str The XML string representation of the DXCC records.
+		 *
+		 * @return Returns the DXCC objects, in document order.
+		 *
+		 * @throws std::runtime_error If there is an error parsing the XML or if the XML is invalid.
+		 */
+		static std::vector<DXCC> FromXmlList(const std::string &xml_str);
+
 		/**
 		 * @brief Converts a vector of DXCC objects to an XML string representation.
 		 *
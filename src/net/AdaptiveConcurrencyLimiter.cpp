@@ -0,0 +1,214 @@
+#include "AdaptiveConcurrencyLimiter.h"
+
+#include <algorithm>
+
+using namespace qrz::net;
+
+namespace
+{
+	// Longest wait for a slot between checks of the deadline. A cancellation may come from a signal handler, which
+	// cannot notify the condition variable
+	constexpr std::chrono::milliseconds deadlineCheckInterval{50};
+}
+
+/**
+ * @brief Constructs a limiter.
+ *
+ * @param initialLimit Number of concurrent requests allowed before any latency has been observed.
+ * @param minLimit Lower bound for the limit.
+ * @param maxLimit Upper bound for the limit.
+ */
+AdaptiveConcurrencyLimiter::AdaptiveConcurrencyLimiter(int initialLimit, int minLimit, int maxLimit) :
+		m_minLimit(std::max(minLimit, 1)), m_maxLimit(std::max(maxLimit, std::max(minLimit, 1)))
+{
+	m_limit = std::clamp(static_cast<double>(initialLimit), static_cast<double>(m_minLimit),
+						 static_cast<double>(m_maxLimit));
+}
+
+/**
+ * @brief Blocks until a request may be sent, then counts it as in flight.
+ *
+ * A request may be sent while the number of requests in flight is below the integer part of the current limit. The
+ * wait wakes at least every deadlineCheckInterval to check the deadline, so a lookup never waits for a slot past its
+ * deadline, or after the batch has been cancelled.
+ *
+ * @param deadline Gives up waiting once this deadline expires or is cancelled.
+ * @return True if the request was counted as in flight, false if the deadline expired first.
+ */
+bool AdaptiveConcurrencyLimiter::acquire(const Deadline &deadline)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	auto canSend = [this]
+	{
+		return m_inFlight < static_cast<int>(m_limit);
+	};
+
+	while (!canSend())
+	{
+		if (deadline.expired())
+		{
+			return false;
+		}
+
+		m_available.wait_for(lock, deadline.clamp(deadlineCheckInterval), canSend);
+	}
+
+	m_inFlight++;
+
+	return true;
+}
+
+/**
+ * @brief Gives back a slot taken by acquire() for a request that was never sent, leaving the limit unchanged.
+ */
+void AdaptiveConcurrencyLimiter::releaseUnused()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		m_inFlight = std::max(m_inFlight - 1, 0);
+	}
+
+	m_available.notify_one();
+}
+
+/**
+ * @brief Marks a request as complete and adjusts the limit based on its outcome.
+ *
+ * Failures, timeouts and successes slower than m_latencyTolerance times the baseline halve the limit. Other
+ * successes raise the limit by 1/limit when the limit is actually being used, which adds about one request per
+ * round trip.
+ *
+ * @param outcome Whether the request succeeded, was throttled, or timed out.
+ * @param latency Time from sending the request to receiving the full response.
+ */
+void AdaptiveConcurrencyLimiter::release(Outcome outcome, std::chrono::microseconds latency)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		Clock::time_point now = Clock::now();
+
+		// Was the limit saturated when this request was running? Only then is a success evidence for more headroom
+		bool saturated = m_inFlight >= static_cast<int>(m_limit);
+
+		m_inFlight = std::max(m_inFlight - 1, 0);
+
+		if (outcome == Outcome::OVERLOAD)
+		{
+			m_overloads++;
+			decrease(now);
+		}
+		else if (outcome == Outcome::TIMEOUT)
+		{
+			m_timeouts++;
+			decrease(now);
+		}
+		else
+		{
+			auto sample = static_cast<double>(latency.count());
+
+			if (m_smoothedLatency == 0)
+			{
+				m_smoothedLatency = sample;
+				m_baselineLatency = sample;
+			}
+			else
+			{
+				m_smoothedLatency += (sample - m_smoothedLatency) * m_smoothingFactor;
+
+				// Track the minimum, but let it creep up so a permanently slower path is eventually accepted
+				m_baselineLatency = (sample < m_baselineLatency) ? sample : m_baselineLatency * 1.01;
+			}
+
+			if (sample > m_baselineLatency * m_latencyTolerance)
+			{
+				decrease(now);
+			}
+			else if (saturated && m_limit < m_maxLimit)
+			{
+				m_limit = std::min(static_cast<double>(m_maxLimit), m_limit + 1.0 / m_limit);
+				m_increases++;
+			}
+		}
+	}
+
+	m_available.notify_all();
+}
+
+/**
+ * @brief Changes the bounds of the limit.
+ *
+ * The current limit is clamped into the new bounds.
+ *
+ * @param minLimit Lower bound for the limit.
+ * @param maxLimit Upper bound for the limit.
+ */
+void AdaptiveConcurrencyLimiter::setBounds(int minLimit, int maxLimit)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		m_minLimit = std::max(minLimit, 1);
+		m_maxLimit = std::max(maxLimit, m_minLimit);
+		m_limit = std::clamp(m_limit, static_cast<double>(m_minLimit), static_cast<double>(m_maxLimit));
+	}
+
+	m_available.notify_all();
+}
+
+/**
+ * @brief Returns the upper bound for the limit.
+ *
+ * @return The maximum number of concurrent requests the limiter will ever allow.
+ */
+int AdaptiveConcurrencyLimiter::getMaxLimit() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_maxLimit;
+}
+
+/**
+ * @brief Returns a snapshot of the limiter state.
+ *
+ * @return The current limit, requests in flight, latency estimates and adjustment counters.
+ */
+AdaptiveConcurrencyLimiter::Snapshot AdaptiveConcurrencyLimiter::snapshot() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	Snapshot output;
+	output.limit = m_limit;
+	output.minLimit = m_minLimit;
+	output.maxLimit = m_maxLimit;
+	output.inFlight = m_inFlight;
+	output.baselineLatencyMs = m_baselineLatency / 1000.0;
+	output.smoothedLatencyMs = m_smoothedLatency / 1000.0;
+	output.increases = m_increases;
+	output.decreases = m_decreases;
+	output.overloads = m_overloads;
+	output.timeouts = m_timeouts;
+
+	return output;
+}
+
+/**
+ * @brief Halves the limit, at most once per smoothed round trip. Must be called with m_mutex held.
+ *
+ * @param now The current time.
+ */
+void AdaptiveConcurrencyLimiter::decrease(Clock::time_point now)
+{
+	auto window = std::chrono::microseconds(static_cast<int64_t>(m_smoothedLatency));
+
+	if (m_decreases > 0 && now - m_lastDecrease < window)
+	{
+		return;
+	}
+
+	m_limit = std::max(static_cast<double>(m_minLimit), m_limit / 2.0);
+	m_lastDecrease = now;
+	m_decreases++;
+}
@@ -0,0 +1,147 @@
+#ifndef QRZ_ADAPTIVECONCURRENCYLIMITER_H
+#define QRZ_ADAPTIVECONCURRENCYLIMITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#include "Deadline.h"
+
+namespace qrz::net
+{
+	/**
+	 * @class AdaptiveConcurrencyLimiter
+	 * @brief Limits the number of QRZ API requests in flight, adapting the limit with AIMD.
+	 *
+	 * The limit grows additively (by roughly one request per round trip) while requests succeed with latency close to
+	 * the observed baseline, and is halved when a request fails, times out, is throttled by the server, or takes much
+	 * longer than the baseline. At most one decrease is applied per round trip, so a burst of failures caused by one
+	 * congestion event only cuts the limit once.
+	 *
+	 * This class is thread safe.
+	 */
+	class AdaptiveConcurrencyLimiter
+	{
+	public:
+		/**
+		 * @brief The result of a request, as seen by the limiter.
+		 */
+		enum class Outcome
+		{
+			// The request completed normally
+			SUCCESS,
+			// The server signalled overload (HTTP 429/5xx) or the connection failed
+			OVERLOAD,
+			// The request timed out
+			TIMEOUT
+		};
+
+		/**
+		 * @brief Point-in-time view of the limiter state, for reporting.
+		 */
+		struct Snapshot
+		{
+			double limit = 0;
+			int minLimit = 0;
+			int maxLimit = 0;
+			int inFlight = 0;
+			double baselineLatencyMs = 0;
+			double smoothedLatencyMs = 0;
+			uint64_t increases = 0;
+			uint64_t decreases = 0;
+			uint64_t overloads = 0;
+			uint64_t timeouts = 0;
+		};
+
+		/**
+		 * @brief Constructs a limiter.
+		 *
+		 * @param initialLimit Number of concurrent requests allowed before any latency has been observed.
+		 * @param minLimit Lower bound for the limit.
+		 * @param maxLimit Upper bound for the limit.
+		 */
+		AdaptiveConcurrencyLimiter(int initialLimit, int minLimit, int maxLimit);
+
+		/**
+		 * @brief Blocks until a request may be sent, then counts it as in flight.
+		 *
+		 * @param deadline Gives up waiting once this deadline expires or is cancelled.
+		 * @return True if the request was counted as in flight, false if the deadline expired first.
+		 */
+		bool acquire(const Deadline &deadline = Deadline());
+
+		/**
+		 * @brief Gives back a slot taken by acquire() for a request that was never sent, leaving the limit unchanged.
+		 */
+		void releaseUnused();
+
+		/**
+		 * @brief Marks a request as complete and adjusts the limit based on its outcome.
+		 *
+		 * @param outcome Whether the request succeeded, was throttled, or timed out.
+		 * @param latency Time from sending the request to receiving the full response.
+		 */
+		void release(Outcome outcome, std::chrono::microseconds latency);
+
+		/**
+		 * @brief Changes the bounds of the limit.
+		 *
+		 * @param minLimit Lower bound for the limit.
+		 * @param maxLimit Upper bound for the limit.
+		 */
+		void setBounds(int minLimit, int maxLimit);
+
+		/**
+		 * @brief Returns the upper bound for the limit.
+		 *
+		 * @return The maximum number of concurrent requests the limiter will ever allow.
+		 */
+		int getMaxLimit() const;
+
+		/**
+		 * @brief Returns a snapshot of the limiter state.
+		 *
+		 * @return The current limit, requests in flight, latency estimates and adjustment counters.
+		 */
+		Snapshot snapshot() const;
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		// A successful request slower than this multiple of the baseline latency is treated as congestion
+		static constexpr double m_latencyTolerance = 2.0;
+
+		// Weight of a new sample in the smoothed latency
+		static constexpr double m_smoothingFactor = 0.2;
+
+		mutable std::mutex m_mutex;
+		std::condition_variable m_available;
+
+		double m_limit;
+		int m_minLimit;
+		int m_maxLimit;
+		int m_inFlight = 0;
+
+		// Lowest recent latency in microseconds, drifting slowly upwards so it can follow real changes
+		double m_baselineLatency = 0;
+
+		// Exponentially weighted moving average of latency in microseconds
+		double m_smoothedLatency = 0;
+
+		// Time of the last multiplicative decrease
+		Clock::time_point m_lastDecrease;
+
+		uint64_t m_increases = 0;
+		uint64_t m_decreases = 0;
+		uint64_t m_overloads = 0;
+		uint64_t m_timeouts = 0;
+
+		/**
+		 * @brief Halves the limit, at most once per smoothed round trip. Must be called with m_mutex held.
+		 */
+		void decrease(Clock::time_point now);
+	};
+}
+
+#endif //QRZ_ADAPTIVECONCURRENCYLIMITER_H
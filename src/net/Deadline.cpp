@@ -0,0 +1,152 @@
+#include "Deadline.h"
+
+#include <algorithm>
+#include <thread>
+
+using namespace qrz::net;
+
+/**
+ * @brief Constructs a deadline that never expires.
+ */
+Deadline::Deadline() : m_cancelled(std::make_shared<std::atomic<bool>>(false))
+{}
+
+/**
+ * @brief Creates a deadline the given time from now.
+ *
+ * @param timeout Time until the deadline. Zero or negative means no deadline.
+ * @return The new deadline, with its own cancellation flag.
+ */
+Deadline Deadline::after(std::chrono::milliseconds timeout)
+{
+	Deadline output;
+
+	if (timeout.count() > 0)
+	{
+		output.m_expiry = Clock::now() + timeout;
+	}
+
+	return output;
+}
+
+/**
+ * @brief Creates a deadline that expires at the earlier of this deadline and the given time from now.
+ *
+ * @param timeout Time until the new deadline. Zero or negative keeps this deadline's expiry.
+ * @return The new deadline, sharing this deadline's cancellation flag.
+ */
+Deadline Deadline::narrowed(std::chrono::milliseconds timeout) const
+{
+	Deadline output = *this;
+
+	if (timeout.count() > 0)
+	{
+		Clock::time_point expiry = Clock::now() + timeout;
+
+		output.m_expiry = m_expiry ? std::min(*m_expiry, expiry) : expiry;
+	}
+
+	return output;
+}
+
+/**
+ * @brief Checks whether the deadline has passed or has been cancelled.
+ *
+ * @return True if work should stop.
+ */
+bool Deadline::expired() const
+{
+	return cancelled() || (m_expiry && Clock::now() >= *m_expiry);
+}
+
+/**
+ * @brief Checks whether the deadline has been cancelled.
+ *
+ * @return True if cancel() has been called on this deadline or one it shares a flag with.
+ */
+bool Deadline::cancelled() const
+{
+	return m_cancelled->load();
+}
+
+/**
+ * @brief Cancels the deadline and every deadline sharing its flag.
+ */
+void Deadline::cancel() const
+{
+	m_cancelled->store(true);
+}
+
+/**
+ * @brief Returns the time left until the deadline.
+ *
+ * @return The time left, zero if expired, or std::nullopt if there is no deadline.
+ */
+std::optional<std::chrono::milliseconds> Deadline::remaining() const
+{
+	if (cancelled())
+	{
+		return std::chrono::milliseconds{0};
+	}
+
+	if (!m_expiry)
+	{
+		return std::nullopt;
+	}
+
+	auto left = std::chrono::duration_cast<std::chrono::milliseconds>(*m_expiry - Clock::now());
+
+	return std::max(left, std::chrono::milliseconds{0});
+}
+
+/**
+ * @brief Limits a timeout so it does not run past the deadline.
+ *
+ * @param timeout The timeout to limit.
+ * @return The smaller of the timeout and the time remaining, but at least 1ms so it is never mistaken for
+ * "no timeout".
+ */
+std::chrono::milliseconds Deadline::clamp(std::chrono::milliseconds timeout) const
+{
+	std::optional<std::chrono::milliseconds> left = remaining();
+
+	if (left)
+	{
+		timeout = std::min(timeout, *left);
+	}
+
+	return std::max(timeout, std::chrono::milliseconds{1});
+}
+
+/**
+ * @brief Sleeps for the given time, waking early if the deadline expires or is cancelled.
+ *
+ * The sleep is split into short slices so a cancellation, which may come from a signal handler and so cannot notify
+ * a condition variable, is noticed promptly.
+ *
+ * @param duration The time to sleep.
+ * @return True if the full time was slept, false if the deadline expired or was cancelled.
+ */
+bool Deadline::sleepFor(std::chrono::milliseconds duration) const
+{
+	constexpr std::chrono::milliseconds slice{50};
+
+	Clock::time_point wakeAt = Clock::now() + duration;
+
+	while (true)
+	{
+		if (expired())
+		{
+			return false;
+		}
+
+		Clock::time_point now = Clock::now();
+
+		if (now >= wakeAt)
+		{
+			return true;
+		}
+
+		std::this_thread::sleep_for(std::min<Clock::duration>(slice, wakeAt - now));
+	}
+}
@@ -0,0 +1,99 @@
+#ifndef QRZ_DEADLINE_H
+#define QRZ_DEADLINE_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+
+namespace qrz::net
+{
+	/**
+	 * @class Deadline
+	 * @brief A point in time after which work should stop, combined with a cancellation flag.
+	 *
+	 * A default-constructed deadline never expires. Deadlines derived from another deadline with narrowed() share its
+	 * cancellation flag, so cancelling a batch deadline also cancels every lookup deadline derived from it.
+	 *
+	 * Copies are cheap and may be used from several threads. cancel() only stores to a lock-free atomic, so it may
+	 * also be called from a signal handler.
+	 */
+	class Deadline
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		/**
+		 * @brief Constructs a deadline that never expires.
+		 */
+		Deadline();
+
+		/**
+		 * @brief Creates a deadline the given time from now.
+		 *
+		 * @param timeout Time until the deadline. Zero or negative means no deadline.
+		 * @return The new deadline, with its own cancellation flag.
+		 */
+		static Deadline after(std::chrono::milliseconds timeout);
+
+		/**
+		 * @brief Creates a deadline that expires at the earlier of this deadline and the given time from now.
+		 *
+		 * @param timeout Time until the new deadline. Zero or negative keeps this deadline's expiry.
+		 * @return The new deadline, sharing this deadline's cancellation flag.
+		 */
+		Deadline narrowed(std::chrono::milliseconds timeout) const;
+
+		/**
+		 * @brief Checks whether the deadline has passed or has been cancelled.
+		 *
+		 * @return True if work should stop.
+		 */
+		bool expired() const;
+
+		/**
+		 * @brief Checks whether the deadline has been cancelled.
+		 *
+		 * @return True if cancel() has been called on this deadline or one it shares a flag with.
+		 */
+		bool cancelled() const;
+
+		/**
+		 * @brief Cancels the deadline and every deadline sharing its flag.
+		 */
+		void cancel() const;
+
+		/**
+		 * @brief Returns the time left until the deadline.
+		 *
+		 * @return The time left, zero if expired, or std::nullopt if there is no deadline.
+		 */
+		std::optional<std::chrono::milliseconds> remaining() const;
+
+		/**
+		 * @brief Limits a timeout so it does not run past the deadline.
+		 *
+		 * @param timeout The timeout to limit.
+		 * @return The smaller of the timeout and the time remaining, but at least 1ms so it is never mistaken for
+		 * "no timeout".
+		 */
+		std::chrono::milliseconds clamp(std::chrono::milliseconds timeout) const;
+
+		/**
+		 * @brief Sleeps for the given time, waking early if the deadline expires or is cancelled.
+		 *
+		 * @param duration The time to sleep.
+		 * @return True if the full time was slept, false if the deadline expired or was cancelled.
+		 */
+		bool sleepFor(std::chrono::milliseconds duration) const;
+
+	private:
+		// The expiry time, if any
+		std::optional<Clock::time_point> m_expiry;
+
+		// Cancellation flag shared by related deadlines
+		std::shared_ptr<std::atomic<bool>> m_cancelled;
+	};
+}
+
+#endif //QRZ_DEADLINE_H
@@ -0,0 +1,87 @@
+#include "GuardedInputStream.h"
+
+#include <algorithm>
+
+using namespace qrz::net;
+
+/**
+ * @brief Wraps a stream.
+ *
+ * @param source The stream to read from.
+ * @param guard Called before each read from the source. Returns false to stop reading.
+ */
+GuardedStreamBuf::GuardedStreamBuf(std::istream &source, std::function<bool()> guard)
+		: m_source(source.rdbuf()), m_guard(std::move(guard))
+{}
+
+/**
+ * @brief Returns whether the guard stopped the read.
+ *
+ * @return True if the guard returned false.
+ */
+bool GuardedStreamBuf::stopped() const
+{
+	return m_stopped;
+}
+
+/**
+ * @brief Refills the buffer from the source, if the guard allows it.
+ *
+ * sgetc() refills the source at most once, and reading no more than it then has buffered does not refill it again.
+ * A source without a buffer of its own is read one character at a time.
+ *
+ * @return The next character, or EOF if the source has ended or the guard stopped the read.
+ */
+GuardedStreamBuf::int_type GuardedStreamBuf::underflow()
+{
+	if (gptr() < egptr())
+	{
+		return traits_type::to_int_type(*gptr());
+	}
+
+	if (m_stopped || !m_guard())
+	{
+		m_stopped = true;
+		return traits_type::eof();
+	}
+
+	if (traits_type::eq_int_type(m_source->sgetc(), traits_type::eof()))
+	{
+		return traits_type::eof();
+	}
+
+	std::streamsize available = std::clamp<std::streamsize>(m_source->in_avail(), 1,
+															static_cast<std::streamsize>(m_buffer.size()));
+	std::streamsize read = m_source->sgetn(m_buffer.data(), available);
+
+	if (read <= 0)
+	{
+		return traits_type::eof();
+	}
+
+	setg(m_buffer.data(), m_buffer.data(), m_buffer.data() + read);
+
+	return traits_type::to_int_type(*gptr());
+}
+
+/**
+ * @brief Wraps a stream.
+ *
+ * @param source The stream to read from.
+ * @param guard Called before each read from the source. Returns false to stop reading.
+ */
+GuardedInputStream::GuardedInputStream(std::istream &source, std::function<bool()> guard)
+		: std::istream(nullptr), m_buffer(source, std::move(guard))
+{
+	rdbuf(&m_buffer);
+}
+
+/**
+ * @brief Returns whether the guard stopped the read.
+ *
+ * @return True if the guard returned false.
+ */
+bool GuardedInputStream::stopped() const
+{
+	return m_buffer.stopped();
+}
@@ -0,0 +1,88 @@
+#ifndef QRZ_GUARDEDINPUTSTREAM_H
+#define QRZ_GUARDEDINPUTSTREAM_H
+
+#include <array>
+#include <functional>
+#include <istream>
+#include <streambuf>
+
+namespace qrz::net
+{
+	/**
+	 * @class GuardedStreamBuf
+	 * @brief An input stream buffer that asks a guard before each read from the stream it wraps.
+	 *
+	 * Each refill takes only what the source already has buffered, or else makes it refill exactly once, so when the
+	 * source is a socket stream the guard runs before every receive. The guard can stop the read, which then ends as
+	 * if the source had, or adjust the socket before it blocks.
+	 */
+	class GuardedStreamBuf : public std::streambuf
+	{
+	public:
+		/**
+		 * @brief Wraps a stream.
+		 *
+		 * @param source The stream to read from.
+		 * @param guard Called before each read from the source. Returns false to stop reading.
+		 */
+		GuardedStreamBuf(std::istream &source, std::function<bool()> guard);
+
+		/**
+		 * @brief Returns whether the guard stopped the read.
+		 *
+		 * @return True if the guard returned false.
+		 */
+		bool stopped() const;
+
+	protected:
+		/**
+		 * @brief Refills the buffer from the source, if the guard allows it.
+		 *
+		 * @return The next character, or EOF if the source has ended or the guard stopped the read.
+		 */
+		int_type underflow() override;
+
+	private:
+		std::streambuf *m_source;
+
+		std::function<bool()> m_guard;
+
+		bool m_stopped = false;
+
+		std::array<char, 8192> m_buffer{};
+	};
+
+	/**
+	 * @class GuardedInputStream
+	 * @brief An input stream that asks a guard before each read from the stream it wraps.
+	 *
+	 * Example Usage:
+	 *
+	 * GuardedInputStream guarded(socketStream, [&deadline]() { return !deadline.expired(); });
+	 * Poco::StreamCopier::copyToString(guarded, body);
+	 * if (guarded.stopped()) { ... }
+	 */
+	class GuardedInputStream : public std::istream
+	{
+	public:
+		/**
+		 * @brief Wraps a stream.
+		 *
+		 * @param source The stream to read from.
+		 * @param guard Called before each read from the source. Returns false to stop reading.
+		 */
+		GuardedInputStream(std::istream &source, std::function<bool()> guard);
+
+		/**
+		 * @brief Returns whether the guard stopped the read.
+		 *
+		 * @return True if the guard returned false.
+		 */
+		bool stopped() const;
+
+	private:
+		GuardedStreamBuf m_buffer;
+	};
+}
+
+#endif //QRZ_GUARDEDINPUTSTREAM_H
@@ -0,0 +1,81 @@
+#include "LatencyWindow.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace qrz::net;
+
+/**
+ * @brief Constructs an empty window.
+ *
+ * @param capacity Number of recent samples to keep.
+ */
+LatencyWindow::LatencyWindow(size_t capacity) : m_capacity(std::max<size_t>(capacity, 1))
+{
+	m_samples.reserve(m_capacity);
+}
+
+/**
+ * @brief Adds a latency sample, replacing the oldest one if the window is full.
+ *
+ * @param latency The observed latency.
+ */
+void LatencyWindow::record(std::chrono::microseconds latency)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_samples.size() < m_capacity)
+	{
+		m_samples.push_back(latency);
+	}
+	else
+	{
+		m_samples[m_next] = latency;
+		m_next = (m_next + 1) % m_capacity;
+	}
+}
+
+/**
+ * @brief Returns the given percentile of the samples in the window.
+ *
+ * Uses the nearest-rank method on a copy of the samples, so recording is never blocked for long.
+ *
+ * @param percentile The percentile to compute, between 0 and 100.
+ * @param minSamples Minimum number of samples needed for a meaningful answer.
+ * @return The percentile, or nothing if the window holds fewer than minSamples samples.
+ */
+std::optional<std::chrono::microseconds> LatencyWindow::percentile(double percentile, size_t minSamples) const
+{
+	std::vector<std::chrono::microseconds> samples;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (m_samples.empty() || m_samples.size() < minSamples)
+		{
+			return std::nullopt;
+		}
+
+		samples = m_samples;
+	}
+
+	double clamped = std::clamp(percentile, 0.0, 100.0);
+	auto rank = static_cast<size_t>(std::ceil(clamped / 100.0 * static_cast<double>(samples.size())));
+	size_t index = std::clamp<size_t>(rank, 1, samples.size()) - 1;
+
+	std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(index), samples.end());
+
+	return samples[index];
+}
+
+/**
+ * @brief Returns the number of samples in the window.
+ *
+ * @return The number of samples, at most the capacity.
+ */
+size_t LatencyWindow::size() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_samples.size();
+}
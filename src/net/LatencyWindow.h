@@ -0,0 +1,68 @@
+#ifndef QRZ_LATENCYWINDOW_H
+#define QRZ_LATENCYWINDOW_H
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace qrz::net
+{
+	/**
+	 * @class LatencyWindow
+	 * @brief Keeps the most recent request latencies and answers percentile queries over them.
+	 *
+	 * Samples are stored in a fixed-size ring buffer, so old latencies age out as new ones arrive and the percentiles
+	 * follow changes in server behaviour.
+	 *
+	 * This class is thread safe.
+	 */
+	class LatencyWindow
+	{
+	public:
+		/**
+		 * @brief Constructs an empty window.
+		 *
+		 * @param capacity Number of recent samples to keep.
+		 */
+		explicit LatencyWindow(size_t capacity);
+
+		/**
+		 * @brief Adds a latency sample, replacing the oldest one if the window is full.
+		 *
+		 * @param latency The observed latency.
+		 */
+		void record(std::chrono::microseconds latency);
+
+		/**
+		 * @brief Returns the given percentile of the samples in the window.
+		 *
+		 * @param percentile The percentile to compute, between 0 and 100.
+		 * @param minSamples Minimum number of samples needed for a meaningful answer.
+		 * @return The percentile, or nothing if the window holds fewer than minSamples samples.
+		 */
+		std::optional<std::chrono::microseconds> percentile(double percentile, size_t minSamples) const;
+
+		/**
+		 * @brief Returns the number of samples in the window.
+		 *
+		 * @return The number of samples, at most the capacity.
+		 */
+		size_t size() const;
+
+	private:
+		mutable std::mutex m_mutex;
+
+		// Ring buffer of samples
+		std::vector<std::chrono::microseconds> m_samples;
+
+		// Maximum number of samples kept
+		size_t m_capacity;
+
+		// Index the next sample is written to once the buffer is full
+		size_t m_next = 0;
+	};
+}
+
+#endif //QRZ_LATENCYWINDOW_H
@@ -0,0 +1,207 @@
+#include "PhaseStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace qrz::net;
+
+namespace
+{
+	/**
+	 * @brief Returns a percentile of sorted durations, using the nearest-rank method.
+	 *
+	 * @param sorted The durations, in ascending order. Must not be empty.
+	 * @param percentile The percentile, between 0 and 100.
+	 * @return The percentile.
+	 */
+	std::chrono::microseconds nearestRank(const std::vector<std::chrono::microseconds> &sorted, double percentile)
+	{
+		auto rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sorted.size())));
+
+		return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+	}
+}
+
+/**
+ * @brief Starts timing a phase.
+ *
+ * @param stats The stats to record to, or nullptr to time nothing.
+ * @param phase The phase that starts now.
+ */
+PhaseStats::Timer::Timer(PhaseStats *stats, Phase phase) : m_stats(stats), m_phase(phase), m_running(stats != nullptr)
+{
+	if (m_running)
+	{
+		m_start = Clock::now();
+	}
+}
+
+/**
+ * @brief Records the phase being timed, unless stop() was called.
+ *
+ * A phase left by an exception is still recorded, so failed requests count towards the time spent.
+ */
+PhaseStats::Timer::~Timer()
+{
+	stop();
+}
+
+/**
+ * @brief Records the phase being timed and starts timing the next one.
+ *
+ * The clock is read once, so no time falls between the two phases.
+ *
+ * @param phase The phase that starts now.
+ */
+void PhaseStats::Timer::next(Phase phase)
+{
+	if (!m_running)
+	{
+		return;
+	}
+
+	Clock::time_point now = Clock::now();
+
+	m_stats->record(m_phase, m_start, now);
+
+	m_phase = phase;
+	m_start = now;
+}
+
+/**
+ * @brief Records the phase being timed, and stops timing.
+ */
+void PhaseStats::Timer::stop()
+{
+	if (!m_running)
+	{
+		return;
+	}
+
+	m_running = false;
+
+	m_stats->record(m_phase, m_start, Clock::now());
+}
+
+/**
+ * @brief Adds a sample to a phase.
+ *
+ * @param phase The phase.
+ * @param duration The time spent in it.
+ */
+void PhaseStats::record(Phase phase, std::chrono::microseconds duration)
+{
+	Samples &samples = m_samples[static_cast<size_t>(phase)];
+
+	std::lock_guard<std::mutex> lock(samples.mutex);
+
+	samples.durations.push_back(duration);
+}
+
+/**
+ * @brief Adds a sample to a phase, and records it as a span if a trace recorder is attached.
+ *
+ * @param phase The phase.
+ * @param start When the phase started.
+ * @param end When the phase ended.
+ */
+void PhaseStats::record(Phase phase, Clock::time_point start, Clock::time_point end)
+{
+	record(phase, std::chrono::duration_cast<std::chrono::microseconds>(end - start));
+
+	if (m_traceRecorder)
+	{
+		m_traceRecorder->span(name(phase), start, end);
+	}
+}
+
+/**
+ * @brief Attaches a trace recorder. It must be called before any phase is timed.
+ *
+ * The recorder is read without a lock while phases are timed, so it cannot change once timing has started.
+ *
+ * @param traceRecorder The recorder to record every timed phase to, or nullptr for none.
+ */
+void PhaseStats::setTraceRecorder(std::shared_ptr<TraceRecorder> traceRecorder)
+{
+	m_traceRecorder = std::move(traceRecorder);
+}
+
+/**
+ * @brief Summarizes the phases that have samples.
+ *
+ * Each phase's samples are copied under its lock and sorted afterwards, so recording is never blocked for long.
+ *
+ * @return One summary per phase with at least one sample, in phase order.
+ */
+std::vector<PhaseStats::Summary> PhaseStats::summarize() const
+{
+	std::vector<Summary> output;
+
+	for (size_t i = 0; i < m_phaseCount; ++i)
+	{
+		std::vector<std::chrono::microseconds> durations;
+
+		{
+			std::lock_guard<std::mutex> lock(m_samples[i].mutex);
+
+			durations = m_samples[i].durations;
+		}
+
+		if (durations.empty())
+		{
+			continue;
+		}
+
+		std::sort(durations.begin(), durations.end());
+
+		Summary summary;
+		summary.phase = static_cast<Phase>(i);
+		summary.count = durations.size();
+		summary.total = std::accumulate(durations.begin(), durations.end(), std::chrono::microseconds{0});
+		summary.p50 = nearestRank(durations, 50);
+		summary.p90 = nearestRank(durations, 90);
+		summary.p99 = nearestRank(durations, 99);
+		summary.max = durations.back();
+
+		output.push_back(summary);
+	}
+
+	return output;
+}
+
+/**
+ * @brief Returns the name used for a phase in reports.
+ *
+ * @param phase The phase.
+ * @return The name, e.g. "first byte".
+ */
+std::string_view PhaseStats::name(Phase phase)
+{
+	switch (phase)
+	{
+		case Phase::QUEUE:
+			return "queue";
+		case Phase::CONNECT:
+			return "connect";
+		case Phase::FIRST_BYTE:
+			return "first byte";
+		case Phase::TRANSFER:
+			return "transfer";
+		case Phase::PARSE:
+			return "parse";
+		case Phase::MARSHAL:
+			return "marshal";
+		case Phase::CACHE:
+			return "cache";
+		case Phase::AUTH:
+			return "auth";
+		case Phase::LOOKUP:
+			return "lookup";
+		case Phase::RENDER:
+			return "render";
+	}
+
+	return "unknown";
+}
@@ -0,0 +1,188 @@
+#ifndef QRZ_PHASESTATS_H
+#define QRZ_PHASESTATS_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "TraceRecorder.h"
+
+namespace qrz::net
+{
+	/**
+	 * @brief The phases of a run that are timed for --stats.
+	 */
+	enum class Phase
+	{
+		// Waiting for a worker to pick up a queued lookup
+		QUEUE,
+
+		// Name resolution, TCP connect and TLS handshake, which Poco performs together when the request is sent
+		CONNECT,
+
+		// Waiting for the response headers once the request has been sent
+		FIRST_BYTE,
+
+		// Reading the response body
+		TRANSFER,
+
+		// Checking the response for API errors, which parses it into a DOM
+		PARSE,
+
+		// Converting the response to records
+		MARSHAL,
+
+		// Reading and writing the lookup cache
+		CACHE,
+
+		// Logging in to get a session key
+		AUTH,
+
+		// A whole lookup, including authentication, retries and backoff
+		LOOKUP,
+
+		// Writing the results
+		RENDER
+	};
+
+	/**
+	 * @class PhaseStats
+	 * @brief Collects the time spent in each phase of a run, and summarizes it with totals and percentiles.
+	 *
+	 * Durations are measured with the monotonic clock. Recording takes a lock held only to append one sample, and each
+	 * phase has its own lock, so concurrent lookups rarely wait on each other. With a trace recorder attached, every
+	 * sample is also recorded as a span, on the thread that timed it.
+	 *
+	 * This class is thread safe.
+	 */
+	class PhaseStats
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		/**
+		 * @brief Summary of the samples recorded for one phase.
+		 */
+		struct Summary
+		{
+			Phase phase = Phase::QUEUE;
+
+			uint64_t count = 0;
+
+			std::chrono::microseconds total{0};
+			std::chrono::microseconds p50{0};
+			std::chrono::microseconds p90{0};
+			std::chrono::microseconds p99{0};
+			std::chrono::microseconds max{0};
+		};
+
+		/**
+		 * @class Timer
+		 * @brief Times consecutive phases, recording each one as the next begins.
+		 *
+		 * A timer without stats does nothing, so instrumented code needs no checks of its own when --stats is off.
+		 */
+		class Timer
+		{
+		public:
+			/**
+			 * @brief Starts timing a phase.
+			 *
+			 * @param stats The stats to record to, or nullptr to time nothing.
+			 * @param phase The phase that starts now.
+			 */
+			Timer(PhaseStats *stats, Phase phase);
+
+			/**
+			 * @brief Records the phase being timed, unless stop() was called.
+			 */
+			~Timer();
+
+			Timer(const Timer &) = delete;
+			Timer &operator=(const Timer &) = delete;
+
+			/**
+			 * @brief Records the phase being timed and starts timing the next one.
+			 *
+			 * @param phase The phase that starts now.
+			 */
+			void next(Phase phase);
+
+			/**
+			 * @brief Records the phase being timed, and stops timing.
+			 */
+			void stop();
+
+		private:
+			PhaseStats *m_stats;
+			Phase m_phase;
+			Clock::time_point m_start;
+			bool m_running;
+		};
+
+		/**
+		 * @brief Adds a sample to a phase.
+		 *
+		 * @param phase The phase.
+		 * @param duration The time spent in it.
+		 */
+		void record(Phase phase, std::chrono::microseconds duration);
+
+		/**
+		 * @brief Adds a sample to a phase, and records it as a span if a trace recorder is attached.
+		 *
+		 * @param phase The phase.
+		 * @param start When the phase started.
+		 * @param end When the phase ended.
+		 */
+		void record(Phase phase, Clock::time_point start, Clock::time_point end);
+
+		/**
+		 * @brief Attaches a trace recorder. It must be called before any phase is timed.
+		 *
+		 * @param traceRecorder The recorder to record every timed phase to, or nullptr for none.
+		 */
+		void setTraceRecorder(std::shared_ptr<TraceRecorder> traceRecorder);
+
+		/**
+		 * @brief Summarizes the phases that have samples.
+		 *
+		 * @return One summary per phase with at least one sample, in phase order.
+		 */
+		std::vector<Summary> summarize() const;
+
+		/**
+		 * @brief Returns the name used for a phase in reports.
+		 *
+		 * @param phase The phase.
+		 * @return The name, e.g. "first byte".
+		 */
+		static std::string_view name(Phase phase);
+
+	private:
+		// Number of values in Phase
+		static constexpr size_t m_phaseCount = static_cast<size_t>(Phase::RENDER) + 1;
+
+		/**
+		 * @brief The samples of one phase.
+		 */
+		struct Samples
+		{
+			mutable std::mutex mutex;
+
+			std::vector<std::chrono::microseconds> durations;
+		};
+
+		std::array<Samples, m_phaseCount> m_samples;
+
+		// Recorder every timed phase is also recorded to, or nullptr
+		std::shared_ptr<TraceRecorder> m_traceRecorder;
+	};
+}
+
+#endif //QRZ_PHASESTATS_H
@@ -0,0 +1,154 @@
+#include "RetryPolicy.h"
+
+#include <algorithm>
+
+using namespace qrz::net;
+
+/**
+ * @brief Constructs a retry policy.
+ *
+ * The budget starts at minBudget.
+ *
+ * @param maxAttempts Maximum number of attempts per request, including the first.
+ * @param baseDelay Upper bound of the delay before the first retry.
+ * @param maxDelay Upper bound of the delay before any retry.
+ * @param budgetRatio Retries added to the budget for every request.
+ * @param minBudget Retries available at the start of a batch, so small batches can still retry.
+ */
+RetryPolicy::RetryPolicy(int maxAttempts, std::chrono::milliseconds baseDelay, std::chrono::milliseconds maxDelay,
+						 double budgetRatio, double minBudget) :
+		m_maxAttempts(std::max(maxAttempts, 1)), m_baseDelay(baseDelay), m_maxDelay(std::max(maxDelay, baseDelay)),
+		m_budgetRatio(std::max(budgetRatio, 0.0)), m_minBudget(std::max(minBudget, 0.0)), m_budget(m_minBudget),
+		m_random(std::random_device{}())
+{}
+
+/**
+ * @brief Records a new request, adding to the retry budget.
+ */
+void RetryPolicy::recordRequest()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_requests++;
+	m_budget += m_budgetRatio;
+}
+
+/**
+ * @brief Decides whether a failed request may be retried, and spends from the budget if so.
+ *
+ * A retry is refused once the request has used all of its attempts, or when the batch has no retry budget left.
+ *
+ * @param attempts Number of attempts made so far for this request.
+ * @return True if the request should be retried.
+ */
+bool RetryPolicy::allowRetry(int attempts)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (attempts >= m_maxAttempts)
+	{
+		m_attemptsExhausted++;
+		return false;
+	}
+
+	if (m_budget < 1.0)
+	{
+		m_budgetExhausted++;
+		return false;
+	}
+
+	m_budget -= 1.0;
+	m_retries++;
+
+	return true;
+}
+
+/**
+ * @brief Computes the jittered delay before the next attempt.
+ *
+ * The delay is drawn uniformly from [0, min(maxDelay, baseDelay * 2^(attempts - 1))].
+ *
+ * @param attempts Number of attempts made so far for this request.
+ * @return The time to wait before retrying.
+ */
+std::chrono::milliseconds RetryPolicy::backoff(int attempts)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// Cap the shift so the multiplication cannot overflow; the result is clamped to m_maxDelay anyway
+	int exponent = std::clamp(attempts - 1, 0, 20);
+
+	std::chrono::milliseconds ceiling = std::min(m_maxDelay, m_baseDelay * (int64_t{1} << exponent));
+
+	std::uniform_int_distribution<int64_t> distribution(0, ceiling.count());
+	std::chrono::milliseconds delay(distribution(m_random));
+
+	m_totalBackoff += delay;
+
+	return delay;
+}
+
+/**
+ * @brief Refills the retry budget to its starting value, at the start of a batch.
+ */
+void RetryPolicy::resetBudget()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_budget = m_minBudget;
+}
+
+/**
+ * @brief Returns the upper bound of the delay before any retry.
+ *
+ * @return The maximum backoff delay.
+ */
+std::chrono::milliseconds RetryPolicy::getMaxDelay() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_maxDelay;
+}
+
+/**
+ * @brief Returns a snapshot of the retry state.
+ *
+ * @return The attempt limit, remaining budget and retry counters.
+ */
+RetryPolicy::Snapshot RetryPolicy::snapshot() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	Snapshot output;
+	output.maxAttempts = m_maxAttempts;
+	output.budget = m_budget;
+	output.requests = m_requests;
+	output.retries = m_retries;
+	output.attemptsExhausted = m_attemptsExhausted;
+	output.budgetExhausted = m_budgetExhausted;
+	output.totalBackoff = m_totalBackoff;
+
+	return output;
+}
+
+/**
+ * @brief Checks whether an HTTP status code indicates a transient failure worth retrying.
+ *
+ * @param status The HTTP status code.
+ * @return True for 408, 429, 500, 502, 503 and 504.
+ */
+bool RetryPolicy::isRetryableStatus(int status)
+{
+	switch (status)
+	{
+		case 408:
+		case 429:
+		case 500:
+		case 502:
+		case 503:
+		case 504:
+			return true;
+		default:
+			return false;
+	}
+}
@@ -0,0 +1,126 @@
+#ifndef QRZ_RETRYPOLICY_H
+#define QRZ_RETRYPOLICY_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+namespace qrz::net
+{
+	/**
+	 * @class RetryPolicy
+	 * @brief Decides whether a failed QRZ API request may be retried, and how long to wait before retrying.
+	 *
+	 * Each request may be attempted up to a fixed number of times. Delays grow exponentially from the base delay up to
+	 * the maximum delay, and "full jitter" is applied (the actual delay is uniformly distributed between zero and the
+	 * exponential delay) so concurrent workers that failed together do not retry together.
+	 *
+	 * Retries are also limited by a retry budget shared by a whole batch. Every request adds a fraction of a retry to
+	 * the budget and every retry spends one, so during an outage the client sends at most that fraction of extra load
+	 * instead of multiplying its request rate by the number of attempts.
+	 *
+	 * This class is thread safe.
+	 */
+	class RetryPolicy
+	{
+	public:
+		/**
+		 * @brief Point-in-time view of the retry state, for reporting.
+		 */
+		struct Snapshot
+		{
+			int maxAttempts = 0;
+			double budget = 0;
+			uint64_t requests = 0;
+			uint64_t retries = 0;
+			uint64_t attemptsExhausted = 0;
+			uint64_t budgetExhausted = 0;
+			std::chrono::microseconds totalBackoff{0};
+		};
+
+		/**
+		 * @brief Constructs a retry policy.
+		 *
+		 * @param maxAttempts Maximum number of attempts per request, including the first.
+		 * @param baseDelay Upper bound of the delay before the first retry.
+		 * @param maxDelay Upper bound of the delay before any retry.
+		 * @param budgetRatio Retries added to the budget for every request.
+		 * @param minBudget Retries available at the start of a batch, so small batches can still retry.
+		 */
+		RetryPolicy(int maxAttempts, std::chrono::milliseconds baseDelay, std::chrono::milliseconds maxDelay,
+					double budgetRatio, double minBudget);
+
+		/**
+		 * @brief Records a new request, adding to the retry budget.
+		 */
+		void recordRequest();
+
+		/**
+		 * @brief Decides whether a failed request may be retried, and spends from the budget if so.
+		 *
+		 * @param attempts Number of attempts made so far for this request.
+		 * @return True if the request should be retried.
+		 */
+		bool allowRetry(int attempts);
+
+		/**
+		 * @brief Computes the jittered delay before the next attempt.
+		 *
+		 * @param attempts Number of attempts made so far for this request.
+		 * @return The time to wait before retrying.
+		 */
+		std::chrono::milliseconds backoff(int attempts);
+
+		/**
+		 * @brief Refills the retry budget to its starting value, at the start of a batch.
+		 */
+		void resetBudget();
+
+		/**
+		 * @brief Returns the upper bound of the delay before any retry.
+		 *
+		 * @return The maximum backoff delay.
+		 */
+		std::chrono::milliseconds getMaxDelay() const;
+
+		/**
+		 * @brief Returns a snapshot of the retry state.
+		 *
+		 * @return The attempt limit, remaining budget and retry counters.
+		 */
+		Snapshot snapshot() const;
+
+		/**
+		 * @brief Checks whether an HTTP status code indicates a transient failure worth retrying.
+		 *
+		 * @param status The HTTP status code.
+		 * @return True for 408, 429, 500, 502, 503 and 504.
+		 */
+		static bool isRetryableStatus(int status);
+
+	private:
+		mutable std::mutex m_mutex;
+
+		int m_maxAttempts;
+		std::chrono::milliseconds m_baseDelay;
+		std::chrono::milliseconds m_maxDelay;
+		double m_budgetRatio;
+		double m_minBudget;
+
+		// Retries that may still be spent in this batch
+		double m_budget;
+
+		// Source of jitter
+		std::mt19937 m_random;
+
+		// Counters for reporting
+		uint64_t m_requests = 0;
+		uint64_t m_retries = 0;
+		uint64_t m_attemptsExhausted = 0;
+		uint64_t m_budgetExhausted = 0;
+		std::chrono::microseconds m_totalBackoff{0};
+	};
+}
+
+#endif //QRZ_RETRYPOLICY_H
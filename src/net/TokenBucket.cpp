@@ -0,0 +1,114 @@
+#include "TokenBucket.h"
+
+#include <algorithm>
+
+using namespace qrz::net;
+
+/**
+ * @brief Constructs a token bucket.
+ *
+ * The bucket starts full, so the first `burst` requests are not delayed.
+ *
+ * @param ratePerSecond Sustained number of requests allowed per second.
+ * @param burst Maximum number of requests that may be made back to back after an idle period.
+ */
+TokenBucket::TokenBucket(double ratePerSecond, double burst) : m_rate(std::max(ratePerSecond, 0.001)),
+															   m_burst(std::max(burst, 1.0)), m_tokens(m_burst),
+															   m_lastRefill(Clock::now())
+{}
+
+/**
+ * @brief Takes a token, sleeping until one is available.
+ *
+ * If no token is available, the caller reserves one by driving the token count negative, computes when that token
+ * will have accrued, and sleeps outside the lock until then. If the deadline expires or is cancelled during the sleep,
+ * the reserved token is given back, so the requests queued behind it do not wait for a request that is never sent.
+ *
+ * @param deadline Gives up waiting once this deadline expires or is cancelled.
+ * @return True if a token was taken, false if the deadline expired first.
+ */
+bool TokenBucket::acquire(const Deadline &deadline)
+{
+	std::chrono::microseconds wait{0};
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		refill(Clock::now());
+
+		m_tokens -= 1.0;
+		m_acquired++;
+
+		if (m_tokens < 0)
+		{
+			wait = std::chrono::microseconds(static_cast<int64_t>(-m_tokens / m_rate * 1e6));
+
+			m_waits++;
+			m_totalWait += wait;
+		}
+	}
+
+	if (wait.count() > 0 && !deadline.sleepFor(std::chrono::ceil<std::chrono::milliseconds>(wait)))
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		m_tokens = std::min(m_tokens + 1.0, m_burst);
+		m_acquired--;
+
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Changes the sustained rate and the burst size.
+ *
+ * Tokens accrued at the old rate are kept, clamped to the new burst size.
+ *
+ * @param ratePerSecond Sustained number of requests allowed per second.
+ * @param burst Maximum number of requests that may be made back to back after an idle period.
+ */
+void TokenBucket::setRate(double ratePerSecond, double burst)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	refill(Clock::now());
+
+	m_rate = std::max(ratePerSecond, 0.001);
+	m_burst = std::max(burst, 1.0);
+	m_tokens = std::min(m_tokens, m_burst);
+}
+
+/**
+ * @brief Returns a snapshot of the limiter state.
+ *
+ * @return The current rate, burst, available tokens and wait counters.
+ */
+TokenBucket::Snapshot TokenBucket::snapshot() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	Snapshot output;
+	output.rate = m_rate;
+	output.burst = m_burst;
+	output.tokens = m_tokens;
+	output.acquired = m_acquired;
+	output.waits = m_waits;
+	output.totalWait = m_totalWait;
+
+	return output;
+}
+
+/**
+ * @brief Adds the tokens accrued since the last refill. Must be called with m_mutex held.
+ *
+ * @param now The current time.
+ */
+void TokenBucket::refill(Clock::time_point now)
+{
+	std::chrono::duration<double> elapsed = now - m_lastRefill;
+
+	m_tokens = std::min(m_burst, m_tokens + elapsed.count() * m_rate);
+	m_lastRefill = now;
+}
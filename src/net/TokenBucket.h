@@ -0,0 +1,98 @@
+#ifndef QRZ_TOKENBUCKET_H
+#define QRZ_TOKENBUCKET_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#include "Deadline.h"
+
+namespace qrz::net
+{
+	/**
+	 * @class TokenBucket
+	 * @brief Client-side token-bucket rate limiter for QRZ API calls.
+	 *
+	 * Tokens are added continuously at the configured rate, up to the burst size. Each request takes one token.
+	 * When the bucket is empty the caller reserves the next token and sleeps until it is due, so waiting callers are
+	 * released one token interval apart instead of all at once.
+	 *
+	 * This class is thread safe.
+	 */
+	class TokenBucket
+	{
+	public:
+		/**
+		 * @brief Point-in-time view of the limiter state, for reporting.
+		 */
+		struct Snapshot
+		{
+			double rate = 0;
+			double burst = 0;
+			double tokens = 0;
+			uint64_t acquired = 0;
+			uint64_t waits = 0;
+			std::chrono::microseconds totalWait{0};
+		};
+
+		/**
+		 * @brief Constructs a token bucket.
+		 *
+		 * @param ratePerSecond Sustained number of requests allowed per second.
+		 * @param burst Maximum number of requests that may be made back to back after an idle period.
+		 */
+		TokenBucket(double ratePerSecond, double burst);
+
+		/**
+		 * @brief Takes a token, sleeping until one is available.
+		 *
+		 * @param deadline Gives up waiting once this deadline expires or is cancelled.
+		 * @return True if a token was taken, false if the deadline expired first.
+		 */
+		bool acquire(const Deadline &deadline = Deadline());
+
+		/**
+		 * @brief Changes the sustained rate and the burst size.
+		 *
+		 * @param ratePerSecond Sustained number of requests allowed per second.
+		 * @param burst Maximum number of requests that may be made back to back after an idle period.
+		 */
+		void setRate(double ratePerSecond, double burst);
+
+		/**
+		 * @brief Returns a snapshot of the limiter state.
+		 *
+		 * @return The current rate, burst, available tokens and wait counters.
+		 */
+		Snapshot snapshot() const;
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		mutable std::mutex m_mutex;
+
+		// Sustained rate in tokens per second
+		double m_rate;
+
+		// Bucket capacity
+		double m_burst;
+
+		// Available tokens. Goes negative while callers are waiting on reserved tokens
+		double m_tokens;
+
+		// Last time the bucket was refilled
+		Clock::time_point m_lastRefill;
+
+		// Counters for reporting
+		uint64_t m_acquired = 0;
+		uint64_t m_waits = 0;
+		std::chrono::microseconds m_totalWait{0};
+
+		/**
+		 * @brief Adds the tokens accrued since the last refill. Must be called with m_mutex held.
+		 */
+		void refill(Clock::time_point now);
+	};
+}
+
+#endif //QRZ_TOKENBUCKET_H
@@ -0,0 +1,202 @@
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <format>
+
+using namespace qrz::net;
+
+namespace
+{
+	// Source of recorder ids. 0 is never used, so it can mean "no recorder"
+	std::atomic<uint64_t> nextRecorderId = 1;
+
+	// Tag added to the spans recorded by this thread, null-terminated
+	thread_local std::array<char, 16> threadTag{};
+
+	// The ring this thread last recorded into, and the id of the recorder it belongs to
+	thread_local uint64_t cachedRecorderId = 0;
+	thread_local void *cachedRing = nullptr;
+
+	/**
+	 * @brief Writes a tag as a JSON string, escaping what JSON requires.
+	 *
+	 * @param output The stream to write to.
+	 * @param tag The tag.
+	 */
+	void writeJsonString(std::ostream &output, std::string_view tag)
+	{
+		output << '"';
+
+		for (char c : tag)
+		{
+			if (c == '"' || c == '\\')
+			{
+				output << '\\' << c;
+			}
+			else if (static_cast<unsigned char>(c) < 0x20)
+			{
+				output << std::format("\\u{:04x}", static_cast<unsigned>(c));
+			}
+			else
+			{
+				output << c;
+			}
+		}
+
+		output << '"';
+	}
+}
+
+/**
+ * @brief Constructs a recorder. Span times are written relative to its construction.
+ *
+ * @param spansPerThread Maximum number of spans each thread's ring buffer holds.
+ */
+TraceRecorder::TraceRecorder(size_t spansPerThread) : m_id(nextRecorderId.fetch_add(1)), m_origin(Clock::now()),
+													  m_capacity(std::max<size_t>(spansPerThread, 1))
+{
+}
+
+/**
+ * @brief Records a span on the calling thread.
+ *
+ * Only the calling thread writes to its ring, so the span is stored without a lock. The ring grows as needed up to
+ * its capacity, so short runs use little memory and a full ring never allocates. The head is published with release
+ * ordering, so write() sees the whole span once it sees the new head.
+ *
+ * @param name The span name. It must have static storage duration, e.g. a string literal.
+ * @param start When the span started.
+ * @param end When the span ended.
+ */
+void TraceRecorder::span(std::string_view name, Clock::time_point start, Clock::time_point end)
+{
+	Ring &ring = threadRing();
+
+	uint64_t head = ring.head.load(std::memory_order_relaxed);
+
+	if (ring.spans.size() < m_capacity)
+	{
+		ring.spans.emplace_back();
+	}
+
+	Span &span = ring.spans[head % m_capacity];
+
+	span.name = name;
+	span.start = std::chrono::duration_cast<std::chrono::microseconds>(start - m_origin).count();
+	span.duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+	span.tag = threadTag;
+
+	ring.head.store(head + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Sets the tag added to the spans the calling thread records from now on.
+ *
+ * @param tag The tag, e.g. a callsign, or empty for none. Tags longer than 15 characters are truncated.
+ */
+void TraceRecorder::setThreadTag(std::string_view tag)
+{
+	size_t length = std::min(tag.size(), threadTag.size() - 1);
+
+	std::copy_n(tag.begin(), length, threadTag.begin());
+	threadTag[length] = '\0';
+}
+
+/**
+ * @brief Writes every recorded span as Chrome trace-event JSON.
+ *
+ * Spans are written as complete ("X") events on process 1, one track per recording thread, with the tag as the call
+ * argument. Each thread is also named, so workers are easy to tell apart.
+ *
+ * @param output The stream to write to.
+ */
+void TraceRecorder::write(std::ostream &output) const
+{
+	std::lock_guard<std::mutex> lock(m_ringsMutex);
+
+	output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	bool first = true;
+
+	for (const std::unique_ptr<Ring> &ring : m_rings)
+	{
+		output << (first ? "\n" : ",\n");
+		first = false;
+
+		output << std::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"thread {}"}}}})",
+							  ring->threadId, ring->threadId);
+
+		uint64_t head = ring->head.load(std::memory_order_acquire);
+
+		for (uint64_t i = head > m_capacity ? head - m_capacity : 0; i < head; ++i)
+		{
+			const Span &span = ring->spans[i % m_capacity];
+
+			output << std::format(R"(,{}{{"name":"{}","cat":"qrz","ph":"X","ts":{},"dur":{},"pid":1,"tid":{})", '\n',
+								  span.name, span.start, span.duration, ring->threadId);
+
+			if (span.tag[0] != '\0')
+			{
+				output << ",\"args\":{\"call\":";
+				writeJsonString(output, span.tag.data());
+				output << '}';
+			}
+
+			output << '}';
+		}
+	}
+
+	output << "\n]}\n";
+}
+
+/**
+ * @brief Returns the number of spans overwritten because a ring buffer was full.
+ *
+ * @return The number of spans lost.
+ */
+uint64_t TraceRecorder::dropped() const
+{
+	std::lock_guard<std::mutex> lock(m_ringsMutex);
+
+	uint64_t output = 0;
+
+	for (const std::unique_ptr<Ring> &ring : m_rings)
+	{
+		uint64_t head = ring->head.load(std::memory_order_relaxed);
+
+		output += head > m_capacity ? head - m_capacity : 0;
+	}
+
+	return output;
+}
+
+/**
+ * @brief Returns the calling thread's ring, registering one on first use.
+ *
+ * The ring is remembered in thread-local storage, so the lock is only taken the first time a thread records. A thread
+ * that alternates between recorders registers a new ring each time it switches.
+ *
+ * @return The ring.
+ */
+TraceRecorder::Ring &TraceRecorder::threadRing()
+{
+	if (cachedRecorderId == m_id)
+	{
+		return *static_cast<Ring *>(cachedRing);
+	}
+
+	auto ring = std::make_unique<Ring>();
+
+	{
+		std::lock_guard<std::mutex> lock(m_ringsMutex);
+
+		ring->threadId = static_cast<uint32_t>(m_rings.size() + 1);
+		m_rings.push_back(std::move(ring));
+
+		cachedRing = m_rings.back().get();
+	}
+
+	cachedRecorderId = m_id;
+
+	return *static_cast<Ring *>(cachedRing);
+}
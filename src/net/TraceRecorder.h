@@ -0,0 +1,125 @@
+#ifndef QRZ_TRACERECORDER_H
+#define QRZ_TRACERECORDER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace qrz::net
+{
+	/**
+	 * @class TraceRecorder
+	 * @brief Records timed spans from many threads and writes them as Chrome trace-event JSON.
+	 *
+	 * Every thread records into a ring buffer of its own, registered the first time it records, so recording a span
+	 * takes no lock. When a ring is full the oldest spans are overwritten. Each span carries the tag the recording
+	 * thread set last, e.g. the callsign it is looking up.
+	 *
+	 * The output can be loaded into chrome://tracing or https://ui.perfetto.dev to see how lookups overlapped, queued
+	 * and stalled.
+	 *
+	 * Recording is thread safe. write() must only be called once no thread is recording.
+	 */
+	class TraceRecorder
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		/**
+		 * @brief Constructs a recorder. Span times are written relative to its construction.
+		 *
+		 * @param spansPerThread Maximum number of spans each thread's ring buffer holds.
+		 */
+		explicit TraceRecorder(size_t spansPerThread = 65536);
+
+		/**
+		 * @brief Records a span on the calling thread.
+		 *
+		 * @param name The span name. It must have static storage duration, e.g. a string literal.
+		 * @param start When the span started.
+		 * @param end When the span ended.
+		 */
+		void span(std::string_view name, Clock::time_point start, Clock::time_point end);
+
+		/**
+		 * @brief Sets the tag added to the spans the calling thread records from now on.
+		 *
+		 * @param tag The tag, e.g. a callsign, or empty for none. Tags longer than 15 characters are truncated.
+		 */
+		static void setThreadTag(std::string_view tag);
+
+		/**
+		 * @brief Writes every recorded span as Chrome trace-event JSON.
+		 *
+		 * @param output The stream to write to.
+		 */
+		void write(std::ostream &output) const;
+
+		/**
+		 * @brief Returns the number of spans overwritten because a ring buffer was full.
+		 *
+		 * @return The number of spans lost.
+		 */
+		uint64_t dropped() const;
+
+	private:
+		// Maximum tag length, plus the terminating null
+		static constexpr size_t m_tagSize = 16;
+
+		/**
+		 * @brief A recorded span.
+		 */
+		struct Span
+		{
+			std::string_view name;
+
+			// Start and duration, in microseconds since the recorder was constructed
+			int64_t start = 0;
+			int64_t duration = 0;
+
+			std::array<char, m_tagSize> tag{};
+		};
+
+		/**
+		 * @brief The spans recorded by one thread. Only that thread writes to it.
+		 */
+		struct Ring
+		{
+			// Thread id written to the trace, numbered in order of first use
+			uint32_t threadId = 0;
+
+			std::vector<Span> spans;
+
+			// Number of spans ever recorded. Spans [head - capacity, head) are in the ring
+			std::atomic<uint64_t> head = 0;
+		};
+
+		/**
+		 * @brief Returns the calling thread's ring, registering one on first use.
+		 *
+		 * @return The ring.
+		 */
+		Ring &threadRing();
+
+		// Distinguishes recorders in the per-thread ring lookup, even if one is created at the address of another
+		const uint64_t m_id;
+
+		const Clock::time_point m_origin;
+
+		const size_t m_capacity;
+
+		// Guards the ring list, which only changes when a thread records for the first time
+		mutable std::mutex m_ringsMutex;
+
+		std::vector<std::unique_ptr<Ring>> m_rings;
+	};
+}
+
+#endif //QRZ_TRACERECORDER_H
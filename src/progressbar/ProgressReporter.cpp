@@ -0,0 +1,202 @@
+#include "ProgressReporter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <format>
+
+#ifdef WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace qrz;
+
+/**
+ * @brief Hides the cursor and starts drawing the bar.
+ *
+ * @param bar The bar to draw.
+ * @param total The number of items in the batch.
+ * @param frameInterval Time between redraws.
+ */
+ProgressReporter::ProgressReporter(std::unique_ptr<ProgressBar> bar, size_t total,
+								   std::chrono::milliseconds frameInterval)
+		: m_bar(std::move(bar)), m_total(total), m_frameInterval(frameInterval)
+{
+	showConsoleCursor(false);
+
+	m_thread = std::thread(&ProgressReporter::run, this);
+}
+
+/**
+ * @brief Stops drawing, see finish().
+ */
+ProgressReporter::~ProgressReporter()
+{
+	finish();
+}
+
+/**
+ * @brief Stops drawing and clears the bar, e.g. while the user is prompted for their password.
+ *
+ * Once this returns, no frame is being drawn, so the terminal is free to use.
+ */
+void ProgressReporter::suspend()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (!m_suspended && !m_stopping)
+	{
+		m_suspended = true;
+		eraseLine();
+		showConsoleCursor(true);
+	}
+}
+
+/**
+ * @brief Starts drawing again after suspend().
+ */
+void ProgressReporter::resume()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_suspended && !m_stopping)
+	{
+		m_suspended = false;
+		showConsoleCursor(false);
+	}
+}
+
+/**
+ * @brief Stops the rendering thread, clears the bar and shows the cursor again. Safe to call more than once.
+ */
+void ProgressReporter::finish()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (m_stopping)
+		{
+			return;
+		}
+
+		m_stopping = true;
+	}
+
+	m_wake.notify_all();
+	m_thread.join();
+
+	m_bar->setOption(indicators::option::PostfixText{""});
+	m_bar->setProgress(100);
+	eraseLine();
+	showConsoleCursor(true);
+}
+
+/**
+ * @brief Checks whether a stream, by default stderr where the bar is drawn, is a terminal.
+ *
+ * When stderr is redirected to a file or a pipe, such as in cron jobs, a bar would only fill the log with escape
+ * codes.
+ *
+ * @param stream The stream to check.
+ * @return True if the stream is a terminal.
+ */
+bool ProgressReporter::isTerminal(std::FILE *stream)
+{
+#ifdef WIN32
+	return _isatty(_fileno(stream)) != 0;
+#else
+	return isatty(fileno(stream)) != 0;
+#endif
+}
+
+/**
+ * @brief Formats the text shown after the bar.
+ *
+ * The throughput is the average since the batch started, and the time left is the remaining items at that rate.
+ *
+ * @param completed The number of items done.
+ * @param total The number of items in the batch.
+ * @param elapsed The time since the batch started.
+ * @return The status, e.g. "312/1284 42.1/s ETA 0:23".
+ */
+std::string ProgressReporter::formatStatus(size_t completed, size_t total, std::chrono::duration<double> elapsed)
+{
+	double rate = elapsed.count() > 0 ? static_cast<double>(completed) / elapsed.count() : 0;
+
+	if (completed == 0 || rate <= 0)
+	{
+		return std::format("{}/{} ETA --:--", completed, total);
+	}
+
+	auto remaining = static_cast<long long>(std::ceil(static_cast<double>(total - std::min(completed, total)) / rate));
+
+	return std::format("{}/{} {:.1f}/s ETA {}:{:02}", completed, total, rate, remaining / 60, remaining % 60);
+}
+
+/**
+ * @brief Redraws the bar every frame until finish() is called.
+ */
+void ProgressReporter::run()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	while (!m_stopping)
+	{
+		if (!m_suspended)
+		{
+			draw();
+		}
+
+		m_wake.wait_for(lock, m_frameInterval, [this]()
+		{
+			return m_stopping;
+		});
+	}
+}
+
+/**
+ * @brief Redraws the bar. The caller must hold m_mutex.
+ */
+void ProgressReporter::draw()
+{
+	size_t done = std::min(completed(), m_total);
+
+	m_bar->setOption(indicators::option::PostfixText{formatStatus(done, m_total, Clock::now() - m_start)});
+	m_bar->setProgress(m_total > 0 ? done * 100 / m_total : 100);
+}
+
+/**
+ * @brief Changes the visibility of the console cursor.
+ *
+ * @param show True to show the cursor, false to hide it.
+ */
+void ProgressReporter::showConsoleCursor(bool show)
+{
+	std::fputs(show ? "\033[?25h" : "\033[?25l", stderr);
+}
+
+#ifdef WIN32
+/**
+ * @brief Erases the current line in the console.
+ *
+ * It uses the escape sequences "\x1b[1A" and "\x1b[2K" to move the cursor to the beginning of the line and clear all
+ * characters.
+ */
+void ProgressReporter::eraseLine()
+{
+	std::fputs("\x1b[1A", stderr);
+	std::fputs("\x1b[2K", stderr);
+}
+#else
+/**
+ * @brief Erases the current line in the console.
+ *
+ * It uses the escape sequence "\r\033[K" to move the cursor to the beginning of the line and clear all characters.
+ */
+void ProgressReporter::eraseLine()
+{
+	std::fputs("\r\033[K", stderr);
+}
+#endif
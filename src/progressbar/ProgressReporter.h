@@ -0,0 +1,147 @@
+#ifndef QRZ_PROGRESSREPORTER_H
+#define QRZ_PROGRESSREPORTER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "ProgressBar.h"
+
+namespace qrz
+{
+	/**
+	 * @class ProgressReporter
+	 * @brief Draws a progress bar for a batch on a thread of its own.
+	 *
+	 * The fetch workers only bump an atomic counter through advance(). A rendering thread samples the counter at a
+	 * fixed frame rate and redraws the bar with the throughput and estimated time left, so drawing to the terminal
+	 * never slows the fetches down, however fast they complete.
+	 *
+	 * The bar should only be shown when stderr is a terminal, see isTerminal().
+	 */
+	class ProgressReporter
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		/**
+		 * @brief Hides the cursor and starts drawing the bar.
+		 *
+		 * @param bar The bar to draw.
+		 * @param total The number of items in the batch.
+		 * @param frameInterval Time between redraws.
+		 */
+		ProgressReporter(std::unique_ptr<ProgressBar> bar, size_t total,
+						 std::chrono::milliseconds frameInterval = std::chrono::milliseconds(100));
+
+		/**
+		 * @brief Stops drawing, see finish().
+		 */
+		~ProgressReporter();
+
+		ProgressReporter(const ProgressReporter &) = delete;
+		ProgressReporter &operator=(const ProgressReporter &) = delete;
+
+		/**
+		 * @brief Counts one more item as done. Safe to call from any thread.
+		 */
+		void advance()
+		{
+			m_completed.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Returns the number of items done so far.
+		 *
+		 * @return The count.
+		 */
+		size_t completed() const
+		{
+			return m_completed.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Stops drawing and clears the bar, e.g. while the user is prompted for their password.
+		 */
+		void suspend();
+
+		/**
+		 * @brief Starts drawing again after suspend().
+		 */
+		void resume();
+
+		/**
+		 * @brief Stops the rendering thread, clears the bar and shows the cursor again. Safe to call more than once.
+		 */
+		void finish();
+
+		/**
+		 * @brief Checks whether a stream, by default stderr where the bar is drawn, is a terminal.
+		 *
+		 * @param stream The stream to check.
+		 * @return True if the stream is a terminal.
+		 */
+		static bool isTerminal(std::FILE *stream = stderr);
+
+		/**
+		 * @brief Formats the text shown after the bar.
+		 *
+		 * @param completed The number of items done.
+		 * @param total The number of items in the batch.
+		 * @param elapsed The time since the batch started.
+		 * @return The status, e.g. "312/1284 42.1/s ETA 0:23".
+		 */
+		static std::string formatStatus(size_t completed, size_t total, std::chrono::duration<double> elapsed);
+
+	private:
+		std::unique_ptr<ProgressBar> m_bar;
+
+		const size_t m_total;
+
+		const std::chrono::milliseconds m_frameInterval;
+
+		const Clock::time_point m_start = Clock::now();
+
+		std::atomic<size_t> m_completed = 0;
+
+		// Guards the bar and the terminal, and the flags below
+		std::mutex m_mutex;
+
+		std::condition_variable m_wake;
+
+		bool m_stopping = false;
+
+		bool m_suspended = false;
+
+		std::thread m_thread;
+
+		/**
+		 * @brief Redraws the bar every frame until finish() is called.
+		 */
+		void run();
+
+		/**
+		 * @brief Redraws the bar. The caller must hold m_mutex.
+		 */
+		void draw();
+
+		/**
+		 * @brief Changes the visibility of the console cursor.
+		 *
+		 * @param show True to show the cursor, false to hide it.
+		 */
+		static void showConsoleCursor(bool show);
+
+		/**
+		 * @brief Erases the current line in the console.
+		 */
+		static void eraseLine();
+	};
+}
+
+#endif //QRZ_PROGRESSREPORTER_H
@@ -14,25 +14,48 @@ namespace qrz::render
 	 * @brief The BioRenderer class is a concrete class for rendering bios.
 	 *
 	 * This class is derived from the Renderer class and provides the implementation for rendering bios.
-	 * It takes a vector of bios as input and prints each bio to the console.
+	 * Bios are written to the output stream as they are, either all at once or one at a time as they are fetched.
 	 */
 	class BioRenderer : public Renderer<std::string>
 	{
 	public:
 		/**
-		 * @brief Render the bios to the console.
+		 * @brief Constructs a renderer writing to the given stream.
 		 *
-		 * This method takes a vector of bios as input and prints each bio to the console.
+		 * @param output The stream to write to, the console by default. It must outlive the renderer.
+		 */
+		explicit BioRenderer(std::ostream &output = std::cout) : m_output(output)
+		{
+		}
+
+		/**
+		 * @brief Render the bios to the output stream.
+		 *
+		 * This method takes a vector of bios as input and writes each bio to the output stream.
 		 *
 		 * @param bios The vector of bios to be rendered.
 		 */
 		void Render(const std::vector<std::string> &bios) override
 		{
-			for (const std::string bio: bios)
+			for (const std::string &bio: bios)
 			{
-				std::cout << bio << std::endl;
+				Render(bio);
 			}
 		}
+
+		/**
+		 * @brief Render a single bio to the output stream.
+		 *
+		 * @param bio The bio HTML.
+		 */
+		void Render(const std::string &bio)
+		{
+			m_output << bio << '\n';
+			m_output.flush();
+		}
+
+	private:
+		std::ostream &m_output;
 	};
 }
 
@@ -0,0 +1,97 @@
+#ifndef QRZ_CALLSIGNADIFRENDERER_H
+#define QRZ_CALLSIGNADIFRENDERER_H
+
+#include "Renderer.h"
+
+#include <iostream>
+#include <vector>
+
+#include "../adif/AdifWriter.h"
+#include "../model/Callsign.h"
+#include "DXCCJoin.h"
+
+namespace qrz::render
+{
+	/**
+	 * @class CallsignADIFRenderer
+	 * @brief The CallsignADIFRenderer class is responsible for rendering Callsign objects as an ADIF log.
+	 *
+	 * Each callsign becomes one record of the fields describing the contacted station, so the output can be imported
+	 * by logging software. Records are streamed to the console as they are written rather than built up in memory.
+	 */
+	class CallsignADIFRenderer : public Renderer<Callsign>
+	{
+	public:
+		/**
+		 * @brief Constructs a renderer.
+		 *
+		 * @param dxccJoin DXCC entities whose continent is added as the CONT field, or nullptr for none. It must
+		 * outlive the renderer.
+		 */
+		explicit CallsignADIFRenderer(const DXCCJoin *dxccJoin = nullptr) : m_dxccJoin(dxccJoin)
+		{
+		}
+
+		/**
+		 * @brief Renders Callsign objects as an ADIF log, with a header followed by one record per callsign.
+		 *
+		 * @param callsigns The vector of Callsign objects to render.
+		 */
+		void Render(const std::vector<Callsign> &callsigns) override
+		{
+			Begin();
+
+			for (const Callsign &callsign: callsigns)
+			{
+				RenderOne(callsign);
+			}
+
+			End();
+		}
+
+		/**
+		 * @brief Starts streaming callsigns by writing the ADIF header.
+		 */
+		void Begin() override
+		{
+			m_writer.writeHeader();
+		}
+
+		/**
+		 * @brief Writes one callsign as an ADIF record, as soon as it arrives.
+		 *
+		 * @param callsign The Callsign to render.
+		 */
+		void RenderOne(const Callsign &callsign) override
+		{
+			m_extraFields.clear();
+
+			if (const DXCC *record = m_dxccJoin ? m_dxccJoin->find(callsign) : nullptr;
+				record && !record->getContinent().empty())
+			{
+				m_extraFields.push_back(adif::Field{"CONT", record->getContinent(), ""});
+			}
+
+			m_writer.writeCallsign(callsign, m_extraFields);
+		}
+
+		/**
+		 * @brief Completes the log by flushing it.
+		 */
+		void End() override
+		{
+			std::cout << std::flush;
+		}
+
+	private:
+		// DXCC entities joined to the callsigns, or nullptr
+		const DXCCJoin *m_dxccJoin = nullptr;
+
+		adif::AdifWriter m_writer{std::cout};
+
+		// Fields added to the current record, reused across records
+		std::vector<adif::Field> m_extraFields;
+	};
+}
+
+#endif //QRZ_CALLSIGNADIFRENDERER_H
@@ -10,6 +10,7 @@
 
 #include "../Util.h"
 #include "../model/Callsign.h"
+#include "DXCCJoin.h"
 
 namespace qrz::render
 {
@@ -22,6 +23,15 @@ namespace qrz::render
 	class CallsignCSVRenderer : public Renderer<Callsign>
 	{
 	public:
+		/**
+		 * @brief Constructs a renderer.
+		 *
+		 * @param dxccJoin DXCC entities to add as extra columns, or nullptr for none. It must outlive the renderer.
+		 */
+		explicit CallsignCSVRenderer(const DXCCJoin *dxccJoin = nullptr) : m_dxccJoin(dxccJoin)
+		{
+		}
+
 		/**
 		 * @brief Renders Callsign objects in CSV format.
 		 *
@@ -38,138 +48,197 @@ namespace qrz::render
 			std::cout << output << std::endl;
 		}
 
+		/**
+		 * @brief Starts streaming callsigns by writing the header row.
+		 */
+		void Begin() override
+		{
+			std::cout << VectorToCSV(headerRow()) << '\n';
+		}
+
+		/**
+		 * @brief Writes one callsign as a CSV row, as soon as it arrives.
+		 *
+		 * @param callsign The Callsign to render.
+		 */
+		void RenderOne(const Callsign &callsign) override
+		{
+			std::cout << VectorToCSV(row(callsign)) << '\n';
+		}
+
+		/**
+		 * @brief Completes the output the same way Render() does.
+		 */
+		void End() override
+		{
+			std::cout << std::endl;
+		}
+
 	private:
+		// DXCC entities joined to the callsigns, or nullptr
+		const DXCCJoin *m_dxccJoin = nullptr;
+
 		/**
 		 * @brief Generates a CSV string from a list of Callsign objects.
 		 *
 		 * This function takes a vector of Callsign objects and converts them into a CSV string format.
 		 * The CSV string will contain information from each Callsign object, separated by commas.
-		 * The first row of the CSV string will contain column headers.
+		 * The first row of the CSV string will contain column headers. When there is a DXCC join, its columns follow.
 		 *
 		 * @param callsignList The vector of Callsign objects to generate a CSV string from.
 		 * @return The CSV string representation of the Callsign objects.
 		 */
-		static std::string generateCSV(const std::vector<Callsign> &callsignList)
+		std::string generateCSV(const std::vector<Callsign> &callsignList)
 		{
-			std::vector<std::vector<std::string>> rows;
-
-			rows.push_back({
-						"call",
-						"xref",
-						"aliases",
-						"dxcc",
-						"fname",
-						"name",
-						"addr1",
-						"city",
-						"state",
-						"zip",
-						"country",
-						"ccode",
-						"lat",
-						"lon",
-						"grid",
-						"county",
-						"fips",
-						"land",
-						"efdate",
-						"expdate",
-						"p_call",
-						"class",
-						"codes",
-						"qslmgr",
-						"email",
-						"url",
-						"u_views",
-						"bio",
-						"biodate",
-						"image",
-						"imageinfo",
-						"serial",
-						"moddate",
-						"MSA",
-						"AreaCode",
-						"TimeZone",
-						"GMTOffset",
-						"DST",
-						"eqsl",
-						"mqsl",
-						"cqzone",
-						"ituzone",
-						"born",
-						"user",
-						"lotw",
-						"iota",
-						"geoloc",
-						"attn",
-						"nickname",
-						"name_fmt"
-						   });
+			std::stringstream ss;
+
+			ss << VectorToCSV(headerRow()) << '\n';
 
 			for (const Callsign &callsign: callsignList)
 			{
-				rows.push_back({
-					   callsign.getCall(),
-					   callsign.getXref(),
-					   callsign.getAliases(),
-					   callsign.getDxcc(),
-					   callsign.getFname(),
-					   callsign.getName(),
-					   callsign.getAddr1(),
-					   callsign.getCity(),
-					   callsign.getState(),
-					   callsign.getZip(),
-					   callsign.getCountry(),
-					   callsign.getCodes(),
-					   callsign.getLat(),
-					   callsign.getLon(),
-					   callsign.getGrid(),
-					   callsign.getCounty(),
-					   callsign.getFips(),
-					   callsign.getLand(),
-					   callsign.getEfdate(),
-					   callsign.getExpdate(),
-					   callsign.getPcall(),
-					   callsign.getClass(),
-					   callsign.getCodes(),
-					   callsign.getQslmgr(),
-					   callsign.getEmail(),
-					   callsign.getUrl(),
-					   std::to_string(callsign.getUViews()),
-					   std::to_string(callsign.getBio()),
-					   callsign.getBiodate(),
-					   callsign.getImage(),
-					   callsign.getImageinfo(),
-					   callsign.getSerial(),
-					   callsign.getModdate(),
-					   callsign.getMsa(),
-					   callsign.getAreaCode(),
-					   callsign.getTimeZone(),
-					   std::to_string(callsign.getGmtOffset()),
-					   callsign.getDst(),
-					   callsign.getEqsl(),
-					   callsign.getMqsl(),
-					   std::to_string(callsign.getCqzone()),
-					   std::to_string(callsign.getItuzone()),
-					   callsign.getBorn(),
-					   callsign.getUser(),
-					   callsign.getLotw(),
-					   callsign.getIota(),
-					   callsign.getGeoloc(),
-					   callsign.getAttn(),
-					   callsign.getNickname(),
-					   callsign.getNameFmt(),
-			   });
+				ss << VectorToCSV(row(callsign)) << '\n';
 			}
 
-			std::stringstream ss;
+			return ss.str();
+		}
+
+		/**
+		 * @brief Builds the column headers, followed by the DXCC join columns when there is a join.
+		 *
+		 * @return The header row.
+		 */
+		std::vector<std::string> headerRow() const
+		{
+			std::vector<std::string> header = {
+				"call",
+				"xref",
+				"aliases",
+				"dxcc",
+				"fname",
+				"name",
+				"addr1",
+				"city",
+				"state",
+				"zip",
+				"country",
+				"ccode",
+				"lat",
+				"lon",
+				"grid",
+				"county",
+				"fips",
+				"land",
+				"efdate",
+				"expdate",
+				"p_call",
+				"class",
+				"codes",
+				"qslmgr",
+				"email",
+				"url",
+				"u_views",
+				"bio",
+				"biodate",
+				"image",
+				"imageinfo",
+				"serial",
+				"moddate",
+				"MSA",
+				"AreaCode",
+				"TimeZone",
+				"GMTOffset",
+				"DST",
+				"eqsl",
+				"mqsl",
+				"cqzone",
+				"ituzone",
+				"born",
+				"user",
+				"lotw",
+				"iota",
+				"geoloc",
+				"attn",
+				"nickname",
+				"name_fmt"
+			};
 
-			for (const auto &row: rows)
+			if (m_dxccJoin)
 			{
-				ss << VectorToCSV(row) << '\n';
+				std::vector<std::string> keys = DXCCJoin::keys();
+				header.insert(header.end(), keys.begin(), keys.end());
 			}
 
-			return ss.str();
+			return header;
+		}
+
+		/**
+		 * @brief Builds the row of one callsign, followed by its DXCC join values when there is a join.
+		 *
+		 * @param callsign The callsign.
+		 * @return The row.
+		 */
+		std::vector<std::string> row(const Callsign &callsign) const
+		{
+			std::vector<std::string> values = {
+				callsign.getCall(),
+				callsign.getXref(),
+				callsign.getAliases(),
+				callsign.getDxcc(),
+				callsign.getFname(),
+				callsign.getName(),
+				callsign.getAddr1(),
+				callsign.getCity(),
+				callsign.getState(),
+				callsign.getZip(),
+				callsign.getCountry(),
+				callsign.getCodes(),
+				callsign.getLat(),
+				callsign.getLon(),
+				callsign.getGrid(),
+				callsign.getCounty(),
+				callsign.getFips(),
+				callsign.getLand(),
+				callsign.getEfdate(),
+				callsign.getExpdate(),
+				callsign.getPcall(),
+				callsign.getClass(),
+				callsign.getCodes(),
+				callsign.getQslmgr(),
+				callsign.getEmail(),
+				callsign.getUrl(),
+				std::to_string(callsign.getUViews()),
+				std::to_string(callsign.getBio()),
+				callsign.getBiodate(),
+				callsign.getImage(),
+				callsign.getImageinfo(),
+				callsign.getSerial(),
+				callsign.getModdate(),
+				callsign.getMsa(),
+				callsign.getAreaCode(),
+				callsign.getTimeZone(),
+				std::to_string(callsign.getGmtOffset()),
+				callsign.getDst(),
+				callsign.getEqsl(),
+				callsign.getMqsl(),
+				std::to_string(callsign.getCqzone()),
+				std::to_string(callsign.getItuzone()),
+				callsign.getBorn(),
+				callsign.getUser(),
+				callsign.getLotw(),
+				callsign.getIota(),
+				callsign.getGeoloc(),
+				callsign.getAttn(),
+				callsign.getNickname(),
+				callsign.getNameFmt()
+			};
+
+			if (m_dxccJoin)
+			{
+				std::vector<std::string> joined = m_dxccJoin->values(callsign);
+				values.insert(values.end(), joined.begin(), joined.end());
+			}
+
+			return values;
 		}
 	};
 }
@@ -8,6 +8,7 @@
 #include <tabulate/table.hpp>
 
 #include "../model/Callsign.h"
+#include "DXCCJoin.h"
 
 
 namespace qrz::render
@@ -22,6 +23,15 @@ namespace qrz::render
 	class CallsignConsoleRenderer : public Renderer<Callsign>
 	{
 	public:
+		/**
+		 * @brief Constructs a renderer.
+		 *
+		 * @param dxccJoin DXCC entities to add as extra columns, or nullptr for none. It must outlive the renderer.
+		 */
+		explicit CallsignConsoleRenderer(const DXCCJoin *dxccJoin = nullptr) : m_dxccJoin(dxccJoin)
+		{
+		}
+
 		/**
 		 * Renders the given vector of Callsign objects to the console.
 		 *
@@ -35,6 +45,9 @@ namespace qrz::render
 		}
 
 	private:
+		// DXCC entities joined to the callsigns, or nullptr
+		const DXCCJoin *m_dxccJoin = nullptr;
+
 		/**
 		 * @brief Generates a table based on the provided Callsign objects.
 		 *
@@ -50,6 +63,8 @@ namespace qrz::render
 		 * - Country
 		 * - Grid
 		 *
+		 * When there is a DXCC join, its columns follow.
+		 *
 		 * Each Callsign object in the vector will be added as a row in the table.
 		 * The header cells of the table will be centered and styled with bold font.
 		 *
@@ -60,7 +75,7 @@ namespace qrz::render
 		{
 			tabulate::Table output;
 
-			output.add_row({
+			tabulate::Table::Row_t header{
 								   "Callsign",
 								   "Name",
 								   "Class",
@@ -71,11 +86,21 @@ namespace qrz::render
 								   "Zip",
 								   "Country",
 								   "Grid"
-						   });
+						   };
+
+			if (m_dxccJoin)
+			{
+				for (const std::string &title : DXCCJoin::titles())
+				{
+					header.emplace_back(title);
+				}
+			}
+
+			output.add_row(header);
 
 			for (const Callsign &callsign: callsignList)
 			{
-				output.add_row({
+				tabulate::Table::Row_t row{
 									   callsign.getCall(),
 									   callsign.getNameFmt(),
 									   callsign.getClass(),
@@ -86,7 +111,17 @@ namespace qrz::render
 									   callsign.getZip(),
 									   callsign.getCountry(),
 									   callsign.getGrid()
-							   });
+							   };
+
+				if (m_dxccJoin)
+				{
+					for (const std::string &value : m_dxccJoin->values(callsign))
+					{
+						row.emplace_back(value);
+					}
+				}
+
+				output.add_row(row);
 			}
 
 			// center-align and color header cells
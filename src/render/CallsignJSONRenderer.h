@@ -10,6 +10,7 @@
 #include <Poco/JSON/Object.h>
 
 #include "../model/Callsign.h"
+#include "DXCCJoin.h"
 
 namespace qrz::render
 {
@@ -22,6 +23,15 @@ namespace qrz::render
 	class CallsignJSONRenderer : public Renderer<Callsign>
 	{
 	public:
+		/**
+		 * @brief Constructs a renderer.
+		 *
+		 * @param dxccJoin DXCC entities to add as extra columns, or nullptr for none. It must outlive the renderer.
+		 */
+		explicit CallsignJSONRenderer(const DXCCJoin *dxccJoin = nullptr) : m_dxccJoin(dxccJoin)
+		{
+		}
+
 		/**
 		 * @brief Renders a vector of Callsign objects as JSON and outputs it to the console.
 		 *
@@ -38,12 +48,16 @@ namespace qrz::render
 		}
 
 	private:
+		// DXCC entities joined to the callsigns, or nullptr
+		const DXCCJoin *m_dxccJoin = nullptr;
+
 		/**
 		 * @brief Generates a JSON string from a list of Callsign objects.
 		 *
 		 * This function takes a vector of Callsign objects and converts them into a JSON string representation using
 		 * the Poco::JSON library. Each Callsign object is converted into a JSON object with its properties as key-value
-		 * pairs. The resulting JSON array is then stringified using the Poco::JSON::Array stringify function.
+		 * pairs, plus the joined DXCC keys when there is a join. The resulting JSON array is then stringified using the
+		 * Poco::JSON::Array stringify function.
 		 *
 		 * @param callsignList A vector of Callsign objects.
 		 * @return A string representation of the JSON.
@@ -107,6 +121,17 @@ namespace qrz::render
 				currValue.set("nickname", callsign.getNickname());
 				currValue.set("name_fmt", callsign.getNameFmt());
 
+				if (m_dxccJoin)
+				{
+					std::vector<std::string> keys = DXCCJoin::keys();
+					std::vector<std::string> values = m_dxccJoin->values(callsign);
+
+					for (size_t i = 0; i < keys.size(); ++i)
+					{
+						currValue.set(keys[i], values[i]);
+					}
+				}
+
 				root.add(currValue);
 			}
 
@@ -10,6 +10,7 @@
 
 #include "../model/Callsign.h"
 #include "../model/CallsignMarshaler.h"
+#include "DXCCJoin.h"
 
 namespace qrz::render
 {
@@ -23,6 +24,15 @@ namespace qrz::render
 	class CallsignMarkdownRenderer : public Renderer<Callsign>
 	{
 	public:
+		/**
+		 * @brief Constructs a renderer.
+		 *
+		 * @param dxccJoin DXCC entities to add as extra columns, or nullptr for none. It must outlive the renderer.
+		 */
+		explicit CallsignMarkdownRenderer(const DXCCJoin *dxccJoin = nullptr) : m_dxccJoin(dxccJoin)
+		{
+		}
+
 		/**
 		 * @brief Renders a list of Callsign objects as markdown.
 		 *
@@ -44,12 +54,16 @@ namespace qrz::render
 		}
 
 	private:
+		// DXCC entities joined to the callsigns, or nullptr
+		const DXCCJoin *m_dxccJoin = nullptr;
+
 		/**
 		 * @brief Generate a markdown table from a list of Callsign objects.
 		 *
 		 * This function takes a vector of Callsign objects and generates a markdown table with the Callsign object
 		 * properties. The table has the following columns: Callsign, Name, Class, Address, City, County, State, Zip,
-		 * Country, and Grid. The Callsign objects are displayed row by row in the table.
+		 * Country, and Grid, followed by the joined DXCC columns when there is a join. The Callsign objects are
+		 * displayed row by row in the table.
 		 *
 		 * @param callsignList A vector of Callsign objects.
 		 * @return A markdown table with the Callsign object properties.
@@ -58,7 +72,7 @@ namespace qrz::render
 		{
 			tabulate::Table output;
 
-			output.add_row({
+			tabulate::Table::Row_t header{
 								   "Callsign",
 								   "Name",
 								   "Class",
@@ -69,11 +83,21 @@ namespace qrz::render
 								   "Zip",
 								   "Country",
 								   "Grid"
-						   });
+						   };
+
+			if (m_dxccJoin)
+			{
+				for (const std::string &title : DXCCJoin::titles())
+				{
+					header.emplace_back(title);
+				}
+			}
+
+			output.add_row(header);
 
 			for (const Callsign &callsign: callsignList)
 			{
-				output.add_row({
+				tabulate::Table::Row_t row{
 									   callsign.getCall(),
 									   callsign.getNameFmt(),
 									   callsign.getClass(),
@@ -84,7 +108,17 @@ namespace qrz::render
 									   callsign.getZip(),
 									   callsign.getCountry(),
 									   callsign.getGrid()
-							   });
+							   };
+
+				if (m_dxccJoin)
+				{
+					for (const std::string &value : m_dxccJoin->values(callsign))
+					{
+						row.emplace_back(value);
+					}
+				}
+
+				output.add_row(row);
 			}
 
 			// center-align and color header cells
@@ -0,0 +1,210 @@
+#include "CallsignTemplate.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <format>
+#include <stdexcept>
+
+using namespace qrz;
+using namespace qrz::render;
+
+namespace
+{
+	/**
+	 * @brief A field a template can use.
+	 */
+	struct TemplateField
+	{
+		// The field name, as used in {name}
+		std::string_view name;
+
+		// Appends the field value to the buffer
+		void (*append)(const Callsign &, std::string &);
+	};
+
+	/**
+	 * @brief Appends a number to a buffer without going through a temporary string.
+	 *
+	 * @param value The number.
+	 * @param out The buffer.
+	 */
+	void appendNumber(int value, std::string &out)
+	{
+		char digits[16];
+		auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+
+		out.append(digits, end);
+	}
+
+	// The fields, named after the CSV columns
+	const TemplateField templateFields[] = {
+		{"call", [](const Callsign &c, std::string &out) { out.append(c.getCall()); }},
+		{"xref", [](const Callsign &c, std::string &out) { out.append(c.getXref()); }},
+		{"aliases", [](const Callsign &c, std::string &out) { out.append(c.getAliases()); }},
+		{"dxcc", [](const Callsign &c, std::string &out) { out.append(c.getDxcc()); }},
+		{"fname", [](const Callsign &c, std::string &out) { out.append(c.getFname()); }},
+		{"name", [](const Callsign &c, std::string &out) { out.append(c.getName()); }},
+		{"addr1", [](const Callsign &c, std::string &out) { out.append(c.getAddr1()); }},
+		{"city", [](const Callsign &c, std::string &out) { out.append(c.getCity()); }},
+		{"addr2", [](const Callsign &c, std::string &out) { out.append(c.getAddr2()); }},
+		{"state", [](const Callsign &c, std::string &out) { out.append(c.getState()); }},
+		{"zip", [](const Callsign &c, std::string &out) { out.append(c.getZip()); }},
+		{"country", [](const Callsign &c, std::string &out) { out.append(c.getCountry()); }},
+		{"ccode", [](const Callsign &c, std::string &out) { out.append(c.getCcode()); }},
+		{"lat", [](const Callsign &c, std::string &out) { out.append(c.getLat()); }},
+		{"lon", [](const Callsign &c, std::string &out) { out.append(c.getLon()); }},
+		{"grid", [](const Callsign &c, std::string &out) { out.append(c.getGrid()); }},
+		{"county", [](const Callsign &c, std::string &out) { out.append(c.getCounty()); }},
+		{"fips", [](const Callsign &c, std::string &out) { out.append(c.getFips()); }},
+		{"land", [](const Callsign &c, std::string &out) { out.append(c.getLand()); }},
+		{"efdate", [](const Callsign &c, std::string &out) { out.append(c.getEfdate()); }},
+		{"expdate", [](const Callsign &c, std::string &out) { out.append(c.getExpdate()); }},
+		{"p_call", [](const Callsign &c, std::string &out) { out.append(c.getPcall()); }},
+		{"class", [](const Callsign &c, std::string &out) { out.append(c.getClass()); }},
+		{"codes", [](const Callsign &c, std::string &out) { out.append(c.getCodes()); }},
+		{"qslmgr", [](const Callsign &c, std::string &out) { out.append(c.getQslmgr()); }},
+		{"email", [](const Callsign &c, std::string &out) { out.append(c.getEmail()); }},
+		{"url", [](const Callsign &c, std::string &out) { out.append(c.getUrl()); }},
+		{"u_views", [](const Callsign &c, std::string &out) { appendNumber(c.getUViews(), out); }},
+		{"bio", [](const Callsign &c, std::string &out) { appendNumber(c.getBio(), out); }},
+		{"biodate", [](const Callsign &c, std::string &out) { out.append(c.getBiodate()); }},
+		{"image", [](const Callsign &c, std::string &out) { out.append(c.getImage()); }},
+		{"imageinfo", [](const Callsign &c, std::string &out) { out.append(c.getImageinfo()); }},
+		{"serial", [](const Callsign &c, std::string &out) { out.append(c.getSerial()); }},
+		{"moddate", [](const Callsign &c, std::string &out) { out.append(c.getModdate()); }},
+		{"msa", [](const Callsign &c, std::string &out) { out.append(c.getMsa()); }},
+		{"areacode", [](const Callsign &c, std::string &out) { out.append(c.getAreaCode()); }},
+		{"timezone", [](const Callsign &c, std::string &out) { out.append(c.getTimeZone()); }},
+		{"gmtoffset", [](const Callsign &c, std::string &out) { appendNumber(c.getGmtOffset(), out); }},
+		{"dst", [](const Callsign &c, std::string &out) { out.append(c.getDst()); }},
+		{"eqsl", [](const Callsign &c, std::string &out) { out.append(c.getEqsl()); }},
+		{"mqsl", [](const Callsign &c, std::string &out) { out.append(c.getMqsl()); }},
+		{"cqzone", [](const Callsign &c, std::string &out) { appendNumber(c.getCqzone(), out); }},
+		{"ituzone", [](const Callsign &c, std::string &out) { appendNumber(c.getItuzone(), out); }},
+		{"born", [](const Callsign &c, std::string &out) { out.append(c.getBorn()); }},
+		{"user", [](const Callsign &c, std::string &out) { out.append(c.getUser()); }},
+		{"lotw", [](const Callsign &c, std::string &out) { out.append(c.getLotw()); }},
+		{"iota", [](const Callsign &c, std::string &out) { out.append(c.getIota()); }},
+		{"geoloc", [](const Callsign &c, std::string &out) { out.append(c.getGeoloc()); }},
+		{"attn", [](const Callsign &c, std::string &out) { out.append(c.getAttn()); }},
+		{"nickname", [](const Callsign &c, std::string &out) { out.append(c.getNickname()); }},
+		{"name_fmt", [](const Callsign &c, std::string &out) { out.append(c.getNameFmt()); }},
+	};
+}
+
+/**
+ * @brief Compiles a template.
+ *
+ * Consecutive literal text, including escapes, is merged into one span, and each field is resolved to its accessor
+ * here, so render() never looks at the template text.
+ *
+ * @param source The template text.
+ * @return The compiled template.
+ * @throws std::invalid_argument If the template names an unknown field or has an unbalanced brace.
+ */
+CallsignTemplate CallsignTemplate::compile(std::string_view source)
+{
+	CallsignTemplate compiled;
+	Part part;
+
+	for (size_t i = 0; i < source.size(); ++i)
+	{
+		char c = source[i];
+		char next = i + 1 < source.size() ? source[i + 1] : '\0';
+
+		if ((c == '{' && next == '{') || (c == '}' && next == '}'))
+		{
+			part.literal.push_back(c);
+			++i;
+		}
+		else if (c == '\\' && (next == 't' || next == 'n' || next == '\\'))
+		{
+			part.literal.push_back(next == 't' ? '\t' : next == 'n' ? '\n' : '\\');
+			++i;
+		}
+		else if (c == '{')
+		{
+			size_t end = source.find('}', i + 1);
+
+			if (end == std::string_view::npos)
+			{
+				throw std::invalid_argument{std::format("Unclosed field in template at position {}", i)};
+			}
+
+			std::string name(source.substr(i + 1, end - i - 1));
+			std::transform(name.begin(), name.end(), name.begin(), [](unsigned char ch)
+			{
+				return static_cast<char>(std::tolower(ch));
+			});
+
+			auto field = std::find_if(std::begin(templateFields), std::end(templateFields),
+									  [&name](const TemplateField &candidate)
+			{
+				return candidate.name == name;
+			});
+
+			if (field == std::end(templateFields))
+			{
+				throw std::invalid_argument{std::format("Unknown field in template: {{{}}}", name)};
+			}
+
+			part.field = field->append;
+			compiled.m_parts.push_back(std::move(part));
+			part = Part();
+
+			i = end;
+		}
+		else if (c == '}')
+		{
+			throw std::invalid_argument{std::format("Unmatched }} in template at position {}", i)};
+		}
+		else
+		{
+			part.literal.push_back(c);
+		}
+	}
+
+	if (!part.literal.empty())
+	{
+		compiled.m_parts.push_back(std::move(part));
+	}
+
+	return compiled;
+}
+
+/**
+ * @brief Renders a callsign record.
+ *
+ * @param callsign The callsign record.
+ * @param out The buffer to append the rendered line to, without a line break.
+ */
+void CallsignTemplate::render(const Callsign &callsign, std::string &out) const
+{
+	for (const Part &part : m_parts)
+	{
+		out.append(part.literal);
+
+		if (part.field)
+		{
+			part.field(callsign, out);
+		}
+	}
+}
+
+/**
+ * @brief Returns the names of the fields a template can use.
+ *
+ * @return The field names, in CSV column order.
+ */
+std::vector<std::string_view> CallsignTemplate::fieldNames()
+{
+	std::vector<std::string_view> names;
+
+	for (const TemplateField &field : templateFields)
+	{
+		names.push_back(field.name);
+	}
+
+	return names;
+}
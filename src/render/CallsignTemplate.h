@@ -0,0 +1,66 @@
+#ifndef QRZ_CALLSIGNTEMPLATE_H
+#define QRZ_CALLSIGNTEMPLATE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../model/Callsign.h"
+
+namespace qrz::render
+{
+	/**
+	 * @class CallsignTemplate
+	 * @brief A user-defined output line for callsign records, such as "{call}\t{grid}\t{lat},{lon}".
+	 *
+	 * The template is parsed once into a sequence of literal text and field accessors, so rendering a record is a
+	 * series of appends to a buffer, with no parsing per record.
+	 *
+	 * Fields are written as {name}, using the CSV column names, in any case. {{ and }} stand for literal braces, and
+	 * \t, \n and \\ for a tab, a line break and a backslash, so templates can be given on the command line.
+	 */
+	class CallsignTemplate
+	{
+	public:
+		/**
+		 * @brief Compiles a template.
+		 *
+		 * @param source The template text.
+		 * @return The compiled template.
+		 * @throws std::invalid_argument If the template names an unknown field or has an unbalanced brace.
+		 */
+		static CallsignTemplate compile(std::string_view source);
+
+		/**
+		 * @brief Renders a callsign record.
+		 *
+		 * @param callsign The callsign record.
+		 * @param out The buffer to append the rendered line to, without a line break.
+		 */
+		void render(const Callsign &callsign, std::string &out) const;
+
+		/**
+		 * @brief Returns the names of the fields a template can use.
+		 *
+		 * @return The field names, in CSV column order.
+		 */
+		static std::vector<std::string_view> fieldNames();
+
+	private:
+		/**
+		 * @brief A literal span followed by a field, either of which may be empty.
+		 */
+		struct Part
+		{
+			// Text written before the field
+			std::string literal;
+
+			// Appends the field value to the buffer, or nullptr for a trailing literal
+			void (*field)(const Callsign &, std::string &) = nullptr;
+		};
+
+		std::vector<Part> m_parts;
+	};
+}
+
+#endif //QRZ_CALLSIGNTEMPLATE_H
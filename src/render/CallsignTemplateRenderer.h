@@ -0,0 +1,91 @@
+#ifndef QRZ_CALLSIGNTEMPLATERENDERER_H
+#define QRZ_CALLSIGNTEMPLATERENDERER_H
+
+#include "Renderer.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../model/Callsign.h"
+#include "CallsignTemplate.h"
+
+namespace qrz::render
+{
+	/**
+	 * @class CallsignTemplateRenderer
+	 * @brief Renders Callsign objects through a user-defined template, one line per callsign.
+	 */
+	class CallsignTemplateRenderer : public Renderer<Callsign>
+	{
+	public:
+		/**
+		 * @brief Constructs a renderer.
+		 *
+		 * @param compiled The compiled template.
+		 */
+		explicit CallsignTemplateRenderer(CallsignTemplate compiled) : m_template(std::move(compiled))
+		{
+		}
+
+		/**
+		 * @brief Renders each callsign as a line of the template.
+		 *
+		 * Lines are rendered into one reused buffer, which is written out as each line is finished.
+		 *
+		 * @param callsigns The vector of Callsign objects to render.
+		 */
+		void Render(const std::vector<Callsign> &callsigns) override
+		{
+			std::string line;
+
+			for (const Callsign &callsign : callsigns)
+			{
+				line.clear();
+				m_template.render(callsign, line);
+				line.push_back('\n');
+
+				std::cout << line;
+			}
+
+			std::cout.flush();
+		}
+
+		/**
+		 * @brief Starts streaming callsigns. A template has no header, so nothing is written.
+		 */
+		void Begin() override
+		{
+		}
+
+		/**
+		 * @brief Renders one callsign as a line of the template, as soon as it arrives.
+		 *
+		 * @param callsign The Callsign to render.
+		 */
+		void RenderOne(const Callsign &callsign) override
+		{
+			m_line.clear();
+			m_template.render(callsign, m_line);
+			m_line.push_back('\n');
+
+			std::cout << m_line;
+		}
+
+		/**
+		 * @brief Completes the output by flushing it.
+		 */
+		void End() override
+		{
+			std::cout.flush();
+		}
+
+	private:
+		CallsignTemplate m_template;
+
+		// Line buffer reused by RenderOne()
+		std::string m_line;
+	};
+}
+
+#endif //QRZ_CALLSIGNTEMPLATERENDERER_H
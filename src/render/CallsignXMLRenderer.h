@@ -7,6 +7,7 @@
 
 #include "../model/Callsign.h"
 #include "../model/CallsignMarshaler.h"
+#include "DXCCJoin.h"
 
 namespace qrz::render
 {
@@ -20,6 +21,15 @@ namespace qrz::render
 	class CallsignXMLRenderer : public Renderer<Callsign>
 	{
 	public:
+		/**
+		 * @brief Constructs a renderer.
+		 *
+		 * @param dxccJoin DXCC entities to add as extra elements, or nullptr for none. It must outlive the renderer.
+		 */
+		explicit CallsignXMLRenderer(const DXCCJoin *dxccJoin = nullptr) : m_dxccJoin(dxccJoin)
+		{
+		}
+
 		/**
 		 * @brief Renders a vector of Callsign objects to XML format.
 		 *
@@ -27,14 +37,36 @@ namespace qrz::render
 		 *
 		 * @param callsign A reference to a vector of Callsign objects to be rendered.
 		 *
+		 * When there is a DXCC join, its columns are appended to each Callsign element.
+		 *
 		 * @note The rendered XML is printed to the standard output.
 		 */
 		void Render(const std::vector<Callsign> &callsign) override
 		{
-			CallsignMarshaler m;
+			if (!m_dxccJoin)
+			{
+				std::cout << CallsignMarshaler::ToXML(callsign) << std::endl;
+				return;
+			}
+
+			std::cout << CallsignMarshaler::ToXML(callsign, [this](const Callsign &c)
+			{
+				std::vector<std::string> keys = DXCCJoin::keys();
+				std::vector<std::string> values = m_dxccJoin->values(c);
+				std::vector<std::pair<std::string, std::string>> elements;
 
-			std::cout << m.ToXML(callsign) << std::endl;
+				for (size_t i = 0; i < keys.size(); ++i)
+				{
+					elements.emplace_back(keys[i], values[i]);
+				}
+
+				return elements;
+			}) << std::endl;
 		}
+
+	private:
+		// DXCC entities joined to the callsigns, or nullptr
+		const DXCCJoin *m_dxccJoin = nullptr;
 	};
 }
 
@@ -0,0 +1,100 @@
+#ifndef QRZ_DXCCJOIN_H
+#define QRZ_DXCCJOIN_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../model/Callsign.h"
+#include "../model/DXCC.h"
+
+namespace qrz::render
+{
+	/**
+	 * @class DXCCJoin
+	 * @brief The DXCC entities joined to a batch of callsigns, keyed by entity number.
+	 *
+	 * Callsign renderers given a join add the entity name, continent and zones of each callsign's DXCC entity as extra
+	 * columns. Callsigns whose entity is not in the join get empty values in those columns.
+	 */
+	class DXCCJoin
+	{
+	public:
+		/**
+		 * @brief Adds an entity to the join.
+		 *
+		 * @param record The DXCC record. It replaces any record with the same entity number.
+		 */
+		void add(const DXCC &record)
+		{
+			m_records[record.getDxcc()] = record;
+		}
+
+		/**
+		 * @brief Finds the entity a callsign belongs to.
+		 *
+		 * @param callsign The callsign.
+		 * @return The DXCC record, or nullptr if the join has no entity for the callsign.
+		 */
+		const DXCC *find(const Callsign &callsign) const
+		{
+			auto it = m_records.find(callsign.getDxcc());
+
+			return it == m_records.end() ? nullptr : &it->second;
+		}
+
+		/**
+		 * @brief Returns the number of entities in the join.
+		 *
+		 * @return The entity count.
+		 */
+		size_t size() const
+		{
+			return m_records.size();
+		}
+
+		/**
+		 * @brief Returns the names of the joined columns, for machine readable formats.
+		 *
+		 * @return The column names, in the order values() returns them.
+		 */
+		static std::vector<std::string> keys()
+		{
+			return {"dxcc_name", "dxcc_continent", "dxcc_cqzone", "dxcc_ituzone"};
+		}
+
+		/**
+		 * @brief Returns the titles of the joined columns, for tables.
+		 *
+		 * @return The column titles, in the order values() returns them.
+		 */
+		static std::vector<std::string> titles()
+		{
+			return {"DXCC Name", "Continent", "CQ Zone", "ITU Zone"};
+		}
+
+		/**
+		 * @brief Returns the joined column values for a callsign.
+		 *
+		 * @param callsign The callsign.
+		 * @return The values, or empty strings if the join has no entity for the callsign.
+		 */
+		std::vector<std::string> values(const Callsign &callsign) const
+		{
+			const DXCC *record = find(callsign);
+
+			if (!record)
+			{
+				return std::vector<std::string>(keys().size());
+			}
+
+			return {record->getName(), record->getContinent(), record->getCqzone(), record->getItuzone()};
+		}
+
+	private:
+		// Entity number to DXCC record
+		std::map<std::string, DXCC> m_records;
+	};
+}
+
+#endif //QRZ_DXCCJOIN_H
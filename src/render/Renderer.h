@@ -28,10 +28,52 @@ namespace qrz::render
 		 * @param toRender A reference to a vector of objects to be rendered.
 		 */
 		virtual void Render(const std::vector<T> &toRender);
+
+		/**
+		 * @brief Starts rendering objects one at a time, as they arrive.
+		 *
+		 * Objects are then passed to RenderOne() and the output is completed by End(). Formats that can be written
+		 * incrementally override all three; the others keep these defaults, which collect the objects and Render()
+		 * them at the end.
+		 */
+		virtual void Begin();
+
+		/**
+		 * @brief Renders, or collects, one object between Begin() and End().
+		 *
+		 * @param item The object to render.
+		 */
+		virtual void RenderOne(const T &item);
+
+		/**
+		 * @brief Completes the output started by Begin().
+		 */
+		virtual void End();
+
 		virtual ~Renderer() = default;
+
+	private:
+		// Objects collected by the default RenderOne(), for End() to render
+		std::vector<T> m_collected;
 	};
 
 	template<typename T> void Renderer<T>::Render(const std::vector<T> &toRender){}
+
+	template<typename T> void Renderer<T>::Begin()
+	{
+		m_collected.clear();
+	}
+
+	template<typename T> void Renderer<T>::RenderOne(const T &item)
+	{
+		m_collected.push_back(item);
+	}
+
+	template<typename T> void Renderer<T>::End()
+	{
+		Render(m_collected);
+		m_collected.clear();
+	}
 }
 
 
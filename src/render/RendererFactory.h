@@ -5,12 +5,15 @@
 #include "../model/Callsign.h"
 #include "../model/DXCC.h"
 #include "BioRenderer.h"
+#include "CallsignADIFRenderer.h"
 #include "CallsignConsoleRenderer.h"
 #include "CallsignCSVRenderer.h"
 #include "CallsignJSONRenderer.h"
 #include "CallsignMarkdownRenderer.h"
+#include "CallsignTemplateRenderer.h"
 #include "CallsignXMLRenderer.h"
 #include "DXCCConsoleRenderer.h"
+#include "DXCCJoin.h"
 #include "DXCCCSVRenderer.h"
 #include "DXCCJSONRenderer.h"
 #include "DXCCMarkdownRenderer.h"
@@ -22,25 +25,44 @@ namespace qrz::render
 	class RendererFactory
 	{
 	public:
-		static std::unique_ptr<Renderer<Callsign>> createCallsignRenderer(OutputFormat format)
+		static std::unique_ptr<Renderer<Callsign>> createCallsignRenderer(OutputFormat format,
+																		  const DXCCJoin *dxccJoin = nullptr)
 		{
 			switch (format)
 			{
 				case OutputFormat::CONSOLE:
-					return std::make_unique<CallsignConsoleRenderer>();
+					return std::make_unique<CallsignConsoleRenderer>(dxccJoin);
 				case OutputFormat::CSV:
-					return std::make_unique<CallsignCSVRenderer>();
+					return std::make_unique<CallsignCSVRenderer>(dxccJoin);
 				case OutputFormat::JSON:
-					return std::make_unique<CallsignJSONRenderer>();
+					return std::make_unique<CallsignJSONRenderer>(dxccJoin);
 				case OutputFormat::XML:
-					return std::make_unique<CallsignXMLRenderer>();
+					return std::make_unique<CallsignXMLRenderer>(dxccJoin);
 				case OutputFormat::MD:
-					return std::make_unique<CallsignMarkdownRenderer>();
+					return std::make_unique<CallsignMarkdownRenderer>(dxccJoin);
+				case OutputFormat::ADIF:
+					return std::make_unique<CallsignADIFRenderer>(dxccJoin);
 				default:
 					throw std::invalid_argument("Invalid Format");
 			}
 		}
 
+		static std::unique_ptr<Renderer<Callsign>> createCallsignRenderer(const CallsignTemplate &compiled)
+		{
+			return std::make_unique<CallsignTemplateRenderer>(compiled);
+		}
+
+		/**
+		 * @brief Checks whether the callsign renderer for a format writes each record as it arrives.
+		 *
+		 * @param format The output format.
+		 * @return True if records are written by RenderOne(), false if they are collected and written by End().
+		 */
+		static bool streamsCallsigns(OutputFormat format)
+		{
+			return format == OutputFormat::CSV || format == OutputFormat::ADIF || format == OutputFormat::TEMPLATE;
+		}
+
 		static std::unique_ptr<Renderer<DXCC>> createDXCCRenderer(OutputFormat format)
 		{
 			switch (format)
@@ -60,7 +82,7 @@ namespace qrz::render
 			}
 		}
 
-		static std::unique_ptr<Renderer<std::string>> createBioRenderer()
+		static std::unique_ptr<BioRenderer> createBioRenderer()
 		{
 			return std::make_unique<BioRenderer>();
 		}
@@ -20,9 +20,46 @@ namespace qrz
 			return fetchDXCCRecords(searchTerms);
 		}
 
+		render::DXCCJoin proxyJoinDXCC(const std::vector<Callsign> &callsigns)
+		{
+			return joinDXCC(callsigns);
+		}
+
+		void proxyEnrichAdif(const std::string &inputPath, const std::string &outputPath)
+		{
+			enrichAdif(inputPath, outputPath);
+		}
+
+		void proxySetPrefixTable(const std::string &path, bool offline)
+		{
+			m_prefixTablePath = path;
+			m_offline = offline;
+		}
+
+		void proxySetDXCCTablePath(const std::string &path)
+		{
+			m_dxccTablePath = path;
+		}
+
 		std::vector<std::string> proxyFetchBios(const std::set<std::string> &searchTerms)
 		{
-			return fetchBios(searchTerms);
+			std::vector<std::string> bios(searchTerms.size());
+
+			fetchBios(std::vector<std::string>(searchTerms.begin(), searchTerms.end()),
+					  [&bios](size_t index, const std::string &bio)
+			{
+				bios[index] = bio;
+			});
+
+			return bios;
+		}
+
+		static std::optional<std::string> proxyGetCachedBio(const cache::LookupCache &cache, const std::string &call,
+															const std::string &biodate)
+		{
+			std::optional<cache::LookupCache::Entry> entry = cache.get(cache::RecordType::BIO, call);
+
+			return entry ? getCachedBio(*entry, biodate) : std::nullopt;
 		}
 	};
 }
@@ -18,7 +18,7 @@ namespace qrz
 			setSessionExpiration(config.getSessionExpiration());
 		}
 
-		QrzResponse sendRequest(Poco::URI &uri) override
+		QrzResponse sendRequest(Poco::URI &uri, const net::Deadline &deadline) override
 		{
 			std::string path = Poco::format("/xml/%s/", m_apiVersion);
 			uri.setPath(path);
@@ -65,6 +65,10 @@ namespace qrz
 				{
 					body = callsignXmlW5YI;
 				}
+				else if(term == "N0CALL")
+				{
+					body = Poco::format(notFoundResponse, term);
+				}
 			}
 			else if(action == "html")
 			{
@@ -87,6 +91,10 @@ namespace qrz
 				{
 					body = dxccXml291;
 				}
+				else if(term == "ALL")
+				{
+					body = dxccXmlAll;
+				}
 			}
 			else if(action == "password")
 			{
@@ -98,6 +106,15 @@ namespace qrz
 			return output;
 		}
 
+		QrzResponse streamRequest(Poco::URI &uri, const net::Deadline &deadline, std::ostream &body) override
+		{
+			QrzResponse response = sendRequest(uri, deadline);
+
+			body << response.getBody();
+
+			return QrzResponse{response.getHttpResponse(), ""};
+		}
+
 		bool testValidateResponse(const std::string &responseBody)
 		{
 			try
@@ -259,6 +276,43 @@ namespace qrz
 		<GMTime>Mon Oct 12 22:33:56 2012</GMTime>
 	</Session>
 </QRZDatabase>
+)xml";
+
+	std::string dxccXmlAll=R"xml(
+<QRZDatabase>
+    <DXCC>
+        <dxcc>1</dxcc>
+        <cc>CA</cc>
+        <ccc>CAN</ccc>
+        <name>Canada</name>
+        <continent>NA</continent>
+        <ituzone>0</ituzone>
+        <cqzone>0</cqzone>
+        <timezone>-5</timezone>
+        <lat>56.130366</lat>
+        <lon>-106.346771</lon>
+        <notes/>
+    </DXCC>
+    <DXCC>
+        <dxcc>291</dxcc>
+        <cc>US</cc>
+        <ccc>USA</ccc>
+        <name>United States</name>
+        <continent>NA</continent>
+        <ituzone>0</ituzone>
+        <cqzone>0</cqzone>
+        <timezone>-5</timezone>
+        <lat>37.701207</lat>
+        <lon>-97.316895</lon>
+        <notes/>
+    </DXCC>
+	<Session>
+		<Key>d0cf9d7b3b937ed5f5de28ddf5a0122d</Key>
+		<Count>12</Count>
+		<SubExp>Wed Jan 13 13:59:00 2013</SubExp>
+		<GMTime>Mon Oct 12 22:33:56 2012</GMTime>
+	</Session>
+</QRZDatabase>
 )xml";
 
 		std::string dxccXml191=R"xml(
@@ -327,6 +381,18 @@ namespace qrz
 
 )html";
 
+	std::string notFoundResponse=R"xml(
+<QRZDatabase version="1.34">
+  <Session>
+    <Error>Not found: %s</Error>
+    <Key>2331uf894c4bd29f3923f3bacf02c532d7bd9</Key>
+    <Count>123</Count>
+    <SubExp>Wed Jan 1 12:34:03 2013</SubExp>
+    <GMTime>Sun Aug 16 03:51:47 2012</GMTime>
+  </Session>
+</QRZDatabase>
+)xml";
+
 	std::string sessionResponse=R"xml(
 <QRZDatabase version="1.34">
   <Session>
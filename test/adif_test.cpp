@@ -0,0 +1,135 @@
+#include "../src/adif/AdifReader.h"
+#include "../src/adif/AdifWriter.h"
+
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace qrz
+{
+	namespace
+	{
+		const char *adifLog = "Exported by a logger\n"
+							  "<ADIF_VER:5>3.1.4 <PROGRAMID:6>Logger\n"
+							  "<EOH>\n"
+							  "<CALL:4>W1AW <QSO_DATE:8:D>20240101 <COMMENT:9>a <b> c\nd <EOR>\n"
+							  "<call:4>w5yi <name:4>Fred <eor>\n";
+
+		TEST(AdifTests, TestReadRecords)
+		{
+			std::istringstream input(adifLog);
+			adif::AdifReader reader(input);
+
+			ASSERT_TRUE(reader.header().starts_with("Exported by a logger"));
+			ASSERT_TRUE(reader.header().ends_with("<EOH>"));
+
+			adif::Record record;
+
+			ASSERT_TRUE(reader.next(record));
+			ASSERT_EQ(3, record.fields.size());
+			ASSERT_EQ("W1AW", record.find("CALL")->value);
+			ASSERT_EQ("D", record.find("qso_date")->type);
+			ASSERT_EQ("a <b> c\nd", record.find("COMMENT")->value) << "Data is read by length, so it may contain tags";
+
+			ASSERT_TRUE(reader.next(record));
+			ASSERT_EQ("w5yi", record.find("CALL")->value) << "Field names are case-insensitive";
+			ASSERT_EQ("Fred", record.find("NAME")->value);
+
+			ASSERT_FALSE(reader.next(record));
+		}
+
+		TEST(AdifTests, TestReadWithoutHeader)
+		{
+			std::istringstream input("<CALL:4>W1AW<EOR><CALL:5>K1TTT");
+			adif::AdifReader reader(input);
+
+			ASSERT_TRUE(reader.header().empty());
+
+			adif::Record record;
+
+			ASSERT_TRUE(reader.next(record));
+			ASSERT_EQ("W1AW", record.find("CALL")->value);
+
+			ASSERT_TRUE(reader.next(record)) << "A final record without <EOR> should still be read";
+			ASSERT_EQ("K1TTT", record.find("CALL")->value);
+
+			ASSERT_FALSE(reader.next(record));
+		}
+
+		TEST(AdifTests, TestRejectMalformedInput)
+		{
+			std::istringstream truncated("<CALL:10>W1AW<EOR>");
+			adif::AdifReader truncatedReader(truncated);
+			adif::Record record;
+
+			ASSERT_THROW(truncatedReader.next(record), std::runtime_error);
+
+			std::istringstream badLength("<CALL:x>W1AW<EOR>");
+			adif::AdifReader badLengthReader(badLength);
+
+			ASSERT_THROW(badLengthReader.next(record), std::runtime_error);
+
+			std::istringstream noEndOfHeader("Header only <ADIF_VER:5>3.1.4");
+
+			ASSERT_THROW(adif::AdifReader{noEndOfHeader}, std::runtime_error);
+		}
+
+		TEST(AdifTests, TestWriteRoundTrip)
+		{
+			std::istringstream input(adifLog);
+			adif::AdifReader reader(input);
+
+			std::ostringstream output;
+			adif::AdifWriter writer(output);
+
+			writer.writeHeader(reader.header());
+
+			adif::Record record;
+
+			while (reader.next(record))
+			{
+				writer.writeRecord(record);
+			}
+
+			std::istringstream rewritten(output.str());
+			adif::AdifReader rereader(rewritten);
+
+			ASSERT_EQ(reader.header(), rereader.header());
+
+			ASSERT_TRUE(rereader.next(record));
+			ASSERT_EQ("a <b> c\nd", record.find("COMMENT")->value);
+			ASSERT_EQ("D", record.find("QSO_DATE")->type);
+
+			ASSERT_TRUE(rereader.next(record));
+			ASSERT_EQ("Fred", record.find("NAME")->value);
+
+			ASSERT_FALSE(rereader.next(record));
+		}
+
+		TEST(AdifTests, TestCallsignFields)
+		{
+			Callsign callsign;
+			callsign.setCall("W1AW");
+			callsign.setNameFmt("ARRL HQ OPERATORS CLUB");
+			callsign.setCity("NEWINGTON");
+			callsign.setState("CT");
+			callsign.setCounty("Hartford");
+			callsign.setGrid("FN31pr");
+			callsign.setCqzone(5);
+			callsign.setItuzone(8);
+			callsign.setLat("41.714775");
+			callsign.setLon("-72.727260");
+
+			adif::Record record{adif::AdifWriter::callsignFields(callsign)};
+
+			ASSERT_EQ("ARRL HQ OPERATORS CLUB", record.find("NAME")->value);
+			ASSERT_EQ("NEWINGTON", record.find("QTH")->value);
+			ASSERT_EQ("CT,Hartford", record.find("CNTY")->value);
+			ASSERT_EQ("FN31pr", record.find("GRIDSQUARE")->value);
+			ASSERT_EQ("5", record.find("CQZ")->value);
+			ASSERT_EQ("8", record.find("ITUZ")->value);
+			ASSERT_EQ("N041 42.887", record.find("LAT")->value);
+			ASSERT_EQ("W072 43.636", record.find("LON")->value);
+			ASSERT_EQ(nullptr, record.find("EMAIL")) << "Empty values should be left out";
+		}
+	}
+}
@@ -1,9 +1,11 @@
 #include "../src/AppController.h"
 #include "AppControllerProxy.h"
+#include "../src/adif/AdifReader.h"
 
 #include <gtest/gtest.h>
 #include <format>
 #include <filesystem>
+#include <fstream>
 
 namespace qrz
 {
@@ -136,6 +138,189 @@ namespace qrz
 			}
 		}
 
+		TEST_F(AppControllerTests, TestFetchDXCCRecordsOffline)
+		{
+			std::string prefixTablePath = std::format("{:s}/qrz_test_cty.csv", configDirPath);
+
+			std::ofstream prefixTable(prefixTablePath);
+			prefixTable << "K,United States,291,NA,05,08,37.53,91.67,5.0,AA K N W;\n";
+			prefixTable << "VE,Canada,1,NA,05,09,44.35,78.75,5.0,VA VE VO VY;\n";
+			prefixTable.close();
+
+			std::set<std::string> searchTerms;
+			searchTerms.insert("1");
+			searchTerms.insert("W1AW");
+			searchTerms.insert("ZZ9ZZ");
+
+			AppControllerProxy controller;
+			controller.proxySetPrefixTable(prefixTablePath, true);
+
+			std::vector<DXCC> results = controller.proxyFetchDXCCRecords(searchTerms);
+
+			std::filesystem::remove(prefixTablePath);
+
+			ASSERT_EQ(2, results.size()) << "Only the terms in the prefix table should be returned";
+			ASSERT_EQ("Canada", results.at(0).getName());
+			ASSERT_EQ("291", results.at(1).getDxcc());
+		}
+
+		TEST_F(AppControllerTests, TestFetchDXCCRecordsFromMirror)
+		{
+			std::string dxccTablePath = std::format("{:s}/qrz_test_dxcc.tsv", configDirPath);
+
+			DXCC spain;
+			spain.setDxcc("281");
+			spain.setCc("ES");
+			spain.setName("Spain");
+
+			dxcc::DXCCTable(std::vector<DXCC>{spain}, dxcc::DXCCTable::Clock::now()).save(dxccTablePath);
+
+			std::set<std::string> searchTerms;
+			searchTerms.insert("281");
+			searchTerms.insert("999");
+
+			AppControllerProxy controller;
+			controller.proxySetDXCCTablePath(dxccTablePath);
+			controller.proxySetPrefixTable("", true);
+
+			std::vector<DXCC> results = controller.proxyFetchDXCCRecords(searchTerms);
+
+			std::filesystem::remove(dxccTablePath);
+			std::filesystem::remove(dxccTablePath + ".lock");
+
+			ASSERT_EQ(1, results.size()) << "Only the entities in the DXCC table should be returned";
+			ASSERT_EQ("Spain", results.at(0).getName());
+			ASSERT_EQ("ES", results.at(0).getCc());
+		}
+
+		TEST_F(AppControllerTests, TestJoinDXCC)
+		{
+			std::set<std::string> searchTerms;
+			searchTerms.insert("W1AW");
+			searchTerms.insert("W5YI");
+
+			AppControllerProxy controller;
+
+			std::vector<Callsign> callsigns = controller.proxyFetchCallsignRecords(searchTerms);
+
+			ASSERT_EQ(2, callsigns.size());
+
+			render::DXCCJoin join = controller.proxyJoinDXCC(callsigns);
+
+			ASSERT_EQ(1, join.size()) << "Both callsigns are in one entity, so it should be looked up once";
+
+			const DXCC *entity = join.find(callsigns.at(0));
+			ASSERT_NE(nullptr, entity);
+			ASSERT_EQ("United States", entity->getName());
+			ASSERT_EQ(entity, join.find(callsigns.at(1)));
+		}
+
+		TEST_F(AppControllerTests, TestEnrichAdif)
+		{
+			std::string inputPath = std::format("{:s}/qrz_test_log.adi", configDirPath);
+			std::string outputPath = std::format("{:s}/qrz_test_log_enriched.adi", configDirPath);
+
+			std::ofstream(inputPath) << "Test log\n<ADIF_VER:5>3.1.4\n<EOH>\n"
+									 << "<CALL:4>W1AW <NAME:11>Logged name <EOR>\n"
+									 << "<CALL:4>w5yi <BAND:3>20m <EOR>\n"
+									 << "<CALL:6>W1AW/P <EOR>\n"
+									 << "<CALL:3>??? <EOR>\n";
+
+			AppControllerProxy controller;
+			controller.proxyEnrichAdif(inputPath, outputPath);
+
+			std::ifstream output(outputPath);
+			adif::AdifReader reader(output);
+			adif::Record record;
+
+			ASSERT_TRUE(reader.header().starts_with("Test log")) << "The header should be preserved";
+
+			ASSERT_TRUE(reader.next(record));
+			ASSERT_EQ("Logged name", record.find("NAME")->value) << "Logged fields should not be overwritten";
+			ASSERT_EQ("FN31pr", record.find("GRIDSQUARE")->value);
+
+			ASSERT_TRUE(reader.next(record));
+			ASSERT_EQ("20m", record.find("BAND")->value);
+			ASSERT_NE(nullptr, record.find("GRIDSQUARE"));
+
+			ASSERT_TRUE(reader.next(record));
+			ASSERT_EQ("W1AW/P", record.find("CALL")->value);
+			ASSERT_EQ("FN31pr", record.find("GRIDSQUARE")->value) << "Portable calls should use the base callsign";
+
+			ASSERT_TRUE(reader.next(record));
+			ASSERT_EQ(1, record.fields.size()) << "Records without a valid callsign should be copied unchanged";
+
+			ASSERT_FALSE(reader.next(record));
+
+			output.close();
+			std::filesystem::remove(inputPath);
+			std::filesystem::remove(outputPath);
+		}
+
+		TEST_F(AppControllerTests, TestEnrichAdifAwayFromHome)
+		{
+			std::string inputPath = std::format("{:s}/qrz_test_log.adi", configDirPath);
+			std::string outputPath = std::format("{:s}/qrz_test_log_enriched.adi", configDirPath);
+			std::string prefixTablePath = std::format("{:s}/qrz_test_cty.csv", configDirPath);
+
+			std::ofstream(inputPath) << "<EOH>\n"
+									 << "<CALL:8>KH6/W1AW <EOR>\n"
+									 << "<CALL:8>W1AW/KH6 <EOR>\n"
+									 << "<CALL:8>W1AW/QRP <EOR>\n";
+
+			AppControllerProxy controller;
+			controller.proxyEnrichAdif(inputPath, outputPath);
+
+			{
+				std::ifstream output(outputPath);
+				adif::AdifReader reader(output);
+				adif::Record record;
+
+				ASSERT_TRUE(reader.next(record));
+				ASSERT_EQ("ARRL HQ OPERATORS CLUB", record.find("NAME")->value) << "The operator should be filled in";
+				ASSERT_EQ(nullptr, record.find("DXCC")) << "The home entity should not be used for a portable call";
+				ASSERT_EQ(nullptr, record.find("CQZ"));
+				ASSERT_EQ(nullptr, record.find("ITUZ"));
+				ASSERT_EQ(nullptr, record.find("GRIDSQUARE"));
+				ASSERT_EQ(nullptr, record.find("STATE"));
+
+				ASSERT_TRUE(reader.next(record));
+				ASSERT_EQ(nullptr, record.find("DXCC")) << "A location suffix should count as away from home";
+
+				ASSERT_TRUE(reader.next(record));
+				ASSERT_EQ("291", record.find("DXCC")->value) << "An operating suffix should not";
+				ASSERT_EQ("FN31pr", record.find("GRIDSQUARE")->value);
+			}
+
+			std::ofstream prefixTable(prefixTablePath);
+			prefixTable << "K,United States,291,NA,05,08,37.53,91.67,5.0,AA K N W;\n";
+			prefixTable << "KH6,Hawaii,110,OC,31,61,21.12,157.48,10.0,AH6 AH7 KH6 KH7 NH6 NH7 WH6 WH7;\n";
+			prefixTable.close();
+
+			AppControllerProxy withTable;
+			withTable.proxySetPrefixTable(prefixTablePath, false);
+			withTable.proxyEnrichAdif(inputPath, outputPath);
+
+			std::ifstream output(outputPath);
+			adif::AdifReader reader(output);
+			adif::Record record;
+
+			for (int i = 0; i < 2; ++i)
+			{
+				ASSERT_TRUE(reader.next(record));
+				ASSERT_EQ("110", record.find("DXCC")->value) << "The entity should come from the prefix table";
+				ASSERT_EQ("Hawaii", record.find("COUNTRY")->value);
+				ASSERT_EQ("31", record.find("CQZ")->value);
+				ASSERT_EQ("61", record.find("ITUZ")->value);
+				ASSERT_EQ(nullptr, record.find("GRIDSQUARE"));
+			}
+
+			output.close();
+			std::filesystem::remove(inputPath);
+			std::filesystem::remove(outputPath);
+			std::filesystem::remove(prefixTablePath);
+		}
+
 		TEST_F(AppControllerTests, TestFetchBioRecords)
 		{
 			std::set<std::string> searchTerms;
@@ -156,5 +341,26 @@ namespace qrz
 			foundNeedle = (results.at(1).find(needle) != std::string::npos);
 			ASSERT_TRUE(foundNeedle) << "Expected string should be found in bio HTML";
 		}
+
+		TEST_F(AppControllerTests, TestGetCachedBio)
+		{
+			std::string cachePath = std::format("{:s}/qrz_test_bio_cache.log", configDirPath);
+
+			cache::LookupCache cache(cachePath);
+			cache.put(cache::RecordType::BIO, "W1AW", "2023-11-02 17:48:19\n<p>ARRL HQ</p>");
+
+			std::optional<std::string> bio = AppControllerProxy::proxyGetCachedBio(cache, "W1AW", "2023-11-02 17:48:19");
+
+			ASSERT_TRUE(bio);
+			ASSERT_EQ("<p>ARRL HQ</p>", *bio);
+			ASSERT_FALSE(AppControllerProxy::proxyGetCachedBio(cache, "W1AW", "2024-01-15 09:12:44"))
+				<< "A bio changed since it was cached should be fetched again";
+			ASSERT_FALSE(AppControllerProxy::proxyGetCachedBio(cache, "W5YI", "2023-11-02 17:48:19"));
+
+			cache.put(cache::RecordType::BIO, "W5YI", "");
+
+			ASSERT_FALSE(AppControllerProxy::proxyGetCachedBio(cache, "W5YI", ""))
+				<< "A \"not found\" entry should not be read as an empty bio";
+		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "../src/BioArchive.h"
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace qrz
+{
+	namespace
+	{
+		class BioArchiveTests : public testing::Test
+		{
+		protected:
+			void SetUp() override
+			{
+				directory = std::filesystem::temp_directory_path() / "qrz_bio_archive_test";
+
+				std::filesystem::remove_all(directory);
+			}
+
+			void TearDown() override
+			{
+				std::filesystem::remove_all(directory);
+			}
+
+			static std::string readFile(const std::filesystem::path &path)
+			{
+				std::ifstream input(path);
+				std::stringstream content;
+				content << input.rdbuf();
+
+				return content.str();
+			}
+
+			std::filesystem::path directory;
+		};
+
+		TEST_F(BioArchiveTests, TestWriteAndSkipUnchanged)
+		{
+			{
+				BioArchive archive(directory);
+
+				ASSERT_FALSE(archive.isCurrent("W1AW", "2023-11-02 17:48:19"));
+
+				archive.write("W1AW", "2023-11-02 17:48:19", [](std::ostream &output) { output << "<p>ARRL HQ</p>"; });
+				archive.write("W1AW/P", "", [](std::ostream &output) { output << "<p>Portable</p>"; });
+				archive.save();
+
+				ASSERT_EQ("<p>ARRL HQ</p>", readFile(directory / "W1AW.html"));
+				ASSERT_EQ("<p>Portable</p>", readFile(directory / "W1AW_P.html"));
+			}
+
+			BioArchive reopened(directory);
+
+			ASSERT_TRUE(reopened.isCurrent("W1AW", "2023-11-02 17:48:19"));
+			ASSERT_FALSE(reopened.isCurrent("W1AW", "2024-01-15 09:12:44")) << "A changed bio should be written again";
+			ASSERT_FALSE(reopened.isCurrent("W1AW/P", "")) << "Bios without a biodate should always be written";
+
+			std::filesystem::remove(directory / "W1AW.html");
+
+			ASSERT_FALSE(reopened.isCurrent("W1AW", "2023-11-02 17:48:19")) << "A deleted bio should be written again";
+		}
+
+		TEST_F(BioArchiveTests, TestRewoundWriteIsTrimmed)
+		{
+			BioArchive archive(directory);
+
+			archive.write("W5YI", "2022-06-01 12:00:00", [](std::ostream &output)
+			{
+				// A retried download rewinds the stream and writes a shorter body over the failed one
+				std::streampos start = output.tellp();
+				output << "partial body of a failed attempt";
+				output.seekp(start);
+				output << "<p>W5YI</p>";
+			});
+
+			ASSERT_EQ("<p>W5YI</p>", readFile(directory / "W5YI.html"));
+		}
+
+		TEST_F(BioArchiveTests, TestFailedWriteKeepsPreviousBio)
+		{
+			BioArchive archive(directory);
+
+			archive.write("W1AW", "2023-11-02 17:48:19", [](std::ostream &output) { output << "<p>ARRL HQ</p>"; });
+
+			ASSERT_THROW(archive.write("W1AW", "2024-01-15 09:12:44", [](std::ostream &output)
+			{
+				output << "<p>cut";
+				throw std::runtime_error("Timed out: W1AW");
+			}), std::runtime_error);
+
+			ASSERT_EQ("<p>ARRL HQ</p>", readFile(directory / "W1AW.html"));
+			ASSERT_FALSE(std::filesystem::exists(directory / "W1AW.html.tmp"));
+			ASSERT_TRUE(archive.isCurrent("W1AW", "2023-11-02 17:48:19"));
+		}
+	}
+}
@@ -0,0 +1,75 @@
+#include "../src/CallsignNormalizer.h"
+
+#include <gtest/gtest.h>
+
+namespace qrz
+{
+	namespace
+	{
+		TEST(CallsignNormalizerTests, TestParseBaseCallsign)
+		{
+			std::optional<ParsedCallsign> parsed = CallsignNormalizer::parse("  w1aw ");
+
+			ASSERT_TRUE(parsed.has_value());
+			ASSERT_EQ("", parsed->prefix);
+			ASSERT_EQ("W1AW", parsed->base) << "Callsigns should be trimmed and uppercased";
+			ASSERT_EQ("", parsed->suffix);
+		}
+
+		TEST(CallsignNormalizerTests, TestParsePrefixAndSuffix)
+		{
+			ParsedCallsign expected{"VE3", "W1AW", "P"};
+
+			ASSERT_EQ(expected, CallsignNormalizer::parse("VE3/W1AW/P"));
+			ASSERT_EQ((ParsedCallsign{"VE3", "W1AW", ""}), CallsignNormalizer::parse("VE3/W1AW"));
+			ASSERT_EQ((ParsedCallsign{"", "W1AW", "QRP"}), CallsignNormalizer::parse("W1AW/QRP"));
+			ASSERT_EQ((ParsedCallsign{"", "W1AW", "M"}), CallsignNormalizer::parse("w1aw/m"));
+			ASSERT_EQ((ParsedCallsign{"", "W1AW", "KH6"}), CallsignNormalizer::parse("W1AW/KH6"));
+			ASSERT_EQ("VE3/W1AW/P", expected.toString());
+		}
+
+		TEST(CallsignNormalizerTests, TestRejectMalformed)
+		{
+			const char *malformed[] = {"", "W1", "ABCDEF", "123456", "W1AW/", "/W1AW", "W1AW//P", "W1-AW", "W1AW/PORTABLE",
+									   "A/B/C/D", "W1AW W5YI"};
+
+			for (const char *term : malformed)
+			{
+				ASSERT_FALSE(CallsignNormalizer::parse(term).has_value()) << "'" << term << "' should be rejected";
+			}
+		}
+
+		TEST(CallsignNormalizerTests, TestNormalizeCallsignsCollapsesEquivalents)
+		{
+			CallsignNormalizer::Result result = CallsignNormalizer::normalizeCallsigns(
+					{"w1aw", "W1AW", "W1AW/P", "VE3/W1AW", "W5YI", "not a call", "K4RWR"});
+
+			std::set<std::string> expectedTerms = {"K4RWR", "W1AW", "W5YI"};
+
+			ASSERT_EQ(expectedTerms, result.terms);
+			ASSERT_EQ(3, result.duplicates);
+			ASSERT_EQ(std::vector<std::string>{"not a call"}, result.rejected);
+		}
+
+		TEST(CallsignNormalizerTests, TestNormalizeSingleTerms)
+		{
+			ASSERT_EQ("W1AW", CallsignNormalizer::normalizeCallsign(" w1aw\r"));
+			ASSERT_EQ("W1AW", CallsignNormalizer::normalizeCallsign("VE3/W1AW/P"));
+			ASSERT_EQ(std::nullopt, CallsignNormalizer::normalizeCallsign("W1"));
+			ASSERT_EQ("291", CallsignNormalizer::normalizeDXCCTerm("0291"));
+			ASSERT_EQ("VE3/W1AW", CallsignNormalizer::normalizeDXCCTerm("ve3/w1aw"));
+			ASSERT_EQ(std::nullopt, CallsignNormalizer::normalizeDXCCTerm("1x"));
+		}
+
+		TEST(CallsignNormalizerTests, TestNormalizeDXCCTerms)
+		{
+			CallsignNormalizer::Result result = CallsignNormalizer::normalizeDXCCTerms({"291", "0291", "ve3/w1aw", "1x"});
+
+			std::set<std::string> expectedTerms = {"291", "VE3/W1AW"};
+
+			ASSERT_EQ(expectedTerms, result.terms) << "Entity numbers and callsigns should both be accepted";
+			ASSERT_EQ(1, result.duplicates);
+			ASSERT_EQ(std::vector<std::string>{"1x"}, result.rejected);
+		}
+	}
+}
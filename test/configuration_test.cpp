@@ -89,5 +89,92 @@ namespace qrz
 			ASSERT_EQ(expectedSessionKey, testConfig.getSessionKey());
 			ASSERT_EQ(expectedSessionExpiration, testConfig.getSessionExpiration());
 		}
+
+		TEST_F(ConfigurationTests, TestSaveOnlyWhenDirty)
+		{
+			auto inputConfig = Configuration(configDirPath);
+
+			ASSERT_FALSE(inputConfig.isDirty()) << "A freshly loaded configuration should not be dirty";
+
+			inputConfig.setCallsign("W1AW");
+			inputConfig.setSessionKey("c992efd9432fbc4972b36432f822be64");
+
+			ASSERT_TRUE(inputConfig.isDirty()) << "Changing a value should mark the configuration dirty";
+
+			inputConfig.saveConfig();
+
+			ASSERT_FALSE(inputConfig.isDirty()) << "Saving should clear the dirty flag";
+			ASSERT_FALSE(std::filesystem::exists(expectedConfigFilePath + ".tmp")) << "No temporary file should be left behind";
+
+			// Setting the same values again must not mark the configuration dirty, or rewrite the file
+			auto lastWrite = std::filesystem::last_write_time(expectedConfigFilePath);
+
+			inputConfig.setCallsign("W1AW");
+			inputConfig.setSessionKey("c992efd9432fbc4972b36432f822be64");
+
+			ASSERT_FALSE(inputConfig.isDirty()) << "Setting an unchanged value should not mark the configuration dirty";
+
+			inputConfig.saveConfig();
+
+			ASSERT_EQ(lastWrite, std::filesystem::last_write_time(expectedConfigFilePath)) << "Config file should not be rewritten";
+
+			inputConfig.setSessionKey("d0cf9d7b3b937ed5f5de28ddf5a0122d");
+			inputConfig.saveConfig();
+
+			auto testConfig = Configuration(configDirPath);
+
+			ASSERT_EQ("d0cf9d7b3b937ed5f5de28ddf5a0122d", testConfig.getSessionKey());
+		}
+
+		TEST_F(ConfigurationTests, TestParallelSavesMerge)
+		{
+			{
+				auto setupConfig = Configuration(configDirPath);
+				setupConfig.setCallsign("W1AW");
+				setupConfig.setSessionKey("c992efd9432fbc4972b36432f822be64");
+				setupConfig.saveConfig();
+			}
+
+			// Two invocations load the same file, then each refreshes part of the session
+			auto firstConfig = Configuration(configDirPath);
+			auto secondConfig = Configuration(configDirPath);
+
+			firstConfig.setSessionKey("d0cf9d7b3b937ed5f5de28ddf5a0122d");
+			firstConfig.saveConfig();
+
+			secondConfig.setSessionExpiration("2030-01-01 00:00:00");
+			secondConfig.saveConfig();
+
+			ASSERT_EQ("d0cf9d7b3b937ed5f5de28ddf5a0122d", secondConfig.getSessionKey())
+				<< "Saving should pick up the values other invocations saved";
+
+			auto testConfig = Configuration(configDirPath);
+
+			ASSERT_EQ("W1AW", testConfig.getCallsign());
+			ASSERT_EQ("d0cf9d7b3b937ed5f5de28ddf5a0122d", testConfig.getSessionKey())
+				<< "A later save should not overwrite keys it did not change";
+			ASSERT_EQ("2030-01-01 00:00:00", testConfig.getSessionExpiration());
+		}
+
+		TEST_F(ConfigurationTests, TestCachedPassword)
+		{
+			auto inputConfig = Configuration(configDirPath);
+
+			inputConfig.setCallsign("W1AW");
+			inputConfig.setPassword("wh15ky7@n60F0x7r07");
+
+			ASSERT_EQ("wh15ky7@n60F0x7r07", inputConfig.getPassword());
+			ASSERT_EQ("wh15ky7@n60F0x7r07", inputConfig.getPassword()) << "Repeated reads should return the cached password";
+
+			inputConfig.setPassword("n3wP@55w0rd");
+
+			ASSERT_EQ("n3wP@55w0rd", inputConfig.getPassword()) << "Setting the password should refresh the cache";
+
+			inputConfig.saveConfig();
+
+			auto testConfig = Configuration(configDirPath);
+
+			ASSERT_EQ("n3wP@55w0rd", testConfig.getPassword()) << "Cached cipher should produce a decryptable password";
+		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "../src/net/Deadline.h"
+#include "../src/net/GuardedInputStream.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+namespace qrz
+{
+	namespace
+	{
+		// A stream buffer that hands out a few characters per refill, like a socket receiving a slow response
+		class DribbleBuf : public std::streambuf
+		{
+		public:
+			explicit DribbleBuf(std::string data) : m_data(std::move(data))
+			{}
+
+			int refills = 0;
+
+		protected:
+			int_type underflow() override
+			{
+				if (m_position >= m_data.size())
+				{
+					return traits_type::eof();
+				}
+
+				size_t length = std::min<size_t>(4, m_data.size() - m_position);
+				char *start = m_data.data() + m_position;
+
+				m_position += length;
+				refills++;
+				setg(start, start, start + length);
+
+				return traits_type::to_int_type(*gptr());
+			}
+
+		private:
+			std::string m_data;
+
+			size_t m_position = 0;
+		};
+
+		TEST(DeadlineTests, TestNoDeadline)
+		{
+			net::Deadline deadline;
+
+			ASSERT_FALSE(deadline.expired());
+			ASSERT_FALSE(deadline.remaining().has_value()) << "A default deadline should have no expiry";
+			ASSERT_EQ(std::chrono::milliseconds(250), deadline.clamp(std::chrono::milliseconds(250)));
+		}
+
+		TEST(DeadlineTests, TestExpiry)
+		{
+			net::Deadline deadline = net::Deadline::after(std::chrono::milliseconds(50));
+
+			ASSERT_FALSE(deadline.expired());
+			ASSERT_LE(deadline.clamp(std::chrono::seconds(10)), std::chrono::milliseconds(50)) << "Timeouts should be limited to the time left";
+
+			ASSERT_FALSE(deadline.sleepFor(std::chrono::seconds(5))) << "Sleeping should stop at the deadline";
+			ASSERT_TRUE(deadline.expired());
+			ASSERT_EQ(std::chrono::milliseconds(0), deadline.remaining());
+		}
+
+		TEST(DeadlineTests, TestNarrowedSharesCancellation)
+		{
+			net::Deadline batch = net::Deadline::after(std::chrono::seconds(60));
+			net::Deadline lookup = batch.narrowed(std::chrono::seconds(5));
+
+			ASSERT_LE(lookup.remaining(), std::chrono::seconds(5)) << "The narrowed deadline should be the earlier one";
+
+			batch.cancel();
+
+			ASSERT_TRUE(lookup.cancelled()) << "Cancelling the batch should cancel its lookups";
+			ASSERT_TRUE(lookup.expired());
+			ASSERT_FALSE(net::Deadline().cancelled()) << "Unrelated deadlines should not be cancelled";
+		}
+
+		TEST(DeadlineTests, TestGuardedStreamChecksBeforeEachRead)
+		{
+			DribbleBuf source("0123456789ABCDEF");
+			std::istream input(&source);
+			int checks = 0;
+
+			net::GuardedInputStream guarded(input, [&checks]() { return ++checks <= 2; });
+			std::string read((std::istreambuf_iterator<char>(guarded)), std::istreambuf_iterator<char>());
+
+			ASSERT_EQ("01234567", read) << "Reading should stop once the guard refuses";
+			ASSERT_TRUE(guarded.stopped());
+			ASSERT_EQ(2, source.refills) << "The source should not be read after the guard refuses";
+
+			DribbleBuf whole("0123456789ABCDEF");
+			std::istream wholeInput(&whole);
+			checks = 0;
+
+			net::GuardedInputStream unguarded(wholeInput, [&checks]() { return ++checks > 0; });
+			std::string all((std::istreambuf_iterator<char>(unguarded)), std::istreambuf_iterator<char>());
+
+			ASSERT_EQ("0123456789ABCDEF", all);
+			ASSERT_FALSE(unguarded.stopped());
+			ASSERT_EQ(5, checks) << "The guard should run once per read from the source";
+		}
+	}
+}
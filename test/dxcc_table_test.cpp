@@ -0,0 +1,98 @@
+#include "../src/dxcc/DXCCTable.h"
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+namespace qrz
+{
+	namespace
+	{
+		DXCC buildDXCC(const std::string &dxcc, const std::string &name, const std::string &cc)
+		{
+			DXCC output;
+			output.setDxcc(dxcc);
+			output.setName(name);
+			output.setCc(cc);
+			output.setContinent("NA");
+
+			return output;
+		}
+
+		class DXCCTableTests : public testing::Test
+		{
+		protected:
+			void SetUp() override
+			{
+				tablePath = (std::filesystem::temp_directory_path() / "qrz_dxcc_table_test" / "dxcc.tsv").string();
+
+				std::filesystem::remove_all(std::filesystem::path(tablePath).parent_path());
+			}
+
+			void TearDown() override
+			{
+				std::filesystem::remove_all(std::filesystem::path(tablePath).parent_path());
+			}
+
+			std::string tablePath;
+		};
+
+		TEST_F(DXCCTableTests, TestFindByEntityNumber)
+		{
+			dxcc::DXCCTable table({buildDXCC("291", "United States", "US"), buildDXCC("1", "Canada", "CA"),
+								   buildDXCC("", "No entity", ""), buildDXCC("abc", "Bad entity", "")},
+								  dxcc::DXCCTable::Clock::now());
+
+			ASSERT_EQ(2, table.size()) << "Records without a numeric entity number should be dropped";
+
+			const DXCC *us = table.find("291");
+			ASSERT_NE(nullptr, us);
+			ASSERT_EQ("United States", us->getName());
+
+			ASSERT_EQ("Canada", table.find("1")->getName());
+			ASSERT_EQ(nullptr, table.find("2"));
+			ASSERT_EQ(nullptr, table.find("5000"));
+			ASSERT_EQ(nullptr, table.find("W1AW"));
+		}
+
+		TEST_F(DXCCTableTests, TestSaveAndLoad)
+		{
+			DXCC us = buildDXCC("291", "United States", "US");
+			us.setNotes("Notes\twith a tab");
+
+			auto fetchedAt = std::chrono::time_point_cast<std::chrono::seconds>(dxcc::DXCCTable::Clock::now());
+
+			dxcc::DXCCTable(std::vector<DXCC>{us, buildDXCC("1", "Canada", "CA")}, fetchedAt).save(tablePath);
+
+			ASSERT_FALSE(std::filesystem::exists(tablePath + ".tmp")) << "The temporary file should be renamed into place";
+
+			dxcc::DXCCTable loaded = dxcc::DXCCTable::load(tablePath);
+
+			ASSERT_EQ(2, loaded.size());
+			ASSERT_EQ(fetchedAt, loaded.getFetchedAt());
+			ASSERT_EQ("US", loaded.find("291")->getCc());
+			ASSERT_EQ("NA", loaded.find("291")->getContinent());
+			ASSERT_EQ("Notes with a tab", loaded.find("291")->getNotes());
+			ASSERT_EQ("Canada", loaded.find("1")->getName());
+		}
+
+		TEST_F(DXCCTableTests, TestStaleness)
+		{
+			dxcc::DXCCTable fresh({buildDXCC("1", "Canada", "CA")}, dxcc::DXCCTable::Clock::now());
+			dxcc::DXCCTable old({buildDXCC("1", "Canada", "CA")}, dxcc::DXCCTable::Clock::now() - std::chrono::hours(24 * 60));
+
+			ASSERT_FALSE(fresh.isStale(std::chrono::hours(24 * 30)));
+			ASSERT_TRUE(old.isStale(std::chrono::hours(24 * 30)));
+		}
+
+		TEST_F(DXCCTableTests, TestLoadRejectsOtherFiles)
+		{
+			std::filesystem::create_directories(std::filesystem::path(tablePath).parent_path());
+
+			std::ofstream(tablePath) << "not a table\n";
+
+			ASSERT_THROW(dxcc::DXCCTable::load(tablePath), std::runtime_error);
+			ASSERT_THROW(dxcc::DXCCTable::load(tablePath + ".missing"), std::runtime_error);
+		}
+	}
+}
@@ -0,0 +1,357 @@
+#include "../src/cache/CacheSegment.h"
+#include "../src/cache/LookupCache.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace qrz
+{
+	namespace
+	{
+		class LookupCacheTests : public testing::Test
+		{
+		protected:
+			void SetUp() override
+			{
+				cachePath = (std::filesystem::temp_directory_path() / "qrz_lookup_cache_test" / "cache.log").string();
+
+				std::filesystem::remove_all(std::filesystem::path(cachePath).parent_path());
+			}
+
+			void TearDown() override
+			{
+				std::filesystem::remove_all(std::filesystem::path(cachePath).parent_path());
+			}
+
+			// Reads the segment generation the cache's pointer file names
+			std::string readPointer() const
+			{
+				std::string generation;
+				std::ifstream(std::filesystem::path(cachePath).replace_extension(".current")) >> generation;
+
+				return generation;
+			}
+
+			std::string cachePath;
+		};
+
+		TEST_F(LookupCacheTests, TestPutAndGet)
+		{
+			cache::LookupCache cache(cachePath);
+
+			ASSERT_EQ(0, cache.size());
+			ASSERT_FALSE(cache.get(cache::RecordType::CALLSIGN, "W1AW"));
+
+			cache.put(cache::RecordType::CALLSIGN, "W1AW", "callsign");
+			cache.put(cache::RecordType::DXCC, "W1AW", "dxcc");
+
+			ASSERT_EQ("callsign", cache.get(cache::RecordType::CALLSIGN, "W1AW")->value);
+			ASSERT_EQ("dxcc", cache.get(cache::RecordType::DXCC, "W1AW")->value) << "Record types should not share keys";
+			ASSERT_FALSE(cache.get(cache::RecordType::BIO, "W1AW"));
+		}
+
+		TEST_F(LookupCacheTests, TestFlushAndReload)
+		{
+			{
+				cache::LookupCache cache(cachePath);
+				cache.put(cache::RecordType::CALLSIGN, "W1AW", "first\nwith a line break");
+				cache.put(cache::RecordType::CALLSIGN, "W5YI", "other");
+				cache.flush();
+
+				cache.put(cache::RecordType::CALLSIGN, "W1AW", "second");
+				cache.flush();
+			}
+
+			cache::LookupCache reloaded(cachePath);
+
+			ASSERT_EQ(2, reloaded.size());
+			ASSERT_EQ("second", reloaded.get(cache::RecordType::CALLSIGN, "W1AW")->value) << "Later entries should win";
+			ASSERT_EQ("other", reloaded.get(cache::RecordType::CALLSIGN, "W5YI")->value);
+		}
+
+		TEST_F(LookupCacheTests, TestTruncatedLog)
+		{
+			{
+				cache::LookupCache cache(cachePath);
+				cache.put(cache::RecordType::CALLSIGN, "W1AW", "complete");
+				cache.flush();
+			}
+
+			std::ofstream(cachePath, std::ios::app) << "C\tW5YI\t0\t100\ncut short";
+
+			cache::LookupCache reloaded(cachePath);
+
+			ASSERT_EQ(1, reloaded.size()) << "The damaged entry should be dropped";
+			ASSERT_EQ("complete", reloaded.get(cache::RecordType::CALLSIGN, "W1AW")->value);
+		}
+
+		TEST_F(LookupCacheTests, TestRejectOtherFiles)
+		{
+			std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path());
+
+			std::ofstream(cachePath) << "not a cache\n";
+
+			ASSERT_THROW(cache::LookupCache{cachePath}, std::runtime_error);
+		}
+
+		TEST_F(LookupCacheTests, TestCompactIntoSegment)
+		{
+			std::filesystem::path directory = std::filesystem::path(cachePath).parent_path();
+
+			{
+				cache::LookupCache cache(cachePath, 0);
+				cache.put(cache::RecordType::CALLSIGN, "W1AW", "first");
+				cache.put(cache::RecordType::CALLSIGN, "W5YI", "other");
+				cache.flush();
+				cache.finishCompaction();
+
+				ASSERT_EQ(1, cache.getCompactionStats().runs);
+			}
+
+			ASSERT_TRUE(std::filesystem::exists(directory / "cache.1.seg"));
+			ASSERT_EQ("1", readPointer()) << "The pointer file should name the new segment";
+			ASSERT_EQ(std::string("# qrz lookup cache v1\n").size(), std::filesystem::file_size(cachePath))
+				<< "The log should be emptied once it has been merged into the segment";
+
+			cache::LookupCache reader(cachePath);
+
+			{
+				cache::LookupCache writer(cachePath, 0);
+				writer.put(cache::RecordType::CALLSIGN, "W1AW", "second");
+				writer.put(cache::RecordType::DXCC, "291", "dxcc");
+				writer.flush();
+				writer.finishCompaction();
+			}
+
+			ASSERT_EQ("first", reader.get(cache::RecordType::CALLSIGN, "W1AW")->value)
+				<< "An open cache should keep reading the segment it mapped";
+			ASSERT_EQ("2", readPointer()) << "Each compaction should write a new generation, not replace a mapped file";
+			ASSERT_TRUE(std::filesystem::exists(directory / "cache.2.seg"));
+#ifndef WIN32
+			ASSERT_FALSE(std::filesystem::exists(directory / "cache.1.seg")) << "Old generations should be removed";
+#endif
+
+			cache::LookupCache reloaded(cachePath);
+
+			ASSERT_EQ(3, reloaded.size());
+			ASSERT_EQ("second", reloaded.get(cache::RecordType::CALLSIGN, "W1AW")->value) << "Later entries should win";
+			ASSERT_EQ("other", reloaded.get(cache::RecordType::CALLSIGN, "W5YI")->value);
+			ASSERT_EQ("dxcc", reloaded.get(cache::RecordType::DXCC, "291")->value);
+			ASSERT_FALSE(reloaded.get(cache::RecordType::CALLSIGN, "K1ABC"));
+		}
+
+		TEST_F(LookupCacheTests, TestSegment)
+		{
+			std::string segmentPath = std::filesystem::path(cachePath).replace_extension(".seg").string();
+			std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path());
+
+			std::vector<std::string> keys;
+
+			for (int i = 0; i < 1000; ++i)
+			{
+				keys.push_back("C\tK" + std::to_string(i));
+			}
+
+			std::sort(keys.begin(), keys.end());
+
+			std::vector<cache::CacheSegment::Record> records;
+
+			for (const std::string &key : keys)
+			{
+				records.push_back({key, std::string_view(key).substr(2), 42});
+			}
+
+			cache::CacheSegment::write(segmentPath, records);
+
+			cache::CacheSegment segment(segmentPath);
+
+			ASSERT_EQ(1000, segment.size());
+
+			for (const std::string &key : keys)
+			{
+				std::optional<cache::CacheSegment::Record> record = segment.find(key);
+
+				ASSERT_TRUE(record) << key;
+				ASSERT_EQ(key.substr(2), record->value);
+				ASSERT_EQ(42, record->storedAt);
+			}
+
+			ASSERT_FALSE(segment.find("C\tW1AW"));
+
+			ASSERT_FALSE(segment.at(7)->referenced) << "A new segment should start out unreferenced";
+			segment.touch(7);
+			ASSERT_TRUE(segment.at(7)->referenced);
+			ASSERT_TRUE(cache::CacheSegment(segmentPath).at(7)->referenced) << "Uses should be shared through the file";
+			ASSERT_FALSE(cache::CacheSegment(segmentPath).at(8)->referenced);
+			ASSERT_EQ(0, cache::CacheSegment(segmentPath + ".missing").size());
+
+			std::filesystem::resize_file(segmentPath, std::filesystem::file_size(segmentPath) - 1);
+
+			ASSERT_THROW(cache::CacheSegment{segmentPath}, std::runtime_error) << "A truncated segment should be rejected";
+		}
+
+		TEST_F(LookupCacheTests, TestNotFoundEntries)
+		{
+			{
+				cache::LookupCache cache(cachePath);
+				cache.putNotFound(cache::RecordType::CALLSIGN, "N0CALL");
+				cache.putNotFound(cache::RecordType::BIO, "N0CALL");
+				cache.flush();
+
+				ASSERT_EQ(1, cache.getStats(cache::RecordType::CALLSIGN).notFoundStored);
+				ASSERT_EQ(0, cache.getStats(cache::RecordType::BIO).notFoundStored)
+					<< "Bios should not be negatively cached by default";
+			}
+
+			cache::LookupCache reloaded(cachePath);
+
+			std::optional<cache::LookupCache::Hit> hit = reloaded.lookup(cache::RecordType::CALLSIGN, "N0CALL");
+
+			ASSERT_TRUE(hit);
+			ASSERT_TRUE(hit->entry.isNotFound());
+			ASSERT_EQ(cache::Freshness::FRESH, hit->freshness);
+			ASSERT_FALSE(reloaded.lookup(cache::RecordType::BIO, "N0CALL"));
+		}
+
+		TEST_F(LookupCacheTests, TestLookupByAge)
+		{
+			std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path());
+
+			auto ago = [](std::chrono::hours age)
+			{
+				auto storedAt = cache::LookupCache::Clock::now() - age;
+
+				return std::chrono::duration_cast<std::chrono::seconds>(storedAt.time_since_epoch()).count();
+			};
+
+			std::ofstream(cachePath) << "# qrz lookup cache v1\n"
+									 << "C\tFRESH\t" << ago(std::chrono::hours(1)) << "\t1\nf\n"
+									 << "C\tSTALE\t" << ago(std::chrono::hours(24 * 10)) << "\t1\ns\n"
+									 << "C\tOLD\t" << ago(std::chrono::hours(24 * 60)) << "\t1\no\n"
+									 << "C\tGONE\t" << ago(std::chrono::hours(48)) << "\t0\n\n";
+
+			cache::LookupCache cache(cachePath);
+
+			ASSERT_EQ(cache::Freshness::FRESH, cache.lookup(cache::RecordType::CALLSIGN, "FRESH")->freshness);
+			ASSERT_EQ(cache::Freshness::STALE, cache.lookup(cache::RecordType::CALLSIGN, "STALE")->freshness);
+			ASSERT_FALSE(cache.lookup(cache::RecordType::CALLSIGN, "OLD")) << "Entries past their stale period should expire";
+			ASSERT_FALSE(cache.lookup(cache::RecordType::CALLSIGN, "GONE")) << "Not found answers should expire sooner";
+
+			cache::CachePolicies policies;
+			policies.apply("callsign=max-age:3600,stale:0,not-found:604800");
+			cache.setPolicies(policies);
+
+			ASSERT_EQ(cache::Freshness::FRESH, cache.lookup(cache::RecordType::CALLSIGN, "FRESH")->freshness);
+			ASSERT_FALSE(cache.lookup(cache::RecordType::CALLSIGN, "STALE")) << "A zero stale period should disable stale hits";
+			ASSERT_TRUE(cache.lookup(cache::RecordType::CALLSIGN, "GONE"));
+		}
+
+		TEST_F(LookupCacheTests, TestEviction)
+		{
+			cache::CachePolicies policies;
+			policies.apply("callsign=max-entries:3");
+			policies.apply("dxcc=max-bytes:20");
+
+			{
+				cache::LookupCache cache(cachePath, 0);
+				cache.setPolicies(policies);
+
+				for (const char *call : {"K1ABC", "K2ABC", "K3ABC", "K4ABC"})
+				{
+					cache.put(cache::RecordType::CALLSIGN, call, "callsign");
+				}
+
+				cache.put(cache::RecordType::DXCC, "1", "0123456789");
+				cache.put(cache::RecordType::DXCC, "2", "0123456789");
+				cache.put(cache::RecordType::BIO, "K1ABC", "bio");
+				cache.flush();
+				cache.finishCompaction();
+
+				ASSERT_EQ(1, cache.getStats(cache::RecordType::CALLSIGN).evicted);
+				ASSERT_EQ(1, cache.getStats(cache::RecordType::DXCC).evicted) << "Two 13 byte entries should not fit";
+				ASSERT_EQ(0, cache.getStats(cache::RecordType::BIO).evicted);
+			}
+
+			{
+				// Use two of the three callsigns that are left, then push the cache over its limit
+				cache::LookupCache cache(cachePath, 0);
+				cache.setPolicies(policies);
+
+				int used = 0;
+
+				for (const char *call : {"K1ABC", "K2ABC", "K3ABC", "K4ABC"})
+				{
+					if (used < 2 && cache.get(cache::RecordType::CALLSIGN, call))
+					{
+						used++;
+					}
+				}
+
+				ASSERT_EQ(2, used);
+
+				cache.put(cache::RecordType::CALLSIGN, "K5ABC", "callsign");
+				cache.flush();
+				cache.finishCompaction();
+
+				ASSERT_EQ(1, cache.getStats(cache::RecordType::CALLSIGN).evicted);
+			}
+
+			cache::LookupCache reloaded(cachePath);
+			int kept = 0;
+
+			for (const char *call : {"K1ABC", "K2ABC", "K3ABC", "K4ABC"})
+			{
+				kept += reloaded.get(cache::RecordType::CALLSIGN, call) ? 1 : 0;
+			}
+
+			ASSERT_EQ(2, kept) << "The unused callsign should have been evicted";
+			ASSERT_TRUE(reloaded.get(cache::RecordType::CALLSIGN, "K5ABC")) << "A new entry should count as used";
+			ASSERT_EQ("bio", reloaded.get(cache::RecordType::BIO, "K1ABC")->value) << "Limits should be per type";
+			ASSERT_EQ(5, reloaded.size());
+		}
+
+		TEST_F(LookupCacheTests, TestCompactionDropsExpired)
+		{
+			std::filesystem::create_directories(std::filesystem::path(cachePath).parent_path());
+
+			std::ofstream(cachePath) << "# qrz lookup cache v1\n"
+									 << "C\tOLD\t0\t1\no\n"
+									 << "C\tGONE\t0\t0\n\n";
+
+			cache::LookupCache cache(cachePath, 0);
+			cache.put(cache::RecordType::CALLSIGN, "W1AW", "new");
+			cache.flush();
+			cache.finishCompaction();
+
+			ASSERT_EQ(2, cache.getStats(cache::RecordType::CALLSIGN).expired);
+			ASSERT_EQ(1, cache::LookupCache(cachePath).size());
+		}
+
+		TEST(CachePolicyTests, TestApplySpec)
+		{
+			cache::CachePolicies policies;
+			const cache::CachePolicy bio = policies.get(cache::RecordType::BIO);
+
+			policies.apply("dxcc=not-found:60,max-age:120");
+
+			ASSERT_EQ(std::chrono::seconds(60), policies.get(cache::RecordType::DXCC).notFoundMaxAge);
+			ASSERT_EQ(std::chrono::seconds(120), policies.get(cache::RecordType::DXCC).maxAge);
+			ASSERT_EQ(std::chrono::hours(24 * 90), policies.get(cache::RecordType::DXCC).staleFor)
+				<< "Settings left out should keep their value";
+
+			policies.apply("bio=max-entries:1000,max-bytes:1048576");
+
+			ASSERT_EQ(1000, policies.get(cache::RecordType::BIO).maxEntries);
+			ASSERT_EQ(1048576, policies.get(cache::RecordType::BIO).maxBytes);
+
+			ASSERT_THROW(policies.apply("qsl=max-age:1"), std::invalid_argument);
+			ASSERT_THROW(policies.apply("bio=max-age:-1"), std::invalid_argument);
+			ASSERT_THROW(policies.apply("bio=max-age:1,ttl:5"), std::invalid_argument);
+			ASSERT_THROW(policies.apply("bio"), std::invalid_argument);
+
+			ASSERT_EQ(bio.maxAge, policies.get(cache::RecordType::BIO).maxAge) << "A bad spec should change nothing";
+		}
+	}
+}
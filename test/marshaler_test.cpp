@@ -80,6 +80,24 @@ namespace qrz
         <name_fmt>ARRL HQ OPERATORS CLUB</name_fmt>
     </Callsign>
 </QRZDatabase>
+)xml";
+
+			std::string dxccXmlList=R"xml(
+<QRZDatabase>
+    <DXCC>
+        <dxcc>1</dxcc>
+        <cc>CA</cc>
+        <name>Canada</name>
+    </DXCC>
+    <DXCC>
+        <dxcc>291</dxcc>
+        <cc>US</cc>
+        <name>United States</name>
+    </DXCC>
+    <Session>
+        <Key>d0cf9d7b3b937ed5f5de28ddf5a0122d</Key>
+    </Session>
+</QRZDatabase>
 )xml";
 
 			std::string dxccXml291=R"xml(
@@ -145,5 +163,21 @@ namespace qrz
 			ASSERT_STREQ(expectedCc, remarshaledDXCC.getCc().c_str()) << "CC should be " << expectedCc;
 			ASSERT_STREQ(expectedName, remarshaledDXCC.getName().c_str()) << "Name should be " << expectedName;
 		}
+
+		TEST_F(MarshalerTests, TestDXCCListMarshal)
+		{
+			std::vector<DXCC> dxccs = DXCCMarshaler::FromXmlList(dxccXmlList);
+
+			ASSERT_EQ(2, dxccs.size()) << "Every DXCC element should be converted";
+			ASSERT_STREQ("1", dxccs.at(0).getDxcc().c_str());
+			ASSERT_STREQ("Canada", dxccs.at(0).getName().c_str());
+			ASSERT_STREQ("291", dxccs.at(1).getDxcc().c_str());
+			ASSERT_STREQ("US", dxccs.at(1).getCc().c_str());
+
+			std::vector<DXCC> remarshaled = DXCCMarshaler::FromXmlList(DXCCMarshaler::ToXML(dxccs));
+
+			ASSERT_EQ(2, remarshaled.size());
+			ASSERT_STREQ("United States", remarshaled.at(1).getName().c_str());
+		}
 	}
 }
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "../src/metrics/Histogram.h"
+#include "../src/metrics/Registry.h"
+#include "../src/metrics/TextFileExporter.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace qrz
+{
+	namespace
+	{
+		TEST(MetricsTests, TestHistogramPercentiles)
+		{
+			metrics::Histogram histogram;
+
+			for (int i = 1; i <= 1000; ++i)
+			{
+				histogram.record(std::chrono::milliseconds(i));
+			}
+
+			ASSERT_EQ(1000, histogram.count());
+			ASSERT_EQ(std::chrono::milliseconds(500500), histogram.sum());
+			ASSERT_EQ(std::chrono::milliseconds(1000), histogram.max());
+
+			auto withinOnePercent = [](std::chrono::microseconds actual, std::chrono::microseconds expected)
+			{
+				return std::abs(actual.count() - expected.count()) <= expected.count() / 100;
+			};
+
+			ASSERT_TRUE(withinOnePercent(histogram.percentile(50), std::chrono::milliseconds(500)));
+			ASSERT_TRUE(withinOnePercent(histogram.percentile(99), std::chrono::milliseconds(990)));
+			ASSERT_EQ(std::chrono::milliseconds(1000), histogram.percentile(100)) << "No percentile exceeds the maximum";
+		}
+
+		TEST(MetricsTests, TestHistogramSmallAndHugeValues)
+		{
+			metrics::Histogram histogram;
+
+			ASSERT_EQ(std::chrono::microseconds(0), histogram.percentile(50)) << "An empty histogram reads 0";
+
+			histogram.record(std::chrono::microseconds(7));
+
+			ASSERT_EQ(std::chrono::microseconds(7), histogram.percentile(50)) << "Small values should be exact";
+
+			histogram.record(std::chrono::hours(24 * 365));
+			histogram.record(std::chrono::microseconds(-5));
+
+			ASSERT_EQ(3, histogram.count());
+			ASSERT_GT(histogram.percentile(100), std::chrono::hours(24 * 12)) << "Huge values should clamp, not wrap";
+		}
+
+		TEST(MetricsTests, TestConcurrentRecording)
+		{
+			metrics::Histogram histogram;
+			metrics::Counter counter;
+
+			std::vector<std::thread> threads;
+
+			for (int t = 0; t < 4; ++t)
+			{
+				threads.emplace_back([&histogram, &counter]()
+				{
+					for (int i = 0; i < 10000; ++i)
+					{
+						histogram.record(std::chrono::microseconds(i));
+						counter.increment();
+					}
+				});
+			}
+
+			for (std::thread &thread : threads)
+			{
+				thread.join();
+			}
+
+			ASSERT_EQ(40000, histogram.count());
+			ASSERT_EQ(40000, counter.value());
+		}
+
+		TEST(MetricsTests, TestPrometheusText)
+		{
+			metrics::Registry registry;
+
+			registry.counter("qrz_retries_total", "Retries").increment(3);
+			registry.gauge("qrz_requests_in_flight", "In flight").add(2);
+			registry.histogram("qrz_request_duration_seconds", "Latency", {{"endpoint", "callsign"}})
+					.record(std::chrono::milliseconds(250));
+
+			metrics::Counter &retries = registry.counter("qrz_retries_total", "Retries");
+
+			ASSERT_EQ(&retries, &registry.counter("qrz_retries_total", "Retries")) << "Metrics should be registered once";
+			ASSERT_THROW(registry.gauge("qrz_retries_total", "Retries"), std::invalid_argument);
+
+			std::ostringstream output;
+			registry.writePrometheus(output);
+
+			std::string text = output.str();
+
+			ASSERT_NE(std::string::npos, text.find("# TYPE qrz_retries_total counter\nqrz_retries_total 3\n"));
+			ASSERT_NE(std::string::npos, text.find("qrz_requests_in_flight 2\n"));
+			ASSERT_NE(std::string::npos, text.find("# TYPE qrz_request_duration_seconds summary\n"));
+			ASSERT_NE(std::string::npos, text.find(R"(duration_seconds{endpoint="callsign",quantile="0.5"} 0.25)"));
+			ASSERT_NE(std::string::npos, text.find(R"(qrz_request_duration_seconds_count{endpoint="callsign"} 1)"));
+		}
+
+		TEST(MetricsTests, TestTextFileExporter)
+		{
+			std::filesystem::path path = std::filesystem::temp_directory_path() / "qrz_metrics_test.prom";
+			std::filesystem::remove(path);
+
+			auto registry = std::make_shared<metrics::Registry>();
+			metrics::Counter &counter = registry->counter("qrz_test_total", "Test");
+
+			{
+				metrics::TextFileExporter exporter(registry, path.string(), std::chrono::hours(1));
+
+				counter.increment();
+			}
+
+			std::ifstream input(path);
+			std::stringstream text;
+			text << input.rdbuf();
+
+			ASSERT_NE(std::string::npos, text.str().find("qrz_test_total 1\n")) << "The final values should be written";
+			ASSERT_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+
+			std::filesystem::remove(path);
+		}
+	}
+}
@@ -0,0 +1,78 @@
+#include "../src/net/PhaseStats.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace qrz
+{
+	namespace
+	{
+		TEST(PhaseStatsTests, TestSummarize)
+		{
+			net::PhaseStats stats;
+
+			for (int i = 1; i <= 100; ++i)
+			{
+				stats.record(net::Phase::TRANSFER, std::chrono::milliseconds(i));
+			}
+
+			stats.record(net::Phase::CONNECT, std::chrono::milliseconds(5));
+
+			std::vector<net::PhaseStats::Summary> summaries = stats.summarize();
+
+			ASSERT_EQ(2, summaries.size()) << "Only phases with samples should be summarized";
+			ASSERT_EQ(net::Phase::CONNECT, summaries[0].phase) << "Phases should be in phase order";
+
+			const net::PhaseStats::Summary &transfer = summaries[1];
+
+			ASSERT_EQ(net::Phase::TRANSFER, transfer.phase);
+			ASSERT_EQ(100, transfer.count);
+			ASSERT_EQ(std::chrono::milliseconds(5050), transfer.total);
+			ASSERT_EQ(std::chrono::milliseconds(50), transfer.p50);
+			ASSERT_EQ(std::chrono::milliseconds(90), transfer.p90);
+			ASSERT_EQ(std::chrono::milliseconds(99), transfer.p99);
+			ASSERT_EQ(std::chrono::milliseconds(100), transfer.max);
+		}
+
+		TEST(PhaseStatsTests, TestTimer)
+		{
+			net::PhaseStats stats;
+
+			{
+				net::PhaseStats::Timer timer(&stats, net::Phase::FIRST_BYTE);
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+				timer.next(net::Phase::TRANSFER);
+			}
+
+			std::vector<net::PhaseStats::Summary> summaries = stats.summarize();
+
+			ASSERT_EQ(2, summaries.size()) << "Both phases should be recorded, the last one when the timer goes away";
+			ASSERT_GE(summaries[0].total, std::chrono::milliseconds(20));
+			ASSERT_LT(summaries[1].total, std::chrono::milliseconds(20));
+		}
+
+		TEST(PhaseStatsTests, TestTimerWithoutStats)
+		{
+			net::PhaseStats::Timer timer(nullptr, net::Phase::RENDER);
+
+			timer.next(net::Phase::CACHE);
+			timer.stop();
+		}
+
+		TEST(PhaseStatsTests, TestStopRecordsOnce)
+		{
+			net::PhaseStats stats;
+
+			{
+				net::PhaseStats::Timer timer(&stats, net::Phase::PARSE);
+				timer.stop();
+			}
+
+			ASSERT_EQ(1, stats.summarize().at(0).count);
+		}
+	}
+}
@@ -0,0 +1,141 @@
+#include "../src/dxcc/PrefixResolver.h"
+#include "../src/dxcc/PrefixTrie.h"
+
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace qrz
+{
+	namespace
+	{
+		// An excerpt of cty.dat, with a location override on KH6 and an exact callsign
+		const std::string ctyDat = R"cty(Sov Mil Order of Malta:   15:  28:  EU:   41.90:   -12.43:    -1.0:  1A:
+    1A;
+Canada:                   05:  09:  NA:   44.35:    78.75:     5.0:  VE:
+    CF,CG,CJ,CK,CY,CZ,VA,VB,VC,VD,VE,VF,VG,VO,VX,VY,XJ,XK,XL,XM,XN,XO,
+    =VE2IM(2)[4];
+Hawaii:                   31:  61:  OC:   21.12:   157.48:    10.0:  KH6:
+    AH6,AH7,KH6,KH7,NH6,NH7,WH6,WH7;
+United States:            05:  08:  NA:   37.53:    91.67:     5.0:  K:
+    AA,AB,AC,AD,AE,AF,AG,AI,AJ,AK,K,N,W,
+    =KH6QQ(5)[8];
+)cty";
+
+		// The same entities in cty.csv format, which carries entity numbers
+		const std::string ctyCsv = R"cty(1A,Sov Mil Order of Malta,246,EU,15,28,41.90,-12.43,-1.0,1A;
+VE,Canada,1,NA,05,09,44.35,78.75,5.0,CF CG CJ CK CY CZ VA VB VC VD VE VF VG VO VX VY XJ XK XL XM XN XO =VE2IM(2)[4];
+KH6,Hawaii,110,OC,31,61,21.12,157.48,10.0,AH6 AH7 KH6 KH7 NH6 NH7 WH6 WH7;
+K,United States,291,NA,05,08,37.53,91.67,5.0,AA AB AC AD AE AF AG AI AJ AK K N W =KH6QQ(5)[8];
+)cty";
+
+		dxcc::PrefixResolver buildResolver(const std::string &table)
+		{
+			std::istringstream input(table);
+
+			return dxcc::PrefixResolver::parse(input);
+		}
+
+		TEST(PrefixTrieTests, TestLongestPrefixAndExactMatch)
+		{
+			dxcc::PrefixTrie::Builder builder;
+			builder.insert("K", 1, false);
+			builder.insert("KH6", 2, false);
+			builder.insert("KH6QQ", 3, true);
+
+			dxcc::PrefixTrie trie = builder.build();
+
+			ASSERT_EQ(1, trie.find("K1ABC"));
+			ASSERT_EQ(2, trie.find("KH6ABC"));
+			ASSERT_EQ(3, trie.find("KH6QQ"));
+			ASSERT_EQ(2, trie.find("KH6QQA")) << "Exact matches should not match as prefixes";
+			ASSERT_EQ(dxcc::PrefixTrie::npos, trie.find("W1AW"));
+			ASSERT_EQ(dxcc::PrefixTrie::npos, trie.findExact("KH6"));
+			ASSERT_EQ(3, trie.findExact("KH6QQ"));
+		}
+
+		TEST(PrefixResolverTests, TestResolveFromCtyDat)
+		{
+			dxcc::PrefixResolver resolver = buildResolver(ctyDat);
+
+			ASSERT_EQ(4, resolver.entityCount());
+
+			std::optional<DXCC> w1aw = resolver.resolve("w1aw");
+			ASSERT_TRUE(w1aw);
+			ASSERT_EQ("United States", w1aw->getName());
+			ASSERT_EQ("NA", w1aw->getContinent());
+			ASSERT_EQ("5", w1aw->getCqzone());
+			ASSERT_EQ("8", w1aw->getItuzone());
+			ASSERT_EQ("-5", w1aw->getTimezone()) << "UTC offset should be positive to the east";
+			ASSERT_EQ("37.53", w1aw->getLat());
+			ASSERT_EQ("-91.67", w1aw->getLon()) << "Longitude should be positive to the east";
+			ASSERT_EQ("", w1aw->getDxcc()) << "cty.dat does not carry entity numbers";
+
+			std::optional<DXCC> malta = resolver.resolve("1A0KM");
+			ASSERT_TRUE(malta);
+			ASSERT_EQ("1", malta->getTimezone());
+			ASSERT_EQ("12.43", malta->getLon());
+		}
+
+		TEST(PrefixResolverTests, TestResolveOverridesAndExactCallsigns)
+		{
+			dxcc::PrefixResolver resolver = buildResolver(ctyDat);
+
+			std::optional<DXCC> kh6 = resolver.resolve("KH6ABC");
+			ASSERT_TRUE(kh6);
+			ASSERT_EQ("Hawaii", kh6->getName());
+
+			std::optional<DXCC> exact = resolver.resolve("KH6QQ");
+			ASSERT_TRUE(exact);
+			ASSERT_EQ("United States", exact->getName()) << "An exact callsign should win over its prefix";
+			ASSERT_EQ("5", exact->getCqzone());
+
+			std::optional<DXCC> zoned = resolver.resolve("VE2IM");
+			ASSERT_TRUE(zoned);
+			ASSERT_EQ("Canada", zoned->getName());
+			ASSERT_EQ("2", zoned->getCqzone());
+			ASSERT_EQ("4", zoned->getItuzone());
+
+			std::optional<DXCC> unzoned = resolver.resolve("VE2IN");
+			ASSERT_TRUE(unzoned);
+			ASSERT_EQ("5", unzoned->getCqzone());
+		}
+
+		TEST(PrefixResolverTests, TestResolvePortableCallsigns)
+		{
+			dxcc::PrefixResolver resolver = buildResolver(ctyDat);
+
+			ASSERT_EQ("Canada", resolver.resolve("VE3/W1AW")->getName());
+			ASSERT_EQ("Hawaii", resolver.resolve("W1AW/KH6")->getName());
+			ASSERT_EQ("United States", resolver.resolve("W1AW/P")->getName());
+			ASSERT_EQ("United States", resolver.resolve("W1AW/QRP")->getName());
+			ASSERT_FALSE(resolver.resolve("W1AW/MM")) << "Maritime mobile stations have no entity";
+			ASSERT_FALSE(resolver.resolve("ZZ9ZZ")) << "Unknown prefixes should not resolve";
+			ASSERT_FALSE(resolver.resolve("not a call"));
+		}
+
+		TEST(PrefixResolverTests, TestResolveFromCtyCsv)
+		{
+			dxcc::PrefixResolver resolver = buildResolver(ctyCsv);
+
+			ASSERT_EQ(4, resolver.entityCount());
+
+			std::optional<DXCC> w5yi = resolver.resolve("W5YI");
+			ASSERT_TRUE(w5yi);
+			ASSERT_EQ("291", w5yi->getDxcc());
+			ASSERT_EQ("United States", w5yi->getName());
+
+			std::optional<DXCC> entity = resolver.findEntity("110");
+			ASSERT_TRUE(entity);
+			ASSERT_EQ("Hawaii", entity->getName());
+			ASSERT_EQ("OC", entity->getContinent());
+
+			ASSERT_FALSE(resolver.findEntity("999"));
+		}
+
+		TEST(PrefixResolverTests, TestMalformedTableThrows)
+		{
+			ASSERT_THROW(buildResolver("Canada: 05: 09: NA: 44.35: 78.75: 5.0: VE:\n    VE,VA\n"), std::runtime_error);
+			ASSERT_THROW(buildResolver("Canada: zz: 09: NA: 44.35: 78.75: 5.0: VE:\n    VE;\n"), std::runtime_error);
+		}
+	}
+}
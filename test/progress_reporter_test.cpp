@@ -0,0 +1,91 @@
+#include "../src/progressbar/ProgressReporter.h"
+
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace qrz
+{
+	namespace
+	{
+		// Records what the reporter draws
+		class RecordingProgressBar : public ProgressBar
+		{
+		public:
+			struct Frames
+			{
+				std::mutex mutex;
+				std::vector<size_t> progress;
+			};
+
+			explicit RecordingProgressBar(std::shared_ptr<Frames> frames) : m_frames(std::move(frames))
+			{
+			}
+
+			void setProgress(size_t new_progress) override
+			{
+				std::lock_guard<std::mutex> lock(m_frames->mutex);
+				m_frames->progress.push_back(new_progress);
+			}
+
+			void setOption(const indicators::details::Setting<std::string, indicators::details::ProgressBarOption::postfix_text> &) override
+			{
+			}
+
+		private:
+			std::shared_ptr<Frames> m_frames;
+		};
+
+		TEST(ProgressReporterTests, TestFormatStatus)
+		{
+			ASSERT_EQ("0/1284 ETA --:--", ProgressReporter::formatStatus(0, 1284, std::chrono::seconds(2)));
+			ASSERT_EQ("100/400 50.0/s ETA 0:06", ProgressReporter::formatStatus(100, 400, std::chrono::seconds(2)));
+			ASSERT_EQ("10/5000 1.0/s ETA 83:10", ProgressReporter::formatStatus(10, 5000, std::chrono::seconds(10)));
+		}
+
+		TEST(ProgressReporterTests, TestLargeBatchProgress)
+		{
+			auto frames = std::make_shared<RecordingProgressBar::Frames>();
+
+			{
+				ProgressReporter reporter(std::make_unique<RecordingProgressBar>(frames), 1000000,
+										  std::chrono::milliseconds(1));
+
+				std::vector<std::thread> workers;
+				for (int i = 0; i < 4; ++i)
+				{
+					workers.emplace_back([&reporter]()
+					{
+						for (int j = 0; j < 125000; ++j)
+						{
+							reporter.advance();
+						}
+					});
+				}
+
+				for (std::thread &worker : workers)
+				{
+					worker.join();
+				}
+
+				ASSERT_EQ(500000, reporter.completed());
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			}
+
+			std::lock_guard<std::mutex> lock(frames->mutex);
+
+			ASSERT_FALSE(frames->progress.empty());
+			ASSERT_EQ(100, frames->progress.back()) << "Finishing should complete the bar";
+
+			bool sawHalf = false;
+			for (size_t progress : frames->progress)
+			{
+				sawHalf = sawHalf || progress == 50;
+			}
+
+			ASSERT_TRUE(sawHalf) << "Progress should not truncate to zero for large batches";
+		}
+	}
+}
@@ -1,8 +1,13 @@
 #include "../src/AppController.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
 #include <format>
 #include <filesystem>
+#include <thread>
+
+#include <Poco/DeflatingStream.h>
 
 #include "MockClient.h"
 
@@ -10,6 +15,93 @@ namespace qrz
 {
 	namespace
 	{
+		// Mock client that fails the first few requests with a transient error, then behaves like MockClient
+		class FlakyClient : public MockClient
+		{
+		public:
+			FlakyClient(Configuration &config, int failures) : MockClient(config), m_failures(failures)
+			{
+				setRetryPolicy(3, std::chrono::milliseconds(1), std::chrono::milliseconds(5));
+			}
+
+			QrzResponse sendRequest(Poco::URI &uri, const net::Deadline &deadline) override
+			{
+				m_requests++;
+
+				if (m_failures > 0)
+				{
+					m_failures--;
+					throw Poco::TimeoutException("Simulated timeout");
+				}
+
+				return MockClient::sendRequest(uri, deadline);
+			}
+
+			int getRequestCount() const
+			{
+				return m_requests;
+			}
+
+		private:
+			int m_failures;
+			int m_requests = 0;
+		};
+
+		// Mock client whose first request is slow, to exercise request hedging
+		class SlowFirstRequestClient : public MockClient
+		{
+		public:
+			explicit SlowFirstRequestClient(Configuration &config) : MockClient(config)
+			{
+				// Recent requests took about 1ms, so a request still running after that is worth hedging
+				for (int i = 0; i < 10; ++i)
+				{
+					m_hedging->latencies[static_cast<size_t>(Endpoint::CALLSIGN)].record(std::chrono::milliseconds(1));
+					m_hedging->latencies[static_cast<size_t>(Endpoint::HTML)].record(std::chrono::milliseconds(1));
+				}
+			}
+
+			QrzResponse sendRequest(Poco::URI &uri, const net::Deadline &deadline) override
+			{
+				if (m_requests.fetch_add(1) == 0)
+				{
+					std::this_thread::sleep_for(std::chrono::milliseconds(500));
+				}
+
+				return MockClient::sendRequest(uri, deadline);
+			}
+
+		private:
+			std::atomic<int> m_requests = 0;
+		};
+
+		// Mock client that counts its logins, and takes a while over each so concurrent callers overlap
+		class LoginCountingClient : public MockClient
+		{
+		public:
+			explicit LoginCountingClient(Configuration &config) : MockClient(config)
+			{}
+
+			QrzResponse sendRequest(Poco::URI &uri, const net::Deadline &deadline) override
+			{
+				if (uri.toString().find("password=") != std::string::npos)
+				{
+					m_logins++;
+					std::this_thread::sleep_for(std::chrono::milliseconds(50));
+				}
+
+				return MockClient::sendRequest(uri, deadline);
+			}
+
+			int getLoginCount() const
+			{
+				return m_logins;
+			}
+
+		private:
+			std::atomic<int> m_logins = 0;
+		};
+
 		class QrzClientTests : public testing::Test
 		{
 		protected:
@@ -198,6 +290,37 @@ namespace qrz
 			ASSERT_STREQ(expectedSessionKey, client.getSessionKey().c_str()) << "Session key should be " << expectedSessionKey;
 		}
 
+		TEST_F(QrzClientTests, TestExpiredSessionRefreshedOnce)
+		{
+			auto config = Configuration(configDirPath);
+			LoginCountingClient countingClient(config);
+
+			countingClient.setSessionExpiration(generateExpiredSessionExpiration());
+
+			std::vector<std::thread> threads;
+			std::atomic<int> fetched = 0;
+
+			for (int i = 0; i < 4; ++i)
+			{
+				threads.emplace_back([&countingClient, &fetched]()
+				{
+					if (countingClient.fetchCallsign("W1AW").getCall() == "W1AW")
+					{
+						fetched++;
+					}
+				});
+			}
+
+			for (std::thread &thread : threads)
+			{
+				thread.join();
+			}
+
+			ASSERT_EQ(4, fetched);
+			ASSERT_EQ(1, countingClient.getLoginCount()) << "Workers that find the session expired should log in once";
+			ASSERT_TRUE(countingClient.tokenIsValid());
+		}
+
 		TEST_F(QrzClientTests, TestFetchCallsign)
 		{
 			Callsign testCallsign = client.fetchCallsign("W1AW");
@@ -211,6 +334,11 @@ namespace qrz
 			ASSERT_STREQ(expectedEmail, testCallsign.getEmail().c_str()) << "Email should be " << expectedEmail;
 		}
 
+		TEST_F(QrzClientTests, TestFetchCallsignNotFound)
+		{
+			ASSERT_THROW(client.fetchCallsign("N0CALL"), NotFoundException) << "A call QRZ has no record of should be reported as not found";
+		}
+
 		TEST_F(QrzClientTests, TestFetchDXCC)
 		{
 			DXCC testDXCC = client.fetchDXCC("291");
@@ -224,6 +352,17 @@ namespace qrz
 			ASSERT_STREQ(expectedName, testDXCC.getName().c_str()) << "Name should be " << expectedName;
 		}
 
+		TEST_F(QrzClientTests, TestFetchAllDXCC)
+		{
+			std::vector<DXCC> dxccs = client.fetchAllDXCC();
+
+			ASSERT_EQ(2, dxccs.size()) << "Every entity in the response should be returned";
+			ASSERT_EQ("1", dxccs.at(0).getDxcc());
+			ASSERT_EQ("Canada", dxccs.at(0).getName());
+			ASSERT_EQ("291", dxccs.at(1).getDxcc());
+			ASSERT_EQ("USA", dxccs.at(1).getCcc());
+		}
+
 		TEST_F(QrzClientTests, TestFetchBio)
 		{
 			std::string testBio = client.fetchBio("W1AW");
@@ -234,6 +373,147 @@ namespace qrz
 			ASSERT_TRUE(foundUrl) << "Expected URL should be found in bio HTML";
 		}
 
+		TEST_F(QrzClientTests, TestFetchBioToStream)
+		{
+			std::ostringstream bio;
+			client.fetchBio("W1AW", bio);
+
+			ASSERT_EQ(client.fetchBio("W1AW"), bio.str()) << "The streamed bio should match the buffered one";
+		}
+
+		TEST_F(QrzClientTests, TestFetchCallsignRecordsPhases)
+		{
+			auto stats = std::make_shared<net::PhaseStats>();
+			client.setPhaseStats(stats);
+
+			client.fetchCallsign("W1AW");
+
+			std::vector<net::PhaseStats::Summary> summaries = stats->summarize();
+
+			auto count = [&summaries](net::Phase phase)
+			{
+				auto it = std::find_if(summaries.begin(), summaries.end(), [phase](const net::PhaseStats::Summary &summary)
+				{
+					return summary.phase == phase;
+				});
+
+				return it == summaries.end() ? 0 : it->count;
+			};
+
+			ASSERT_EQ(1, count(net::Phase::LOOKUP));
+			ASSERT_EQ(1, count(net::Phase::PARSE));
+			ASSERT_EQ(1, count(net::Phase::MARSHAL));
+			ASSERT_EQ(0, count(net::Phase::RENDER)) << "Rendering is timed by the caller";
+		}
+
+		TEST_F(QrzClientTests, TestFetchCallsignRetriesTransientErrors)
+		{
+			auto config = Configuration(configDirPath);
+			FlakyClient flakyClient(config, 2);
+
+			Callsign testCallsign = flakyClient.fetchCallsign("W1AW");
+
+			ASSERT_STREQ("W1AW", testCallsign.getCall().c_str()) << "Call should be fetched after retrying";
+			ASSERT_EQ(3, flakyClient.getRequestCount()) << "Two failed attempts should be followed by a successful one";
+			ASSERT_EQ(2, flakyClient.getRetrySnapshot().retries);
+		}
+
+		TEST_F(QrzClientTests, TestFetchCallsignThrowsWhenRetriesExhausted)
+		{
+			auto config = Configuration(configDirPath);
+			FlakyClient flakyClient(config, 5);
+
+			ASSERT_THROW(flakyClient.fetchCallsign("W1AW"), std::runtime_error) << "A request that never succeeds should be reported";
+			ASSERT_EQ(3, flakyClient.getRequestCount()) << "The request should be attempted the maximum number of times";
+		}
+
+		TEST_F(QrzClientTests, TestFetchCallsignLookupTimeout)
+		{
+			auto config = Configuration(configDirPath);
+			FlakyClient flakyClient(config, 1000);
+
+			flakyClient.setRetryPolicy(1000, std::chrono::milliseconds(50), std::chrono::milliseconds(50));
+			flakyClient.setLookupTimeout(std::chrono::milliseconds(200));
+
+			auto start = std::chrono::steady_clock::now();
+
+			ASSERT_THROW(flakyClient.fetchCallsign("W1AW"), DeadlineExceededException) << "A lookup that keeps failing should time out";
+			ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1)) << "The lookup should stop at its deadline";
+		}
+
+		TEST_F(QrzClientTests, TestHedgedRequest)
+		{
+			auto config = Configuration(configDirPath);
+			SlowFirstRequestClient slowClient(config);
+
+			slowClient.setHedgePercentile(90);
+
+			auto registry = std::make_shared<metrics::Registry>();
+			slowClient.setMetrics(registry);
+
+			auto start = std::chrono::steady_clock::now();
+			Callsign testCallsign = slowClient.fetchCallsign("W1AW");
+			auto elapsed = std::chrono::steady_clock::now() - start;
+
+			slowClient.waitForHedges();
+
+			QRZClient::HedgeSnapshot snapshot = slowClient.getHedgeSnapshot();
+
+			ASSERT_STREQ("W1AW", testCallsign.getCall().c_str());
+			ASSERT_LT(elapsed, std::chrono::milliseconds(400)) << "The hedge should answer before the slow request";
+			ASSERT_EQ(1, snapshot.fired);
+			ASSERT_EQ(1, snapshot.won);
+
+			std::ostringstream output;
+			registry->writePrometheus(output);
+
+			ASSERT_NE(std::string::npos, output.str().find("qrz_hedges_total{result=\"fired\"} 1\n"));
+			ASSERT_NE(std::string::npos, output.str().find("qrz_hedges_total{result=\"won\"} 1\n"));
+		}
+
+		TEST_F(QrzClientTests, TestBioNotHedged)
+		{
+			auto config = Configuration(configDirPath);
+			SlowFirstRequestClient slowClient(config);
+
+			slowClient.setHedgePercentile(90);
+
+			std::string bio = slowClient.fetchBio("W1AW");
+
+			slowClient.waitForHedges();
+
+			ASSERT_FALSE(bio.empty());
+			ASSERT_EQ(0, slowClient.getHedgeSnapshot().fired) << "Only callsign and DXCC lookups should be hedged";
+		}
+
+		TEST_F(QrzClientTests, TestReadCompressedBody)
+		{
+			for (auto [encoding, type] : {std::pair{"gzip", Poco::DeflatingStreamBuf::STREAM_GZIP},
+										  std::pair{"deflate", Poco::DeflatingStreamBuf::STREAM_ZLIB}})
+			{
+				std::ostringstream compressed;
+				Poco::DeflatingOutputStream deflater(compressed, type);
+				deflater << client.sessionResponse;
+				deflater.close();
+
+				std::istringstream input(compressed.str());
+				std::string body;
+				QRZClient::readBody(input, encoding, body);
+
+				ASSERT_EQ(client.sessionResponse, body) << encoding << " bodies should be inflated";
+			}
+
+			std::istringstream plain(client.sessionResponse);
+			std::string body;
+			QRZClient::readBody(plain, "", body);
+
+			ASSERT_EQ(client.sessionResponse, body);
+
+			std::istringstream brotli("compressed");
+
+			ASSERT_THROW(QRZClient::readBody(brotli, "br", body), Poco::DataFormatException);
+		}
+
 		TEST_F(QrzClientTests, TestValidateResponseGoodResponse)
 		{
 			bool valid = client.testValidateResponse(client.sessionResponse);
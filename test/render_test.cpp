@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <sstream>
+#include "../src/adif/AdifReader.h"
 #include "../src/model/Callsign.h"
 #include "../src/model/DXCC.h"
 #include "../src/render/RendererFactory.h"
@@ -331,5 +333,138 @@ namespace qrz
 
 			ASSERT_STREQ(dxccMD291.c_str(), renderedMD.c_str()) << "Output should match expectation";
 		}
+
+		TEST_F(RendererTests, TestCallsignRenderADIF)
+		{
+			render::DXCCJoin join;
+			join.add(DXCCMarshaler::FromXml(dxccXml291));
+
+			auto renderer = render::RendererFactory::createCallsignRenderer(OutputFormat::ADIF, &join);
+
+			Callsign testCallsign = CallsignMarshaler::FromXml(callsignXmlW1AW);
+
+			renderer->Render(std::vector<Callsign> {testCallsign, testCallsign});
+
+			std::istringstream rendered(buffer.str());
+			adif::AdifReader reader(rendered);
+
+			ASSERT_NE(std::string::npos, reader.header().find("<PROGRAMID:3>qrz")) << "Output should begin with a header";
+
+			adif::Record record;
+
+			ASSERT_TRUE(reader.next(record));
+			ASSERT_EQ("W1AW", record.find("CALL")->value);
+			ASSERT_EQ(testCallsign.getGrid(), record.find("GRIDSQUARE")->value);
+			ASSERT_EQ("NA", record.find("CONT")->value) << "The joined continent should be added";
+
+			ASSERT_TRUE(reader.next(record)) << "Each callsign should be a record";
+			ASSERT_FALSE(reader.next(record));
+		}
+
+		TEST_F(RendererTests, TestCallsignRenderWithDXCCJoin)
+		{
+			render::DXCCJoin join;
+			join.add(DXCCMarshaler::FromXml(dxccXml291));
+
+			Callsign testCallsign = CallsignMarshaler::FromXml(callsignXmlW1AW);
+
+			auto csvRenderer = render::RendererFactory::createCallsignRenderer(OutputFormat::CSV, &join);
+			csvRenderer->Render(std::vector<Callsign> {testCallsign});
+
+			std::string renderedCSV{buffer.str()};
+
+			ASSERT_TRUE(renderedCSV.starts_with(callsignCsvHeader + R"csv(,"dxcc_name","dxcc_continent","dxcc_cqzone","dxcc_ituzone")csv"))
+				<< "Header should end with the joined columns";
+			ASSERT_NE(std::string::npos, renderedCSV.find(callsignCsvPayload + R"csv(,"United States","NA","0","0")csv"))
+				<< "Row should end with the joined values";
+
+			buffer.str("");
+
+			auto jsonRenderer = render::RendererFactory::createCallsignRenderer(OutputFormat::JSON, &join);
+			jsonRenderer->Render(std::vector<Callsign> {testCallsign});
+
+			ASSERT_NE(std::string::npos, buffer.str().find(R"json("dxcc_name": "United States")json"));
+			ASSERT_NE(std::string::npos, buffer.str().find(R"json("dxcc_continent": "NA")json"));
+
+			buffer.str("");
+
+			auto xmlRenderer = render::RendererFactory::createCallsignRenderer(OutputFormat::XML, &join);
+			xmlRenderer->Render(std::vector<Callsign> {testCallsign});
+
+			ASSERT_NE(std::string::npos, buffer.str().find("<dxcc_name>United States</dxcc_name>"));
+			ASSERT_EQ("W1AW", CallsignMarshaler::FromXml(buffer.str()).getCall()) << "Joined elements should not break parsing";
+
+			buffer.str("");
+
+			auto mdRenderer = render::RendererFactory::createCallsignRenderer(OutputFormat::MD, &join);
+			mdRenderer->Render(std::vector<Callsign> {testCallsign});
+
+			ASSERT_NE(std::string::npos, buffer.str().find("DXCC Name"));
+			ASSERT_NE(std::string::npos, buffer.str().find("United States | NA"));
+		}
+
+		TEST_F(RendererTests, TestCallsignRenderWithEmptyDXCCJoin)
+		{
+			render::DXCCJoin join;
+
+			auto renderer = render::RendererFactory::createCallsignRenderer(OutputFormat::CSV, &join);
+
+			renderer->Render(std::vector<Callsign> {CallsignMarshaler::FromXml(callsignXmlW1AW)});
+
+			ASSERT_NE(std::string::npos, buffer.str().find(callsignCsvPayload + R"csv(,"","","","")csv"))
+				<< "Callsigns without a joined entity should get empty columns";
+		}
+
+		TEST_F(RendererTests, TestCallsignRenderTemplate)
+		{
+			auto compiled = render::CallsignTemplate::compile("{call}\\t{grid}\\t{lat},{lon}");
+			auto renderer = render::RendererFactory::createCallsignRenderer(compiled);
+
+			renderer->Render(std::vector<Callsign> {CallsignMarshaler::FromXml(callsignXmlW1AW),
+													CallsignMarshaler::FromXml(callsignXmlW1AW)});
+
+			ASSERT_EQ("W1AW\tFN31pr\t41.714775,-72.727260\nW1AW\tFN31pr\t41.714775,-72.727260\n", buffer.str());
+		}
+
+		TEST_F(RendererTests, TestCallsignTemplateSyntax)
+		{
+			Callsign testCallsign = CallsignMarshaler::FromXml(callsignXmlW1AW);
+
+			std::string line;
+			render::CallsignTemplate::compile("{{{CALL}}} {City}\\\\").render(testCallsign, line);
+
+			ASSERT_EQ("{W1AW} NEWINGTON\\", line) << "Braces should escape and names should ignore case";
+
+			line.clear();
+			render::CallsignTemplate::compile("").render(testCallsign, line);
+
+			ASSERT_EQ("", line);
+
+			ASSERT_THROW(render::CallsignTemplate::compile("{callsign}"), std::invalid_argument);
+			ASSERT_THROW(render::CallsignTemplate::compile("{call"), std::invalid_argument);
+			ASSERT_THROW(render::CallsignTemplate::compile("call}"), std::invalid_argument);
+		}
+
+		TEST_F(RendererTests, TestCallsignRenderOneAtATime)
+		{
+			Callsign testCallsign = CallsignMarshaler::FromXml(callsignXmlW1AW);
+
+			for (OutputFormat format : {OutputFormat::CSV, OutputFormat::ADIF, OutputFormat::MD})
+			{
+				render::RendererFactory::createCallsignRenderer(format)->Render(std::vector<Callsign> {testCallsign});
+
+				std::string rendered = buffer.str();
+				buffer.str("");
+
+				auto renderer = render::RendererFactory::createCallsignRenderer(format);
+
+				renderer->Begin();
+				renderer->RenderOne(testCallsign);
+				renderer->End();
+
+				ASSERT_EQ(rendered, buffer.str()) << "Streamed and batch output should match";
+				buffer.str("");
+			}
+		}
 	}
 }
\ No newline at end of file
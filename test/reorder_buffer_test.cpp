@@ -0,0 +1,115 @@
+#include "../src/ReorderBuffer.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace qrz
+{
+	namespace
+	{
+		TEST(ReorderBufferTests, TestEmitsInOrderAsSoonAsHeadIsReady)
+		{
+			std::vector<int> emitted;
+			ReorderBuffer<int> buffer(16, [&emitted](int &&value) { emitted.push_back(value); });
+
+			buffer.push(2, 2);
+			buffer.push(1, 1);
+
+			ASSERT_TRUE(emitted.empty()) << "Nothing should be emitted before the head of the line";
+
+			buffer.push(0, 0);
+
+			ASSERT_EQ((std::vector<int>{0, 1, 2}), emitted);
+
+			buffer.skip(3);
+			buffer.push(5, 5);
+			buffer.push(4, 4);
+
+			ASSERT_EQ((std::vector<int>{0, 1, 2, 4, 5}), emitted) << "Skipped indices should not hold the line";
+		}
+
+		TEST(ReorderBufferTests, TestUnordered)
+		{
+			std::vector<int> emitted;
+			ReorderBuffer<int> buffer(16, [&emitted](int &&value) { emitted.push_back(value); }, false);
+
+			buffer.push(2, 2);
+			buffer.skip(1);
+			buffer.push(0, 0);
+
+			ASSERT_EQ((std::vector<int>{2, 0}), emitted);
+		}
+
+		TEST(ReorderBufferTests, TestWindowBoundsHeldResults)
+		{
+			std::vector<int> emitted;
+			ReorderBuffer<int> buffer(2, [&emitted](int &&value) { emitted.push_back(value); });
+
+			buffer.push(1, 1);
+			buffer.push(2, 2);
+
+			ASSERT_TRUE(emitted.empty());
+
+			buffer.push(3, 3);
+
+			ASSERT_EQ((std::vector<int>{1, 2, 3}), emitted) << "A full window should be emitted past a stalled head";
+
+			buffer.push(0, 0);
+
+			ASSERT_EQ((std::vector<int>{1, 2, 3, 0}), emitted) << "A late head should still be emitted";
+		}
+
+		TEST(ReorderBufferTests, TestFinishEmitsHeldResults)
+		{
+			std::vector<int> emitted;
+			ReorderBuffer<int> buffer(16, [&emitted](int &&value) { emitted.push_back(value); });
+
+			buffer.push(3, 3);
+			buffer.push(1, 1);
+			buffer.finish();
+
+			ASSERT_EQ((std::vector<int>{1, 3}), emitted);
+		}
+
+		TEST(ReorderBufferTests, TestConcurrentPushes)
+		{
+			const size_t count = 10000;
+
+			std::vector<size_t> order(count);
+			std::iota(order.begin(), order.end(), 0);
+			std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+			std::vector<size_t> emitted;
+			ReorderBuffer<size_t> buffer(count, [&emitted](size_t &&value) { emitted.push_back(value); });
+
+			{
+				std::vector<std::jthread> workers;
+
+				for (size_t worker = 0; worker < 4; ++worker)
+				{
+					workers.emplace_back([&order, &buffer, worker]()
+					{
+						for (size_t i = worker; i < order.size(); i += 4)
+						{
+							if (order[i] % 10 == 0)
+							{
+								buffer.skip(order[i]);
+							}
+							else
+							{
+								buffer.push(order[i], size_t(order[i]));
+							}
+						}
+					});
+				}
+			}
+
+			ASSERT_EQ(count - count / 10, emitted.size());
+			ASSERT_TRUE(std::is_sorted(emitted.begin(), emitted.end()));
+		}
+	}
+}
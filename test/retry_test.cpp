@@ -0,0 +1,74 @@
+#include "../src/net/RetryPolicy.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+
+namespace qrz
+{
+	namespace
+	{
+		TEST(RetryTests, TestBackoffIsBounded)
+		{
+			net::RetryPolicy policy(10, std::chrono::milliseconds(100), std::chrono::milliseconds(1000), 1.0, 10.0);
+
+			for (int attempt = 1; attempt <= 10; ++attempt)
+			{
+				// Full jitter: anywhere between zero and the exponential delay, which is capped at the maximum
+				std::chrono::milliseconds ceiling = std::min(std::chrono::milliseconds(1000),
+															 std::chrono::milliseconds(100) * (1 << (attempt - 1)));
+
+				for (int i = 0; i < 50; ++i)
+				{
+					std::chrono::milliseconds delay = policy.backoff(attempt);
+
+					ASSERT_GE(delay.count(), 0);
+					ASSERT_LE(delay, ceiling) << "Delay for attempt " << attempt << " should not exceed " << ceiling.count() << "ms";
+				}
+			}
+		}
+
+		TEST(RetryTests, TestMaxAttempts)
+		{
+			net::RetryPolicy policy(3, std::chrono::milliseconds(1), std::chrono::milliseconds(1), 1.0, 10.0);
+
+			policy.recordRequest();
+
+			ASSERT_TRUE(policy.allowRetry(1));
+			ASSERT_TRUE(policy.allowRetry(2));
+			ASSERT_FALSE(policy.allowRetry(3)) << "A request should not be attempted more than the maximum number of times";
+
+			net::RetryPolicy::Snapshot snapshot = policy.snapshot();
+
+			ASSERT_EQ(2, snapshot.retries);
+			ASSERT_EQ(1, snapshot.attemptsExhausted);
+		}
+
+		TEST(RetryTests, TestRetryBudget)
+		{
+			// No starting budget, and one retry earned for every two requests
+			net::RetryPolicy policy(5, std::chrono::milliseconds(1), std::chrono::milliseconds(1), 0.5, 0.0);
+
+			ASSERT_FALSE(policy.allowRetry(1)) << "An empty budget should not allow a retry";
+
+			policy.recordRequest();
+			policy.recordRequest();
+
+			ASSERT_TRUE(policy.allowRetry(1));
+			ASSERT_FALSE(policy.allowRetry(1)) << "The budget should be spent by the first retry";
+			ASSERT_EQ(2, policy.snapshot().budgetExhausted);
+
+			policy.resetBudget();
+
+			ASSERT_DOUBLE_EQ(0.0, policy.snapshot().budget) << "Resetting should restore the starting budget";
+		}
+
+		TEST(RetryTests, TestRetryableStatus)
+		{
+			ASSERT_TRUE(net::RetryPolicy::isRetryableStatus(429));
+			ASSERT_TRUE(net::RetryPolicy::isRetryableStatus(503));
+			ASSERT_FALSE(net::RetryPolicy::isRetryableStatus(200));
+			ASSERT_FALSE(net::RetryPolicy::isRetryableStatus(404));
+		}
+	}
+}
@@ -0,0 +1,84 @@
+#include "../src/TermReader.h"
+#include "../src/TermSet.h"
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+namespace qrz
+{
+	namespace
+	{
+		TEST(TermReaderTests, TestTermSetDeduplicatesAcrossGrowth)
+		{
+			TermSet terms;
+
+			ASSERT_TRUE(terms.insert("W1AW"));
+			ASSERT_FALSE(terms.insert("W1AW"));
+
+			for (int i = 0; i < 100000; ++i)
+			{
+				terms.insert("K" + std::to_string(i) + "X");
+			}
+
+			ASSERT_EQ(100001, terms.size());
+			ASSERT_FALSE(terms.insert("K99999X")) << "Terms should be found again after the table grows";
+
+			TermSet other(2);
+			other.insert("W1AW");
+			other.insert("W5YI");
+
+			ASSERT_EQ(1, terms.merge(other));
+			ASSERT_EQ(100002, terms.size());
+
+			size_t visited = 0;
+			terms.forEach([&visited](std::string_view) { visited++; });
+
+			ASSERT_EQ(terms.size(), visited);
+		}
+
+		TEST(TermReaderTests, TestSplitIntoChunks)
+		{
+			std::string list = "w1aw\r\n\n  W5YI \nnot a call\nVE3/W1AW/P\nK4RWR\n1x\nW5YI";
+
+			for (size_t chunks : {1, 2, 3, 50})
+			{
+				CallsignNormalizer::Result result =
+						TermReader::split(list, CallsignNormalizer::normalizeCallsign, chunks);
+
+				std::set<std::string> expectedTerms = {"K4RWR", "W1AW", "W5YI"};
+				std::vector<std::string> expectedRejected = {"not a call", "1x"};
+
+				ASSERT_EQ(expectedTerms, result.terms) << chunks << " chunks";
+				ASSERT_EQ(2, result.duplicates) << chunks << " chunks";
+				ASSERT_EQ(expectedRejected, result.rejected) << "Rejected lines should keep their order";
+			}
+
+			ASSERT_TRUE(TermReader::split("", CallsignNormalizer::normalizeCallsign, 4).terms.empty());
+		}
+
+		TEST(TermReaderTests, TestReadFile)
+		{
+			std::filesystem::path path = std::filesystem::temp_directory_path() / "qrz_term_reader_test.txt";
+
+			{
+				std::ofstream output(path);
+
+				for (int i = 0; i < 300000; ++i)
+				{
+					output << "k" << (i % 5000) << "abc\n";
+				}
+			}
+
+			CallsignNormalizer::Result result = TermReader::read(path.string(), CallsignNormalizer::normalizeCallsign);
+
+			ASSERT_EQ(5000, result.terms.size());
+			ASSERT_EQ(295000, result.duplicates);
+			ASSERT_EQ(1, result.terms.count("K42ABC"));
+
+			std::filesystem::remove(path);
+
+			ASSERT_THROW(TermReader::read(path.string(), CallsignNormalizer::normalizeCallsign), std::runtime_error);
+		}
+	}
+}
@@ -0,0 +1,142 @@
+#include "../src/net/AdaptiveConcurrencyLimiter.h"
+#include "../src/net/LatencyWindow.h"
+#include "../src/net/TokenBucket.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+
+namespace qrz
+{
+	namespace
+	{
+		using Outcome = net::AdaptiveConcurrencyLimiter::Outcome;
+
+		TEST(ThrottleTests, TestTokenBucketBurst)
+		{
+			net::TokenBucket bucket(1.0, 5.0);
+
+			auto start = std::chrono::steady_clock::now();
+
+			for (int i = 0; i < 5; ++i)
+			{
+				bucket.acquire();
+			}
+
+			auto elapsed = std::chrono::steady_clock::now() - start;
+
+			ASSERT_LT(elapsed, std::chrono::milliseconds(100)) << "A full bucket should not delay a burst";
+
+			net::TokenBucket::Snapshot snapshot = bucket.snapshot();
+
+			ASSERT_EQ(5, snapshot.acquired);
+			ASSERT_EQ(0, snapshot.waits);
+		}
+
+		TEST(ThrottleTests, TestTokenBucketRate)
+		{
+			net::TokenBucket bucket(20.0, 1.0);
+
+			auto start = std::chrono::steady_clock::now();
+
+			// The first token is free, the next four are spaced 50ms apart
+			for (int i = 0; i < 5; ++i)
+			{
+				bucket.acquire();
+			}
+
+			auto elapsed = std::chrono::steady_clock::now() - start;
+
+			ASSERT_GE(elapsed, std::chrono::milliseconds(180)) << "Tokens should be handed out at the configured rate";
+			ASSERT_EQ(4, bucket.snapshot().waits);
+		}
+
+		TEST(ThrottleTests, TestConcurrencyAdditiveIncrease)
+		{
+			net::AdaptiveConcurrencyLimiter limiter(1, 1, 4);
+
+			for (int i = 0; i < 20; ++i)
+			{
+				limiter.acquire();
+				limiter.release(Outcome::SUCCESS, std::chrono::milliseconds(100));
+			}
+
+			net::AdaptiveConcurrencyLimiter::Snapshot snapshot = limiter.snapshot();
+
+			ASSERT_GT(snapshot.limit, 1.0) << "Saturated successes should raise the limit";
+			ASSERT_LE(snapshot.limit, 4.0) << "The limit should never exceed the maximum";
+			ASSERT_EQ(0, snapshot.inFlight);
+		}
+
+		TEST(ThrottleTests, TestConcurrencyMultiplicativeDecrease)
+		{
+			net::AdaptiveConcurrencyLimiter limiter(8, 1, 8);
+
+			limiter.acquire();
+			limiter.release(Outcome::OVERLOAD, std::chrono::milliseconds(100));
+
+			ASSERT_DOUBLE_EQ(4.0, limiter.snapshot().limit) << "An overload should halve the limit";
+
+			limiter.acquire();
+			limiter.release(Outcome::TIMEOUT, std::chrono::milliseconds(100));
+
+			net::AdaptiveConcurrencyLimiter::Snapshot snapshot = limiter.snapshot();
+
+			ASSERT_GE(snapshot.limit, 1.0) << "The limit should never drop below the minimum";
+			ASSERT_EQ(1, snapshot.overloads);
+			ASSERT_EQ(1, snapshot.timeouts);
+		}
+
+		TEST(ThrottleTests, TestAcquireGivesUpAtDeadline)
+		{
+			net::TokenBucket bucket(1.0, 1.0);
+			bucket.acquire();
+
+			auto start = std::chrono::steady_clock::now();
+
+			ASSERT_FALSE(bucket.acquire(net::Deadline::after(std::chrono::milliseconds(50))))
+				<< "Waiting for a token should stop at the deadline";
+			ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+			ASSERT_EQ(1, bucket.snapshot().acquired) << "The reserved token should be given back";
+
+			net::AdaptiveConcurrencyLimiter limiter(1, 1, 1);
+			limiter.acquire();
+
+			net::Deadline cancelled = net::Deadline::after(std::chrono::seconds(10));
+			cancelled.cancel();
+
+			ASSERT_FALSE(limiter.acquire(cancelled)) << "Waiting for a slot should stop when cancelled";
+			ASSERT_FALSE(limiter.acquire(net::Deadline::after(std::chrono::milliseconds(50))));
+
+			limiter.releaseUnused();
+
+			ASSERT_EQ(0, limiter.snapshot().inFlight);
+			ASSERT_DOUBLE_EQ(1.0, limiter.snapshot().limit) << "An unused slot should not change the limit";
+			ASSERT_TRUE(limiter.acquire(net::Deadline::after(std::chrono::milliseconds(50))));
+		}
+
+		TEST(ThrottleTests, TestLatencyWindowPercentile)
+		{
+			net::LatencyWindow window(100);
+
+			ASSERT_FALSE(window.percentile(50, 1).has_value()) << "An empty window has no percentiles";
+
+			for (int i = 1; i <= 100; ++i)
+			{
+				window.record(std::chrono::milliseconds(i));
+			}
+
+			ASSERT_EQ(std::chrono::milliseconds(50), window.percentile(50, 1));
+			ASSERT_EQ(std::chrono::milliseconds(95), window.percentile(95, 1));
+			ASSERT_FALSE(window.percentile(95, 101).has_value()) << "Too few samples should yield no answer";
+
+			// The oldest samples should be replaced once the window is full
+			for (int i = 0; i < 100; ++i)
+			{
+				window.record(std::chrono::milliseconds(1000));
+			}
+
+			ASSERT_EQ(100, window.size());
+			ASSERT_EQ(std::chrono::milliseconds(1000), window.percentile(1, 1));
+		}
+	}
+}
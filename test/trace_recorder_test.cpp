@@ -0,0 +1,97 @@
+#include "../src/net/PhaseStats.h"
+#include "../src/net/TraceRecorder.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+namespace qrz
+{
+	namespace
+	{
+		size_t countOf(const std::string &text, const std::string &pattern)
+		{
+			size_t count = 0;
+
+			for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+			{
+				count++;
+			}
+
+			return count;
+		}
+
+		TEST(TraceRecorderTests, TestSpansPerThread)
+		{
+			net::TraceRecorder recorder;
+
+			auto record = [&recorder](const char *call)
+			{
+				net::TraceRecorder::setThreadTag(call);
+
+				auto start = net::TraceRecorder::Clock::now();
+				recorder.span("lookup", start, start + std::chrono::milliseconds(3));
+			};
+
+			std::thread first(record, "W1AW");
+			std::thread second(record, "W5YI");
+
+			first.join();
+			second.join();
+
+			std::ostringstream output;
+			recorder.write(output);
+
+			std::string trace = output.str();
+
+			ASSERT_TRUE(trace.starts_with("{")) << trace;
+			ASSERT_EQ(2, countOf(trace, R"("name":"lookup")"));
+			ASSERT_EQ(2, countOf(trace, R"("name":"thread_name")")) << "Each thread should have its own track";
+			ASSERT_EQ(1, countOf(trace, R"("args":{"call":"W1AW"})"));
+			ASSERT_EQ(1, countOf(trace, R"("args":{"call":"W5YI"})"));
+			ASSERT_EQ(2, countOf(trace, R"("dur":3000)"));
+		}
+
+		TEST(TraceRecorderTests, TestRingOverwritesOldest)
+		{
+			net::TraceRecorder recorder(2);
+
+			net::TraceRecorder::setThreadTag("");
+
+			auto start = net::TraceRecorder::Clock::now();
+
+			recorder.span("connect", start, start);
+			recorder.span("transfer", start, start);
+			recorder.span("parse", start, start);
+
+			std::ostringstream output;
+			recorder.write(output);
+
+			ASSERT_EQ(1, recorder.dropped());
+			ASSERT_EQ(std::string::npos, output.str().find(R"("name":"connect")")) << "The oldest span should go";
+			ASSERT_NE(std::string::npos, output.str().find(R"("name":"parse")"));
+			ASSERT_EQ(std::string::npos, output.str().find(R"("call")")) << "Untagged spans should have no call";
+		}
+
+		TEST(TraceRecorderTests, TestPhaseStatsRecordSpans)
+		{
+			auto recorder = std::make_shared<net::TraceRecorder>();
+
+			net::PhaseStats stats;
+			stats.setTraceRecorder(recorder);
+
+			{
+				net::PhaseStats::Timer timer(&stats, net::Phase::FIRST_BYTE);
+				timer.next(net::Phase::TRANSFER);
+			}
+
+			std::ostringstream output;
+			recorder->write(output);
+
+			ASSERT_NE(std::string::npos, output.str().find(R"("name":"first byte")"));
+			ASSERT_NE(std::string::npos, output.str().find(R"("name":"transfer")"));
+			ASSERT_EQ(2, stats.summarize().size()) << "Traced phases should still be counted";
+		}
+	}
+}
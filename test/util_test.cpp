@@ -35,5 +35,20 @@ namespace qrz
 
 			ASSERT_STREQ(expected.c_str(), actual.c_str()) << "Strings should be equal and lowercase";
 		}
+
+		TEST(UtilTests, TestSecureWipe)
+		{
+			std::string secret = "wh15ky7@n60F0x7r07 and some more to force a heap buffer";
+			secret.resize(4);
+
+			size_t capacity = secret.capacity();
+			const char *buffer = secret.data();
+
+			SecureWipe(secret);
+
+			ASSERT_TRUE(secret.empty());
+			ASSERT_EQ(capacity, secret.capacity()) << "Wiping should not reallocate";
+			ASSERT_EQ(buffer, secret.data()) << "The buffer should be wiped in place, not freed";
+		}
 	}
 }
\ No newline at end of file